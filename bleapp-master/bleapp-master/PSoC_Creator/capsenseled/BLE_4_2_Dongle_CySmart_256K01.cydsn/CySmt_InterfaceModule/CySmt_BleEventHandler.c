@@ -39,6 +39,7 @@
 
 #include "CySmt_protocol.h"
 #include "CySmt_BleEventHandler.h"
+#include "CySmt_Macro.h"
 
 #ifdef CYSMART_SUPPORT
 
@@ -51,6 +52,52 @@ uint8 cysBdHandle;
 
 CYBLE_GAP_IOCAP_T CySIoCap = CYBLE_IO_CAPABILITY;
 
+/* Largest EVT_SCAN_AGGREGATED_RESULT record data, leaves room for the event header within MAX_PAYLOAD_SIZE.
+        A longer flush is split over several events */
+#define SCAN_AGGR_FRAME_MAX         (MAX_PAYLOAD_SIZE - 16u)
+
+/* Advertisement reports of one device merged over the aggregation window */
+typedef struct _SCAN_AGGR_ENTRY
+{
+    uint8 bdAddr[CYBLE_GAP_BD_ADDR_SIZE];
+    uint8 addrType;
+    uint8 eventType;
+    int8 rssiMin;
+    int8 rssiMax;
+    int32 rssiSum;
+    uint16 count;
+    /* Latest advertisement or scan response data */
+    uint8 dataLen;
+    uint8 data[CYBLE_GAP_MAX_ADV_DATA_LEN];
+}SCAN_AGGR_ENTRY;
+
+static uint8 scanAggrMode = SCAN_AGGR_PASSTHROUGH;
+static uint16 scanAggrWindow = SCAN_AGGR_DEFAULT_WINDOW;
+static SCAN_AGGR_ENTRY scanAggrTable[SCAN_AGGR_TABLE_SIZE];
+static uint8 scanAggrCount = 0;
+
+/* Time stamp of the first report in the table */
+static uint32 scanAggrStart = 0;
+
+/* Notification batch buffer, sized so a full batch stays within MAX_PAYLOAD_SIZE */
+#define NTF_BATCH_BUFF_SIZE         (MAX_PAYLOAD_SIZE - 16u)
+
+/* Flush reasons */
+#define NTF_FLUSH_SIZE              (0u)
+#define NTF_FLUSH_TIME              (1u)
+#define NTF_FLUSH_EVENT             (2u)
+
+static uint8 ntfBatchMode = NTF_BATCH_OFF;
+static uint16 ntfBatchMaxBytes = NTF_BATCH_BUFF_SIZE;
+static uint32 ntfBatchBudget = NTF_BATCH_DEFAULT_BUDGET_US;
+static uint8 ntfBatchBuf[NTF_BATCH_BUFF_SIZE];
+static uint16 ntfBatchUsed = 0;
+static uint8 ntfBatchCount = 0;
+
+/* Microsecond time stamp of each record, for the added latency */
+static uint32 ntfBatchArrival[NTF_BATCH_MAX_RECORDS];
+static NTF_BATCH_STATS_T ntfBatchStats;
+
 /*******************************************************************************
 * Function Name: Send_advt_report
 ********************************************************************************
@@ -98,6 +145,233 @@ static CYBLE_API_RESULT_T Send_advt_report(CYBLE_GAPC_ADV_REPORT_T *scanResp)
     return CYBLE_ERROR_OK;
 }
 
+/*******************************************************************************
+* Function Name: Aggregate_advt_report
+********************************************************************************
+*
+* Summary:
+* This function merges the advertisement report into the device table
+*
+* Parameters:
+*  CYBLE_GAPC_ADV_REPORT_T *scanResp: Pointer to scan response
+*
+* Return:
+*  pass/fail status of Advertisement report parsing
+*
+* Theory:
+*  Reports with the same address, address type and event type share one entry,
+*  advertisements and scan responses of a device are kept apart as their data differs
+*
+* Side Effects:
+*  The table is flushed first if the device is new and the table is full
+*
+* Note:
+*
+*******************************************************************************/
+static CYBLE_API_RESULT_T Aggregate_advt_report(CYBLE_GAPC_ADV_REPORT_T *scanResp)
+{
+    SCAN_AGGR_ENTRY *entry = NULL;
+    uint8 i;
+
+    if(scanResp->dataLen > CYBLE_GAP_MAX_ADV_DATA_LEN)
+    {
+        return CYBLE_ERROR_INVALID_PARAMETER;
+    }
+
+    for(i = 0; i < scanAggrCount; i++)
+    {
+        if((scanAggrTable[i].eventType == scanResp->eventType) &&
+           (scanAggrTable[i].addrType == scanResp->peerAddrType) &&
+           (0 == memcmp(scanAggrTable[i].bdAddr, scanResp->peerBdAddr, CYBLE_GAP_BD_ADDR_SIZE)))
+        {
+            entry = &scanAggrTable[i];
+            break;
+        }
+    }
+
+    if(NULL == entry)
+    {
+        if(SCAN_AGGR_TABLE_SIZE == scanAggrCount)
+        {
+            CyS_FlushScanReports();
+        }
+        if(0 == scanAggrCount)
+        {
+            scanAggrStart = Timer_Get_Time_Stamp();
+        }
+
+        entry = &scanAggrTable[scanAggrCount++];
+        memcpy(entry->bdAddr, scanResp->peerBdAddr, CYBLE_GAP_BD_ADDR_SIZE);
+        entry->addrType = scanResp->peerAddrType;
+        entry->eventType = scanResp->eventType;
+        entry->rssiMin = scanResp->rssi;
+        entry->rssiMax = scanResp->rssi;
+        entry->rssiSum = 0;
+        entry->count = 0;
+    }
+
+    if(scanResp->rssi < entry->rssiMin)
+    {
+        entry->rssiMin = scanResp->rssi;
+    }
+    if(scanResp->rssi > entry->rssiMax)
+    {
+        entry->rssiMax = scanResp->rssi;
+    }
+    if(entry->count < 0xFFFFu)
+    {
+        entry->rssiSum += scanResp->rssi;
+        entry->count++;
+    }
+
+    entry->dataLen = scanResp->dataLen;
+    memcpy(entry->data, scanResp->data, scanResp->dataLen);
+    return CYBLE_ERROR_OK;
+}
+
+/*******************************************************************************
+* Function Name: CyS_FlushScanReports
+********************************************************************************
+*
+* Summary:
+*  Sends the merged advertisement reports and empties the device table
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  Each EVT_SCAN_AGGREGATED_RESULT carries a 1-byte record count followed by the
+*  records, as many as fit in SCAN_AGGR_FRAME_MAX
+*
+* Side Effects:
+*
+* Note:
+*
+*******************************************************************************/
+void CyS_FlushScanReports(void)
+{
+    uint8 record[SCAN_AGGR_RECORD_HEADER];
+    uint8 first = 0;
+    uint8 last;
+    uint8 count;
+    uint8 index;
+    uint16 payloadSize;
+    SCAN_AGGR_ENTRY *entry;
+
+    while(first < scanAggrCount)
+    {
+        /* Find the records that fit in one event */
+        payloadSize = 0;
+        for(last = first; last < scanAggrCount; last++)
+        {
+            if((payloadSize + SCAN_AGGR_RECORD_HEADER + scanAggrTable[last].dataLen) > SCAN_AGGR_FRAME_MAX)
+            {
+                break;
+            }
+            payloadSize += SCAN_AGGR_RECORD_HEADER + scanAggrTable[last].dataLen;
+        }
+
+        count = last - first;
+        CyS_SendEvent(EVT_SCAN_AGGREGATED_RESULT, CMD_START_SCAN, payloadSize, sizeof(count), &count);
+
+        for(; first < last; first++)
+        {
+            entry = &scanAggrTable[first];
+            index = 0;
+            record[index++] = entry->eventType;
+            memcpy(&record[index], entry->bdAddr, CYBLE_GAP_BD_ADDR_SIZE);
+            index += CYBLE_GAP_BD_ADDR_SIZE;
+            record[index++] = entry->addrType;
+            record[index++] = (uint8)entry->rssiMin;
+            record[index++] = (uint8)(int8)(entry->rssiSum / (int32)entry->count);
+            record[index++] = (uint8)entry->rssiMax;
+            record[index++] = LO8(entry->count);
+            record[index++] = HI8(entry->count);
+            record[index++] = entry->dataLen;
+
+            TransmitAdditionalData(record, index);
+            if(0 != entry->dataLen)
+            {
+                TransmitAdditionalData(entry->data, entry->dataLen);
+            }
+        }
+    }
+    scanAggrCount = 0;
+}
+
+/*******************************************************************************
+* Function Name: CyS_ScanAggregationProcess
+********************************************************************************
+*
+* Summary:
+*  Flushes the merged advertisement reports once the aggregation window has passed
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  NONE
+*
+* Side Effects:
+*
+* Note:
+*  Call from the main loop
+*
+*******************************************************************************/
+void CyS_ScanAggregationProcess(void)
+{
+    if((0 != scanAggrCount) && Timer_Time_Elapsed(scanAggrStart, scanAggrWindow))
+    {
+        CyS_FlushScanReports();
+    }
+}
+
+/*******************************************************************************
+* Function Name: CyS_SetScanAggregation
+********************************************************************************
+*
+* Summary:
+*  Selects how advertisement reports are forwarded to the host
+*
+* Parameters:
+*  mode:   SCAN_AGGR_PASSTHROUGH or SCAN_AGGR_BATCH
+*
+*  window: aggregation window in timer ticks (ms)
+*
+* Return:
+*  CYBLE_API_RESULT_T - CYBLE_ERROR_INVALID_PARAMETER for an unknown mode or empty window
+*
+* Theory:
+*  NONE
+*
+* Side Effects:
+*  Reports merged so far are flushed
+*
+* Note:
+*
+*******************************************************************************/
+CYBLE_API_RESULT_T CyS_SetScanAggregation(uint8 mode, uint16 window)
+{
+    if((SCAN_AGGR_BATCH < mode) || ((SCAN_AGGR_BATCH == mode) && (0 == window)))
+    {
+        return CYBLE_ERROR_INVALID_PARAMETER;
+    }
+
+    CyS_FlushScanReports();
+    scanAggrMode = mode;
+    if(0 != window)
+    {
+        scanAggrWindow = window;
+    }
+    return CYBLE_ERROR_OK;
+}
+
 /*******************************************************************************
 * Function Name: ReadByGroupEventHandler
 ********************************************************************************
@@ -730,6 +1004,250 @@ static void ReadRspEventHandler(CYBLE_GATTC_READ_RSP_PARAM_T *ReadResp)
     }
 }
 
+/*******************************************************************************
+* Function Name: Flush_Notification_Batch
+********************************************************************************
+*
+* Summary:
+* Sends the batched notifications as one event and updates the batching counters
+*
+* Parameters:
+* uint8 reason: NTF_FLUSH_SIZE, NTF_FLUSH_TIME or NTF_FLUSH_EVENT
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  The event carries a 1-byte record count followed by the records
+*
+* Side Effects:
+*
+* Note:
+*
+*******************************************************************************/
+static void Flush_Notification_Batch(uint8 reason)
+{
+    uint32 now;
+    uint32 latency;
+    uint8 bin;
+    uint8 i;
+
+    if(0 == ntfBatchCount)
+    {
+        return;
+    }
+
+    CyS_SendEvent(EVT_CHARACTERISTIC_VALUE_NOTIFICATION_BATCH, 0, ntfBatchUsed,
+                    sizeof(ntfBatchCount), &ntfBatchCount);
+    TransmitAdditionalData(ntfBatchBuf, ntfBatchUsed);
+
+    now = Timer_Get_Time_Stamp_Us();
+    for(i = 0; i < ntfBatchCount; i++)
+    {
+        latency = now - ntfBatchArrival[i];
+        if((int32)latency < 0)
+        {
+            /* Time stamp read across a SysTick reload */
+            latency = 0;
+        }
+        if(latency > ntfBatchStats.latencyMaxUs)
+        {
+            ntfBatchStats.latencyMaxUs = latency;
+        }
+        for(bin = 0; (bin < (NTF_BATCH_LATENCY_BINS - 1u)) &&
+                     (latency >= ((uint32)NTF_BATCH_LATENCY_BIN0_US << bin)); bin++)
+        {
+        }
+        ntfBatchStats.latencyHist[bin]++;
+    }
+
+    ntfBatchStats.notifications += ntfBatchCount;
+    ntfBatchStats.batches++;
+    ntfBatchStats.headerBytesSaved += (int32)(ntfBatchCount * (NTF_SINGLE_EVENT_HEADER - NTF_BATCH_RECORD_HEADER)) -
+                                      (int32)(sizeof(uint16) + sizeof(uint16) + sizeof(uint16) + sizeof(ntfBatchCount));
+    if(NTF_FLUSH_SIZE == reason)
+    {
+        ntfBatchStats.flushSize++;
+    }
+    else if(NTF_FLUSH_TIME == reason)
+    {
+        ntfBatchStats.flushTime++;
+    }
+    else
+    {
+        ntfBatchStats.flushEvent++;
+    }
+
+    ntfBatchUsed = 0;
+    ntfBatchCount = 0;
+}
+
+/*******************************************************************************
+* Function Name: Batch_Notification
+********************************************************************************
+*
+* Summary:
+* Appends a notification to the batch
+*
+* Parameters:
+* CYBLE_GATTC_HANDLE_VALUE_NTF_PARAM_T *NotifyParams
+*
+* Return:
+*  bool - false if the notification is too large for a batch and must be sent on its own
+*
+* Theory:
+*  The batch is flushed first if the record does not fit
+*
+* Side Effects:
+*
+* Note:
+*
+*******************************************************************************/
+static bool Batch_Notification(CYBLE_GATTC_HANDLE_VALUE_NTF_PARAM_T *NotifyParams)
+{
+    uint16 recordSize = NTF_BATCH_RECORD_HEADER + NotifyParams->handleValPair.value.len;
+    uint8 *record;
+
+    if(recordSize > ntfBatchMaxBytes)
+    {
+        /* Keep the order with the notifications already batched */
+        Flush_Notification_Batch(NTF_FLUSH_SIZE);
+        return false;
+    }
+
+    if(((ntfBatchUsed + recordSize) > ntfBatchMaxBytes) || (NTF_BATCH_MAX_RECORDS == ntfBatchCount))
+    {
+        Flush_Notification_Batch(NTF_FLUSH_SIZE);
+    }
+
+    record = &ntfBatchBuf[ntfBatchUsed];
+    memcpy(record, &NotifyParams->connHandle, sizeof(CYBLE_CONN_HANDLE_T));
+    CyBle_Set16ByPtr(&record[2], NotifyParams->handleValPair.attrHandle);
+    CyBle_Set16ByPtr(&record[4], NotifyParams->handleValPair.value.len);
+    memcpy(&record[NTF_BATCH_RECORD_HEADER], NotifyParams->handleValPair.value.val,
+            NotifyParams->handleValPair.value.len);
+
+    ntfBatchArrival[ntfBatchCount++] = Timer_Get_Time_Stamp_Us();
+    ntfBatchUsed += recordSize;
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: CyS_NotificationBatchProcess
+********************************************************************************
+*
+* Summary:
+*  Flushes batched notifications once the connection event is over or the time
+*  budget is spent
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  The link layer leaves the active state when the connection event closes,
+*  no more notifications arrive before the next one
+*
+* Side Effects:
+*
+* Note:
+*  Call from the main loop after CyBle_ProcessEvents()
+*
+*******************************************************************************/
+void CyS_NotificationBatchProcess(void)
+{
+    if(0 == ntfBatchCount)
+    {
+        return;
+    }
+
+    if(CYBLE_BLESS_STATE_ACTIVE != CyBle_GetBleSsState())
+    {
+        Flush_Notification_Batch(NTF_FLUSH_EVENT);
+    }
+    else if((Timer_Get_Time_Stamp_Us() - ntfBatchArrival[0]) >= ntfBatchBudget)
+    {
+        Flush_Notification_Batch(NTF_FLUSH_TIME);
+    }
+    else
+    {
+        /* Keep collecting */
+    }
+}
+
+/*******************************************************************************
+* Function Name: CyS_SetNotificationBatching
+********************************************************************************
+*
+* Summary:
+*  Selects how GATT notifications are forwarded to the host and clears the batching counters
+*
+* Parameters:
+*  mode:     NTF_BATCH_OFF or NTF_BATCH_ON
+*
+*  maxBytes: largest batch payload, 0 selects the whole batch buffer
+*
+*  budgetUs: time budget in microseconds, 0 keeps the current budget
+*
+* Return:
+*  CYBLE_API_RESULT_T - CYBLE_ERROR_INVALID_PARAMETER for an unknown mode
+*
+* Theory:
+*  NONE
+*
+* Side Effects:
+*  Notifications batched so far are flushed
+*
+* Note:
+*
+*******************************************************************************/
+CYBLE_API_RESULT_T CyS_SetNotificationBatching(uint8 mode, uint16 maxBytes, uint32 budgetUs)
+{
+    if(NTF_BATCH_ON < mode)
+    {
+        return CYBLE_ERROR_INVALID_PARAMETER;
+    }
+
+    Flush_Notification_Batch(NTF_FLUSH_EVENT);
+    memset(&ntfBatchStats, 0, sizeof(ntfBatchStats));
+
+    ntfBatchMode = mode;
+    ntfBatchMaxBytes = ((0 == maxBytes) || (maxBytes > NTF_BATCH_BUFF_SIZE)) ? NTF_BATCH_BUFF_SIZE : maxBytes;
+    if(0 != budgetUs)
+    {
+        ntfBatchBudget = budgetUs;
+    }
+    return CYBLE_ERROR_OK;
+}
+
+/*******************************************************************************
+* Function Name: CyS_GetNotificationBatchStats
+********************************************************************************
+*
+* Summary:
+*  Returns the notification batching counters
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  NTF_BATCH_STATS_T* - counters, updated in place
+*
+* Theory:
+*  NONE
+*
+* Side Effects:
+*
+* Note:
+*
+*******************************************************************************/
+const NTF_BATCH_STATS_T *CyS_GetNotificationBatchStats(void)
+{
+    return &ntfBatchStats;
+}
+
 /*******************************************************************************
 * Function Name: Gattc_NotificationHandler
 ********************************************************************************
@@ -757,6 +1275,11 @@ static void Gattc_NotificationHandler(CYBLE_GATTC_HANDLE_VALUE_NTF_PARAM_T *Noti
                         sizeof(NotifyParams->handleValPair.value.len) +
                         NotifyParams->handleValPair.value.len;
 
+    if((NTF_BATCH_ON == ntfBatchMode) && Batch_Notification(NotifyParams))
+    {
+        return;
+    }
+
     CyS_SendEvent(EVT_CHARACTERISTIC_VALUE_NOTIFICATION, 0, payloadSize,
                     sizeof(CYBLE_CONN_HANDLE_T), (uint8 *)&NotifyParams->connHandle);
 
@@ -828,6 +1351,17 @@ static void Gattc_IndicationHandler(CYBLE_GATTC_HANDLE_VALUE_IND_PARAM_T *IndPar
 *******************************************************************************/
 void CyS_GenericEventHandler(uint32 event, void *eventParam)
 {
+#ifdef TRANSPORT_TX_DMA
+    /* Events raised from here never wait for room in the TX ring */
+    txInStackCallback = true;
+#endif /* TRANSPORT_TX_DMA */
+
+    /* Batched notifications go out before anything the stack reports after them */
+    if(CYBLE_EVT_GATTC_HANDLE_VALUE_NTF != event)
+    {
+        Flush_Notification_Batch(NTF_FLUSH_EVENT);
+    }
+
     switch(event)
     {
         /**********************************************************
@@ -860,6 +1394,7 @@ void CyS_GenericEventHandler(uint32 event, void *eventParam)
                   case CYBLE_GAP_SCAN_TO:
                       if( (primaryCmdInProgress) && (CMD_START_SCAN  == primaryCmd.opcode) )
                       {
+                          CyS_FlushScanReports();
                           CyS_SendEvent(EVT_SCAN_STOPPED_NOTIFICATION, 0, 0, 0, 0);
                           CySmt_SendCommandComplete(primaryCmd.opcode, CYBLE_ERROR_OK);
                       }
@@ -930,7 +1465,16 @@ void CyS_GenericEventHandler(uint32 event, void *eventParam)
         case CYBLE_EVT_GAPC_SCAN_PROGRESS_RESULT:
             if(CMD_START_SCAN  == primaryCmd.opcode)
             {
-                CYBLE_API_RESULT_T status = Send_advt_report((CYBLE_GAPC_ADV_REPORT_T *)eventParam);
+                CYBLE_API_RESULT_T status;
+
+                if(SCAN_AGGR_BATCH == scanAggrMode)
+                {
+                    status = Aggregate_advt_report((CYBLE_GAPC_ADV_REPORT_T *)eventParam);
+                }
+                else
+                {
+                    status = Send_advt_report((CYBLE_GAPC_ADV_REPORT_T *)eventParam);
+                }
 
                 /* Send complete with internal error, if the Advertisement report is not correct */
                 if(CYBLE_ERROR_OK != status)
@@ -1117,6 +1661,7 @@ void CyS_GenericEventHandler(uint32 event, void *eventParam)
                 {
                     /*Stop scan command will also close the start scan command*/
                     primaryCmdInProgress = false;
+                    CyS_FlushScanReports();
                     CyS_SendEvent(EVT_SCAN_STOPPED_NOTIFICATION, 0, 0, 0, 0);
                     CySmt_SendCommandComplete(secondaryCmd.opcode, (uint16)status);
                     memset((uint8*)&secondaryCmd, 0, sizeof(secondaryCmd));
@@ -1124,6 +1669,7 @@ void CyS_GenericEventHandler(uint32 event, void *eventParam)
 
                 if( (CMD_START_SCAN  == primaryCmd.opcode) && (0 != status) )
                 {
+                    CyS_FlushScanReports();
                     CyS_SendEvent(EVT_SCAN_STOPPED_NOTIFICATION, 0, 0, 0, 0);
                     CySmt_SendCommandComplete(primaryCmd.opcode, (uint16)status);
                 }
@@ -1278,6 +1824,9 @@ void CyS_GenericEventHandler(uint32 event, void *eventParam)
                 /* Send Error code */
                 TransmitAdditionalData((uint8 *)&GattErrResp->errorCode,
                     sizeof(GattErrResp->errorCode));
+
+                /* The error code is the status of a macro step */
+                CySmt_MacroGattError(primaryCmd.opcode, (uint8)GattErrResp->errorCode);
             }
             break;
 
@@ -1498,6 +2047,10 @@ void CyS_GenericEventHandler(uint32 event, void *eventParam)
             /* Undefined event, Do nothing */
             break;
     }
+
+#ifdef TRANSPORT_TX_DMA
+    txInStackCallback = false;
+#endif /* TRANSPORT_TX_DMA */
 }
 
 #endif /* CYSMART_SUPPORT */
@@ -45,6 +45,57 @@ extern CYBLE_GATT_DB_ATTR_HANDLE_T cys_charEndHandle;
 extern uint8 cysBdHandle;
 extern CYBLE_GAP_IOCAP_T CySIoCap;
 
+/* Scan report modes for CMD_SET_SCAN_AGGREGATION */
+#define SCAN_AGGR_PASSTHROUGH       (0u)    /* every report is sent as EVT_SCAN_PROGRESS_RESULT */
+#define SCAN_AGGR_BATCH             (1u)    /* reports are merged per device and sent as EVT_SCAN_AGGREGATED_RESULT */
+
+/* Devices tracked in one aggregation window, the table is flushed early when it is full */
+#define SCAN_AGGR_TABLE_SIZE        (16u)
+
+/* Default window in timer ticks (ms), reports of a device within the window are merged */
+#define SCAN_AGGR_DEFAULT_WINDOW    (100u)
+
+/* Per device record of EVT_SCAN_AGGREGATED_RESULT: event type, BD address, address type,
+        RSSI min/avg/max, 2-byte report count, data length, followed by the latest advertisement data */
+#define SCAN_AGGR_RECORD_HEADER     (1u + CYBLE_GAP_BD_ADDR_SIZE + 1u + 3u + 2u + 1u)
+
+/* Notification modes for CMD_SET_NOTIFICATION_BATCHING */
+#define NTF_BATCH_OFF               (0u)    /* every notification is sent as EVT_CHARACTERISTIC_VALUE_NOTIFICATION */
+#define NTF_BATCH_ON                (1u)    /* notifications are packed into EVT_CHARACTERISTIC_VALUE_NOTIFICATION_BATCH */
+
+/* Records held in one batch */
+#define NTF_BATCH_MAX_RECORDS       (32u)
+
+/* Default time budget, microseconds from the first record of a batch to its flush */
+#define NTF_BATCH_DEFAULT_BUDGET_US (2000u)
+
+/* Record of EVT_CHARACTERISTIC_VALUE_NOTIFICATION_BATCH: connection handle, attribute handle
+        and value length, 2 bytes each, followed by the value */
+#define NTF_BATCH_RECORD_HEADER     (6u)
+
+/* Bytes a notification takes as its own event besides the value: event header code, length,
+        event code, connection handle, attribute handle and value length */
+#define NTF_SINGLE_EVENT_HEADER     (12u)
+
+/* Added latency histogram, bin n counts records flushed within (250us << n), the last bin the rest */
+#define NTF_BATCH_LATENCY_BINS      (8u)
+#define NTF_BATCH_LATENCY_BIN0_US   (250u)
+
+/* Batching counters, returned by CMD_GET_NOTIFICATION_BATCH_STATS */
+typedef struct _NTF_BATCH_STATS_T
+{
+    uint32 notifications;
+    uint32 batches;
+    /* Event bytes saved against one event per notification, negative while batches hold single records */
+    int32  headerBytesSaved;
+    /* Flush reasons: batch full, time budget spent, connection event over or another event to send */
+    uint32 flushSize;
+    uint32 flushTime;
+    uint32 flushEvent;
+    uint32 latencyMaxUs;
+    uint32 latencyHist[NTF_BATCH_LATENCY_BINS];
+}NTF_BATCH_STATS_T;
+
 /*******************************************************************************
 * Function Name: CyS_GenericEventHandler
 ********************************************************************************
@@ -62,6 +113,113 @@ extern CYBLE_GAP_IOCAP_T CySIoCap;
 *
 *******************************************************************************/
 extern void CyS_GenericEventHandler(uint32 event, void *eventParam);
+
+/*******************************************************************************
+* Function Name: CyS_SetScanAggregation
+********************************************************************************
+*
+* Summary:
+*  Selects how advertisement reports are forwarded to the host
+*
+* Parameters:
+*  mode:   SCAN_AGGR_PASSTHROUGH or SCAN_AGGR_BATCH
+*  window: aggregation window in timer ticks (ms), must not be 0 for SCAN_AGGR_BATCH
+*
+* Return:
+*  CYBLE_API_RESULT_T - CYBLE_ERROR_INVALID_PARAMETER for an unknown mode or empty window
+*
+* Note:
+*  Reports merged so far are flushed before the mode changes
+*
+*******************************************************************************/
+extern CYBLE_API_RESULT_T CyS_SetScanAggregation(uint8 mode, uint16 window);
+
+/*******************************************************************************
+* Function Name: CyS_FlushScanReports
+********************************************************************************
+*
+* Summary:
+*  Sends the merged advertisement reports and empties the device table
+*
+* Parameters:  
+*  NONE
+*
+* Return: 
+*  None
+*
+*******************************************************************************/
+extern void CyS_FlushScanReports(void);
+
+/*******************************************************************************
+* Function Name: CyS_ScanAggregationProcess
+********************************************************************************
+*
+* Summary:
+*  Flushes the merged advertisement reports once the aggregation window has passed,
+*  call from the main loop
+*
+* Parameters:  
+*  NONE
+*
+* Return: 
+*  None
+*
+*******************************************************************************/
+extern void CyS_ScanAggregationProcess(void);
+
+/*******************************************************************************
+* Function Name: CyS_SetNotificationBatching
+********************************************************************************
+*
+* Summary:
+*  Selects how GATT notifications are forwarded to the host and clears the batching counters
+*
+* Parameters:
+*  mode:     NTF_BATCH_OFF or NTF_BATCH_ON
+*  maxBytes: largest batch payload, 0 or anything above the batch buffer selects the whole buffer
+*  budgetUs: time budget in microseconds, 0 keeps the current budget
+*
+* Return:
+*  CYBLE_API_RESULT_T - CYBLE_ERROR_INVALID_PARAMETER for an unknown mode
+*
+* Note:
+*  Notifications batched so far are flushed before the mode changes
+*
+*******************************************************************************/
+extern CYBLE_API_RESULT_T CyS_SetNotificationBatching(uint8 mode, uint16 maxBytes, uint32 budgetUs);
+
+/*******************************************************************************
+* Function Name: CyS_NotificationBatchProcess
+********************************************************************************
+*
+* Summary:
+*  Flushes batched notifications once the connection event is over or the time
+*  budget is spent, call from the main loop after CyBle_ProcessEvents()
+*
+* Parameters:  
+*  NONE
+*
+* Return: 
+*  None
+*
+*******************************************************************************/
+extern void CyS_NotificationBatchProcess(void);
+
+/*******************************************************************************
+* Function Name: CyS_GetNotificationBatchStats
+********************************************************************************
+*
+* Summary:
+*  Returns the notification batching counters
+*
+* Parameters:  
+*  NONE
+*
+* Return: 
+*  NTF_BATCH_STATS_T* - counters, updated in place
+*
+*******************************************************************************/
+extern const NTF_BATCH_STATS_T *CyS_GetNotificationBatchStats(void);
    
 #endif /* _HOST_EMULATOR_H_ */
 /* [] END OF FILE */
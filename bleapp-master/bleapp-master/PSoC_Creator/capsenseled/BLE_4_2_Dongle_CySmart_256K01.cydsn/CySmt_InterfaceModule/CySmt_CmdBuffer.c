@@ -0,0 +1,196 @@
+/******************************************************************************
+* File Name         : CySmt_CmdBuffer.c
+* Description       : Static buffer for command data that outlives the command packet.
+* Version           : 1.2
+* Software Used     : PSoC Creator 3.3 CP2
+* Compiler          : ARM GCC 4.9.3, ARM MDK Generic
+*
+********************************************************************************
+* Copyright (2016), Cypress Semiconductor Corporation. All Rights Reserved.
+********************************************************************************
+* This software is owned by Cypress Semiconductor Corporation (Cypress)
+* and is protected by and subject to worldwide patent protection (United
+* States and foreign), United States copyright laws and international treaty
+* provisions. Cypress hereby grants to licensee a personal, non-exclusive,
+* non-transferable license to copy, use, modify, create derivative works of,
+* and compile the Cypress Source Code and derivative works for the sole
+* purpose of creating custom software in support of licensee product to be
+* used only in conjunction with a Cypress integrated circuit as specified in
+* the applicable agreement. Any reproduction, modification, translation,
+* compilation, or representation of this software except as specified above 
+* is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: CYPRESS MAKES NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, WITH 
+* REGARD TO THIS MATERIAL, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+* Cypress reserves the right to make changes without further notice to the 
+* materials described herein. Cypress does not assume any liability arising out 
+* of the application or use of any product or circuit described herein. Cypress 
+* does not authorize its products for use as critical components in life-support 
+* systems where a malfunction or failure may reasonably be expected to result in 
+* significant injury to the user. The inclusion of Cypress' product in a life-
+* support systems application implies that the manufacturer assumes all risk of 
+* such use and in doing so indemnifies Cypress against all charges. 
+*
+* Use of this Software may be limited by and subject to the applicable Cypress
+* software license agreement. 
+*******************************************************************************/
+
+#include "CySmt_CmdBuffer.h"
+#include <string.h>
+#ifdef CYSMART_SUPPORT
+
+/* Whole words so any structure fits its alignment */
+#define CMD_BUFFER_WORDS                     ((CMD_BUFFER_SIZE + sizeof(uint32) - 1u) / sizeof(uint32))
+
+/* Only the primary command holds the buffer, and it gives back the one of the previous
+        command first, so one buffer is enough */
+static uint32 cmdBuffer[CMD_BUFFER_WORDS];
+static uint8 cmdBufferTaken = 0;
+
+static CY_CMD_BUFFER_STATS cmdBufferStats;
+
+/*******************************************************************************
+* Function Name: CySmt_CmdBufferInit
+********************************************************************************
+*
+* Summary:
+*  Marks the buffer free
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  NONE
+*
+* Side Effects:
+*  A buffer taken before is lost
+*
+* Note:
+*  Call once at startup
+*
+*******************************************************************************/
+void CySmt_CmdBufferInit(void)
+{
+    cmdBufferTaken = 0;
+
+    memset(&cmdBufferStats, 0, sizeof(cmdBufferStats));
+    cmdBufferStats.size = (uint16)CMD_BUFFER_SIZE;
+}
+
+/*******************************************************************************
+* Function Name: CySmt_CmdBufferTake
+********************************************************************************
+*
+* Summary:
+*  Hands out the buffer
+*
+* Parameters:
+*  size - bytes needed
+*
+* Return:
+*  void* - buffer of CMD_BUFFER_SIZE bytes, NULL if size doesn't fit or it is taken
+*
+* Theory:
+*  NONE
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*  Call from the main loop only
+*
+*******************************************************************************/
+void *CySmt_CmdBufferTake(uint32 size)
+{
+    if((size > CMD_BUFFER_SIZE) || (0u != cmdBufferTaken))
+    {
+        cmdBufferStats.failures++;
+        return NULL;
+    }
+
+    cmdBufferTaken = 1u;
+
+    cmdBufferStats.takes++;
+    if(size > cmdBufferStats.peakBytes)
+    {
+        cmdBufferStats.peakBytes = (uint16)size;
+    }
+    return cmdBuffer;
+}
+
+/*******************************************************************************
+* Function Name: CySmt_CmdBufferGive
+********************************************************************************
+*
+* Summary:
+*  Gives the buffer back
+*
+* Parameters:
+*  buffer - buffer returned by CySmt_CmdBufferTake, or NULL
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  A pointer that is not the buffer, or a second give, would free the buffer
+*  while its holder still writes to it, so both are counted and ignored
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*  Call from the main loop only
+*
+*******************************************************************************/
+void CySmt_CmdBufferGive(void *buffer)
+{
+    if(NULL == buffer)
+    {
+        return;
+    }
+
+    if((buffer != (void *)cmdBuffer) || (0u == cmdBufferTaken))
+    {
+        if(cmdBufferStats.badGives < 0xFFu)
+        {
+            cmdBufferStats.badGives++;
+        }
+        return;
+    }
+
+    cmdBufferTaken = 0;
+}
+
+/*******************************************************************************
+* Function Name: CySmt_CmdBufferGetStats
+********************************************************************************
+*
+* Summary:
+*  Returns the buffer counters
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  CY_CMD_BUFFER_STATS* - buffer counters, updated in place
+*
+* Theory:
+*  NONE
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+const CY_CMD_BUFFER_STATS *CySmt_CmdBufferGetStats(void)
+{
+    return &cmdBufferStats;
+}
+#endif /* CYSMART_SUPPORT */
+
+/* [] END OF FILE */
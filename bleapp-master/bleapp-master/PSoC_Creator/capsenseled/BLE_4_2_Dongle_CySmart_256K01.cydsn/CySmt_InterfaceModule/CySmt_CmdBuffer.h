@@ -0,0 +1,77 @@
+/******************************************************************************
+* File Name         : CySmt_CmdBuffer.h
+* Description       : Static buffer for command data that outlives the command packet.
+* Version           : 1.2
+* Software Used     : PSoC Creator 3.3 CP2
+* Compiler          : ARM GCC 4.9.3, ARM MDK Generic
+*
+********************************************************************************
+* Copyright (2016), Cypress Semiconductor Corporation. All Rights Reserved.
+********************************************************************************
+* This software is owned by Cypress Semiconductor Corporation (Cypress)
+* and is protected by and subject to worldwide patent protection (United
+* States and foreign), United States copyright laws and international treaty
+* provisions. Cypress hereby grants to licensee a personal, non-exclusive,
+* non-transferable license to copy, use, modify, create derivative works of,
+* and compile the Cypress Source Code and derivative works for the sole
+* purpose of creating custom software in support of licensee product to be
+* used only in conjunction with a Cypress integrated circuit as specified in
+* the applicable agreement. Any reproduction, modification, translation,
+* compilation, or representation of this software except as specified above 
+* is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: CYPRESS MAKES NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, WITH 
+* REGARD TO THIS MATERIAL, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+* Cypress reserves the right to make changes without further notice to the 
+* materials described herein. Cypress does not assume any liability arising out 
+* of the application or use of any product or circuit described herein. Cypress 
+* does not authorize its products for use as critical components in life-support 
+* systems where a malfunction or failure may reasonably be expected to result in 
+* significant injury to the user. The inclusion of Cypress' product in a life-
+* support systems application implies that the manufacturer assumes all risk of 
+* such use and in doing so indemnifies Cypress against all charges. 
+*
+* Use of this Software may be limited by and subject to the applicable Cypress
+* software license agreement. 
+*******************************************************************************/
+
+#ifndef _CYSMT_CMD_BUFFER_H_
+#define _CYSMT_CMD_BUFFER_H_
+
+#include "CySmt_TransportLayer.h"
+
+/* The buffer holds the prepared write list of a reliable writes command. The most writes a
+        command of MAX_PAYLOAD_SIZE can carry are zero length values after the connection
+        handle and the count, each with its handle, offset and length */
+#define CMD_BUFFER_MAX_PREP_WRITES           ((MAX_PAYLOAD_SIZE - sizeof(CYBLE_CONN_HANDLE_T) - sizeof(uint16)) / \
+                                                (3u * sizeof(uint16)))
+#define CMD_BUFFER_SIZE                      (CMD_BUFFER_MAX_PREP_WRITES * sizeof(CYBLE_GATTC_PREP_WRITE_REQ_T))
+
+/* Buffer counters, sent as they are by CMD_GET_CMD_BUFFER_STATS */
+typedef struct _CY_CMD_BUFFER_STATS
+{
+    uint32 takes;
+    /* Requests larger than the buffer or while it was taken */
+    uint32 failures;
+    uint16 size;
+    /* Largest request served */
+    uint16 peakBytes;
+    /* Gives of a pointer that is not the buffer, or of the buffer while it was not taken */
+    uint8 badGives;
+}CY_CMD_BUFFER_STATS;
+
+/* Marks the buffer free, call once at startup */
+void CySmt_CmdBufferInit(void);
+
+/* Returns the buffer for size bytes, NULL if size is above CMD_BUFFER_SIZE or it is taken */
+void *CySmt_CmdBufferTake(uint32 size);
+
+/* Gives the buffer back, NULL is ignored, so is anything else that was not taken */
+void CySmt_CmdBufferGive(void *buffer);
+
+/* Returns the buffer counters */
+const CY_CMD_BUFFER_STATS *CySmt_CmdBufferGetStats(void);
+
+#endif /* _CYSMT_CMD_BUFFER_H_ */
+/* [] END OF FILE */
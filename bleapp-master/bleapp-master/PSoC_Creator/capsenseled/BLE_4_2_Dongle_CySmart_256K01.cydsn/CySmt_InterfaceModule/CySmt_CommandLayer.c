@@ -40,6 +40,8 @@
 
 #include "CySmt_CommandLayer.h"
 #include "CySmt_BleEventHandler.h"
+#include "CySmt_CmdBuffer.h"
+#include "CySmt_Macro.h"
 #include "Application.h"
 #include "led.h"
 
@@ -56,6 +58,9 @@ typedef enum
 /* GATT Long procedures requires the arguments to be global */
 static CYBLE_GATTC_PREP_WRITE_REQ_T gPrepLongWriteReq;
 
+/* Prepared write list of the reliable writes in progress, in the CySmt_CmdBuffer buffer */
+static CYBLE_GATTC_PREP_WRITE_REQ_T *prepWriteList = NULL;
+
 /*************************************************************************
  *  General Commands API 
  *************************************************************************/
@@ -162,6 +167,7 @@ CYBLE_API_RESULT_T Cmd_Tool_Disconnected_Api(Command_Format *currentCmd)
     (void)currentCmd;
 
     primaryCmdInProgress = false;
+    (void)CySmt_MacroStop();
     if(isCySmtConnected)
     {
         /* Wait till flash write is fully completed */
@@ -181,6 +187,7 @@ CYBLE_API_RESULT_T Cmd_Host_Timed_Out_Api(Command_Format *currentCmd)
 
     /* Time out, clear all operations */
     primaryCmdInProgress = false;
+    (void)CySmt_MacroStop();
     
     /* Reset any ongoing stack operations */
     if(GATT_CMD_IN_PROGRESS)
@@ -301,6 +308,75 @@ CYBLE_API_RESULT_T Cmd_Set_HostChannelClassification_Api(Command_Format *current
     return status;
 }
 
+CYBLE_API_RESULT_T Cmd_Set_Scan_Aggregation_Api(Command_Format *currentCmd)
+{
+    /* Mode followed by the aggregation window in ms, 0 keeps the current window */
+    return CyS_SetScanAggregation(*currentCmd->parameters, CyBle_Get16ByPtr(&currentCmd->parameters[sizeof(uint8)]));
+}
+
+CYBLE_API_RESULT_T Cmd_Set_Notification_Batching_Api(Command_Format *currentCmd)
+{
+    uint32 budgetUs;
+
+    /* Mode, largest batch payload, then the time budget in microseconds */
+    memcpy(&budgetUs, &currentCmd->parameters[sizeof(uint8) + sizeof(uint16)], sizeof(budgetUs));
+    return CyS_SetNotificationBatching(*currentCmd->parameters,
+                CyBle_Get16ByPtr(&currentCmd->parameters[sizeof(uint8)]), budgetUs);
+}
+
+CYBLE_API_RESULT_T Cmd_Get_Notification_Batch_Stats_Api(Command_Format *currentCmd)
+{
+    CyS_SendEvent(EVT_GET_NOTIFICATION_BATCH_STATS_RESPONSE, currentCmd->opcode, 0,
+                    sizeof(NTF_BATCH_STATS_T), (const uint8 *)CyS_GetNotificationBatchStats());
+    return CYBLE_ERROR_OK;
+}
+
+CYBLE_API_RESULT_T Cmd_Get_Cmd_Buffer_Stats_Api(Command_Format *currentCmd)
+{
+    CyS_SendEvent(EVT_GET_CMD_BUFFER_STATS_RESPONSE, currentCmd->opcode, 0,
+                    sizeof(CY_CMD_BUFFER_STATS), (const uint8 *)CySmt_CmdBufferGetStats());
+    return CYBLE_ERROR_OK;
+}
+
+CYBLE_API_RESULT_T Cmd_Run_Macro_Api(Command_Format *currentCmd)
+{
+    CYBLE_API_RESULT_T status;
+
+    /* Steps need the primary slot, a macro doesn't start next to a primary command */
+    if(&primaryCmd != currentCmd)
+    {
+        return CYBLE_ERROR_INVALID_STATE;
+    }
+
+    status = CySmt_MacroStart(currentCmd->parameters, currentCmd->paramlen);
+    if(CYBLE_ERROR_OK == status)
+    {
+        /* Free the slot for the first step, the macro sends the complete */
+        primaryCmdInProgress = false;
+    }
+    return status;
+}
+
+CYBLE_API_RESULT_T Cmd_Stop_Macro_Api(Command_Format *currentCmd)
+{
+    (void)currentCmd;
+    return CySmt_MacroStop();
+}
+
+CYBLE_API_RESULT_T Cmd_Set_Transport_Mode_Api(Command_Format *currentCmd)
+{
+#ifdef TRANSPORT_FRAMED
+    uint32 baud;
+
+    /* Mode followed by the new baud rate, 0 keeps the current one. The switch waits for the complete event to go out */
+    memcpy(&baud, &currentCmd->parameters[sizeof(uint8)], sizeof(baud));
+    return Transport_SetMode(*currentCmd->parameters, baud) ? CYBLE_ERROR_OK : CYBLE_ERROR_INVALID_PARAMETER;
+#else
+    (void)currentCmd;
+    return CYBLE_ERROR_INVALID_OPERATION;
+#endif /* TRANSPORT_FRAMED */
+}
+
 /*************************************************************************
 *  Gap Commands API 
 *************************************************************************/
@@ -1639,22 +1715,24 @@ CYBLE_API_RESULT_T Cmd_Write_Long_Characteristic_Value_Api(Command_Format *curre
     return Write_Long_item(CHARACTERISTIC_VALUE, currentCmd);
 }
 
-/* Note: CySmart FW module uses Heap section for multiple write operation, 
-        so make sure 1K of heap area is allocated */
+/* Note: The write request array is taken from CySmt_CmdBuffer and given back
+        by CySmt_ReleaseCmdBuffers once the primary command is completed */
 CYBLE_API_RESULT_T Cmd_Reliable_Characteristic_Value_Writes_Api(Command_Format *currentCmd)
 {
-    uint8 index, *paramBuf = currentCmd->parameters, ParamIndex = sizeof(CYBLE_CONN_HANDLE_T);
+    uint8 index, *paramBuf = currentCmd->parameters;
+    uint16 ParamIndex = sizeof(CYBLE_CONN_HANDLE_T);
     CYBLE_API_RESULT_T status = CYBLE_ERROR_INVALID_OPERATION;
     CYBLE_GATTC_PREP_WRITE_REQ_T *WriteParamList;
 
     /* Extract 2 byte count value from parameter list */
-    uint8 WritesCount = (uint8)CyBle_Get16ByPtr(&paramBuf[ParamIndex]);
+    uint16 WritesCount = CyBle_Get16ByPtr(&paramBuf[ParamIndex]);
 
-    /* Allocate memory for write request array; this will freed once the primary command is completed */
-    heapBuffer = calloc(WritesCount, sizeof(CYBLE_GATTC_PREP_WRITE_REQ_T));
+    /* The buffer holds the most writes a command can carry, so a larger count fails below */
+    CySmt_ReleaseCmdBuffers();
+    prepWriteList = CySmt_CmdBufferTake((uint32)WritesCount * sizeof(CYBLE_GATTC_PREP_WRITE_REQ_T));
 
-    /* Return FW resources error, if dynamic allocation fails */
-    if(NULL == heapBuffer)
+    /* Return FW resources error, if the buffer is not free */
+    if(NULL == prepWriteList)
     {
         /* Command payload is too big to handle by Dongle, send error code */
         CySmt_SendCommandStatus(currentCmd->opcode, CYS_FW_ERR_INSUFFICIENT_RESOURCES);
@@ -1662,12 +1740,13 @@ CYBLE_API_RESULT_T Cmd_Reliable_Characteristic_Value_Writes_Api(Command_Format *
         /* Don't send command complete */
         return CYBLE_ERROR_INVALID_PARAMETER;
     }
-    WriteParamList = (CYBLE_GATTC_PREP_WRITE_REQ_T *)heapBuffer;
+    WriteParamList = prepWriteList;
 
     /* Move the index for writes count */
     ParamIndex += sizeof(uint16);
 
-    for(index = 0; index < WritesCount; index++)
+    /* Stop at the end of the parameters, a count larger than the writes sent fails the length check */
+    for(index = 0; (index < WritesCount) && ((ParamIndex + (3u * sizeof(uint16))) <= currentCmd->paramlen); index++)
     {
         WriteParamList[index].handleValuePair.attrHandle = 
             (CYBLE_GATT_DB_ATTR_HANDLE_T)CyBle_Get16ByPtr(&paramBuf[ParamIndex]);
@@ -1686,18 +1765,47 @@ CYBLE_API_RESULT_T Cmd_Reliable_Characteristic_Value_Writes_Api(Command_Format *
     }
 
     /* Check for expected length */
-    if(currentCmd->paramlen != ParamIndex)
+    if((currentCmd->paramlen != ParamIndex) || (index != WritesCount))
     {
         status = CYBLE_ERROR_INVALID_PARAMETER;
     }
     else
     {
         cyBle_connHandle = *(CYBLE_CONN_HANDLE_T *)paramBuf;
-        status = CyBle_GattcReliableWrites(cyBle_connHandle, WriteParamList, WritesCount);
+        status = CyBle_GattcReliableWrites(cyBle_connHandle, WriteParamList, (uint8)WritesCount);
     }
     return status;
 }
 
+/*******************************************************************************
+* Function Name: CySmt_ReleaseCmdBuffers
+********************************************************************************
+*
+* Summary:
+*  Gives the buffers held for the primary command back to CySmt_CmdBuffer
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  NONE
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*  Call once the primary command is no longer in progress
+*
+*******************************************************************************/
+void CySmt_ReleaseCmdBuffers(void)
+{
+    CySmt_CmdBufferGive(prepWriteList);
+    prepWriteList = NULL;
+}
+
 CYBLE_API_RESULT_T Cmd_Read_Characteristic_Descriptor_Api(Command_Format *currentCmd)
 {
     /* Params: connection Handle + Att Handle */
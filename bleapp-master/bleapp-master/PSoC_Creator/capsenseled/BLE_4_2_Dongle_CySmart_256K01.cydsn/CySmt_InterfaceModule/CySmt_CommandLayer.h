@@ -93,6 +93,13 @@ CYBLE_API_RESULT_T Cmd_Get_Rssi_Api(Command_Format *currentCmd);
 CYBLE_API_RESULT_T Cmd_Get_TxPowerLevel_Api(Command_Format *currentCmd);
 CYBLE_API_RESULT_T Cmd_Set_TxPowerLevel_Api(Command_Format *currentCmd);
 CYBLE_API_RESULT_T Cmd_Set_HostChannelClassification_Api(Command_Format *currentCmd);
+CYBLE_API_RESULT_T Cmd_Set_Scan_Aggregation_Api(Command_Format *currentCmd);
+CYBLE_API_RESULT_T Cmd_Set_Notification_Batching_Api(Command_Format *currentCmd);
+CYBLE_API_RESULT_T Cmd_Get_Notification_Batch_Stats_Api(Command_Format *currentCmd);
+CYBLE_API_RESULT_T Cmd_Set_Transport_Mode_Api(Command_Format *currentCmd);
+CYBLE_API_RESULT_T Cmd_Get_Cmd_Buffer_Stats_Api(Command_Format *currentCmd);
+CYBLE_API_RESULT_T Cmd_Run_Macro_Api(Command_Format *currentCmd);
+CYBLE_API_RESULT_T Cmd_Stop_Macro_Api(Command_Format *currentCmd);
 
 /* Gap Commands API */
 CYBLE_API_RESULT_T Cmd_Set_Device_Io_Capabilities_Api(Command_Format *currentCmd);
@@ -185,5 +192,8 @@ CYBLE_API_RESULT_T Cmd_CBFC_SendFlowControlCredit_Api(Command_Format *currentCmd
 CYBLE_API_RESULT_T Cmd_CBFC_SendData_Api(Command_Format *currentCmd);
 CYBLE_API_RESULT_T Cmd_CBFC_SendDisconnectReq_Api(Command_Format *currentCmd);
 
+/* Gives the buffers held for the primary command back to CySmt_CmdBuffer */
+void CySmt_ReleaseCmdBuffers(void);
+
 #endif    /* _CYSMT_COMMANDLAYER_H_ */
 /* [] END OF FILE */
@@ -0,0 +1,748 @@
+/******************************************************************************
+* File Name         : CySmt_Macro.c
+* Description       : Runs host-supplied command sequences on the dongle, one step per command.
+* Version           : 1.2
+* Software Used     : PSoC Creator 3.3 CP2
+* Compiler          : ARM GCC 4.9.3, ARM MDK Generic
+*
+********************************************************************************
+* Copyright (2016), Cypress Semiconductor Corporation. All Rights Reserved.
+********************************************************************************
+* This software is owned by Cypress Semiconductor Corporation (Cypress)
+* and is protected by and subject to worldwide patent protection (United
+* States and foreign), United States copyright laws and international treaty
+* provisions. Cypress hereby grants to licensee a personal, non-exclusive,
+* non-transferable license to copy, use, modify, create derivative works of,
+* and compile the Cypress Source Code and derivative works for the sole
+* purpose of creating custom software in support of licensee product to be
+* used only in conjunction with a Cypress integrated circuit as specified in
+* the applicable agreement. Any reproduction, modification, translation,
+* compilation, or representation of this software except as specified above 
+* is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: CYPRESS MAKES NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, WITH 
+* REGARD TO THIS MATERIAL, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+* Cypress reserves the right to make changes without further notice to the 
+* materials described herein. Cypress does not assume any liability arising out 
+* of the application or use of any product or circuit described herein. Cypress 
+* does not authorize its products for use as critical components in life-support 
+* systems where a malfunction or failure may reasonably be expected to result in 
+* significant injury to the user. The inclusion of Cypress' product in a life-
+* support systems application implies that the manufacturer assumes all risk of 
+* such use and in doing so indemnifies Cypress against all charges. 
+*
+* Use of this Software may be limited by and subject to the applicable Cypress
+* software license agreement. 
+*******************************************************************************/
+
+#include "CySmt_Macro.h"
+#include <string.h>
+#ifdef CYSMART_SUPPORT
+
+/* Instruction sizes without the command parameters */
+#define MACRO_END_SIZE                       (1u)
+#define MACRO_CMD_SIZE                       (5u)
+#define MACRO_WAIT_SIZE                      (5u)
+#define MACRO_JUMP_SIZE                      (7u)
+#define MACRO_STORE_SIZE                     (3u)
+#define MACRO_DELAY_SIZE                     (3u)
+
+typedef enum
+{
+    MACRO_STATE_IDLE,
+    /* Run the instruction at macroPc */
+    MACRO_STATE_NEXT,
+    /* Command of MACRO_OP_CMD in progress */
+    MACRO_STATE_STEP,
+    MACRO_STATE_WAIT,
+    MACRO_STATE_DELAY,
+}MACRO_STATE;
+
+static MACRO_STATE macroState = MACRO_STATE_IDLE;
+static uint8 macroProgram[MACRO_PROGRAM_SIZE];
+static uint16 macroLength;
+static uint16 macroPc;
+static bool macroStopRequested;
+static uint32 macroStartTime;
+static MACRO_RESULT_T macroResult;
+
+/* Command of the step in progress */
+static uint16 macroStepOpcode;
+static bool macroStepPrimary;
+static bool macroStepNoWait;
+
+/* MACRO_OP_WAIT and MACRO_OP_DELAY */
+static uint16 macroWaitEvent;
+static bool macroWaitDone;
+static uint32 macroWaitStart;
+static uint16 macroWaitTime;
+
+/* Last event of the step's command or of the awaited event code */
+static uint16 macroEvent;
+static uint8 macroCapture[MACRO_CAPTURE_SIZE];
+static uint8 macroCaptureLen;
+
+static uint8 macroVar[MACRO_VAR_SIZE];
+static uint8 macroVarLen;
+
+/*******************************************************************************
+* Function Name: Macro_OpSize
+********************************************************************************
+*
+* Summary:
+*  Checks the operands of an instruction
+*
+* Parameters:
+*  op - instruction
+*
+*  left - program bytes from op on
+*
+* Return:
+*  uint16 - size of the instruction, 0 if it is unknown, invalid or runs past the program
+*
+* Theory:
+*  NONE
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+static uint16 Macro_OpSize(const uint8 *op, uint16 left)
+{
+    uint16 size = 0;
+
+    switch(op[0])
+    {
+        case MACRO_OP_END:
+            size = MACRO_END_SIZE;
+            break;
+
+        case MACRO_OP_CMD:
+            /* Room for the stored bytes in front of the parameters */
+            if((MACRO_CMD_SIZE <= left) && ((op[4] + MACRO_VAR_SIZE) <= MAX_PAYLOAD_SIZE))
+            {
+                size = MACRO_CMD_SIZE + op[4];
+            }
+            break;
+
+        case MACRO_OP_WAIT:
+            size = MACRO_WAIT_SIZE;
+            break;
+
+        case MACRO_OP_JUMP:
+            if((MACRO_JUMP_SIZE <= left) && (MACRO_IF_U16_NE >= op[1]))
+            {
+                size = MACRO_JUMP_SIZE;
+            }
+            break;
+
+        case MACRO_OP_STORE:
+            if((MACRO_STORE_SIZE <= left) && (MACRO_VAR_SIZE >= op[2]) &&
+                (MACRO_CAPTURE_SIZE >= (op[1] + op[2])))
+            {
+                size = MACRO_STORE_SIZE;
+            }
+            break;
+
+        case MACRO_OP_DELAY:
+            size = MACRO_DELAY_SIZE;
+            break;
+
+        default:
+            break;
+    }
+    return (size <= left) ? size : 0;
+}
+
+/*******************************************************************************
+* Function Name: Macro_End
+********************************************************************************
+*
+* Summary:
+*  Ends the macro, sends EVT_MACRO_RESULT and the complete of CMD_RUN_MACRO
+*
+* Parameters:
+*  status - status of the macro
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  The complete is sent as a plain event: CySmt_SendCommandComplete() would clear the
+*   command of a step or of the host, which holds the primary slot by now
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+static void Macro_End(uint16 status)
+{
+    macroState = MACRO_STATE_IDLE;
+
+    macroResult.status = status;
+    macroResult.elapsed = Timer_Get_Time_Stamp() - macroStartTime;
+    CyS_SendEvent(EVT_MACRO_RESULT, CMD_RUN_MACRO, 0, sizeof(macroResult), (const uint8 *)&macroResult);
+    CyS_SendEvent(EVT_COMMAND_COMPLETE, CMD_RUN_MACRO, 0, sizeof(status), (const uint8 *)&status);
+}
+
+/*******************************************************************************
+* Function Name: Macro_StepSlotFree
+********************************************************************************
+*
+* Summary:
+*  Checks if the command of the step in progress is over
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  bool - true once the command slot of the step is free
+*
+* Theory:
+*  Catches commands that end without a complete, e.g. on a GATT error response
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+static bool Macro_StepSlotFree(void)
+{
+    return macroStepPrimary ? (!primaryCmdInProgress) : (!secondaryCmdInProgress);
+}
+
+/*******************************************************************************
+* Function Name: Macro_RunCmd
+********************************************************************************
+*
+* Summary:
+*  Issues the command of a MACRO_OP_CMD instruction
+*
+* Parameters:
+*  op - instruction
+*
+* Return:
+*  bool - false if the command has to wait for a free command slot
+*
+* Theory:
+*  The command goes the way of a host command: into the primary slot if it is free, else into the
+*   secondary slot if the command can run next to the primary one
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+static bool Macro_RunCmd(const uint8 *op)
+{
+    uint8 *cmdBuf;
+    uint16 opcode = CyBle_Get16ByPtr(&op[2]);
+    uint8 varLen = (0 != (op[1] & MACRO_CMD_LOAD)) ? macroVarLen : 0u;
+    uint16 paramLen = varLen + op[4];
+
+    if(!primaryCmdInProgress)
+    {
+        cmdBuf = primaryCmdRxBuf;
+    }
+    else if( (!secondaryCmdInProgress) && (opcode != primaryCmd.opcode) &&
+             (SECONDARY_CMD_BUFF_SIZE >= (COMMAND_HEADER_SIZE + paramLen)) && CySmt_IsConcurrentCmd(opcode) )
+    {
+        cmdBuf = secondaryCmdRxBuf;
+    }
+    else
+    {
+        return false;
+    }
+
+    /* Same layout as a received command packet */
+    CyBle_Set16ByPtr(cmdBuf, opcode);
+    CyBle_Set16ByPtr(&cmdBuf[sizeof(uint16)], paramLen);
+    memcpy(&cmdBuf[COMMAND_HEADER_SIZE], macroVar, varLen);
+    memcpy(&cmdBuf[COMMAND_HEADER_SIZE + varLen], &op[MACRO_CMD_SIZE], op[4]);
+
+    macroStepOpcode = opcode;
+    macroStepPrimary = (primaryCmdRxBuf == cmdBuf);
+    macroStepNoWait = (0 != (op[1] & MACRO_CMD_NO_WAIT));
+    macroEvent = 0;
+    macroCaptureLen = 0;
+    macroResult.status = CYBLE_ERROR_OK;
+    macroResult.pc = macroPc;
+    macroResult.steps++;
+    macroResult.lastOpcode = opcode;
+    macroPc += MACRO_CMD_SIZE + op[4];
+    macroState = MACRO_STATE_STEP;
+
+    CySmt_RunCommand();
+
+    /* Commands served by local data are over already */
+    if((MACRO_STATE_STEP == macroState) && Macro_StepSlotFree())
+    {
+        macroState = MACRO_STATE_NEXT;
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: Macro_Condition
+********************************************************************************
+*
+* Summary:
+*  Evaluates the condition of a MACRO_OP_JUMP instruction
+*
+* Parameters:
+*  op - instruction
+*
+* Return:
+*  bool - true if the jump is taken
+*
+* Theory:
+*  NONE
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+static bool Macro_Condition(const uint8 *op)
+{
+    uint8 index = op[2];
+    uint16 value = CyBle_Get16ByPtr(&op[3]);
+    bool equal;
+
+    switch((MACRO_CONDITION)op[1])
+    {
+        case MACRO_IF_STATUS_EQ:
+        case MACRO_IF_STATUS_NE:
+            equal = (macroResult.status == value);
+            break;
+
+        case MACRO_IF_EVENT_EQ:
+        case MACRO_IF_EVENT_NE:
+            equal = (macroEvent == value);
+            break;
+
+        case MACRO_IF_BYTE_EQ:
+        case MACRO_IF_BYTE_NE:
+            equal = (index < macroCaptureLen) && (macroCapture[index] == (uint8)value);
+            break;
+
+        case MACRO_IF_U16_EQ:
+        case MACRO_IF_U16_NE:
+            equal = ((index + sizeof(uint16)) <= macroCaptureLen) &&
+                        (CyBle_Get16ByPtr(&macroCapture[index]) == value);
+            break;
+
+        default:
+            return true;
+    }
+
+    /* The EQ condition of each pair comes first */
+    return ((op[1] - MACRO_IF_STATUS_EQ) & 1u) ? (!equal) : equal;
+}
+
+/*******************************************************************************
+* Function Name: CySmt_MacroStart
+********************************************************************************
+*
+* Summary:
+*  Checks a program and copies it, the macro starts on the next CySmt_MacroProcess()
+*
+* Parameters:
+*  program - instructions
+*
+*  length - program size in bytes
+*
+* Return:
+*  CYBLE_API_RESULT_T - CYBLE_ERROR_INVALID_STATE if a macro runs, CYBLE_ERROR_INVALID_PARAMETER
+*                       for an invalid program
+*
+* Theory:
+*  Every instruction is checked up front and every jump has to land on an instruction,
+*   so the program can't run past its end or into operands
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+CYBLE_API_RESULT_T CySmt_MacroStart(const uint8 *program, uint16 length)
+{
+    uint8 starts[MACRO_PROGRAM_SIZE / 8u];
+    uint16 pc;
+    uint16 size;
+
+    if(MACRO_STATE_IDLE != macroState)
+    {
+        return CYBLE_ERROR_INVALID_STATE;
+    }
+    if((0 == length) || (MACRO_PROGRAM_SIZE < length))
+    {
+        return CYBLE_ERROR_INVALID_PARAMETER;
+    }
+
+    memset(starts, 0, sizeof(starts));
+    for(pc = 0; pc < length; pc += size)
+    {
+        size = Macro_OpSize(&program[pc], length - pc);
+        if(0 == size)
+        {
+            return CYBLE_ERROR_INVALID_PARAMETER;
+        }
+        starts[pc / 8u] |= (uint8)(1u << (pc % 8u));
+    }
+
+    for(pc = 0; pc < length; pc += Macro_OpSize(&program[pc], length - pc))
+    {
+        if(MACRO_OP_JUMP == program[pc])
+        {
+            size = CyBle_Get16ByPtr(&program[pc + 5u]);
+            if((length <= size) || (0 == (starts[size / 8u] & (1u << (size % 8u)))))
+            {
+                return CYBLE_ERROR_INVALID_PARAMETER;
+            }
+        }
+    }
+
+    memcpy(macroProgram, program, length);
+    macroLength = length;
+    macroPc = 0;
+    macroStopRequested = false;
+    macroEvent = 0;
+    macroCaptureLen = 0;
+    macroVarLen = 0;
+    memset(&macroResult, 0, sizeof(macroResult));
+    macroStartTime = Timer_Get_Time_Stamp();
+    macroState = MACRO_STATE_NEXT;
+    return CYBLE_ERROR_OK;
+}
+
+/*******************************************************************************
+* Function Name: CySmt_MacroStop
+********************************************************************************
+*
+* Summary:
+*  Ends the macro once its step in progress is over
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  CYBLE_API_RESULT_T - CYBLE_ERROR_INVALID_STATE if no macro runs
+*
+* Theory:
+*  A step can't be called back, the host stops a long one with the command for it,
+*   e.g. cancel connection
+*
+* Side Effects:
+*  The macro ends with CYS_FW_ERR_MACRO_STOPPED
+*
+* Note:
+*
+*******************************************************************************/
+CYBLE_API_RESULT_T CySmt_MacroStop(void)
+{
+    if(MACRO_STATE_IDLE == macroState)
+    {
+        return CYBLE_ERROR_INVALID_STATE;
+    }
+    macroStopRequested = true;
+    return CYBLE_ERROR_OK;
+}
+
+/*******************************************************************************
+* Function Name: CySmt_MacroRunning
+********************************************************************************
+*
+* Summary:
+*  Checks if a macro runs
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  bool - true from CySmt_MacroStart() until EVT_MACRO_RESULT is sent
+*
+* Theory:
+*  NONE
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+bool CySmt_MacroRunning(void)
+{
+    return (MACRO_STATE_IDLE != macroState);
+}
+
+/*******************************************************************************
+* Function Name: CySmt_MacroProcess
+********************************************************************************
+*
+* Summary:
+*  Runs the macro's instructions until one has to wait
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  A pass ends when a command, wait or delay is in progress, or after MACRO_OPS_PER_PASS
+*   instructions so a program that only jumps can't hold the main loop
+*
+* Side Effects:
+*  Sends EVT_MACRO_RESULT and the complete of CMD_RUN_MACRO at the end of the macro
+*
+* Note:
+*  Call from the main loop before CySmt_ProcessCommands(), so the next step takes the
+*   command slots before host commands
+*
+*******************************************************************************/
+void CySmt_MacroProcess(void)
+{
+    const uint8 *op;
+    uint8 count;
+
+    switch(macroState)
+    {
+        case MACRO_STATE_IDLE:
+            return;
+
+        case MACRO_STATE_STEP:
+            if(Macro_StepSlotFree())
+            {
+                macroState = MACRO_STATE_NEXT;
+            }
+            break;
+
+        case MACRO_STATE_WAIT:
+            if(macroWaitDone)
+            {
+                macroResult.status = CYBLE_ERROR_OK;
+                macroState = MACRO_STATE_NEXT;
+            }
+            else if(macroStopRequested || Timer_Time_Elapsed(macroWaitStart, macroWaitTime))
+            {
+                macroResult.status = CYS_FW_ERR_MACRO_TIMEOUT;
+                macroState = MACRO_STATE_NEXT;
+            }
+            break;
+
+        case MACRO_STATE_DELAY:
+            if(macroStopRequested || Timer_Time_Elapsed(macroWaitStart, macroWaitTime))
+            {
+                macroState = MACRO_STATE_NEXT;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    for(count = 0; (MACRO_STATE_NEXT == macroState) && (count < MACRO_OPS_PER_PASS); count++)
+    {
+        if(macroStopRequested)
+        {
+            Macro_End(CYS_FW_ERR_MACRO_STOPPED);
+            return;
+        }
+        if(macroLength <= macroPc)
+        {
+            /* Running off the end is an implicit MACRO_OP_END */
+            Macro_End(macroResult.status);
+            return;
+        }
+
+        op = &macroProgram[macroPc];
+        switch(op[0])
+        {
+            case MACRO_OP_CMD:
+                if(!Macro_RunCmd(op))
+                {
+                    /* Try again on the next pass */
+                    return;
+                }
+                break;
+
+            case MACRO_OP_WAIT:
+                macroWaitEvent = CyBle_Get16ByPtr(&op[1]);
+                macroWaitTime = CyBle_Get16ByPtr(&op[3]);
+                macroWaitDone = false;
+                macroWaitStart = Timer_Get_Time_Stamp();
+                macroPc += MACRO_WAIT_SIZE;
+                macroState = MACRO_STATE_WAIT;
+                break;
+
+            case MACRO_OP_JUMP:
+                macroPc = Macro_Condition(op) ? CyBle_Get16ByPtr(&op[5]) : (macroPc + MACRO_JUMP_SIZE);
+                break;
+
+            case MACRO_OP_STORE:
+                memcpy(macroVar, &macroCapture[op[1]], op[2]);
+                macroVarLen = op[2];
+                macroPc += MACRO_STORE_SIZE;
+                break;
+
+            case MACRO_OP_DELAY:
+                macroWaitTime = CyBle_Get16ByPtr(&op[1]);
+                macroWaitStart = Timer_Get_Time_Stamp();
+                macroPc += MACRO_DELAY_SIZE;
+                macroState = MACRO_STATE_DELAY;
+                break;
+
+            default:
+                /* MACRO_OP_END, CySmt_MacroStart() let no other op-code through */
+                Macro_End(macroResult.status);
+                return;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: CySmt_MacroCommandResult
+********************************************************************************
+*
+* Summary:
+*  Takes the status or complete of the step's command
+*
+* Parameters:
+*  CommandOpCode - command of the status or complete event
+*
+*  status - status of the event
+*
+*  complete - true for EVT_COMMAND_COMPLETE
+*
+* Return:
+*  bool - true if the event belongs to the step and is not to be sent
+*
+* Theory:
+*  The host only gets the step's own response events and the macro result
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*  Called by CySmt_SendCommandStatus() and CySmt_SendCommandComplete() once they have
+*   cleared the command
+*
+*******************************************************************************/
+bool CySmt_MacroCommandResult(uint16 CommandOpCode, uint16 status, bool complete)
+{
+    if((MACRO_STATE_STEP != macroState) || (CommandOpCode != macroStepOpcode))
+    {
+        return false;
+    }
+
+    macroResult.status = status;
+    if(complete || (CYBLE_ERROR_OK != status) || macroStepNoWait)
+    {
+        macroState = MACRO_STATE_NEXT;
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: CySmt_MacroEvent
+********************************************************************************
+*
+* Summary:
+*  Captures the event parameters the conditions and MACRO_OP_STORE look at
+*
+* Parameters:
+*  EventOpCode - event sent
+*
+*  CommandOpCode - command op-code of the event, 0 if none
+*
+*  ParamSize - bytes at parameters
+*
+*  parameters - event parameters, the additional data of the event is not seen
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  Only the events of the step's command and the awaited event are taken, so
+*   notifications of other characteristics don't overwrite them
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*  Called by CyS_SendEvent()
+*
+*******************************************************************************/
+void CySmt_MacroEvent(Event EventOpCode, uint16 CommandOpCode, uint16 ParamSize, const uint8 *parameters)
+{
+    bool awaited = (MACRO_STATE_WAIT == macroState) && (EventOpCode == macroWaitEvent);
+
+    if( (!awaited) && ((MACRO_STATE_STEP != macroState) || (CommandOpCode != macroStepOpcode)) )
+    {
+        return;
+    }
+
+    macroEvent = (uint16)EventOpCode;
+    macroCaptureLen = (uint8)((MACRO_CAPTURE_SIZE < ParamSize) ? MACRO_CAPTURE_SIZE : ParamSize);
+    if(NULL != parameters)
+    {
+        memcpy(macroCapture, parameters, macroCaptureLen);
+    }
+    else
+    {
+        macroCaptureLen = 0;
+    }
+
+    if(awaited)
+    {
+        macroWaitDone = true;
+    }
+}
+
+/*******************************************************************************
+* Function Name: CySmt_MacroGattError
+********************************************************************************
+*
+* Summary:
+*  Ends the step on a GATT error response to its command
+*
+* Parameters:
+*  CommandOpCode - command the error response ends
+*
+*  errorCode - ATT error code
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  The stack event handler ends the command without a complete and sends the error
+*   code as additional data of EVT_GATT_ERROR_NOTIFICATION, which the capture doesn't see
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*  Called by the CYBLE_EVT_GATTC_ERROR_RSP handler
+*
+*******************************************************************************/
+void CySmt_MacroGattError(uint16 CommandOpCode, uint8 errorCode)
+{
+    if((MACRO_STATE_STEP == macroState) && (CommandOpCode == macroStepOpcode))
+    {
+        macroResult.status = errorCode;
+        macroState = MACRO_STATE_NEXT;
+    }
+}
+#endif /* CYSMART_SUPPORT */
+
+/* [] END OF FILE */
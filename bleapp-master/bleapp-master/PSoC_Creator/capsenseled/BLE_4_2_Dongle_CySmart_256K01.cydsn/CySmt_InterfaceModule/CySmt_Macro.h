@@ -0,0 +1,148 @@
+/******************************************************************************
+* File Name         : CySmt_Macro.h
+* Description       : Runs host-supplied command sequences on the dongle, one step per command.
+* Version           : 1.2
+* Software Used     : PSoC Creator 3.3 CP2
+* Compiler          : ARM GCC 4.9.3, ARM MDK Generic
+*
+********************************************************************************
+* Copyright (2016), Cypress Semiconductor Corporation. All Rights Reserved.
+********************************************************************************
+* This software is owned by Cypress Semiconductor Corporation (Cypress)
+* and is protected by and subject to worldwide patent protection (United
+* States and foreign), United States copyright laws and international treaty
+* provisions. Cypress hereby grants to licensee a personal, non-exclusive,
+* non-transferable license to copy, use, modify, create derivative works of,
+* and compile the Cypress Source Code and derivative works for the sole
+* purpose of creating custom software in support of licensee product to be
+* used only in conjunction with a Cypress integrated circuit as specified in
+* the applicable agreement. Any reproduction, modification, translation,
+* compilation, or representation of this software except as specified above 
+* is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: CYPRESS MAKES NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, WITH 
+* REGARD TO THIS MATERIAL, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+* Cypress reserves the right to make changes without further notice to the 
+* materials described herein. Cypress does not assume any liability arising out 
+* of the application or use of any product or circuit described herein. Cypress 
+* does not authorize its products for use as critical components in life-support 
+* systems where a malfunction or failure may reasonably be expected to result in 
+* significant injury to the user. The inclusion of Cypress' product in a life-
+* support systems application implies that the manufacturer assumes all risk of 
+* such use and in doing so indemnifies Cypress against all charges. 
+*
+* Use of this Software may be limited by and subject to the applicable Cypress
+* software license agreement. 
+*******************************************************************************/
+
+#ifndef _CYSMT_MACRO_H_
+#define _CYSMT_MACRO_H_
+
+#include "CySmt_protocol.h"
+
+/* Largest program CMD_RUN_MACRO accepts */
+#define MACRO_PROGRAM_SIZE                   (256u)
+
+/* Leading event parameter bytes kept for the conditions */
+#define MACRO_CAPTURE_SIZE                   (16u)
+
+/* Bytes MACRO_OP_STORE can keep for the next commands, a BD address with its type fits */
+#define MACRO_VAR_SIZE                       (8u)
+
+/* Instructions run per main loop pass without issuing a command, bounds a loop that only jumps */
+#define MACRO_OPS_PER_PASS                   (16u)
+
+/* Program instructions, an op-code byte followed by its operands, 16-bit operands are little endian.
+        The status register holds the status of the last MACRO_OP_CMD or MACRO_OP_WAIT */
+
+/* [op] - End the macro with the status register */
+#define MACRO_OP_END                         (0x00u)
+
+/* [op][flags][command op-code:2][length][parameters] - Run a command, the step ends with its complete,
+        or with its status if that is an error. A GATT error response ends it with the ATT error code,
+        e.g. 0x0A attribute not found at the end of a discovery. The command's status and complete
+        events are not sent */
+#define MACRO_OP_CMD                         (0x01u)
+
+/* [op][event op-code:2][timeout ms:2] - Wait for an event, the status is CYS_FW_ERR_MACRO_TIMEOUT if
+        it doesn't come */
+#define MACRO_OP_WAIT                        (0x02u)
+
+/* [op][condition][index][value:2][target:2] - Go to the instruction at byte offset target if the
+        condition holds */
+#define MACRO_OP_JUMP                        (0x03u)
+
+/* [op][index][length] - Keep length captured parameter bytes from index for MACRO_CMD_LOAD */
+#define MACRO_OP_STORE                       (0x04u)
+
+/* [op][ms:2] - Pause */
+#define MACRO_OP_DELAY                       (0x05u)
+
+/* MACRO_OP_CMD flags */
+/* The step ends with the status, for commands that only end with another one, e.g. start scan */
+#define MACRO_CMD_NO_WAIT                    (0x01u)
+/* Parameters start with the bytes kept by MACRO_OP_STORE, e.g. a connection handle */
+#define MACRO_CMD_LOAD                       (0x02u)
+
+/* MACRO_OP_JUMP conditions. The captured event is the last one of the step's command or of the
+        awaited event code, fields past its captured parameters compare unequal */
+typedef enum
+{
+    MACRO_IF_ALWAYS = 0,
+    /* Status register against value */
+    MACRO_IF_STATUS_EQ,
+    MACRO_IF_STATUS_NE,
+    /* Captured event op-code against value */
+    MACRO_IF_EVENT_EQ,
+    MACRO_IF_EVENT_NE,
+    /* Captured parameter byte at index against the low byte of value */
+    MACRO_IF_BYTE_EQ,
+    MACRO_IF_BYTE_NE,
+    /* Captured 16-bit parameter at index against value */
+    MACRO_IF_U16_EQ,
+    MACRO_IF_U16_NE,
+}MACRO_CONDITION;
+
+/* Firmware status codes, next to CYS_FW_ERR_INSUFFICIENT_RESOURCES */
+#define CYS_FW_ERR_MACRO_STOPPED             (0xFD01u)
+#define CYS_FW_ERR_MACRO_TIMEOUT             (0xFD02u)
+
+/* EVT_MACRO_RESULT parameters, sent before the complete of CMD_RUN_MACRO */
+typedef struct _MACRO_RESULT_T
+{
+    /* Status register at the end, also the status of the complete */
+    uint16 status;
+    /* Byte offset of the last instruction run */
+    uint16 pc;
+    /* Commands issued */
+    uint16 steps;
+    /* Op-code of the last command issued, 0 if none */
+    uint16 lastOpcode;
+    /* Time from CMD_RUN_MACRO to the end, in timer ticks (ms) */
+    uint32 elapsed;
+}MACRO_RESULT_T;
+
+/* Checks and copies a program, the macro starts on the next CySmt_MacroProcess() */
+CYBLE_API_RESULT_T CySmt_MacroStart(const uint8 *program, uint16 length);
+
+/* Ends the macro once its step in progress is over, CYBLE_ERROR_INVALID_STATE if none runs */
+CYBLE_API_RESULT_T CySmt_MacroStop(void);
+
+/* Returns true while a macro runs, host commands that can't run next to its steps wait */
+bool CySmt_MacroRunning(void);
+
+/* Runs the macro's next instructions, call from the main loop before CySmt_ProcessCommands() */
+void CySmt_MacroProcess(void);
+
+/* Takes the status or complete of a step's command, returns true if the event is not to be sent */
+bool CySmt_MacroCommandResult(uint16 CommandOpCode, uint16 status, bool complete);
+
+/* Captures events for the conditions, called for every event sent */
+void CySmt_MacroEvent(Event EventOpCode, uint16 CommandOpCode, uint16 ParamSize, const uint8 *parameters);
+
+/* Ends the step of CommandOpCode on a GATT error response, its error code becomes the status */
+void CySmt_MacroGattError(uint16 CommandOpCode, uint8 errorCode);
+
+#endif /* _CYSMT_MACRO_H_ */
+/* [] END OF FILE */
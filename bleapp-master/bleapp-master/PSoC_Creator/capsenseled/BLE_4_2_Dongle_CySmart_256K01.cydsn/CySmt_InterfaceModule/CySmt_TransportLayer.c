@@ -37,6 +37,7 @@
 *******************************************************************************/
 
 #include "CySmt_TransportLayer.h"
+#include <string.h>
 #ifdef CYSMART_SUPPORT
 
 /* RX buffers for primary and secondary command data */
@@ -51,16 +52,1706 @@ volatile static CY_RX_CMD_STATE cmdRxState = STATE_HEADER;
 
 volatile static uint32 rxCnt = 0;
 
+/* Command slot, packets up to SECONDARY_CMD_BUFF_SIZE bytes are kept in small */
+typedef struct _CY_CMD_SLOT
+{
+    /* Packet size, 0 while the slot is free */
+    uint16 size;
+    /* Packet start in cmdPool for larger packets */
+    uint16 offset;
+    /* Set once the whole packet is received */
+    bool ready;
+    uint8 small[SECONDARY_CMD_BUFF_SIZE];
+}CY_CMD_SLOT;
+
+static CY_CMD_SLOT cmdSlot[CMD_QUEUE_SLOTS];
+static uint8 cmdPool[CMD_QUEUE_POOL_SIZE];
+static uint16 cmdPoolTail = 0;
+
+/* Slot numbers in order of arrival, a slot being received is always last */
+static uint8 cmdOrder[CMD_QUEUE_SLOTS];
+static volatile uint8 cmdCount = 0;
+
+/* Header of the packet being received, then its slot once one is allocated */
+static uint8 rxHeader[COMMAND_HEADER_SIZE];
+static uint8 *rxPktBuf = rxHeader;
+static CY_CMD_SLOT *rxSlot = NULL;
+
+/* Payload bytes still expected for the packet being received */
+static uint16 expectedPktLength = 0;
+
+#if defined(TRANSPORT_RX_DMA) || defined(TRANSPORT_TX_DMA)
+/* Routes a trigger group 0 input to a DMA channel */
+#define TRANSPORT_TR_OUT_CTL(ch)    (*(reg32 *)(CYREG_PERI_TR_GROUP_TR_OUT_CTL0 + ((uint32)(ch) * 4u)))
+#endif
+
+#ifdef TRANSPORT_RX_DMA
+/* Circular buffer written by the DMA, descriptor 0 fills the lower half and chains to 1 */
+static uint8 rxRing[TRANSPORT_RX_RING_SIZE];
+
+/* Completed DMA halves and bytes consumed, both count up without wrapping at the buffer size */
+static volatile uint32 rxHalves = 0;
+static uint32 rxReadPos = 0;
+
+static int32 rxDmaChannel = CYDMA_INVALID_CHANNEL;
+
+/* Set from interrupt context, acted on by Transport_Process */
+static volatile bool rxTimeoutFlag = false;
+static volatile bool rxResetFlag = false;
+#endif /* TRANSPORT_RX_DMA */
+
+#ifdef TRANSPORT_TX_DMA
+bool txInStackCallback = false;
+
+/* Circular transmit buffer. Positions count up without wrapping at the buffer size:
+   bytes reserved for frames, bytes of completed frames and bytes moved by the DMA */
+static uint8 txRing[TRANSPORT_TX_RING_SIZE];
+static uint32 txWritePos = 0;
+static volatile uint32 txCommitPos = 0;
+static volatile uint32 txReadPos = 0;
+
+/* Bytes in the running DMA transfer, 0 while the DMA is idle */
+static volatile uint32 txDmaLength = 0;
+
+/* Bytes of the open frame still to be written, and whether they are being discarded */
+static uint16 txFrameLeft = 0;
+static bool txFrameDropped = false;
+
+static int32 txDmaChannel = CYDMA_INVALID_CHANNEL;
+static CY_TX_STATS txStats;
+
+/* Set when a wait for room ran out, senders then drop at once until the DMA moves again */
+static bool txStalled = false;
+static uint32 txStallPos = 0;
+#endif /* TRANSPORT_TX_DMA */
+
+#ifdef TRANSPORT_FRAMED
+/* Sent DATA frame kept for a NAK, header and packet without the CRC */
+typedef struct _CY_TX_HISTORY
+{
+    uint16 offset;
+    uint16 length;
+    uint8 seq;
+    bool valid;
+}CY_TX_HISTORY;
+
+static uint8 transportMode = TRANSPORT_MODE_LEGACY;
+
+/* Mode switch requested by the host, applied once the TX side is idle */
+static bool modeSwitchPending = false;
+static uint8 pendingMode;
+static uint32 pendingBaud;
+
+/* Encoded frame being received, decoded in place at its delimiter */
+static uint8 rxFrameBuf[FRAME_COBS_MAX(FRAME_HEADER_SIZE + PRIMARY_CMD_BUFF_SIZE + FRAME_CRC_SIZE)];
+static uint16 rxFrameLen = 0;
+/* Frame ran past rxFrameBuf, bytes are dropped until the next delimiter */
+static bool rxFrameSkip = false;
+/* Packet of an accepted DATA frame not yet fully taken by Transport_Parse */
+static uint16 rxFrameFed = 0;
+static uint16 rxFrameEnd = 0;
+static uint8 rxSeqExpected = 0;
+/* Set once a NAK went out for rxSeqExpected */
+static bool rxNakSent = false;
+
+/* Event frame staged until it is complete, room is left for the header */
+static uint8 txFrameBuf[FRAME_HEADER_SIZE + TRANSPORT_FRAME_BODY_MAX];
+static uint16 txFrameLen = 0;
+static uint8 txSeq = 0;
+
+static uint8 txHistoryBuf[TRANSPORT_TX_HISTORY_SIZE];
+static uint16 txHistoryPos = 0;
+static CY_TX_HISTORY txHistory[TRANSPORT_TX_HISTORY_FRAMES];
+
+static bool Transport_FeedFrame(void);
+static uint32 Transport_ParseFramed(const uint8 *data, uint32 length);
+static void Transport_ApplyMode(void);
+#endif /* TRANSPORT_FRAMED */
+
+/*******************************************************************************
+* Function Name: Transport_SlotData
+********************************************************************************
+*
+* Summary:
+*  Returns where the packet of a command slot is stored
+*
+* Parameters:
+*  slot - command slot
+*
+* Return:
+*  uint8* - packet buffer
+*
+* Theory:
+*  NONE
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+static uint8 *Transport_SlotData(CY_CMD_SLOT *slot)
+{
+    return (slot->size > SECONDARY_CMD_BUFF_SIZE) ? &cmdPool[slot->offset] : slot->small;
+}
+
+/*******************************************************************************
+* Function Name: Transport_PoolAlloc
+********************************************************************************
+*
+* Summary:
+*  Finds contiguous room in the pool for a packet larger than a slot holds
+*
+* Parameters:
+*  size - packet size
+*
+* Return:
+*  uint32 - offset in cmdPool, CMD_QUEUE_POOL_SIZE if there is no room
+*
+* Theory:
+*  Pool packets are always dispatched as primary commands, in order of arrival,
+*  so the pool is a ring from the oldest pool packet up to cmdPoolTail
+*
+* Side Effects:
+*  cmdPoolTail is advanced on success
+*
+* Note:
+*
+*******************************************************************************/
+static uint32 Transport_PoolAlloc(uint16 size)
+{
+    uint32 start = CMD_QUEUE_POOL_SIZE;
+    uint32 offset = CMD_QUEUE_POOL_SIZE;
+    uint8 i;
+
+    for(i = 0; i < cmdCount; i++)
+    {
+        if(cmdSlot[cmdOrder[i]].size > SECONDARY_CMD_BUFF_SIZE)
+        {
+            start = cmdSlot[cmdOrder[i]].offset;
+            break;
+        }
+    }
+
+    if(CMD_QUEUE_POOL_SIZE == start)
+    {
+        /* Pool is empty */
+        cmdPoolTail = 0;
+        offset = 0;
+    }
+    else if(start < cmdPoolTail)
+    {
+        /* Room at the end, else wrap to the beginning */
+        if((cmdPoolTail + size) <= CMD_QUEUE_POOL_SIZE)
+        {
+            offset = cmdPoolTail;
+        }
+        else if(size < start)
+        {
+            offset = 0;
+        }
+    }
+    else if((cmdPoolTail + size) < start)
+    {
+        /* Already wrapped, room up to the oldest packet */
+        offset = cmdPoolTail;
+    }
+
+    if(CMD_QUEUE_POOL_SIZE != offset)
+    {
+        cmdPoolTail = (uint16)(offset + size);
+    }
+    return offset;
+}
+
+/*******************************************************************************
+* Function Name: Transport_AllocCmd
+********************************************************************************
+*
+* Summary:
+*  Opens a command slot for the packet whose header is in rxHeader
+*
+* Parameters:
+*  size - packet size including the header
+*
+* Return:
+*  bool - false if no slot or pool room is free
+*
+* Theory:
+*  Commands that can not run next to a primary command leave the last free
+*  slot to those that can, so a stop or time-out command is never locked out
+*
+* Side Effects:
+*  rxSlot and rxPktBuf point to the new slot
+*
+* Note:
+*
+*******************************************************************************/
+static bool Transport_AllocCmd(uint16 size)
+{
+    uint8 i;
+    uint8 reserve = CySmt_IsConcurrentCmd(CyBle_Get16ByPtr(rxHeader)) ? 0u : 1u;
+    uint32 offset = 0;
+
+    if((cmdCount + reserve) >= CMD_QUEUE_SLOTS)
+    {
+        return false;
+    }
+
+    if(size > SECONDARY_CMD_BUFF_SIZE)
+    {
+        offset = Transport_PoolAlloc(size);
+        if(CMD_QUEUE_POOL_SIZE == offset)
+        {
+            return false;
+        }
+    }
+
+    for(i = 0; 0 != cmdSlot[i].size; i++)
+    {
+        /* A free slot exists as cmdCount is below CMD_QUEUE_SLOTS */
+    }
+
+    rxSlot = &cmdSlot[i];
+    rxSlot->size = size;
+    rxSlot->offset = (uint16)offset;
+    rxSlot->ready = false;
+    cmdOrder[cmdCount++] = i;
+
+    rxPktBuf = Transport_SlotData(rxSlot);
+    memcpy(rxPktBuf, rxHeader, COMMAND_HEADER_SIZE);
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: Transport_PeekCmd
+********************************************************************************
+*
+* Summary:
+*  Returns a received command packet waiting to be dispatched
+*
+* Parameters:
+*  position - 0 for the oldest packet
+*  size     - returns the packet size including the header
+*
+* Return:
+*  uint8* - packet, NULL if fewer packets are waiting
+*
+* Theory:
+*  NONE
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*  The packet stays valid until Transport_ReleaseCmd
+*
+*******************************************************************************/
+uint8 *Transport_PeekCmd(uint8 position, uint16 *size)
+{
+    CY_CMD_SLOT *slot = NULL;
+    uint8 interruptState = CyEnterCriticalSection();
+
+    if((position < cmdCount) && cmdSlot[cmdOrder[position]].ready)
+    {
+        slot = &cmdSlot[cmdOrder[position]];
+    }
+    CyExitCriticalSection(interruptState);
+
+    if(NULL == slot)
+    {
+        return NULL;
+    }
+    *size = slot->size;
+    return Transport_SlotData(slot);
+}
+
+/*******************************************************************************
+* Function Name: Transport_ReleaseCmd
+********************************************************************************
+*
+* Summary:
+*  Frees the slot of a dispatched command packet
+*
+* Parameters:
+*  position - position as passed to Transport_PeekCmd
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  NONE
+*
+* Side Effects:
+*  Later packets move up one position
+*
+* Note:
+*
+*******************************************************************************/
+void Transport_ReleaseCmd(uint8 position)
+{
+    uint8 interruptState = CyEnterCriticalSection();
+
+    if(position < cmdCount)
+    {
+        cmdSlot[cmdOrder[position]].size = 0;
+        cmdCount--;
+        memmove(&cmdOrder[position], &cmdOrder[position + 1u], cmdCount - position);
+    }
+    CyExitCriticalSection(interruptState);
+}
+
+/*******************************************************************************
+* Function Name: Transport_Reset
+********************************************************************************
+*
+* Summary:
+*  Resets the RX command state machine to wait for a new header
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  NONE
+*
+* Side Effects:
+*  Partially received packet is discarded
+*
+* Note:
+*
+*******************************************************************************/
+static void Transport_Reset(void)
+{
+    /* Give back the slot of a partially received packet, it is always the last one */
+    if(NULL != rxSlot)
+    {
+        if(rxSlot->size > SECONDARY_CMD_BUFF_SIZE)
+        {
+            cmdPoolTail = rxSlot->offset;
+        }
+        rxSlot->size = 0;
+        cmdCount--;
+        rxSlot = NULL;
+    }
+
+    rxPktBuf = rxHeader;
+    cmdRxState = STATE_HEADER;
+    rxCnt = 0;
+    expectedPktLength = 0;
+}
+
+/*******************************************************************************
+* Function Name: Transport_PacketDone
+********************************************************************************
+*
+* Summary:
+*  Queues one complete command packet and re-arms the state machine
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  NONE
+*
+* Side Effects:
+*  newCmdRxDoneFlag will be set
+*
+* Note:
+*
+*******************************************************************************/
+static void Transport_PacketDone(void)
+{
+    /* Packet is complete, hand its slot to the dispatcher */
+    rxSlot->ready = true;
+    rxSlot = NULL;
+    Transport_Reset();
+
+    /* Done flag to indicate that the RX packet decoding is complete */
+    newCmdRxDoneFlag = true;
+
+    /* Stop the timer as complete packet is received */
+    Timer_10ms_Stop();
+}
+
+/*******************************************************************************
+* Function Name: Transport_OpenSlot
+********************************************************************************
+*
+* Summary:
+*  Moves the header of the packet being received into a command slot
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  bool - false if all slots are busy, the state machine stays in STATE_SLOT
+*
+* Theory:
+*  A packet with a payload above MAX_PAYLOAD_SIZE is queued without it, so the
+*  dispatcher can send out the error response
+*
+* Side Effects:
+*  cmdRxState will be modified
+*
+* Note:
+*
+*******************************************************************************/
+static bool Transport_OpenSlot(void)
+{
+    uint16 size = COMMAND_HEADER_SIZE;
+
+    if(expectedPktLength <= MAX_PAYLOAD_SIZE)
+    {
+        size += expectedPktLength;
+    }
+
+    if(!Transport_AllocCmd(size))
+    {
+        return false;
+    }
+
+    if(COMMAND_HEADER_SIZE == size)
+    {
+        Transport_PacketDone();
+    }
+    else
+    {
+        cmdRxState = STATE_PAYLOAD;
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: Transport_Parse
+********************************************************************************
+*
+* Summary:
+*  Runs received bytes through the cmdRxState machine into the command slots.
+*  Payload bytes are copied as one block instead of one state machine pass each.
+*
+* Parameters:
+*  data   - received bytes
+*  length - number of bytes at data
+*
+* Return:
+*  uint32 - bytes consumed, less than length if a packet completed before the end
+*           or all command slots are busy
+*
+* Theory:
+*  Stops right after a complete packet and leaves the rest to the caller
+*
+* Side Effects:
+*  Command slots and newCmdRxDoneFlag will be modified
+*
+* Note:
+*
+*******************************************************************************/
+static uint32 Transport_Parse(const uint8 *data, uint32 length)
+{
+    uint32 used = 0;
+    uint32 count;
+
+    while(used < length)
+    {
+        /* Retry a slot for a header that found none */
+        if(STATE_SLOT == cmdRxState)
+        {
+            if((!Transport_OpenSlot()) || (STATE_HEADER == cmdRxState))
+            {
+                return used;
+            }
+        }
+
+        if(STATE_PAYLOAD == cmdRxState)
+        {
+            /* Copy as much of the payload as is available */
+            count = length - used;
+            if(count > expectedPktLength)
+            {
+                count = expectedPktLength;
+            }
+            memcpy(&rxPktBuf[rxCnt], &data[used], count);
+            rxCnt += count;
+            used += count;
+            expectedPktLength -= (uint16)count;
+
+            /* Set complete flag, If last byte occurs */
+            if(0 == expectedPktLength)
+            {
+                Transport_PacketDone();
+                break;
+            }
+            continue;
+        }
+
+        /* Get each input byte into buffer, before checking for cmdRxState transition */
+        rxPktBuf[rxCnt++] = data[used++];
+
+        /* State machine implementation for decoding received packet
+                over UART.
+                There are 4 states in this implementation. 
+                1. Receive commands
+                2. Receive packet length
+                3. Wait for a free command slot
+                4. Receive payload */
+        switch(cmdRxState) 
+        {
+            case STATE_HEADER: 
+                /* Header is 2 byte value, wait until it is received */
+                if(sizeof(uint16) <= rxCnt)
+                {
+                    if((0x43 == rxPktBuf[0]) && (0x59 == rxPktBuf[1]))
+                    {
+                        cmdRxState = STATE_COMMAND;
+                    }
+                    /* Reset the byte counter if header is not detected */
+                    rxCnt = 0;
+                }
+                break;
+
+            /* cmdRxState to receive command code of incoming data */
+            case STATE_COMMAND: 
+                /* command code is 2 byte value, wait until it is received */
+                if(sizeof(uint16) == rxCnt)
+                {
+                    cmdRxState = STATE_LENGTH;
+                }
+                break;
+
+            /* cmdRxState to receive payload length */
+            case STATE_LENGTH:
+                /* wait until 2 byte length value is received */
+                if(COMMAND_HEADER_SIZE == rxCnt)
+                {
+                    expectedPktLength = CyBle_Get16ByPtr(&rxPktBuf[sizeof(uint16)]);
+                    cmdRxState = STATE_SLOT;
+
+                    /* Stop at a complete packet or when no slot is free */
+                    if((!Transport_OpenSlot()) || (STATE_HEADER == cmdRxState))
+                    {
+                        return used;
+                    }
+                }
+                break;
+
+            default:
+                /* Do Nothing, invalid cmdRxState */
+                break;    
+        }
+    }
+    return used;
+}
+
+#ifndef TRANSPORT_RX_DMA
+/*******************************************************************************
+* Function Name: Transport_RX_ISR
+********************************************************************************
+*
+* Summary:
+*  Handles the Interrupt Service Routine for the UART RX.
+*  Contains cmdRxState machine to check for valid command receipt and triggers flag
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  NONE
+*
+* Side Effects:
+*  Command buffers and newCmdRxDoneFlag will be modified
+*
+* Note:
+*
+*******************************************************************************/
+CY_ISR(Transport_RX_ISR)
+{
+    uint8 rxByte;
+        
+    if(UART_CHECK_INTR_RX_MASKED(UART_INTR_RX_NOT_EMPTY))
+    {    
+        while(0 != UART_SpiUartGetRxBufferSize())
+        {
+            rxByte = (uint8)UART_SpiUartReadRxData();
+
+            /* restart the timer on each received byte */
+            Timer_10ms_Stop();
+            Timer_10ms_Start();
+
+            (void)Transport_Parse(&rxByte, 1u);
+
+            /* Bytes can't be held back here, drop the packet if all command slots are busy */
+            if(STATE_SLOT == cmdRxState)
+            {
+                Transport_Reset();
+            }
+        }
+        UART_ClearRxInterruptSource(UART_INTR_RX_NOT_EMPTY);
+    }
+    if(UART_CHECK_INTR_RX_MASKED(UART_INTR_RX_BREAK_DETECT | UART_INTR_RX_OVERFLOW))
+    {    
+        /* Break can occur on start of each command, reset cmdRxState machine and RX buffers */
+        Transport_Reset();
+        UART_ClearRxInterruptSource(UART_INTR_RX_BREAK_DETECT);
+        UART_ClearRxInterruptSource(UART_INTR_RX_OVERFLOW);
+    }
+}
+#else
+/*******************************************************************************
+* Function Name: Transport_RX_ISR
+********************************************************************************
+*
+* Summary:
+*  Handles the Interrupt Service Routine for the UART RX.
+*  Data bytes are moved by the DMA, only break and overflow interrupt here
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  NONE
+*
+* Side Effects:
+*  Transport_Process will reset the cmdRxState machine
+*
+* Note:
+*
+*******************************************************************************/
+CY_ISR(Transport_RX_ISR)
+{
+    if(UART_CHECK_INTR_RX_MASKED(UART_INTR_RX_BREAK_DETECT | UART_INTR_RX_OVERFLOW))
+    {    
+        /* Break can occur on start of each command, the state machine is owned by the main loop */
+        rxResetFlag = true;
+        UART_ClearRxInterruptSource(UART_INTR_RX_BREAK_DETECT);
+        UART_ClearRxInterruptSource(UART_INTR_RX_OVERFLOW);
+    }
+}
+
+/*******************************************************************************
+* Function Name: Transport_DmaDone
+********************************************************************************
+*
+* Summary:
+*  DMA completion callback, one half of the circular buffer is full
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  The completed descriptor invalidated itself, validating it again clears its
+*  transfer index before the DMA chains back to it
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+static void Transport_DmaDone(void)
+{
+    CyDmaValidateDescriptor(rxDmaChannel, (int32)(rxHalves & 1u));
+    rxHalves++;
+}
+
+/*******************************************************************************
+* Function Name: Transport_RxWritePos
+********************************************************************************
+*
+* Summary:
+*  Returns the number of bytes the DMA has written since Transport_Start
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  uint32 - DMA write position, counts up without wrapping at the buffer size
+*
+* Theory:
+*  Completed halves come from the DMA interrupt, the position within the
+*  current half from the transfer index of its descriptor
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+static uint32 Transport_RxWritePos(void)
+{
+    uint32 halves;
+    uint32 index;
+
+    do
+    {
+        halves = rxHalves;
+        index = CyDmaGetDescriptorStatus(rxDmaChannel, (int32)(halves & 1u)) & CYDMA_TRANSFER_INDEX;
+    } while(halves != rxHalves);
+
+    if(index > TRANSPORT_RX_RING_HALF)
+    {
+        index = TRANSPORT_RX_RING_HALF;
+    }
+    return (halves * TRANSPORT_RX_RING_HALF) + index;
+}
+
+/*******************************************************************************
+* Function Name: Transport_Start
+********************************************************************************
+*
+* Summary:
+*  Starts the DMA moving UART RX bytes into the circular buffer
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  The RX FIFO trigger fires while one byte or more is waiting, each trigger
+*  moves one byte. The RX interrupt is left on for break and overflow only.
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*  Call after UART_Start()
+*
+*******************************************************************************/
+void Transport_Start(void)
+{
+    cydma_init_struct config;
+    int32 i;
+
+    UART_SetRxInterruptMode(UART_INTR_RX_BREAK_DETECT | UART_INTR_RX_OVERFLOW);
+    UART_RX_FIFO_CTRL_REG &= (uint32) ~UART_RX_FIFO_CTRL_TRIGGER_LEVEL_MASK;
+
+    config.dataElementSize = CYDMA_BYTE;
+    config.numDataElements = TRANSPORT_RX_RING_HALF;
+    config.srcDstTransferWidth = CYDMA_WORD_ELEMENT;
+    config.addressIncrement = CYDMA_INC_DST_ADDR;
+    config.triggerType = CYDMA_LEVEL_FOUR;
+    config.transferMode = CYDMA_SINGLE_DATA_ELEMENT;
+    config.preemptable = CYDMA_PREEMPTABLE;
+    config.actions = CYDMA_CHAIN | CYDMA_INVALIDATE | CYDMA_GENERATE_IRQ;
+
+    CyDmaEnable();
+    rxDmaChannel = CyDmaChAlloc();
+    if(CYDMA_INVALID_CHANNEL == rxDmaChannel)
+    {
+        return;
+    }
+
+    for(i = 0; i < 2; i++)
+    {
+        CyDmaSetConfiguration(rxDmaChannel, i, &config);
+        CyDmaSetSrcAddress(rxDmaChannel, i, (void *)UART_RX_FIFO_RD_PTR);
+        CyDmaSetDstAddress(rxDmaChannel, i, (void *)&rxRing[i * (int32)TRANSPORT_RX_RING_HALF]);
+        CyDmaValidateDescriptor(rxDmaChannel, i);
+    }
+    CyDmaSetNextDescriptor(rxDmaChannel, 0);
+
+    rxHalves = 0;
+    rxReadPos = 0;
+    CyDmaSetInterruptCallback(rxDmaChannel, Transport_DmaDone);
+    CyDmaSetInterruptSourceMask(CyDmaGetInterruptSourceMask() | (1uL << rxDmaChannel));
+    CyIntEnable(CYDMA_INTR_NUMBER);
+
+    TRANSPORT_TR_OUT_CTL(rxDmaChannel) = TRANSPORT_RX_DMA_TR_SEL;
+    CyDmaChEnable(rxDmaChannel);
+}
+
+/*******************************************************************************
+* Function Name: Transport_Process
+********************************************************************************
+*
+* Summary:
+*  Frames the bytes the DMA has placed in the circular buffer since the last call
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  Bytes stay in the circular buffer while all command slots are busy,
+*  instead of being dropped. The 10ms timer is
+*  restarted once per call that made progress inside a packet, and a packet
+*  is only abandoned when it expired with no new bytes waiting.
+*  In framed mode the delimiters mark the packets and the timer is not used.
+*
+* Side Effects:
+*  Command buffers and newCmdRxDoneFlag will be modified
+*
+* Note:
+*  Call from the main loop
+*
+*******************************************************************************/
+void Transport_Process(void)
+{
+    bool timeout = rxTimeoutFlag;
+    uint32 writePos;
+    uint32 count;
+    uint32 offset;
+    uint32 chunk;
+    uint32 used;
+
+    if(CYDMA_INVALID_CHANNEL == rxDmaChannel)
+    {
+        return;
+    }
+
+    if(rxResetFlag)
+    {
+        rxResetFlag = false;
+        Transport_Reset();
+    }
+
+#ifdef TRANSPORT_FRAMED
+    if(modeSwitchPending && Transport_TxIdle())
+    {
+        Transport_ApplyMode();
+    }
+#endif /* TRANSPORT_FRAMED */
+
+    /* A slot may have been freed since the last pass */
+    if(STATE_SLOT == cmdRxState)
+    {
+        (void)Transport_OpenSlot();
+    }
+
+#ifdef TRANSPORT_FRAMED
+    /* Finish a frame whose packet waited for a command slot */
+    if(0 != rxFrameEnd)
+    {
+        (void)Transport_FeedFrame();
+    }
+#endif /* TRANSPORT_FRAMED */
+
+    writePos = Transport_RxWritePos();
+    count = writePos - rxReadPos;
+
+    if((0 == count) || ((int32)count < 0))
+    {
+        /* Nothing new, or the DMA interrupt is still pending for a half that just completed.
+           A packet waiting for a command slot is not abandoned */
+        if(timeout && (STATE_SLOT != cmdRxState))
+        {
+            Timer_10ms_Stop();
+            rxTimeoutFlag = false;
+            Transport_Reset();
+        }
+        return;
+    }
+
+    if(count > TRANSPORT_RX_RING_SIZE)
+    {
+        /* DMA overtook the reader, the buffered bytes are no longer a stream */
+        rxReadPos = writePos;
+        Transport_Reset();
+        return;
+    }
+
+    while(0 != count)
+    {
+        offset = rxReadPos & TRANSPORT_RX_RING_MASK;
+        chunk = TRANSPORT_RX_RING_SIZE - offset;
+        if(chunk > count)
+        {
+            chunk = count;
+        }
+
+#ifdef TRANSPORT_FRAMED
+        if(TRANSPORT_MODE_FRAMED == transportMode)
+        {
+            used = Transport_ParseFramed(&rxRing[offset], chunk);
+        }
+        else
+#endif /* TRANSPORT_FRAMED */
+        {
+            used = Transport_Parse(&rxRing[offset], chunk);
+        }
+        rxReadPos += used;
+        count -= used;
+
+        /* All command slots are busy, leave the rest in the ring */
+        if(STATE_SLOT == cmdRxState)
+        {
+            break;
+        }
+    }
+
+#ifdef TRANSPORT_FRAMED
+    if(TRANSPORT_MODE_FRAMED == transportMode)
+    {
+        return;
+    }
+#endif /* TRANSPORT_FRAMED */
+
+    /* Restart the inter-byte timeout if a packet is still open */
+    if((STATE_HEADER != cmdRxState) || (0 != rxCnt))
+    {
+        Timer_10ms_Stop();
+        rxTimeoutFlag = false;
+        Timer_10ms_Start();
+    }
+}
+#endif /* TRANSPORT_RX_DMA */
+
+#ifdef TRANSPORT_TX_DMA
+/*******************************************************************************
+* Function Name: Transport_TxKick
+********************************************************************************
+*
+* Summary:
+*  Starts a DMA transfer of the completed frames, if the DMA is idle
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  One transfer covers the committed bytes up to the end of the buffer,
+*  the rest follows from the completion interrupt
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*  Call with interrupts disabled or from the DMA interrupt
+*
+*******************************************************************************/
+static void Transport_TxKick(void)
+{
+    cydma_init_struct config;
+    uint32 offset;
+    uint32 length;
+
+    if((0 != txDmaLength) || (txCommitPos == txReadPos))
+    {
+        return;
+    }
+
+    offset = txReadPos & TRANSPORT_TX_RING_MASK;
+    length = txCommitPos - txReadPos;
+    if(length > (TRANSPORT_TX_RING_SIZE - offset))
+    {
+        length = TRANSPORT_TX_RING_SIZE - offset;
+    }
+
+    config.dataElementSize = CYDMA_BYTE;
+    config.numDataElements = (int32)length;
+    config.srcDstTransferWidth = CYDMA_ELEMENT_WORD;
+    config.addressIncrement = CYDMA_INC_SRC_ADDR;
+    config.triggerType = CYDMA_LEVEL_FOUR;
+    config.transferMode = CYDMA_SINGLE_DATA_ELEMENT;
+    config.preemptable = CYDMA_PREEMPTABLE;
+    config.actions = CYDMA_INVALIDATE | CYDMA_GENERATE_IRQ;
+
+    txDmaLength = length;
+    CyDmaSetConfiguration(txDmaChannel, 0, &config);
+    CyDmaSetSrcAddress(txDmaChannel, 0, (void *)&txRing[offset]);
+    CyDmaValidateDescriptor(txDmaChannel, 0);
+    CyDmaSetNextDescriptor(txDmaChannel, 0);
+    CyDmaChEnable(txDmaChannel);
+}
+
+/*******************************************************************************
+* Function Name: Transport_TxDmaDone
+********************************************************************************
+*
+* Summary:
+*  DMA completion callback, the bytes of the last transfer are in the TX FIFO
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  The channel is stopped before the next transfer is set up, the TX FIFO
+*  trigger stays asserted while the FIFO drains
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+static void Transport_TxDmaDone(void)
+{
+    CyDmaChDisable(txDmaChannel);
+    txReadPos += txDmaLength;
+    txDmaLength = 0;
+    Transport_TxKick();
+}
+
+/*******************************************************************************
+* Function Name: Transport_TxStart
+********************************************************************************
+*
+* Summary:
+*  Allocates the DMA channel that feeds the UART TX FIFO from the circular buffer
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  NONE
+*
+* Side Effects:
+*  If no channel is free, frames are written with UART_SpiUartPutArray
+*
+* Note:
+*  Call after UART_Start()
+*
+*******************************************************************************/
+void Transport_TxStart(void)
+{
+    CyDmaEnable();
+    txDmaChannel = CyDmaChAlloc();
+    if(CYDMA_INVALID_CHANNEL == txDmaChannel)
+    {
+        return;
+    }
+
+    UART_TX_FIFO_CTRL_REG = (UART_TX_FIFO_CTRL_REG & (uint32) ~UART_TX_FIFO_CTRL_TRIGGER_LEVEL_MASK) |
+                            TRANSPORT_TX_FIFO_LEVEL;
+
+    CyDmaSetDstAddress(txDmaChannel, 0, (void *)UART_TX_FIFO_WR_PTR);
+    CyDmaSetInterruptCallback(txDmaChannel, Transport_TxDmaDone);
+    CyDmaSetInterruptSourceMask(CyDmaGetInterruptSourceMask() | (1uL << txDmaChannel));
+    CyIntEnable(CYDMA_INTR_NUMBER);
+
+    TRANSPORT_TR_OUT_CTL(txDmaChannel) = TRANSPORT_TX_DMA_TR_SEL;
+}
+
+/*******************************************************************************
+* Function Name: Transport_Reserve
+********************************************************************************
+*
+* Summary:
+*  Makes room for length bytes in the circular buffer
+*
+* Parameters:
+*  length - bytes about to be written
+*
+* Return:
+*  bool - false if the bytes have to be dropped
+*
+* Theory:
+*  Without room, a frame raised from the BLE stack callback is dropped,
+*  any other sender waits for the DMA to make room for up to TRANSPORT_TX_WAIT_US.
+*  After a wait ran out, frames without room are dropped at once until the DMA
+*  has moved bytes again, so a stalled DMA doesn't hold up every sender.
+*
+* Side Effects:
+*  Transmit counters will be updated
+*
+* Note:
+*  Call with interrupts enabled, the DMA interrupt and the SysTick have to run
+*
+*******************************************************************************/
+static bool Transport_Reserve(uint32 length)
+{
+    uint32 used = txWritePos - txReadPos;
+    uint32 start;
+
+    if((used + length) > TRANSPORT_TX_RING_SIZE)
+    {
+        if(txInStackCallback || (length > TRANSPORT_TX_RING_SIZE) ||
+           (txStalled && (txReadPos == txStallPos)))
+        {
+            txStats.framesDropped++;
+            txStats.bytesDropped += length;
+            return false;
+        }
+
+        txStalled = false;
+        txStats.framesDelayed++;
+        start = Timer_Get_Time_Stamp_Us();
+        while(((txWritePos - txReadPos) + length) > TRANSPORT_TX_RING_SIZE)
+        {
+            /* Wait for the DMA to free enough of the buffer */
+            if((Timer_Get_Time_Stamp_Us() - start) >= TRANSPORT_TX_WAIT_US)
+            {
+                txStalled = true;
+                txStallPos = txReadPos;
+                txStats.framesTimedOut++;
+                txStats.framesDropped++;
+                txStats.bytesDropped += length;
+                return false;
+            }
+        }
+    }
+
+    used = (txWritePos - txReadPos) + length;
+    if(used > txStats.peakUsed)
+    {
+        txStats.peakUsed = (uint16)used;
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: Transport_TxPublish
+********************************************************************************
+*
+* Summary:
+*  Hands every byte written to the circular buffer so far to the DMA
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  NONE
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+static void Transport_TxPublish(void)
+{
+    uint8 interruptState;
+
+    interruptState = CyEnterCriticalSection();
+    txCommitPos = txWritePos;
+    Transport_TxKick();
+    CyExitCriticalSection(interruptState);
+}
+
+#ifdef TRANSPORT_FRAMED
+/*******************************************************************************
+* Function Name: Transport_Crc16
+********************************************************************************
+*
+* Summary:
+*  Runs bytes through the CRC-16/CCITT-FALSE of a frame
+*
+* Parameters:
+*  crc    - 0xFFFF for the first bytes, else the value returned for the previous ones
+*
+*  data   - bytes to add
+*
+*  length - number of bytes at data
+*
+* Return:
+*  uint16 - CRC so far
+*
+* Theory:
+*  Polynomial 0x1021, one 16 entry table lookup per nibble
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+static uint16 Transport_Crc16(uint16 crc, const uint8 *data, uint32 length)
+{
+    static const uint16 crcNibble[16u] =
+    {
+        0x0000u, 0x1021u, 0x2042u, 0x3063u, 0x4084u, 0x50A5u, 0x60C6u, 0x70E7u,
+        0x8108u, 0x9129u, 0xA14Au, 0xB16Bu, 0xC18Cu, 0xD1ADu, 0xE1CEu, 0xF1EFu
+    };
+
+    while(0 != length--)
+    {
+        crc = (uint16)(crc << 4) ^ crcNibble[(crc >> 12) ^ (*data >> 4)];
+        crc = (uint16)(crc << 4) ^ crcNibble[(crc >> 12) ^ (*data & 0x0Fu)];
+        data++;
+    }
+    return crc;
+}
+
+/*******************************************************************************
+* Function Name: Transport_FrameOut
+********************************************************************************
+*
+* Summary:
+*  Appends the CRC to a frame and COBS encodes it into the circular buffer
+*
+* Parameters:
+*  frame  - sequence number, type and packet
+*
+*  length - number of bytes at frame
+*
+* Return:
+*  bool - false if the frame was dropped for want of room
+*
+* Theory:
+*  Every run of up to 254 non-zero bytes is led by a code byte holding its
+*  length plus one, the 0x00 delimiter after the last run closes the frame.
+*  Code bytes are filled in once their run is complete.
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+static bool Transport_FrameOut(const uint8 *frame, uint16 length)
+{
+    uint8 crc[FRAME_CRC_SIZE];
+    uint16 value;
+    uint32 code;
+    uint32 pos;
+    uint16 i;
+    uint8 run = 1u;
+    uint8 byte;
+
+    if(!Transport_Reserve(FRAME_COBS_MAX((uint32)length + FRAME_CRC_SIZE)))
+    {
+        return false;
+    }
+
+    value = Transport_Crc16(0xFFFFu, frame, length);
+    crc[0] = LO8(value);
+    crc[1] = HI8(value);
+
+    code = txWritePos;
+    pos = code + 1u;
+    for(i = 0; i < (length + FRAME_CRC_SIZE); i++)
+    {
+        byte = (i < length) ? frame[i] : crc[i - length];
+        if(0 != byte)
+        {
+            txRing[pos++ & TRANSPORT_TX_RING_MASK] = byte;
+            run++;
+        }
+        if((0 == byte) || (0xFFu == run))
+        {
+            txRing[code & TRANSPORT_TX_RING_MASK] = run;
+            code = pos++;
+            run = 1u;
+        }
+    }
+    txRing[code & TRANSPORT_TX_RING_MASK] = run;
+    txRing[pos++ & TRANSPORT_TX_RING_MASK] = 0x00u;
+    txWritePos = pos;
+
+    Transport_TxPublish();
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: Transport_HistoryStore
+********************************************************************************
+*
+* Summary:
+*  Keeps a sent DATA frame for resending
+*
+* Parameters:
+*  frame  - sequence number, type and packet
+*
+*  length - number of bytes at frame
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  Frames are stored one after the other and start over at the beginning of
+*  the buffer when they don't fit, older frames they overlap are forgotten.
+*  The entry is picked by the sequence number.
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+static void Transport_HistoryStore(const uint8 *frame, uint16 length)
+{
+    CY_TX_HISTORY *entry = &txHistory[frame[0] % TRANSPORT_TX_HISTORY_FRAMES];
+    uint8 i;
+
+    entry->valid = false;
+    if(length > TRANSPORT_TX_HISTORY_SIZE)
+    {
+        return;
+    }
+
+    if((txHistoryPos + length) > TRANSPORT_TX_HISTORY_SIZE)
+    {
+        txHistoryPos = 0;
+    }
+
+    for(i = 0; i < TRANSPORT_TX_HISTORY_FRAMES; i++)
+    {
+        if((txHistory[i].offset < (txHistoryPos + length)) &&
+           ((txHistory[i].offset + txHistory[i].length) > txHistoryPos))
+        {
+            txHistory[i].valid = false;
+        }
+    }
+
+    memcpy(&txHistoryBuf[txHistoryPos], frame, length);
+    entry->offset = txHistoryPos;
+    entry->length = length;
+    entry->seq = frame[0];
+    entry->valid = true;
+    txHistoryPos += length;
+}
+#endif /* TRANSPORT_FRAMED */
+
+/*******************************************************************************
+* Function Name: Transport_CommitFrame
+********************************************************************************
+*
+* Summary:
+*  Closes the open frame and hands its bytes to the DMA
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  In framed mode the staged packet gets the next sequence number and is kept
+*  for resending, even if it is dropped now the host can ask for it
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+static void Transport_CommitFrame(void)
+{
+    txFrameLeft = 0;
+    if(txFrameDropped)
+    {
+        txFrameDropped = false;
+        return;
+    }
+
+#ifdef TRANSPORT_FRAMED
+    if(TRANSPORT_MODE_FRAMED == transportMode)
+    {
+        txFrameBuf[0] = txSeq++;
+        txFrameBuf[1] = FRAME_TYPE_DATA;
+        Transport_HistoryStore(txFrameBuf, txFrameLen);
+        if(!Transport_FrameOut(txFrameBuf, txFrameLen))
+        {
+            return;
+        }
+    }
+    else
+#endif /* TRANSPORT_FRAMED */
+    {
+        Transport_TxPublish();
+    }
+
+    txStats.framesSent++;
+}
+
+/*******************************************************************************
+* Function Name: Transport_OpenFrame
+********************************************************************************
+*
+* Summary:
+*  Reserves room for an event frame in the circular buffer
+*
+* Parameters:
+*  length - total frame size in bytes, including the event header code
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  A frame is only ever queued whole. Without room, a frame raised from the
+*  BLE stack callback is dropped, any other sender waits a bounded time for the DMA
+*  to make room, see Transport_Reserve.
+*  In framed mode the packet is staged and the room taken when it is complete.
+*
+* Side Effects:
+*  A frame left open with bytes missing is sent as it is
+*
+* Note:
+*
+*******************************************************************************/
+void Transport_OpenFrame(uint16 length)
+{
+    if(CYDMA_INVALID_CHANNEL == txDmaChannel)
+    {
+        return;
+    }
+
+    if(0 != txFrameLeft)
+    {
+        Transport_CommitFrame();
+    }
+
+    if(0 == length)
+    {
+        return;
+    }
+
+#ifdef TRANSPORT_FRAMED
+    if(TRANSPORT_MODE_FRAMED == transportMode)
+    {
+        txFrameLen = FRAME_HEADER_SIZE;
+        if(length > TRANSPORT_FRAME_BODY_MAX)
+        {
+            txFrameDropped = true;
+            txStats.framesDropped++;
+            txStats.bytesDropped += length;
+        }
+    }
+    else
+#endif /* TRANSPORT_FRAMED */
+    {
+        txFrameDropped = !Transport_Reserve(length);
+    }
+    txFrameLeft = length;
+}
+
+/*******************************************************************************
+* Function Name: Transport_Write
+********************************************************************************
+*
+* Summary:
+*  Appends bytes to the open frame, the frame is sent once it is complete
+*
+* Parameters:
+*  data - bytes to send
+*
+*  length - number of bytes
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  Bytes beyond the open frame, or written with no frame open, are sent as a
+*  frame of their own so the byte stream stays what the caller wrote
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+void Transport_Write(const uint8 *data, uint32 length)
+{
+    uint32 limit = TRANSPORT_TX_RING_SIZE;
+    uint32 offset;
+    uint32 count;
+    uint32 chunk;
+
+    if(CYDMA_INVALID_CHANNEL == txDmaChannel)
+    {
+        UART_SpiUartPutArray(data, length);
+        return;
+    }
+
+#ifdef TRANSPORT_FRAMED
+    if(TRANSPORT_MODE_FRAMED == transportMode)
+    {
+        limit = TRANSPORT_FRAME_BODY_MAX;
+    }
+#endif /* TRANSPORT_FRAMED */
+
+    while(0 != length)
+    {
+        if(0 == txFrameLeft)
+        {
+            Transport_OpenFrame((length > limit) ? (uint16)limit : (uint16)length);
+        }
+
+        count = (length < txFrameLeft) ? length : txFrameLeft;
+        if(!txFrameDropped)
+        {
+#ifdef TRANSPORT_FRAMED
+            if(TRANSPORT_MODE_FRAMED == transportMode)
+            {
+                memcpy(&txFrameBuf[txFrameLen], data, count);
+                txFrameLen += (uint16)count;
+            }
+            else
+#endif /* TRANSPORT_FRAMED */
+            {
+                offset = txWritePos & TRANSPORT_TX_RING_MASK;
+                chunk = TRANSPORT_TX_RING_SIZE - offset;
+                if(chunk > count)
+                {
+                    chunk = count;
+                }
+                memcpy(&txRing[offset], data, chunk);
+                memcpy(txRing, &data[chunk], count - chunk);
+                txWritePos += count;
+            }
+        }
+
+        data += count;
+        length -= count;
+        txFrameLeft -= (uint16)count;
+        if(0 == txFrameLeft)
+        {
+            Transport_CommitFrame();
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: Transport_TxIdle
+********************************************************************************
+*
+* Summary:
+*  Checks whether all queued frames have been transmitted
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  bool - true if the circular buffer, UART buffer and TX FIFO are empty
+*
+* Theory:
+*  NONE
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+bool Transport_TxIdle(void)
+{
+    return (txWritePos == txReadPos) && (0 == txFrameLeft) &&
+            (0 == (UART_SpiUartGetTxBufferSize() + UART_GET_TX_FIFO_SR_VALID));
+}
+
+/*******************************************************************************
+* Function Name: Transport_GetTxStats
+********************************************************************************
+*
+* Summary:
+*  Returns the counters of sent, delayed and dropped event frames
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  CY_TX_STATS* - transmit counters, updated in place
+*
+* Theory:
+*  NONE
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+const CY_TX_STATS *Transport_GetTxStats(void)
+{
+    return &txStats;
+}
+#endif /* TRANSPORT_TX_DMA */
+
+#ifdef TRANSPORT_FRAMED
+/*******************************************************************************
+* Function Name: Transport_SendControl
+********************************************************************************
+*
+* Summary:
+*  Sends a NAK or GONE frame
+*
+* Parameters:
+*  type - FRAME_TYPE_NAK or FRAME_TYPE_GONE
+*
+*  seq  - sequence number of the DATA frame it is about
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  NONE
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+static void Transport_SendControl(uint8 type, uint8 seq)
+{
+    uint8 frame[FRAME_HEADER_SIZE];
+
+    frame[0] = seq;
+    frame[1] = type;
+    (void)Transport_FrameOut(frame, FRAME_HEADER_SIZE);
+}
+
+/*******************************************************************************
+* Function Name: Transport_RequestResend
+********************************************************************************
+*
+* Summary:
+*  Asks the host for the next expected DATA frame and those after it
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  Frames are only taken in order, so everything from the expected one on has
+*  to come again. One NAK is sent per expected frame, if that is lost too the
+*  host resends on its own timeout.
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+static void Transport_RequestResend(void)
+{
+    if(!rxNakSent)
+    {
+        rxNakSent = true;
+        Transport_SendControl(FRAME_TYPE_NAK, rxSeqExpected);
+    }
+}
+
 /*******************************************************************************
-* Function Name: Transport_RX_ISR
+* Function Name: Transport_Resend
 ********************************************************************************
 *
 * Summary:
-*  Handles the Interrupt Service Routine for the UART RX.
-*  Contains cmdRxState machine to check for valid command receipt and triggers flag
+*  Sends a DATA frame again for a NAK from the host
 *
 * Parameters:
-*  NONE
+*  seq - sequence number of the frame
 *
 * Return:
 *  NONE
@@ -69,151 +1760,402 @@ volatile static uint32 rxCnt = 0;
 *  NONE
 *
 * Side Effects:
-*  Command buffers and newCmdRxDoneFlag will be modified
+*  GONE is sent if the frame is no longer in the history
 *
 * Note:
 *
 *******************************************************************************/
-CY_ISR(Transport_RX_ISR)
+static void Transport_Resend(uint8 seq)
 {
-    volatile static uint16 expectedPktLength;
-    uint8 *currentPktBuf = primaryCmdRxBuf;
-        
-    if(UART_CHECK_INTR_RX_MASKED(UART_INTR_RX_NOT_EMPTY))
-    {    
-        /* Use secondary buffer if primary command is in progress */
-        if(primaryCmdInProgress)
+    CY_TX_HISTORY *entry = &txHistory[seq % TRANSPORT_TX_HISTORY_FRAMES];
+
+    if(entry->valid && (seq == entry->seq))
+    {
+        (void)Transport_FrameOut(&txHistoryBuf[entry->offset], entry->length);
+    }
+    else
+    {
+        Transport_SendControl(FRAME_TYPE_GONE, seq);
+    }
+}
+
+/*******************************************************************************
+* Function Name: Transport_CobsDecode
+********************************************************************************
+*
+* Summary:
+*  Decodes a received frame in place
+*
+* Parameters:
+*  buf    - encoded frame without its delimiter
+*
+*  length - number of bytes at buf
+*
+* Return:
+*  uint16 - decoded length, 0 if a code byte runs past the end
+*
+* Theory:
+*  The decoded bytes never get ahead of the encoded ones
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+static uint16 Transport_CobsDecode(uint8 *buf, uint16 length)
+{
+    uint16 in = 0;
+    uint16 out = 0;
+    uint8 code;
+    uint8 i;
+
+    while(in < length)
+    {
+        code = buf[in++];
+        if((in + code - 1u) > length)
         {
-            currentPktBuf = secondaryCmdRxBuf;
+            return 0;
         }
-
-        /* Check if secondary command has been detected and ignore the new bytes until secondary command is processed */
-        if((currentPktBuf == secondaryCmdRxBuf) && newCmdRxDoneFlag)
+        for(i = 1u; i < code; i++)
         {
-            UART_ClearRxInterruptSource(UART_INTR_RX_NOT_EMPTY);
-            return;
+            buf[out++] = buf[in++];
+        }
+        if((0xFFu != code) && (in < length))
+        {
+            buf[out++] = 0x00u;
         }
+    }
+    return out;
+}
 
-        while(0 != UART_SpiUartGetRxBufferSize())
+/*******************************************************************************
+* Function Name: Transport_FeedFrame
+********************************************************************************
+*
+* Summary:
+*  Runs the packet of the accepted DATA frame through Transport_Parse
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  bool - false while the packet waits for a command slot
+*
+* Theory:
+*  A frame carries one whole packet, whatever is left of a short one is dropped
+*
+* Side Effects:
+*  Command slots and newCmdRxDoneFlag will be modified
+*
+* Note:
+*
+*******************************************************************************/
+static bool Transport_FeedFrame(void)
+{
+    for(;;)
+    {
+        if(STATE_SLOT == cmdRxState)
+        {
+            return false;
+        }
+        if(rxFrameFed >= rxFrameEnd)
         {
-            /* Get each input byte into buffer, before checking for cmdRxState transition */
-            currentPktBuf[rxCnt++] = (uint8)UART_SpiUartReadRxData();
+            break;
+        }
+        rxFrameFed += (uint16)Transport_Parse(&rxFrameBuf[rxFrameFed], (uint32)rxFrameEnd - rxFrameFed);
+    }
 
-            /* restart the timer on each received byte */
-            Timer_10ms_Stop();
-            Timer_10ms_Start();
+    if((STATE_HEADER != cmdRxState) || (0 != rxCnt))
+    {
+        Transport_Reset();
+    }
+    rxFrameFed = 0;
+    rxFrameEnd = 0;
+    return true;
+}
 
-            /* State machine implementation for decoding received packet
-                    over UART.
-                    There are 3 states in this implementation. 
-                    1. Receive commands
-                    2. Receive packet length
-                    3. Receive payload */
-            switch(cmdRxState) 
-            {
-                case STATE_HEADER: 
-                    /* Header is 2 byte value, wait until it is received */
-                    expectedPktLength = 0;
-                    
-                    if(sizeof(uint16) <= rxCnt)
-                    {
-                        if((0x43 == currentPktBuf[0]) && (0x59 == currentPktBuf[1]))
-                        {
-                            cmdRxState = STATE_COMMAND;
-                        }
-                        /* Reset the byte counter if header is not detected */
-                        rxCnt = 0;
-                    }
-                    break;
+/*******************************************************************************
+* Function Name: Transport_FrameIn
+********************************************************************************
+*
+* Summary:
+*  Checks a received frame at its delimiter and acts on it
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  The next DATA frame in order is accepted, one ahead of it or a damaged
+*  frame means frames were lost and a NAK goes out, a repeated one is ignored.
+*  A NAK from the host is answered from the history.
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+static void Transport_FrameIn(void)
+{
+    uint16 length = Transport_CobsDecode(rxFrameBuf, rxFrameLen);
+    uint8 seq;
 
-                /* cmdRxState to receive command code of incoming data */
-                case STATE_COMMAND: 
-                    /* command code is 2 byte value, wait until it is received */
-                    expectedPktLength = 0;
+    if((length < (FRAME_HEADER_SIZE + FRAME_CRC_SIZE)) ||
+       (Transport_Crc16(0xFFFFu, rxFrameBuf, (uint32)length - FRAME_CRC_SIZE) !=
+            CyBle_Get16ByPtr(&rxFrameBuf[length - FRAME_CRC_SIZE])))
+    {
+        Transport_RequestResend();
+        return;
+    }
 
-                    if(sizeof(uint16)== rxCnt)
-                    {
-                        cmdRxState = STATE_LENGTH;
-                    }
-                    break;
+    length -= FRAME_CRC_SIZE;
+    seq = rxFrameBuf[0];
+    switch(rxFrameBuf[1])
+    {
+        case FRAME_TYPE_DATA:
+            if(seq == rxSeqExpected)
+            {
+                rxSeqExpected++;
+                rxNakSent = false;
+                rxFrameFed = FRAME_HEADER_SIZE;
+                rxFrameEnd = length;
+            }
+            else if((uint8)(seq - rxSeqExpected) < 0x80u)
+            {
+                Transport_RequestResend();
+            }
+            else
+            {
+                /* Already taken, the host resent it after a NAK */
+            }
+            break;
 
-                /* cmdRxState to receive payload length */
-                case STATE_LENGTH:
-                    if(COMMAND_HEADER_SIZE == rxCnt)
-                    {
-                        expectedPktLength = CyBle_Get16ByPtr(&currentPktBuf[sizeof(uint16)]);
-                        if(expectedPktLength > MAX_PAYLOAD_SIZE)
-                        {
-                            /* If payload size is big, discard remaining packet data */
-                            rxCnt = 0;
-                            cmdRxState = STATE_HEADER;
-                            /* Set the flag, to send out error response */
-                            newCmdRxDoneFlag = true;
-
-                            /* Stop the timer as complete packet is received */
-                            Timer_10ms_Stop();
-                            break;
-                        }
-                        else if(0 != expectedPktLength)
-                        {
-                            cmdRxState = STATE_PAYLOAD;
-                        }
-                        else
-                        {
-                            rxCnt = 0;
-                            cmdRxState = STATE_HEADER;
-                            /* Done flag to indicate that the RX packet decoding is complete */
-                            newCmdRxDoneFlag = true;
-
-                            /* Stop the timer as complete packet is received */
-                            Timer_10ms_Stop();
-                            break;
-                        }
-                    }
-                    else
-                    {
-                        /* wait until 2 byte length value is received */
-                        expectedPktLength = 0;
-                    }
-                    break;
+        case FRAME_TYPE_NAK:
+            Transport_Resend(seq);
+            break;
 
-                /* cmdRxState to receive payload data */
-                case STATE_PAYLOAD: 
-                    /* Decrement the payload length on each byte reception */
-                    if(0 != expectedPktLength)
-                    {
-                        expectedPktLength--;
-                    }
+        default:
+            /* Do Nothing, unknown frame type */
+            break;
+    }
+}
 
-                    /* Set complete flag, If last byte occurs */
-                    if(0 == expectedPktLength)
-                    {
-                        rxCnt = 0;
-                        cmdRxState = STATE_HEADER;
-                        /* Done flag to indicate that the RX packet decoding is complete */
-                        newCmdRxDoneFlag = true;
+/*******************************************************************************
+* Function Name: Transport_ParseFramed
+********************************************************************************
+*
+* Summary:
+*  Collects received bytes into frames and passes their packets on
+*
+* Parameters:
+*  data   - received bytes
+*  length - number of bytes at data
+*
+* Return:
+*  uint32 - bytes consumed, less than length while a packet waits for a command slot
+*
+* Theory:
+*  A frame too long for rxFrameBuf is dropped up to its delimiter and counts
+*  as damaged
+*
+* Side Effects:
+*  Command slots and newCmdRxDoneFlag will be modified
+*
+* Note:
+*
+*******************************************************************************/
+static uint32 Transport_ParseFramed(const uint8 *data, uint32 length)
+{
+    uint32 used = 0;
+    uint8 byte;
 
-                        /* Stop the timer as complete packet is received */
-                        Timer_10ms_Stop();
-                    }
-                    break;
+    while(used < length)
+    {
+        if((0 != rxFrameEnd) && (!Transport_FeedFrame()))
+        {
+            return used;
+        }
 
-                default:
-                    /* Do Nothing, invalid cmdRxState */
-                    break;    
+        byte = data[used++];
+        if(0x00u != byte)
+        {
+            if(rxFrameLen < sizeof(rxFrameBuf))
+            {
+                rxFrameBuf[rxFrameLen++] = byte;
+            }
+            else
+            {
+                rxFrameSkip = true;
             }
         }
-        UART_ClearRxInterruptSource(UART_INTR_RX_NOT_EMPTY);
+        else
+        {
+            if(rxFrameSkip)
+            {
+                Transport_RequestResend();
+            }
+            else if(0 != rxFrameLen)
+            {
+                Transport_FrameIn();
+            }
+            else
+            {
+                /* Empty frame, a host may send a delimiter to flush noise */
+            }
+            rxFrameLen = 0;
+            rxFrameSkip = false;
+        }
     }
-    if(UART_CHECK_INTR_RX_MASKED(UART_INTR_RX_BREAK_DETECT | UART_INTR_RX_OVERFLOW))
-    {    
-        /* Break can occur on start of each command, reset cmdRxState machine and RX buffers */
-        cmdRxState = STATE_HEADER;
-        rxCnt = 0;
-        UART_ClearRxInterruptSource(UART_INTR_RX_BREAK_DETECT);
-        UART_ClearRxInterruptSource(UART_INTR_RX_OVERFLOW);
+
+    if(0 != rxFrameEnd)
+    {
+        (void)Transport_FeedFrame();
+    }
+    return used;
+}
+
+/*******************************************************************************
+* Function Name: Transport_BaudDivider
+********************************************************************************
+*
+* Summary:
+*  Works out the UART clock divider for a baud rate
+*
+* Parameters:
+*  baud - bits per second
+*
+* Return:
+*  uint32 - divider in 1/32 steps, 0 if the clock can't be divided to it
+*
+* Theory:
+*  The SCB clock runs at UART_UART_OVS_FACTOR times the baud rate, divided
+*  from HFCLK by a 16.5 fractional divider
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+static uint32 Transport_BaudDivider(uint32 baud)
+{
+    uint32 rate;
+    uint32 divider;
+
+    if((0 == baud) || (baud > (CYDEV_BCLK__HFCLK__HZ / UART_UART_OVS_FACTOR)))
+    {
+        return 0;
+    }
+
+    rate = baud * UART_UART_OVS_FACTOR;
+    divider = ((CYDEV_BCLK__HFCLK__HZ * 32u) + (rate / 2u)) / rate;
+    if(divider > (0x10000uL << 5))
+    {
+        return 0;
+    }
+    return divider;
+}
+
+/*******************************************************************************
+* Function Name: Transport_ApplyMode
+********************************************************************************
+*
+* Summary:
+*  Switches to the mode and baud rate the host asked for
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  Both directions start again at sequence number 0
+*
+* Side Effects:
+*  A partially received packet is discarded
+*
+* Note:
+*  Call only once the TX side is idle, the host waits before it sends in the new mode
+*
+*******************************************************************************/
+static void Transport_ApplyMode(void)
+{
+    uint32 divider;
+    uint8 i;
+
+    modeSwitchPending = false;
+
+    if(0 != pendingBaud)
+    {
+        divider = Transport_BaudDivider(pendingBaud);
+        UART_SCBCLK_SetFractionalDividerRegister((uint16)((divider >> 5) - 1u), (uint8)(divider & 0x1Fu));
+    }
+
+    transportMode = pendingMode;
+    txSeq = 0;
+    txHistoryPos = 0;
+    for(i = 0; i < TRANSPORT_TX_HISTORY_FRAMES; i++)
+    {
+        txHistory[i].valid = false;
+    }
+
+    rxSeqExpected = 0;
+    rxNakSent = false;
+    rxFrameLen = 0;
+    rxFrameSkip = false;
+    rxFrameFed = 0;
+    rxFrameEnd = 0;
+
+    Timer_10ms_Stop();
+    rxTimeoutFlag = false;
+    Transport_Reset();
+}
+
+/*******************************************************************************
+* Function Name: Transport_SetMode
+********************************************************************************
+*
+* Summary:
+*  Requests a switch between the plain byte stream and framed mode
+*
+* Parameters:
+*  mode - TRANSPORT_MODE_LEGACY or TRANSPORT_MODE_FRAMED
+*
+*  baud - new baud rate, 0 keeps the current one
+*
+* Return:
+*  bool - false for an unknown mode, a baud rate out of reach or no DMA channels
+*
+* Theory:
+*  The switch is made by Transport_Process once every queued frame has left,
+*  so the command complete event still goes out in the old mode
+*
+* Side Effects:
+*  NONE
+*
+* Note:
+*
+*******************************************************************************/
+bool Transport_SetMode(uint8 mode, uint32 baud)
+{
+    if((mode > TRANSPORT_MODE_FRAMED) ||
+       (CYDMA_INVALID_CHANNEL == rxDmaChannel) || (CYDMA_INVALID_CHANNEL == txDmaChannel) ||
+       ((0 != baud) && (0 == Transport_BaudDivider(baud))))
+    {
+        return false;
     }
+
+    pendingMode = mode;
+    pendingBaud = baud;
+    modeSwitchPending = true;
+    return true;
 }
+#endif /* TRANSPORT_FRAMED */
 
 /*******************************************************************************
 * Function Name: Transport_Timer_ISR
@@ -237,6 +2179,7 @@ CY_ISR(Transport_RX_ISR)
 *  State machine and other parameters will be reset
 *
 * Note:
+*  With TRANSPORT_RX_DMA the reset is left to Transport_Process
 *
 *******************************************************************************/
 CY_ISR(Transport_Timer_ISR)
@@ -246,8 +2189,11 @@ CY_ISR(Transport_Timer_ISR)
     if(Timer_10ms_INTR_MASK_TC == intrSrc)
     {
         /* Reset RX state machine */
-        cmdRxState = STATE_HEADER;
-        rxCnt = 0;
+#ifdef TRANSPORT_RX_DMA
+        rxTimeoutFlag = true;
+#else
+        Transport_Reset();
+#endif /* TRANSPORT_RX_DMA */
         Timer_10ms_ClearInterrupt(intrSrc);
     }
     else
@@ -56,23 +56,132 @@
 /* Secondary command payload maximum derived by CMD_PAIRING_PASSKEY_RESPONSE, all other commands are smaller */
 #define SECONDARY_CMD_BUFF_SIZE              (8u + COMMAND_HEADER_SIZE)
 
+/* Received command packets wait in slots until CySmt_ProcessCommands dispatches them.
+        The last free slot is kept for commands that may run next to a primary command,
+        so a host keeping at most (CMD_QUEUE_SLOTS - 1) commands outstanding can always stop one */
+#define CMD_QUEUE_SLOTS                      (8u)
+
+/* Packets up to SECONDARY_CMD_BUFF_SIZE are kept in the slot, larger ones in a shared pool */
+#define CMD_QUEUE_POOL_SIZE                  (2u * PRIMARY_CMD_BUFF_SIZE)
+
+/* RX bytes are moved by DMA into a circular buffer and framed by Transport_Process() from the main loop,
+        instead of framing each byte in Transport_RX_ISR. Off until TRANSPORT_RX_DMA_TR_SEL is checked
+        on a board, see Tools/CySmtSim/CySmtTransportBench.c for both paths at line rate */
+/* #define TRANSPORT_RX_DMA */
+
+#ifdef TRANSPORT_RX_DMA
+/* Circular receive buffer, a power of two split into two DMA descriptors of half the size each */
+#define TRANSPORT_RX_RING_SIZE               (512u)
+#define TRANSPORT_RX_RING_MASK               (TRANSPORT_RX_RING_SIZE - 1u)
+#define TRANSPORT_RX_RING_HALF               (TRANSPORT_RX_RING_SIZE / 2u)
+
+/* Trigger group 0 input carrying the UART SCB rx_tr_out, routed to the allocated DMA channel.
+        TopDesign has no DMA component, confirm against the trigger table of the part */
+#define TRANSPORT_RX_DMA_TR_SEL              (1u)
+#endif /* TRANSPORT_RX_DMA */
+
+/* Events are built as whole frames in a circular buffer and moved to the UART TX FIFO by DMA,
+        so no sender waits on the UART, instead of being written with UART_SpiUartPutArray.
+        Off until TRANSPORT_TX_DMA_TR_SEL is checked on a board */
+/* #define TRANSPORT_TX_DMA */
+
+#ifdef TRANSPORT_TX_DMA
+/* Circular transmit buffer, a power of two that holds the largest event frame */
+#define TRANSPORT_TX_RING_SIZE               (1024u)
+#define TRANSPORT_TX_RING_MASK               (TRANSPORT_TX_RING_SIZE - 1u)
+
+/* The DMA is triggered while the TX FIFO holds fewer entries than this */
+#define TRANSPORT_TX_FIFO_LEVEL              (4u)
+
+/* Trigger group 0 input carrying the UART SCB tx_tr_out, confirm against the trigger table of the part */
+#define TRANSPORT_TX_DMA_TR_SEL              (2u)
+
+/* Longest wait for room in the circular buffer in us, the DMA empties a full one in under 90 ms
+        at 115200 baud. A frame that waited this long is dropped */
+#define TRANSPORT_TX_WAIT_US                 (100000u)
+
+#if (TRANSPORT_TX_RING_SIZE < (MAX_PAYLOAD_SIZE + 16u))
+#error "TRANSPORT_TX_RING_SIZE must hold an event frame of MAX_PAYLOAD_SIZE"
+#endif
+
+/* Transmit counters, a frame is delayed when its sender had to wait for room in the ring
+        and dropped when it was raised from the BLE stack callback with no room left,
+        or when the wait ran out. Timed out frames are counted in both */
+typedef struct _CY_TX_STATS
+{
+    uint32 framesSent;
+    uint32 framesDelayed;
+    uint32 framesDropped;
+    uint32 framesTimedOut;
+    uint32 bytesDropped;
+    /* Most bytes waiting in the ring at once */
+    uint16 peakUsed;
+}CY_TX_STATS;
+#endif /* TRANSPORT_TX_DMA */
+
+/* Framed mode, switched on by the host with CMD_SET_TRANSPORT_MODE. Every packet travels as one
+        COBS encoded frame (sequence number, type, packet, CRC-16) closed by a 0x00 delimiter,
+        so a corrupted frame is caught and the stream resynchronises on the next delimiter.
+        Needs TRANSPORT_RX_DMA and TRANSPORT_TX_DMA, off with them */
+/* #define TRANSPORT_FRAMED */
+
+#ifdef TRANSPORT_FRAMED
+#if !defined(TRANSPORT_RX_DMA) || !defined(TRANSPORT_TX_DMA)
+#error "TRANSPORT_FRAMED needs TRANSPORT_RX_DMA and TRANSPORT_TX_DMA"
+#endif
+
+#define TRANSPORT_MODE_LEGACY                (0x00u)
+#define TRANSPORT_MODE_FRAMED                (0x01u)
+
+/* Frame types. DATA carries one command or event packet unchanged, its sequence number counts
+        DATA frames per direction from 0 after the switch. NAK asks for the DATA frame with the
+        sequence number in its header, GONE answers a NAK for a frame no longer in the history */
+#define FRAME_TYPE_DATA                      (0x01u)
+#define FRAME_TYPE_NAK                       (0x02u)
+#define FRAME_TYPE_GONE                      (0x03u)
+
+#define FRAME_HEADER_SIZE                    (2u)
+#define FRAME_CRC_SIZE                       (2u)
+
+/* Encoded size of n frame bytes, with the COBS code bytes and the delimiter */
+#define FRAME_COBS_MAX(n)                    ((n) + ((n) / 254u) + 2u)
+
+/* Largest packet carried by one DATA frame */
+#define TRANSPORT_FRAME_BODY_MAX             (MAX_PAYLOAD_SIZE + 16u)
+
+/* Sent DATA frames are kept for resending, up to this many bytes and frames */
+#define TRANSPORT_TX_HISTORY_SIZE            (1024u)
+#define TRANSPORT_TX_HISTORY_FRAMES          (16u)
+
+#if (TRANSPORT_TX_RING_SIZE < FRAME_COBS_MAX(FRAME_HEADER_SIZE + TRANSPORT_FRAME_BODY_MAX + FRAME_CRC_SIZE))
+#error "TRANSPORT_TX_RING_SIZE must hold an encoded frame of TRANSPORT_FRAME_BODY_MAX"
+#endif
+#endif /* TRANSPORT_FRAMED */
+
 /* State machine implementation for decoding received packet
         over UART.
-        There are 3 states in this implementation. 
+        There are 4 states in this implementation. 
         1. Receive commands
         2. Receive packet length
-        3. Receive payload */
+        3. Wait for a free command slot
+        4. Receive payload */
 typedef enum _CY_RX_CMD_STATE
 {
     STATE_HEADER,
     STATE_COMMAND,
     STATE_LENGTH,
+    STATE_SLOT,
     STATE_PAYLOAD,     
 }CY_RX_CMD_STATE;
 
 
 #define ClearTXBuffer                        (UART_SpiUartClearTxBuffer)
+#ifdef TRANSPORT_TX_DMA
+#define TransmitAdditionalData               (Transport_Write)
+#else
 #define TransmitAdditionalData               (UART_SpiUartPutArray)
+#define Transport_OpenFrame(length)
+#endif /* TRANSPORT_TX_DMA */
 
 /* ISR callback for UART RX */
 CY_ISR_PROTO(Transport_RX_ISR);
@@ -80,13 +189,53 @@ CY_ISR_PROTO(Transport_RX_ISR);
 /* ISR callback for 10ms timer used in RX state machine */
 CY_ISR_PROTO(Transport_Timer_ISR);
 
+#ifdef TRANSPORT_RX_DMA
+/* Start the RX DMA into the circular buffer, call after UART_Start() */
+void Transport_Start(void);
+
+/* Frame received bytes into command packets, call from the main loop */
+void Transport_Process(void);
+#endif /* TRANSPORT_RX_DMA */
+
+#ifdef TRANSPORT_TX_DMA
+/* Start the TX DMA from the circular buffer, call after UART_Start() */
+void Transport_TxStart(void);
+
+/* Reserve room for an event frame of length bytes, the frame is sent once all of them are written */
+void Transport_OpenFrame(uint16 length);
+
+/* Append to the open frame, bytes written with no frame open are sent as a frame of their own */
+void Transport_Write(const uint8 *data, uint32 length);
+
+/* Returns true once every frame has left the TX FIFO */
+bool Transport_TxIdle(void);
+
+/* Returns the transmit counters */
+const CY_TX_STATS *Transport_GetTxStats(void);
+
+/* Set while the BLE stack callback runs, frames that find no room are then dropped instead of waited for */
+extern bool txInStackCallback;
+#endif /* TRANSPORT_TX_DMA */
+
+#ifdef TRANSPORT_FRAMED
+/* Switch to mode and, unless baud is 0, to a new baud rate once every queued frame has left.
+        Returns false for an unknown mode, a baud rate the UART clock can't reach or no DMA */
+bool Transport_SetMode(uint8 mode, uint32 baud);
+#endif /* TRANSPORT_FRAMED */
+
+/* Returns the received command packet at position (0 is the oldest) and its size, NULL past the last one */
+uint8 *Transport_PeekCmd(uint8 position, uint16 *size);
+
+/* Frees the command slot at position, later packets move up one position */
+void Transport_ReleaseCmd(uint8 position);
+
 /* Application buffer to cache primary command packet */
 extern uint8 primaryCmdRxBuf[PRIMARY_CMD_BUFF_SIZE];
 
 /* Application buffer to cache secondary command packet */
 extern uint8 secondaryCmdRxBuf[SECONDARY_CMD_BUFF_SIZE];
 
-/* Flag to indicate one complete command packet is detected */
+/* Flag to indicate complete command packets are waiting in the command slots */
 extern volatile bool newCmdRxDoneFlag; 
 
 #endif /* _CYSMT_TRANSPORT_LAYER_H_ */
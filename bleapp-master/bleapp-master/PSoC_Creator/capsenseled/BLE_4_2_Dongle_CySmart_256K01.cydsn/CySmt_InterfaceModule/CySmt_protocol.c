@@ -42,14 +42,15 @@
 * Header files
 *****************************************************************************/
 #include "CySmt_CommandLayer.h"
+#include "CySmt_Macro.h"
 
 /*****************************************************************************
 * Defines used in this file
 *****************************************************************************/
 #ifdef CYSMART_SUPPORT
 
-/* Wrapper for UART transmit */
-#define SendResponseData                            (UART_SpiUartPutArray)
+/* Wrapper for UART transmit, appends to the frame opened by Transport_OpenFrame() */
+#define SendResponseData                            (TransmitAdditionalData)
 
 /* CySmart event packet format for status and complete responses */
 typedef struct _Event_Status_Response
@@ -69,6 +70,9 @@ bool isCySBleStackOn = false;
 /* Status of last primary command */
 bool primaryCmdInProgress = false;
 
+/* Secondary command waiting for a stack event to complete */
+bool secondaryCmdInProgress = false;
+
 /* Global flag for CySmart tool connection with Dongle */
 bool isCySmtConnected = false; 
 
@@ -127,6 +131,28 @@ static const mapping generalMap[] =
 
     {(CHECK_PARAMETER_LENGTH | API_RETURN         | TRIGGER_COMPLETE),
         (HOST_CHANNEL_CLASSIFICATION_MAP_SIZE + sizeof(uint8)), Cmd_Set_HostChannelClassification_Api},
+
+    {(CHECK_PARAMETER_LENGTH | API_RETURN         | TRIGGER_COMPLETE),
+        (sizeof(uint8) + sizeof(uint16)), Cmd_Set_Scan_Aggregation_Api},
+
+    {(CHECK_PARAMETER_LENGTH | API_RETURN         | TRIGGER_COMPLETE),
+        (sizeof(uint8) + sizeof(uint16) + sizeof(uint32)), Cmd_Set_Notification_Batching_Api},
+
+    {(CHECK_PARAMETER_LENGTH | IMMEDIATE_RESPONSE | TRIGGER_COMPLETE),
+        0, Cmd_Get_Notification_Batch_Stats_Api},
+
+    {(CHECK_PARAMETER_LENGTH | API_RETURN         | TRIGGER_COMPLETE),
+        (sizeof(uint8) + sizeof(uint32)), Cmd_Set_Transport_Mode_Api},
+
+    {(CHECK_PARAMETER_LENGTH | IMMEDIATE_RESPONSE | TRIGGER_COMPLETE),
+        0, Cmd_Get_Cmd_Buffer_Stats_Api},
+
+    /* Complete is sent by CySmt_Macro at the end of the macro */
+    {(                         API_RETURN                           ),
+        0, Cmd_Run_Macro_Api},
+
+    {(CHECK_PARAMETER_LENGTH | API_RETURN         | TRIGGER_COMPLETE),
+        0, Cmd_Stop_Macro_Api},
 };
 
 static const mapping gapMap[] = 
@@ -445,9 +471,6 @@ void CyS_SendEvent(Event EventOpCode, uint16 CommandOpCode, uint16 addlDataLen,
     uint8 evtHeaderSize;
     uint16 evtHeader = CYSMT_EVT_HEADER_CODE;
 
-    /* Send out Header first, it will be followed by response packet */
-    SendResponseData((uint8 *)&evtHeader, sizeof(evtHeader));
-
     evt.evt_op_code = (uint16)EventOpCode;
 
     /* Add event op-code length to parameter size */
@@ -467,7 +490,13 @@ void CyS_SendEvent(Event EventOpCode, uint16 CommandOpCode, uint16 addlDataLen,
     
     /* Add additional data length which will be sent as follow-up packet */
     evt.lengthinbytes += addlDataLen;
-    
+
+    /* Whole event goes out as one frame, including the additional data */
+    Transport_OpenFrame(sizeof(evtHeader) + sizeof(evt.lengthinbytes) + evt.lengthinbytes);
+
+    /* Send out Header first, it will be followed by response packet */
+    SendResponseData((uint8 *)&evtHeader, sizeof(evtHeader));
+
     /* Send event header */
     SendResponseData((uint8 *)&evt, evtHeaderSize);
 
@@ -476,6 +505,8 @@ void CyS_SendEvent(Event EventOpCode, uint16 CommandOpCode, uint16 addlDataLen,
     {
         SendResponseData(parameters, ParamSize);
     }
+
+    CySmt_MacroEvent(EventOpCode, CommandOpCode, ParamSize, parameters);
 }
 
 /*******************************************************************************
@@ -517,17 +548,24 @@ void CySmt_SendCommandStatus(uint16 CommandOpCode, uint16 status)
         }
         else
         {
+            secondaryCmdInProgress = false;
             memset(secondaryCmdRxBuf, 0, sizeof(secondaryCmdRxBuf));
         }
     }
 
-    /* Send out Header first, it will be followed by response packet */
-    SendResponseData((uint8 *)&evtHeader, sizeof(evtHeader));
-
+    /* Macro steps report in EVT_MACRO_RESULT */
+    if(CySmt_MacroCommandResult(CommandOpCode, status, false))
+    {
+        return;
+    }
 
     /* Length for STATUS and COMPLETE events: 2 (EVT_OP_CODE) + 2 (CMD_OP_CODE) + 2 (STATUS) */
     evt.lengthinbytes = sizeof(evt.evt_op_code) + sizeof(CommandOpCode) + sizeof(evt.status);
 
+    /* Send out Header first, it will be followed by response packet */
+    Transport_OpenFrame(sizeof(evtHeader) + sizeof(evt.lengthinbytes) + evt.lengthinbytes);
+    SendResponseData((uint8 *)&evtHeader, sizeof(evtHeader));
+
     evt.evt_op_code = (uint16)EVT_COMMAND_STATUS;
     evt.cmd_op_code = CommandOpCode;
     evt.status = status;
@@ -563,9 +601,6 @@ void CySmt_SendCommandComplete(uint16 CommandOpCode, uint16 status)
     Event_Status_Response evt;
     uint16 evtHeader = CYSMT_EVT_HEADER_CODE;
 
-    /* Send out Header first, it will be followed by response packet */
-    SendResponseData((uint8 *)&evtHeader, sizeof(evtHeader));
-
     if(primaryCmd.opcode == CommandOpCode)
     {
         /* Primary command processing is complete */
@@ -575,6 +610,7 @@ void CySmt_SendCommandComplete(uint16 CommandOpCode, uint16 status)
     else
     {
         /* Secondary buffer should only be filled after current secondary command is completed */
+        secondaryCmdInProgress = false;
         memset(secondaryCmdRxBuf, 0, sizeof(secondaryCmdRxBuf));
     }
 
@@ -584,9 +620,19 @@ void CySmt_SendCommandComplete(uint16 CommandOpCode, uint16 status)
         isCySmtConnected = true;
     }
 
+    /* Macro steps report in EVT_MACRO_RESULT */
+    if(CySmt_MacroCommandResult(CommandOpCode, status, true))
+    {
+        return;
+    }
+
     /* Length for STATUS and COMPLETE events: 2 (EVT_OP_CODE) + 2 (CMD_OP_CODE) + 1 (STATUS) */
     evt.lengthinbytes = sizeof(evt.evt_op_code) + sizeof(CommandOpCode) + sizeof(evt.status);
 
+    /* Send out Header first, it will be followed by response packet */
+    Transport_OpenFrame(sizeof(evtHeader) + sizeof(evt.lengthinbytes) + evt.lengthinbytes);
+    SendResponseData((uint8 *)&evtHeader, sizeof(evtHeader));
+
     evt.evt_op_code = (uint16)EVT_COMMAND_COMPLETE;
     evt.cmd_op_code = CommandOpCode;
     evt.status = status;
@@ -643,19 +689,17 @@ static Command_Format* Get_Cmd(void)
 }
 
 /*******************************************************************************
-* Function Name: CySmt_ProcessCommands
+* Function Name: Get_Map
 ********************************************************************************
 *
 * Summary:
-* This function will trigger the required stack operations via command wrapper functions.
-*  It performs checks for validity of command before triggering the operation and uses
-*   command flags to process status/complete responses
+*  Utility function to find the command property map entry of an op-code
 *
 * Parameters:
-*  NONE
+*  opcode: Command op-code
 *
 * Return:
-*  NONE
+*  Pointer to the map entry, NULL for unsupported commands
 *
 * Theory:
 *  NONE
@@ -665,13 +709,11 @@ static Command_Format* Get_Cmd(void)
 * Note:
 *
 *******************************************************************************/
-void CySmt_ProcessCommands(void)
+static const mapping* Get_Map(uint16 opcode)
 {
-    CYBLE_API_RESULT_T status = CYBLE_ERROR_NO_CONNECTION;
     const mapping *map = NULL;
-    Command_Format *currentCmd = Get_Cmd();
-    uint8 commandID = currentCmd->opcode & CYS_CMD_CID_MASK;
-    Command_Group commandGrp = (Command_Group)((currentCmd->opcode >> CYS_CMD_CG_SHIFT) & CYS_CMD_CG_MASK);
+    uint8 commandID = opcode & CYS_CMD_CID_MASK;
+    Command_Group commandGrp = (Command_Group)((opcode >> CYS_CMD_CG_SHIFT) & CYS_CMD_CG_MASK);
 
     /* Check Command Group (CG) */
     switch(commandGrp)
@@ -718,13 +760,78 @@ void CySmt_ProcessCommands(void)
             /* Invalid group, return invalid operation */
             break;
     }
+    return map;
+}
+
+/*******************************************************************************
+* Function Name: CySmt_IsConcurrentCmd
+********************************************************************************
+*
+* Summary:
+*  Checks if a command may run while a primary command is in progress
+*
+* Parameters:
+*  opcode: Command op-code
+*
+* Return:
+*  bool - true for general commands and commands flagged SECONDARY_CMD
+*
+* Theory:
+*  NONE
+*
+* Side Effects:
+*
+* Note:
+*
+*******************************************************************************/
+bool CySmt_IsConcurrentCmd(uint16 opcode)
+{
+    const mapping *map = Get_Map(opcode);
+
+    return (GENERAL_GROUP == ((opcode >> CYS_CMD_CG_SHIFT) & CYS_CMD_CG_MASK)) ||
+           ((NULL != map) && (0 != (map->flags & SECONDARY_CMD)));
+}
+
+/*******************************************************************************
+* Function Name: CySmt_RunCommand
+********************************************************************************
+*
+* Summary:
+*  Runs the command copied into primaryCmdRxBuf, or into secondaryCmdRxBuf if
+*   a primary command is in progress
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  A secondary command stays in progress only if its completion comes from a
+*   stack event, i.e. it was accepted and its map has API_RETURN without TRIGGER_COMPLETE
+*
+* Side Effects:
+*
+* Note:
+*  Used by CySmt_ProcessCommands() for host commands and by CySmt_Macro for macro steps
+*
+*******************************************************************************/
+void CySmt_RunCommand(void)
+{
+    CYBLE_API_RESULT_T status = CYBLE_ERROR_NO_CONNECTION;
+    bool secondary = primaryCmdInProgress;
+    Command_Format *currentCmd = Get_Cmd();
+    const mapping *map = Get_Map(currentCmd->opcode);
+    Command_Group commandGrp = (Command_Group)((currentCmd->opcode >> CYS_CMD_CG_SHIFT) & CYS_CMD_CG_MASK);
+
+    if(secondary)
+    {
+        secondaryCmdInProgress = true;
+    }
 
     if( (!isCySBleStackOn) && (GENERAL_GROUP != commandGrp) )
     {
         /* Accept only general commands, If BLE stack is not running */
-        /* Clear this command, ISR can copy next command */
-        newCmdRxDoneFlag = false;
-
         CySmt_SendCommandStatus(currentCmd->opcode, CYBLE_ERROR_INVALID_OPERATION);
     }
 
@@ -732,25 +839,16 @@ void CySmt_ProcessCommands(void)
     if( (primaryCmdInProgress && (GENERAL_GROUP != commandGrp) && (!(map->flags & SECONDARY_CMD)))
           || (NULL == map) || (NULL == map->fnptr) )
     {
-        /* Clear this command, ISR can copy next command */
-        newCmdRxDoneFlag = false;
-
         CySmt_SendCommandStatus(currentCmd->opcode, CYBLE_ERROR_INVALID_OPERATION);
     }
     else if(MAX_PAYLOAD_SIZE < currentCmd->paramlen)
     {
-        /* Clear this command, ISR can copy next command */
-        newCmdRxDoneFlag = false;
-
         /* Command payload is too big to handle by Dongle, send error code */
         CySmt_SendCommandStatus(currentCmd->opcode, CYS_FW_ERR_INSUFFICIENT_RESOURCES);
     }
     else if( ((map->flags & CHECK_PARAMETER_LENGTH) && (map->AllowedParamSize != currentCmd->paramlen))
         || ( (currentCmd->paramlen) && (NULL == currentCmd->parameters)) )
     {
-        /* Clear this command, ISR can copy next command */
-        newCmdRxDoneFlag = false;
-
         /* Command parameters and length are invalid as per command definition */
         CySmt_SendCommandStatus(currentCmd->opcode, CYBLE_ERROR_INVALID_PARAMETER);
     }
@@ -768,9 +866,6 @@ void CySmt_ProcessCommands(void)
         /* Set command in progress flag */
         primaryCmdInProgress = true;
 
-        /* Clear this command, ISR can copy next command */
-        newCmdRxDoneFlag = false;
-
         /* Invoke the Command API */
         status = (map->fnptr(currentCmd));
 
@@ -786,6 +881,103 @@ void CySmt_ProcessCommands(void)
             CySmt_SendCommandComplete(currentCmd->opcode, status);
         }
     }
+
+    /* Release the secondary slot unless a stack event will complete the command */
+    if( secondary && !( (CYBLE_ERROR_OK == status) && (GENERAL_GROUP != commandGrp) && (NULL != map) &&
+          ((map->flags & (API_RETURN | TRIGGER_COMPLETE)) == API_RETURN) ) )
+    {
+        secondaryCmdInProgress = false;
+    }
+}
+
+/*******************************************************************************
+* Function Name: CySmt_ProcessCommands
+********************************************************************************
+*
+* Summary:
+* This function will trigger the required stack operations via command wrapper functions.
+*  It performs checks for validity of command before triggering the operation and uses
+*   command flags to process status/complete responses
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  Queued commands are visited oldest first. With no primary command in progress the
+*   oldest one starts as primary command, at most one per call so the main loop can free
+*   the command buffers of the previous one. While a primary command is in progress, queued commands
+*   that can run next to it start as secondary command, one at a time, and primary commands
+*   keep their place in the queue. Responses carry the op-code of their command, and no two
+*   commands with the same op-code are in progress at once, so they stay paired.
+*
+* Side Effects:
+*  newCmdRxDoneFlag stays set while commands are queued
+*
+* Note:
+*
+*******************************************************************************/
+void CySmt_ProcessCommands(void)
+{
+    uint8 *packet;
+    uint8 position = 0;
+    uint16 opcode;
+    uint16 size;
+    bool primaryStarted = false;
+
+    /* Cleared first, the transport sets it again for packets arriving meanwhile */
+    newCmdRxDoneFlag = false;
+
+    while(NULL != (packet = Transport_PeekCmd(position, &size)))
+    {
+        opcode = CyBle_Get16ByPtr(packet);
+
+        if(!primaryCmdInProgress)
+        {
+            if(primaryStarted)
+            {
+                /* Next primary command on the next call */
+                break;
+            }
+
+            if(CySmt_MacroRunning() && !CySmt_IsConcurrentCmd(opcode))
+            {
+                /* The macro's steps keep the primary slot, wait for its end */
+                position++;
+                continue;
+            }
+
+            /* Previous secondary commands complete with fixed op-codes, the slot is free again */
+            secondaryCmdInProgress = false;
+            memcpy(primaryCmdRxBuf, packet, size);
+            primaryStarted = true;
+        }
+        else if( (!secondaryCmdInProgress) && (opcode != primaryCmd.opcode) &&
+                 (SECONDARY_CMD_BUFF_SIZE >= size) && CySmt_IsConcurrentCmd(opcode) )
+        {
+            memcpy(secondaryCmdRxBuf, packet, size);
+        }
+        else
+        {
+            /* Wait for the command in progress, check the next one */
+            position++;
+            continue;
+        }
+
+        /* Free the slot before running, the command may take long */
+        Transport_ReleaseCmd(position);
+        CySmt_RunCommand();
+
+        /* Dispatch may have changed what can run, start again from the oldest */
+        position = 0;
+    }
+
+    if(NULL != Transport_PeekCmd(0, &size))
+    {
+        newCmdRxDoneFlag = true;
+    }
 }
 #endif /* CYSMART_SUPPORT */
 
@@ -124,6 +124,9 @@ typedef enum
     EVT_GET_DEVICE_DESCRIPTION_RESPONSE                         = 0x040Au,
     EVT_GET_HARDWARE_VERSION_RESPONSE                           = 0x040Bu,
     EVT_GET_TX_POWER_RESPONSE                                   = 0x040Cu,
+    EVT_GET_NOTIFICATION_BATCH_STATS_RESPONSE                   = 0x040Du,
+    EVT_GET_CMD_BUFFER_STATS_RESPONSE                           = 0x040Eu,
+    EVT_MACRO_RESULT                                            = 0x040Fu,
 
     /* FW specific events, not used by CySmart tool */
     HID_EP1_PACKET                                              = 0x0461u,
@@ -152,6 +155,7 @@ typedef enum
     EVT_EXCHANGE_GATT_MTU_SIZE_RESPONSE                         = 0x060Fu,
     EVT_GATT_STOP_NOTIFICATION                                  = 0x0610u,
     EVT_GATT_TIMEOUT_NOTIFICATION                               = 0x0611u,
+    EVT_CHARACTERISTIC_VALUE_NOTIFICATION_BATCH                 = 0x0612u,
 
     /* GAP Events */
     EVT_GET_DEVICE_IO_CAPABILITIES_RESPONSE                     = 0x0680u,
@@ -191,6 +195,7 @@ typedef enum
     EVT_GENERATE_SECURED_CONNECTION_OOB_DATA_RESPONSE           = 0x06A2u,
     EVT_NUMERIC_COMPARISON_REQUEST                              = 0x06A3u,
     EVT_NEGOTIATED_PAIRING_PARAMETERS                           = 0x06A4u,
+    EVT_SCAN_AGGREGATED_RESULT                                  = 0x06A5u,
 
     /* L2CAP Events */
     EVT_CBFC_CONNECTION_INDICATION                              = 0x0500u,
@@ -209,6 +214,13 @@ typedef enum
 {
     /* General Commands */
     CMD_INIT_BLE_STACK                                          = 0xFC07u,
+    CMD_SET_SCAN_AGGREGATION                                    = 0xFC11u,
+    CMD_SET_NOTIFICATION_BATCHING                               = 0xFC12u,
+    CMD_GET_NOTIFICATION_BATCH_STATS                            = 0xFC13u,
+    CMD_SET_TRANSPORT_MODE                                      = 0xFC14u,
+    CMD_GET_CMD_BUFFER_STATS                                    = 0xFC15u,
+    CMD_RUN_MACRO                                               = 0xFC16u,
+    CMD_STOP_MACRO                                              = 0xFC17u,
 
     /* Application specific Commands - Not to be used by CySmart protocol */
     CMD_PEER_ADDR_FROM_UART                                     = 0xFC61u,
@@ -245,6 +257,9 @@ extern bool isCySBleStackOn;
 /* Status of last primary command */
 extern bool primaryCmdInProgress; 
 
+/* Secondary command waiting for a stack event to complete */
+extern bool secondaryCmdInProgress;
+
 /* Global flag for CySmart tool connection with Dongle */
 extern bool isCySmtConnected;
 
@@ -350,7 +365,8 @@ extern void CySmt_SendCommandComplete(uint16 CommandOpCode, uint16 status);
 *  NONE
 *
 * Theory:
-*  NONE
+*  Dispatches queued commands: primary commands one at a time in order of arrival,
+*   commands that can run next to the primary command as soon as the secondary slot is free
 *
 * Side Effects:
 *
@@ -359,5 +375,54 @@ extern void CySmt_SendCommandComplete(uint16 CommandOpCode, uint16 status);
 *******************************************************************************/
 extern void CySmt_ProcessCommands(void);
 
+/*******************************************************************************
+* Function Name: CySmt_RunCommand
+********************************************************************************
+*
+* Summary:
+*  Runs the command copied into primaryCmdRxBuf, or into secondaryCmdRxBuf if
+*   a primary command is in progress
+*
+* Parameters:
+*  NONE
+*
+* Return:
+*  NONE
+*
+* Theory:
+*  A secondary command stays in progress only if its completion comes from a
+*   stack event, i.e. it was accepted and its map has API_RETURN without TRIGGER_COMPLETE
+*
+* Side Effects:
+*
+* Note:
+*  Used by CySmt_ProcessCommands() for host commands and by CySmt_Macro for macro steps
+*
+*******************************************************************************/
+extern void CySmt_RunCommand(void);
+
+/*******************************************************************************
+* Function Name: CySmt_IsConcurrentCmd
+********************************************************************************
+*
+* Summary:
+*  Checks if a command may run while a primary command is in progress
+*
+* Parameters:
+*  opcode: Command op-code
+*
+* Return:
+*  bool - true for general commands and commands flagged SECONDARY_CMD
+*
+* Theory:
+*  NONE
+*
+* Side Effects:
+*
+* Note:
+*
+*******************************************************************************/
+extern bool CySmt_IsConcurrentCmd(uint16 opcode);
+
 #endif /* _CYSMT_PROTOCOL_H_ */
 /* [] END OF FILE */
@@ -59,14 +59,17 @@
 
 #include "main.h"
 #include "Application.h"
+#ifdef CYSMART_SUPPORT
+#include "CySmt_BleEventHandler.h"
+#include "CySmt_CommandLayer.h"
+#include "CySmt_CmdBuffer.h"
+#include "CySmt_Macro.h"
+#endif /* CYSMART_SUPPORT */
 
 /*****************************************************************************
 * Global Variable Declarations
 *****************************************************************************/
 volatile bool dongleSuspend = false;
-#ifdef CYSMART_SUPPORT
-void* heapBuffer = NULL;
-#endif /* CYSMART_SUPPORT */
 
 /*******************************************************************************
 * Function Name: Device_Timer_Callback
@@ -150,6 +153,13 @@ static void Device_Init(void)
     UART_Start();
     UART_SetCustomInterruptHandler(Transport_RX_ISR);
     isr_10ms_StartEx(Transport_Timer_ISR);
+    CySmt_CmdBufferInit();
+#ifdef TRANSPORT_RX_DMA
+    Transport_Start();
+#endif /* TRANSPORT_RX_DMA */
+#ifdef TRANSPORT_TX_DMA
+    Transport_TxStart();
+#endif /* TRANSPORT_TX_DMA */
 #endif /* CYSMART_SUPPORT */
 
     Isr_Suspend_StartEx(Suspend_Cmd_ISR);
@@ -189,6 +199,11 @@ int main()
     {
         CyBle_ProcessEvents();
 
+#ifdef CYSMART_SUPPORT
+        /* Send batched notifications once the connection event is over */
+        CyS_NotificationBatchProcess();
+#endif /* CYSMART_SUPPORT */
+
         /* Check If suspend command has occurred */
         if(dongleSuspend)
         {
@@ -199,11 +214,22 @@ int main()
         {
 #ifdef CYSMART_SUPPORT
             /* Free-up the Write request buffer on primary command completion, if allocated */
-            if((!primaryCmdInProgress) && (NULL != heapBuffer))
+            if(!primaryCmdInProgress)
             {
-                free(heapBuffer);
+                CySmt_ReleaseCmdBuffers();
             }
 
+#ifdef TRANSPORT_RX_DMA
+            /* Frame the bytes received since the last pass */
+            Transport_Process();
+#endif /* TRANSPORT_RX_DMA */
+
+            /* Send merged advertisement reports whose window has passed */
+            CyS_ScanAggregationProcess();
+
+            /* Run the next macro step, ahead of host commands */
+            CySmt_MacroProcess();
+
             /* Start command processing, If complete command packet is received */
             if(newCmdRxDoneFlag)
             {
@@ -217,7 +243,9 @@ int main()
             }
 
             /* Wait until UART transmit is completed and no command is in progress */
-#ifdef CYSMART_SUPPORT
+#if defined(CYSMART_SUPPORT) && defined(TRANSPORT_TX_DMA)
+            if(Transport_TxIdle() && (!primaryCmdInProgress))
+#elif defined(CYSMART_SUPPORT)
             if((0 == (UART_SpiUartGetTxBufferSize() + UART_GET_TX_FIFO_SR_VALID)) && (!primaryCmdInProgress))
 #else
             if(0 == (UART_SpiUartGetTxBufferSize() + UART_GET_TX_FIFO_SR_VALID))
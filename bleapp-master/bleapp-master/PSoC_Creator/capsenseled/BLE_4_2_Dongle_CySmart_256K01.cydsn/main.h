@@ -47,8 +47,6 @@
 #include "timer.h"
 
 /* CySmart module enables custom serial protocol which will be used to communicate with CySmart PC Tool */
-/* Note: CySmart module uses Heap section for multiple write operation,
-        so make sure 1K of heap area is allocated */
 #define CYSMART_SUPPORT
 #ifdef CYSMART_SUPPORT
 #include "CySmt_protocol.h"
@@ -78,8 +76,6 @@
 
 #define MANUFACTURER_STRING     ("Cypress Semiconductor")
 
-extern void* heapBuffer;
-
 #endif /* CYSMART_SUPPORT */
 
 /* Wrapper functions for LED module */
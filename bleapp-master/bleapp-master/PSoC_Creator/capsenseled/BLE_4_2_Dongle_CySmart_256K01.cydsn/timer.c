@@ -61,6 +61,34 @@ static volatile uint32 tick;
 static uint8 tickIncrement;
 /* Variable to store the timer callback function */
 static TimerCBK timerCallBack = NULL;
+/* Milliseconds counted by the SysTick interrupt, for the microsecond time stamp */
+static volatile uint32 sysTickMs;
+
+/*****************************************************************************
+* Function Name: Timer_SysTick_CallBack()
+******************************************************************************
+* Summary:
+* SysTick callback, fires every millisecond
+*
+* Parameters:
+* None
+*
+* Return:
+* None
+*
+* Theory:
+* None
+*
+* Side Effects:
+* sysTickMs is incremented
+* 
+* Note:
+* None
+*****************************************************************************/
+static void Timer_SysTick_CallBack(void)
+{
+    sysTickMs++;
+}
 
 /*****************************************************************************
 * Function Name: Timer_CallBack()
@@ -149,6 +177,10 @@ void Timer_Init(TimerCBK cbk)
     CySysWdtLock();
 #endif /* ENABLE_TIMER_COMPONENT */
     tickIncrement = 1;
+
+    /* SysTick runs from the system clock with a 1 ms reload, for Timer_Get_Time_Stamp_Us */
+    CySysTickStart();
+    (void)CySysTickSetCallback(0u, Timer_SysTick_CallBack);
 }
 
 /*****************************************************************************
@@ -177,6 +209,44 @@ uint32 Timer_Get_Time_Stamp(void)
     return tick;
 }
 
+/*****************************************************************************
+* Function Name: Timer_Get_Time_Stamp_Us()
+******************************************************************************
+* Summary:
+* This function is used to get a microsecond timestamp
+*
+* Parameters:
+* None
+*
+* Return:
+* uint32 - Microseconds since Timer_Init, wraps after about 71 minutes
+*
+* Theory:
+* Milliseconds from the SysTick interrupt plus the fraction of the current
+* reload period that has counted down. The count is read again if the
+* interrupt fired in between.
+*
+* Side Effects:
+* None
+* 
+* Note:
+* SysTick stops in deep sleep, the time stamp does not advance there
+*****************************************************************************/
+uint32 Timer_Get_Time_Stamp_Us(void)
+{
+    uint32 ms;
+    uint32 count;
+    uint32 reload = CySysTickGetReload() + 1u;
+
+    do
+    {
+        ms = sysTickMs;
+        count = CySysTickGetValue();
+    } while(ms != sysTickMs);
+
+    return (ms * 1000u) + (((reload - count) * 1000u) / reload);
+}
+
 /*****************************************************************************
 * Function Name: Timer_Time_Elapsed()
 ******************************************************************************
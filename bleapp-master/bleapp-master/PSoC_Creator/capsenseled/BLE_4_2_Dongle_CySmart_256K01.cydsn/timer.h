@@ -118,6 +118,21 @@ extern void Timer_Init(TimerCBK cbk);
 *****************************************************************************/
 extern uint32 Timer_Get_Time_Stamp(void);
 
+/*****************************************************************************
+* Function Name: Timer_Get_Time_Stamp_Us()
+******************************************************************************
+* Summary:
+* This functions is used to get a microsecond timestamp from SysTick
+*
+* Parameters:
+* None
+*
+* Return:
+* uint32 - Microseconds since Timer_Init, compare by subtraction
+*
+*****************************************************************************/
+extern uint32 Timer_Get_Time_Stamp_Us(void);
+
 /*****************************************************************************
 * Function Name: Timer_Time_Elapsed()
 ******************************************************************************
@@ -153,6 +168,7 @@ extern void Timer_Set_Period(uint32 period);
 #else
 #define Timer_Init(cbk)
 #define Timer_Get_Time_Stamp()                  (0)
+#define Timer_Get_Time_Stamp_Us()               (0)
 #define Timer_Time_Elapsed(time_stamp,interval) (false)
 #define Timer_Set_Period(period)
 #endif /* DISABLE_TIMER */
@@ -10,6 +10,7 @@
  * ========================================
 */
 #include <project.h>
+#include "VentStatusCodec.h"
 
 #define CYBLE_MAX_ADV_DEVICES        10u
 
@@ -51,7 +52,24 @@ CYBLE_GAPC_ADV_REPORT_T 	list_of_devices[CYBLE_MAX_ADV_DEVICES];
 
 CYBLE_CONN_HANDLE_T			connectionHandle;
 
+/* Last status record from the vent and the notifications lost on the way */
+VENT_STATUS_T ventStatus;
+uint8 ventStatusValid = 0;
+uint32 ventStatusMissed = 0;
+
+/* Value handle of the status characteristic, looked up after discovery */
+CYBLE_GATT_DB_ATTR_HANDLE_T ventStatusHandle = CYBLE_GATT_INVALID_ATTR_HANDLE_VALUE;
+uint8 ventStatusSearching = 0;
+
+/* Characteristic declaration in a Read By Type response: handle,
+   properties, value handle, 128 bit UUID */
+#define CHAR_DECL_UUID128_LEN		(21u)
+#define CHAR_DECL_VALUE_HANDLE		(3u)
+#define CHAR_DECL_UUID				(5u)
+
 void HandleScanDevices(CYBLE_GAPC_ADV_REPORT_T* scanReport);
+void HandleNotification(CYBLE_GATTC_HANDLE_VALUE_NTF_PARAM_T* ntf);
+void HandleCharacteristics(CYBLE_GATTC_READ_BY_TYPE_RSP_PARAM_T* rsp);
 
 
 void Stack_Handler(uint32 eventCode, void* eventParam)
@@ -60,6 +78,8 @@ void Stack_Handler(uint32 eventCode, void* eventParam)
     
     CYBLE_GAPC_ADV_REPORT_T scanReport;
     
+    CYBLE_GATT_ATTR_HANDLE_RANGE_T range;
+    
     uint16 i = 0;
     
     switch(eventCode)
@@ -105,15 +125,40 @@ void Stack_Handler(uint32 eventCode, void* eventParam)
             
             addedDevices = 0;
             periphFound = 0;
+            ventStatusValid = 0;
+            ventStatusHandle = CYBLE_GATT_INVALID_ATTR_HANDLE_VALUE;
+            ventStatusSearching = 0;
             deviceConnected = 0;
             ble_state = BLE_DISCONNECTED;
             
             restartScanning = 1;
             
+            break;
+        case CYBLE_EVT_GATTC_HANDLE_VALUE_NTF:
+            HandleNotification((CYBLE_GATTC_HANDLE_VALUE_NTF_PARAM_T*) eventParam);
             break;
         case CYBLE_EVT_GATTC_DISCOVERY_COMPLETE:
             deviceConnected = 1;
             ble_state = BLE_CONNECTED;
+            
+            /* The vent services are not in our GATT client, walk all their
+               characteristics for the status one */
+            range.startHandle = 0x0001u;
+            range.endHandle = 0xFFFFu;
+            if (CyBle_GattcDiscoverAllCharacteristics(connectionHandle, range) == CYBLE_ERROR_OK)
+            {
+                ventStatusSearching = 1;
+            }
+            break;
+        case CYBLE_EVT_GATTC_READ_BY_TYPE_RSP:
+            if (ventStatusSearching)
+            {
+                HandleCharacteristics((CYBLE_GATTC_READ_BY_TYPE_RSP_PARAM_T*) eventParam);
+            }
+            break;
+        case CYBLE_EVT_GATTC_ERROR_RSP:
+            /* Attribute Not Found ends the walk */
+            ventStatusSearching = 0;
             break;
             
         default:
@@ -195,6 +240,54 @@ void HandleScanDevices(CYBLE_GAPC_ADV_REPORT_T* scanReport)
 		newDevice = 1;
 	}
 }
+void HandleCharacteristics(CYBLE_GATTC_READ_BY_TYPE_RSP_PARAM_T* rsp)
+{
+	uint8* decl;
+	uint16 i;
+	
+	if (rsp->attrData.length != CHAR_DECL_UUID128_LEN)
+	{
+		return;
+	}
+	
+	for (i = 0; i + CHAR_DECL_UUID128_LEN <= rsp->attrData.attrLen; i += CHAR_DECL_UUID128_LEN)
+	{
+		decl = &rsp->attrData.attrValue[i];
+		if (VentStatus_IsUuid(&decl[CHAR_DECL_UUID]))
+		{
+			ventStatusHandle = (CYBLE_GATT_DB_ATTR_HANDLE_T)(decl[CHAR_DECL_VALUE_HANDLE] |
+				((uint16)decl[CHAR_DECL_VALUE_HANDLE + 1u] << 8));
+			ventStatusSearching = 0;
+			CyBle_GattcStopCmd();
+			return;
+		}
+	}
+}
+void HandleNotification(CYBLE_GATTC_HANDLE_VALUE_NTF_PARAM_T* ntf)
+{
+	VENT_STATUS_T status;
+	
+	/* Only the status characteristic carries status records, the other
+		vent notifications are ignored here */
+	if ((ventStatusHandle == CYBLE_GATT_INVALID_ATTR_HANDLE_VALUE) ||
+		(ntf->handleValPair.attrHandle != ventStatusHandle))
+	{
+		return;
+	}
+	
+	if (!VentStatus_Decode(ntf->handleValPair.value.val, (uint8)ntf->handleValPair.value.len, &status))
+	{
+		return;
+	}
+	
+	/* The sequence counts every notification the vent sent */
+	if (ventStatusValid)
+	{
+		ventStatusMissed += (uint8)(status.sequence - ventStatus.sequence - 1u);
+	}
+	ventStatus = status;
+	ventStatusValid = 1;
+}
 int main()
 {
     /* Place your initialization/startup code here (e.g. MyInst_Start()) */
@@ -37,6 +37,7 @@ const CYBLE_CUSTOMS_T cyBle_customs[0x01u] = {
                 /* Array of Descriptors handles */
                 {
                     0x0013u, /* Handle of the Characteristic User Description descriptor */ 
+                    CYBLE_GATT_INVALID_ATTR_HANDLE_VALUE, 
                 }, 
             },
 
@@ -47,6 +48,40 @@ const CYBLE_CUSTOMS_T cyBle_customs[0x01u] = {
                 /* Array of Descriptors handles */
                 {
                     0x0016u, /* Handle of the Characteristic User Description descriptor */ 
+                    CYBLE_GATT_INVALID_ATTR_HANDLE_VALUE, 
+                }, 
+            },
+
+            /* Noise characteristic */
+            {
+                0x0018u, /* Handle of the Noise characteristic */ 
+                
+                /* Array of Descriptors handles */
+                {
+                    0x0019u, /* Handle of the Client Characteristic Configuration descriptor */ 
+                    0x001Au, /* Handle of the Characteristic User Description descriptor */ 
+                }, 
+            },
+
+            /* Status characteristic */
+            {
+                0x001Cu, /* Handle of the Status characteristic */ 
+                
+                /* Array of Descriptors handles */
+                {
+                    0x001Du, /* Handle of the Client Characteristic Configuration descriptor */ 
+                    0x001Eu, /* Handle of the Characteristic User Description descriptor */ 
+                }, 
+            },
+
+            /* Update characteristic */
+            {
+                0x0020u, /* Handle of the Update characteristic */ 
+                
+                /* Array of Descriptors handles */
+                {
+                    0x0021u, /* Handle of the Characteristic User Description descriptor */ 
+                    CYBLE_GATT_INVALID_ATTR_HANDLE_VALUE, 
                 }, 
             },
         }, 
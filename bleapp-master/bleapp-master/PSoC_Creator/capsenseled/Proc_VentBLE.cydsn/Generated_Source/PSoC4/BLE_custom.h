@@ -26,8 +26,8 @@
 /* Maximum supported Custom Services */
 #define CYBLE_CUSTOMS_SERVICE_COUNT                  (0x01u)
 #define CYBLE_CUSTOMC_SERVICE_COUNT                  (0x00u)
-#define CYBLE_CUSTOM_SERVICE_CHAR_COUNT              (0x02u)
-#define CYBLE_CUSTOM_SERVICE_CHAR_DESCRIPTORS_COUNT  (0x01u)
+#define CYBLE_CUSTOM_SERVICE_CHAR_COUNT              (0x05u)
+#define CYBLE_CUSTOM_SERVICE_CHAR_DESCRIPTORS_COUNT  (0x02u)
 
 /* Below are the indexes and handles of the defined Custom Services and their characteristics */
 #define CYBLE_VENTSERVICE_SERVICE_INDEX   (0x00u) /* Index of VentService service in the cyBle_customs array */
@@ -35,6 +35,14 @@
 #define CYBLE_VENTSERVICE_SERVO_CHARACTERISTIC_USER_DESCRIPTION_DESC_INDEX   (0x00u) /* Index of Characteristic User Description descriptor */
 #define CYBLE_VENTSERVICE_PRESSURE_CHAR_INDEX   (0x01u) /* Index of Pressure characteristic */
 #define CYBLE_VENTSERVICE_PRESSURE_CHARACTERISTIC_USER_DESCRIPTION_DESC_INDEX   (0x00u) /* Index of Characteristic User Description descriptor */
+#define CYBLE_VENTSERVICE_NOISE_CHAR_INDEX   (0x02u) /* Index of Noise characteristic */
+#define CYBLE_VENTSERVICE_NOISE_CLIENT_CHARACTERISTIC_CONFIGURATION_DESC_INDEX   (0x00u) /* Index of Client Characteristic Configuration descriptor */
+#define CYBLE_VENTSERVICE_NOISE_CHARACTERISTIC_USER_DESCRIPTION_DESC_INDEX   (0x01u) /* Index of Characteristic User Description descriptor */
+#define CYBLE_VENTSERVICE_STATUS_CHAR_INDEX   (0x03u) /* Index of Status characteristic */
+#define CYBLE_VENTSERVICE_STATUS_CLIENT_CHARACTERISTIC_CONFIGURATION_DESC_INDEX   (0x00u) /* Index of Client Characteristic Configuration descriptor */
+#define CYBLE_VENTSERVICE_STATUS_CHARACTERISTIC_USER_DESCRIPTION_DESC_INDEX   (0x01u) /* Index of Characteristic User Description descriptor */
+#define CYBLE_VENTSERVICE_UPDATE_CHAR_INDEX   (0x04u) /* Index of Update characteristic */
+#define CYBLE_VENTSERVICE_UPDATE_CHARACTERISTIC_USER_DESCRIPTION_DESC_INDEX   (0x00u) /* Index of Characteristic User Description descriptor */
 
 
 #define CYBLE_VENTSERVICE_SERVICE_HANDLE   (0x0010u) /* Handle of VentService service */
@@ -44,6 +52,17 @@
 #define CYBLE_VENTSERVICE_PRESSURE_DECL_HANDLE   (0x0014u) /* Handle of Pressure characteristic declaration */
 #define CYBLE_VENTSERVICE_PRESSURE_CHAR_HANDLE   (0x0015u) /* Handle of Pressure characteristic */
 #define CYBLE_VENTSERVICE_PRESSURE_CHARACTERISTIC_USER_DESCRIPTION_DESC_HANDLE   (0x0016u) /* Handle of Characteristic User Description descriptor */
+#define CYBLE_VENTSERVICE_NOISE_DECL_HANDLE   (0x0017u) /* Handle of Noise characteristic declaration */
+#define CYBLE_VENTSERVICE_NOISE_CHAR_HANDLE   (0x0018u) /* Handle of Noise characteristic */
+#define CYBLE_VENTSERVICE_NOISE_CLIENT_CHARACTERISTIC_CONFIGURATION_DESC_HANDLE   (0x0019u) /* Handle of Client Characteristic Configuration descriptor */
+#define CYBLE_VENTSERVICE_NOISE_CHARACTERISTIC_USER_DESCRIPTION_DESC_HANDLE   (0x001Au) /* Handle of Characteristic User Description descriptor */
+#define CYBLE_VENTSERVICE_STATUS_DECL_HANDLE   (0x001Bu) /* Handle of Status characteristic declaration */
+#define CYBLE_VENTSERVICE_STATUS_CHAR_HANDLE   (0x001Cu) /* Handle of Status characteristic */
+#define CYBLE_VENTSERVICE_STATUS_CLIENT_CHARACTERISTIC_CONFIGURATION_DESC_HANDLE   (0x001Du) /* Handle of Client Characteristic Configuration descriptor */
+#define CYBLE_VENTSERVICE_STATUS_CHARACTERISTIC_USER_DESCRIPTION_DESC_HANDLE   (0x001Eu) /* Handle of Characteristic User Description descriptor */
+#define CYBLE_VENTSERVICE_UPDATE_DECL_HANDLE   (0x001Fu) /* Handle of Update characteristic declaration */
+#define CYBLE_VENTSERVICE_UPDATE_CHAR_HANDLE   (0x0020u) /* Handle of Update characteristic */
+#define CYBLE_VENTSERVICE_UPDATE_CHARACTERISTIC_USER_DESCRIPTION_DESC_HANDLE   (0x0021u) /* Handle of Characteristic User Description descriptor */
 
 
 
@@ -79,20 +79,40 @@ CYBLE_STATE_T cyBle_state;
         0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u }, 
         {{
             0x00u, 0x00u,
+            0x00u, 0x00u,
+            0x00u, 0x00u,
+            0x00u, 0x00u,
+            0x00u, 0x00u,
         },
         {
             0x00u, 0x00u,
+            0x00u, 0x00u,
+            0x00u, 0x00u,
+            0x00u, 0x00u,
+            0x00u, 0x00u,
         },
         {
             0x00u, 0x00u,
+            0x00u, 0x00u,
+            0x00u, 0x00u,
+            0x00u, 0x00u,
+            0x00u, 0x00u,
         },
         {
             0x00u, 0x00u,
+            0x00u, 0x00u,
+            0x00u, 0x00u,
+            0x00u, 0x00u,
+            0x00u, 0x00u,
         },
         {
             0x00u, 0x00u,
+            0x00u, 0x00u,
+            0x00u, 0x00u,
+            0x00u, 0x00u,
+            0x00u, 0x00u,
         }}, 
-        0x02u, /* CYBLE_GATT_DB_CCCD_COUNT */ 
+        0x0Au, /* CYBLE_GATT_DB_CCCD_COUNT */ 
         0x05u, /* CYBLE_GAP_MAX_BONDED_DEVICE */ 
     };
 #endif /* (CYBLE_MODE_PROFILE) */
@@ -108,7 +128,7 @@ CYBLE_STATE_T cyBle_state;
     0x000Fu,    /* Handle of the Client Characteristic Configuration descriptor */
 };
     
-    static uint8 cyBle_attValues[0x34u] = {
+    static uint8 cyBle_attValues[0x85u] = {
     /* Device Name */
     (uint8)'V', (uint8)'e', (uint8)'n', (uint8)'t', (uint8)'U', (uint8)'n', (uint8)'i', (uint8)'t',
 
@@ -141,6 +161,40 @@ CYBLE_STATE_T cyBle_state;
     (uint8)'p', (uint8)'r', (uint8)'e', (uint8)'s', (uint8)'s', (uint8)'u', (uint8)'r', (uint8)'e', (uint8)' ',
     (uint8)'u', (uint8)'i', (uint8)'n', (uint8)'t', (uint8)'8',
 
+    /* Noise */
+    0x00u, 0x00u, 0x00u, 0x00u,
+
+    /* Characteristic User Description */
+    (uint8)'n', (uint8)'o', (uint8)'i', (uint8)'s', (uint8)'e', (uint8)' ', (uint8)'u', (uint8)'i', (uint8)'n',
+    (uint8)'t', (uint8)'8', (uint8)'[', (uint8)'4', (uint8)']',
+
+    /* Status */
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+
+    /* Characteristic User Description */
+    (uint8)'v', (uint8)'e', (uint8)'n', (uint8)'t', (uint8)' ', (uint8)'s', (uint8)'t', (uint8)'a', (uint8)'t',
+    (uint8)'u', (uint8)'s',
+
+    /* Update */
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+
+    /* Characteristic User Description */
+    (uint8)'v', (uint8)'e', (uint8)'n', (uint8)'t', (uint8)' ', (uint8)'u', (uint8)'p', (uint8)'d', (uint8)'a',
+    (uint8)'t', (uint8)'e',
+
+    /* Scan Interval Window */
+    0x00u, 0x00u, 0x00u, 0x00u,
+
+    /* Scan Refresh */
+    0x00u,
+
+    /* Battery Level */
+    0x00u,
+
+    /* Characteristic Presentation Format */
+    0x00u, 0x00u, 0x33u, 0x27u, 0x01u, 0x00u, 0x00u,
+
 };
 #if(CYBLE_GATT_DB_CCCD_COUNT != 0u)
 uint8 cyBle_attValuesCCCD[CYBLE_GATT_DB_CCCD_COUNT];
@@ -153,6 +207,12 @@ const uint8 cyBle_attUuid128[][16u] = {
     { 0xF3u, 0x34u, 0x9Bu, 0x5Fu, 0x80u, 0x00u, 0x00u, 0x80u, 0x00u, 0x10u, 0x00u, 0x00u, 0x12u, 0xBAu, 0x00u, 0x00u },
     /* Pressure */
     { 0xF1u, 0x34u, 0x9Bu, 0x5Fu, 0x80u, 0x00u, 0x00u, 0x80u, 0x00u, 0x10u, 0x00u, 0x00u, 0x12u, 0xBAu, 0x00u, 0x00u },
+    /* Noise */
+    { 0xF2u, 0x34u, 0x9Bu, 0x5Fu, 0x80u, 0x00u, 0x00u, 0x80u, 0x00u, 0x10u, 0x00u, 0x00u, 0x12u, 0xBAu, 0x00u, 0x00u },
+    /* Status */
+    { 0xF8u, 0x34u, 0x9Bu, 0x5Fu, 0x80u, 0x00u, 0x00u, 0x80u, 0x00u, 0x10u, 0x00u, 0x00u, 0x12u, 0xBAu, 0x00u, 0x00u },
+    /* Update */
+    { 0xF9u, 0x34u, 0x9Bu, 0x5Fu, 0x80u, 0x00u, 0x00u, 0x80u, 0x00u, 0x10u, 0x00u, 0x00u, 0x12u, 0xBAu, 0x00u, 0x00u },
 };
 
 CYBLE_GATTS_ATT_GEN_VAL_LEN_T cyBle_attValuesLen[CYBLE_GATT_DB_ATT_VAL_COUNT] = {
@@ -170,31 +230,70 @@ CYBLE_GATTS_ATT_GEN_VAL_LEN_T cyBle_attValuesLen[CYBLE_GATT_DB_ATT_VAL_COUNT] =
     { 0x0010u, (void *)&cyBle_attUuid128[2] }, /* Pressure UUID */
     { 0x0001u, (void *)&cyBle_attValues[37] }, /* Pressure */
     { 0x000Eu, (void *)&cyBle_attValues[38] }, /* Characteristic User Description */
+    { 0x0010u, (void *)&cyBle_attUuid128[3] }, /* Noise UUID */
+    { 0x0004u, (void *)&cyBle_attValues[52] }, /* Noise */
+    { 0x0002u, (void *)&cyBle_attValuesCCCD[2] }, /* Client Characteristic Configuration */
+    { 0x000Eu, (void *)&cyBle_attValues[56] }, /* Characteristic User Description */
+    { 0x0010u, (void *)&cyBle_attUuid128[4] }, /* Status UUID */
+    { 0x0008u, (void *)&cyBle_attValues[70] }, /* Status */
+    { 0x0002u, (void *)&cyBle_attValuesCCCD[4] }, /* Client Characteristic Configuration */
+    { 0x000Bu, (void *)&cyBle_attValues[78] }, /* Characteristic User Description */
+    { 0x0010u, (void *)&cyBle_attUuid128[5] }, /* Update UUID */
+    { 0x0014u, (void *)&cyBle_attValues[89] }, /* Update */
+    { 0x000Bu, (void *)&cyBle_attValues[109] }, /* Characteristic User Description */
+    { 0x0004u, (void *)&cyBle_attValues[120] }, /* Scan Interval Window */
+    { 0x0001u, (void *)&cyBle_attValues[124] }, /* Scan Refresh */
+    { 0x0002u, (void *)&cyBle_attValuesCCCD[6] }, /* Client Characteristic Configuration */
+    { 0x0001u, (void *)&cyBle_attValues[125] }, /* Battery Level */
+    { 0x0007u, (void *)&cyBle_attValues[126] }, /* Characteristic Presentation Format */
+    { 0x0002u, (void *)&cyBle_attValuesCCCD[8] }, /* Client Characteristic Configuration */
 };
 
-const CYBLE_GATTS_DB_T cyBle_gattDB[0x16u] = {
-    { 0x0001u, 0x2800u /* Primary service                     */, 0x00000001u /*       */, 0x000Bu, {{0x1800u, NULL}}                           },
-    { 0x0002u, 0x2803u /* Characteristic                      */, 0x00020001u /* rd    */, 0x0003u, {{0x2A00u, NULL}}                           },
-    { 0x0003u, 0x2A00u /* Device Name                         */, 0x01020001u /* rd    */, 0x0003u, {{0x0008u, (void *)&cyBle_attValuesLen[0]}} },
-    { 0x0004u, 0x2803u /* Characteristic                      */, 0x00020001u /* rd    */, 0x0005u, {{0x2A01u, NULL}}                           },
-    { 0x0005u, 0x2A01u /* Appearance                          */, 0x01020001u /* rd    */, 0x0005u, {{0x0002u, (void *)&cyBle_attValuesLen[1]}} },
-    { 0x0006u, 0x2803u /* Characteristic                      */, 0x00020001u /* rd    */, 0x0007u, {{0x2A04u, NULL}}                           },
-    { 0x0007u, 0x2A04u /* Peripheral Preferred Connection Par */, 0x01020001u /* rd    */, 0x0007u, {{0x0008u, (void *)&cyBle_attValuesLen[2]}} },
-    { 0x0008u, 0x2803u /* Characteristic                      */, 0x00020001u /* rd    */, 0x0009u, {{0x2AA6u, NULL}}                           },
-    { 0x0009u, 0x2AA6u /* Central Address Resolution          */, 0x01020001u /* rd    */, 0x0009u, {{0x0001u, (void *)&cyBle_attValuesLen[3]}} },
-    { 0x000Au, 0x2803u /* Characteristic                      */, 0x00020001u /* rd    */, 0x000Bu, {{0x2AC9u, NULL}}                           },
-    { 0x000Bu, 0x2AC9u /* Resolvable Private Address Only     */, 0x01020001u /* rd    */, 0x000Bu, {{0x0001u, (void *)&cyBle_attValuesLen[4]}} },
-    { 0x000Cu, 0x2800u /* Primary service                     */, 0x00000001u /*       */, 0x000Fu, {{0x1801u, NULL}}                           },
-    { 0x000Du, 0x2803u /* Characteristic                      */, 0x00200001u /* ind   */, 0x000Fu, {{0x2A05u, NULL}}                           },
-    { 0x000Eu, 0x2A05u /* Service Changed                     */, 0x01200000u /* ind   */, 0x000Fu, {{0x0004u, (void *)&cyBle_attValuesLen[5]}} },
-    { 0x000Fu, 0x2902u /* Client Characteristic Configuration */, 0x010A0101u /* rd,wr */, 0x000Fu, {{0x0002u, (void *)&cyBle_attValuesLen[6]}} },
-    { 0x0010u, 0x2800u /* Primary service                     */, 0x08000001u /*       */, 0x0016u, {{0x0010u, (void *)&cyBle_attValuesLen[7]}} },
-    { 0x0011u, 0x2803u /* Characteristic                      */, 0x000A0001u /* rd,wr */, 0x0013u, {{0x0010u, (void *)&cyBle_attValuesLen[8]}} },
-    { 0x0012u, 0xBA12u /* Servo                               */, 0x090A0101u /* rd,wr */, 0x0013u, {{0x0001u, (void *)&cyBle_attValuesLen[9]}} },
-    { 0x0013u, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd    */, 0x0013u, {{0x000Cu, (void *)&cyBle_attValuesLen[10]}} },
-    { 0x0014u, 0x2803u /* Characteristic                      */, 0x000A0001u /* rd,wr */, 0x0016u, {{0x0010u, (void *)&cyBle_attValuesLen[11]}} },
-    { 0x0015u, 0xBA12u /* Pressure                            */, 0x090A0101u /* rd,wr */, 0x0016u, {{0x0001u, (void *)&cyBle_attValuesLen[12]}} },
-    { 0x0016u, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd    */, 0x0016u, {{0x000Eu, (void *)&cyBle_attValuesLen[13]}} },
+const CYBLE_GATTS_DB_T cyBle_gattDB[0x2Cu] = {
+    { 0x0001u, 0x2800u /* Primary service                     */, 0x00000001u /*        */, 0x000Bu, {{0x1800u, NULL}}                           },
+    { 0x0002u, 0x2803u /* Characteristic                      */, 0x00020001u /* rd     */, 0x0003u, {{0x2A00u, NULL}}                           },
+    { 0x0003u, 0x2A00u /* Device Name                         */, 0x01020001u /* rd     */, 0x0003u, {{0x0008u, (void *)&cyBle_attValuesLen[0]}} },
+    { 0x0004u, 0x2803u /* Characteristic                      */, 0x00020001u /* rd     */, 0x0005u, {{0x2A01u, NULL}}                           },
+    { 0x0005u, 0x2A01u /* Appearance                          */, 0x01020001u /* rd     */, 0x0005u, {{0x0002u, (void *)&cyBle_attValuesLen[1]}} },
+    { 0x0006u, 0x2803u /* Characteristic                      */, 0x00020001u /* rd     */, 0x0007u, {{0x2A04u, NULL}}                           },
+    { 0x0007u, 0x2A04u /* Peripheral Preferred Connection Par */, 0x01020001u /* rd     */, 0x0007u, {{0x0008u, (void *)&cyBle_attValuesLen[2]}} },
+    { 0x0008u, 0x2803u /* Characteristic                      */, 0x00020001u /* rd     */, 0x0009u, {{0x2AA6u, NULL}}                           },
+    { 0x0009u, 0x2AA6u /* Central Address Resolution          */, 0x01020001u /* rd     */, 0x0009u, {{0x0001u, (void *)&cyBle_attValuesLen[3]}} },
+    { 0x000Au, 0x2803u /* Characteristic                      */, 0x00020001u /* rd     */, 0x000Bu, {{0x2AC9u, NULL}}                           },
+    { 0x000Bu, 0x2AC9u /* Resolvable Private Address Only     */, 0x01020001u /* rd     */, 0x000Bu, {{0x0001u, (void *)&cyBle_attValuesLen[4]}} },
+    { 0x000Cu, 0x2800u /* Primary service                     */, 0x00000001u /*        */, 0x000Fu, {{0x1801u, NULL}}                           },
+    { 0x000Du, 0x2803u /* Characteristic                      */, 0x00200001u /* ind    */, 0x000Fu, {{0x2A05u, NULL}}                           },
+    { 0x000Eu, 0x2A05u /* Service Changed                     */, 0x01200000u /* ind    */, 0x000Fu, {{0x0004u, (void *)&cyBle_attValuesLen[5]}} },
+    { 0x000Fu, 0x2902u /* Client Characteristic Configuration */, 0x010A0101u /* rd,wr  */, 0x000Fu, {{0x0002u, (void *)&cyBle_attValuesLen[6]}} },
+    { 0x0010u, 0x2800u /* Primary service                     */, 0x08000001u /*        */, 0x0021u, {{0x0010u, (void *)&cyBle_attValuesLen[7]}} },
+    { 0x0011u, 0x2803u /* Characteristic                      */, 0x000A0001u /* rd,wr  */, 0x0013u, {{0x0010u, (void *)&cyBle_attValuesLen[8]}} },
+    { 0x0012u, 0xBA12u /* Servo                               */, 0x090A0101u /* rd,wr  */, 0x0013u, {{0x0001u, (void *)&cyBle_attValuesLen[9]}} },
+    { 0x0013u, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd     */, 0x0013u, {{0x000Cu, (void *)&cyBle_attValuesLen[10]}} },
+    { 0x0014u, 0x2803u /* Characteristic                      */, 0x000A0001u /* rd,wr  */, 0x0016u, {{0x0010u, (void *)&cyBle_attValuesLen[11]}} },
+    { 0x0015u, 0xBA12u /* Pressure                            */, 0x090A0101u /* rd,wr  */, 0x0016u, {{0x0001u, (void *)&cyBle_attValuesLen[12]}} },
+    { 0x0016u, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd     */, 0x0016u, {{0x000Eu, (void *)&cyBle_attValuesLen[13]}} },
+    { 0x0017u, 0x2803u /* Characteristic                      */, 0x00120001u /* rd,ntf */, 0x001Au, {{0x0010u, (void *)&cyBle_attValuesLen[14]}} },
+    { 0x0018u, 0xBA12u /* Noise                               */, 0x09120001u /* rd,ntf */, 0x001Au, {{0x0004u, (void *)&cyBle_attValuesLen[15]}} },
+    { 0x0019u, 0x2902u /* Client Characteristic Configuration */, 0x010A0101u /* rd,wr  */, 0x0019u, {{0x0002u, (void *)&cyBle_attValuesLen[16]}} },
+    { 0x001Au, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd     */, 0x001Au, {{0x000Eu, (void *)&cyBle_attValuesLen[17]}} },
+    { 0x001Bu, 0x2803u /* Characteristic                      */, 0x00120001u /* rd,ntf */, 0x001Eu, {{0x0010u, (void *)&cyBle_attValuesLen[18]}} },
+    { 0x001Cu, 0xBA12u /* Status                              */, 0x09120001u /* rd,ntf */, 0x001Eu, {{0x0008u, (void *)&cyBle_attValuesLen[19]}} },
+    { 0x001Du, 0x2902u /* Client Characteristic Configuration */, 0x010A0101u /* rd,wr  */, 0x001Du, {{0x0002u, (void *)&cyBle_attValuesLen[20]}} },
+    { 0x001Eu, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd     */, 0x001Eu, {{0x000Bu, (void *)&cyBle_attValuesLen[21]}} },
+    { 0x001Fu, 0x2803u /* Characteristic                      */, 0x00080001u /* wr     */, 0x0021u, {{0x0010u, (void *)&cyBle_attValuesLen[22]}} },
+    { 0x0020u, 0xBA12u /* Update                              */, 0x09080100u /* wr     */, 0x0021u, {{0x0014u, (void *)&cyBle_attValuesLen[23]}} },
+    { 0x0021u, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd     */, 0x0021u, {{0x000Bu, (void *)&cyBle_attValuesLen[24]}} },
+    { 0x0022u, 0x2800u /* Primary service                     */, 0x00000001u /*        */, 0x0027u, {{0x1813u, NULL}}                           },
+    { 0x0023u, 0x2803u /* Characteristic                      */, 0x00040001u /* wwr    */, 0x0024u, {{0x2A4Fu, NULL}}                           },
+    { 0x0024u, 0x2A4Fu /* Scan Interval Window                */, 0x01040100u /* wwr    */, 0x0024u, {{0x0004u, (void *)&cyBle_attValuesLen[25]}} },
+    { 0x0025u, 0x2803u /* Characteristic                      */, 0x00100001u /* ntf    */, 0x0027u, {{0x2A31u, NULL}}                           },
+    { 0x0026u, 0x2A31u /* Scan Refresh                        */, 0x01100000u /* ntf    */, 0x0027u, {{0x0001u, (void *)&cyBle_attValuesLen[26]}} },
+    { 0x0027u, 0x2902u /* Client Characteristic Configuration */, 0x010A0101u /* rd,wr  */, 0x0027u, {{0x0002u, (void *)&cyBle_attValuesLen[27]}} },
+    { 0x0028u, 0x2800u /* Primary service                     */, 0x00000001u /*        */, 0x002Cu, {{0x180Fu, NULL}}                           },
+    { 0x0029u, 0x2803u /* Characteristic                      */, 0x00120001u /* rd,ntf */, 0x002Cu, {{0x2A19u, NULL}}                           },
+    { 0x002Au, 0x2A19u /* Battery Level                       */, 0x01120001u /* rd,ntf */, 0x002Cu, {{0x0001u, (void *)&cyBle_attValuesLen[28]}} },
+    { 0x002Bu, 0x2904u /* Characteristic Presentation Format  */, 0x01020001u /* rd     */, 0x002Bu, {{0x0007u, (void *)&cyBle_attValuesLen[29]}} },
+    { 0x002Cu, 0x2902u /* Client Characteristic Configuration */, 0x010A0101u /* rd,wr  */, 0x002Cu, {{0x0002u, (void *)&cyBle_attValuesLen[30]}} },
 };
 
 
@@ -35,13 +35,13 @@
 
 #if(CYBLE_GATT_ROLE_SERVER)
 
-#define CYBLE_GATT_DB_INDEX_COUNT                    (0x0016u)
-#define CYBLE_GATT_DB_ATT_VAL_COUNT                  (0x0Eu)
-#define CYBLE_GATT_DB_MAX_VALUE_LEN                  (0x000Eu)
+#define CYBLE_GATT_DB_INDEX_COUNT                    (0x002Cu)
+#define CYBLE_GATT_DB_ATT_VAL_COUNT                  (0x1Fu)
+#define CYBLE_GATT_DB_MAX_VALUE_LEN                  (0x0014u)
 
 #endif /* CYBLE_GATT_ROLE_SERVER */
 
-#define CYBLE_GATT_DB_CCCD_COUNT                     (0x02u)
+#define CYBLE_GATT_DB_CCCD_COUNT                     (0x0Au)
 
 #if (CYBLE_GATT_DB_CCCD_COUNT == 0u)
     #define CYBLE_GATT_DB_FLASH_CCCD_COUNT          (1u)
@@ -51,6 +51,10 @@
 
 #define CYBLE_CUSTOM
 #define CYBLE_CUSTOM_SERVER
+#define CYBLE_SCPS
+#define CYBLE_SCPS_SERVER
+#define CYBLE_BAS
+#define CYBLE_BAS_SERVER
 
 
 /***************************************
@@ -230,7 +234,7 @@ void CyBle_GattcIndicationEventHandler(CYBLE_GATTC_HANDLE_VALUE_IND_PARAM_T *eve
     
 extern const CYBLE_GATTS_T cyBle_gatts;
 extern const CYBLE_GATTS_DB_T cyBle_gattDB[CYBLE_GATT_DB_INDEX_COUNT];
-extern const uint8 cyBle_attUuid128[3u][16u];
+extern const uint8 cyBle_attUuid128[6u][16u];
 
 #if(CYBLE_GATT_DB_CCCD_COUNT != 0u)
 extern uint8 cyBle_attValuesCCCD[CYBLE_GATT_DB_CCCD_COUNT];
@@ -14,6 +14,10 @@
     
     /*Define your macro callbacks here */
     /*For more information, refer to the Macro Callbacks topic in the PSoC Creator Help.*/
+
+    /* VentPressure collects the SAR results at end of scan */
+    #define ADC_SAR_Seq_1_ISR_INTERRUPT_CALLBACK
+    void ADC_SAR_Seq_1_ISR_InterruptCallback(void);
     
 #endif /* CYAPICALLBACKS_H */   
 /* [] */
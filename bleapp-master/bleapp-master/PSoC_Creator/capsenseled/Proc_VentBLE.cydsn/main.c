@@ -10,20 +10,335 @@
  * ========================================
 */
 #include "project.h"
+#include "VentMotion.h"
+#include "VentPublish.h"
+#include "VentPressure.h"
+#include "VentStore.h"
+#include "VentAdv.h"
+#include "VentBattery.h"
+#include "VentButton.h"
+#include "VentNoise.h"
+#include "VentStatus.h"
+#include "VentUpdate.h"
+
+/* Pressure publish policy, the characteristic has no CCCD so only the
+   GATT DB copy is kept current (ms, 2 Pa units) */
+#define PRESSURE_MIN_INTERVAL_MS    (1000u)
+#define PRESSURE_ABS_DELTA          (1u)
+
+
+/* Duct noise publish policy, one byte per band (ms, 1/4 log2 steps) */
+#define NOISE_MIN_INTERVAL_MS       (1000u)
+#define NOISE_ABS_DELTA             (4u)
+
+/* Status publish policy, the whole vent state in one bit-packed record
+   (ms, Pa, permille) */
+#define STATUS_MIN_INTERVAL_MS      (1000u)
+#define STATUS_MAX_SILENCE_MS       (60000u)
+#define STATUS_PRESSURE_DELTA       (2u)
+#define STATUS_POSITION_DELTA       (10u)
+
+/* Local override from the buttons, remote servo writes are ignored
+   until it times out or SW5 is held (permille, ms) */
+#define OVERRIDE_STEP               (100u)
+#define OVERRIDE_MS                 (3600000u)
 
 CYBLE_CONN_HANDLE_T connectionHandle;
 
 CYBLE_EVENT_T a;
 
+/* Log time continues after the newest stored record across resets */
+uint32 storeBase;
+uint32 storeTime;
+
+/* History record interval, set by the battery power policy (ms) */
+uint32 storeInterval;
+VENT_BATTERY_TIER_T powerTier;
+
+uint8 localOverride;
+uint32 overrideTime;
+uint16 overrideTarget;
+
+uint8 batteryNotify;
+
+VENT_PUBLISH_FIELD_T pressureFields[] =
+{
+    /* size, absDelta, relDelta */
+    { sizeof(int8), PRESSURE_ABS_DELTA, 0u, 0, 0 },
+};
+
+VENT_PUBLISH_GROUP_T pressureGroup =
+{
+    CYBLE_VENTSERVICE_PRESSURE_CHAR_HANDLE,
+    pressureFields,
+    sizeof(pressureFields) / sizeof(pressureFields[0]),
+    PRESSURE_MIN_INTERVAL_MS,
+    0u,
+    0,                      /* pack, fields one after the other */
+    0u, 0u, 0u, { 0u }, 0u, 0u, 0u, 0u
+};
+
+VENT_PUBLISH_FIELD_T noiseFields[VENT_NOISE_BANDS] =
+{
+    /* size, absDelta, relDelta */
+    { sizeof(uint8), NOISE_ABS_DELTA, 0u, 0, 0 },
+    { sizeof(uint8), NOISE_ABS_DELTA, 0u, 0, 0 },
+    { sizeof(uint8), NOISE_ABS_DELTA, 0u, 0, 0 },
+    { sizeof(uint8), NOISE_ABS_DELTA, 0u, 0, 0 },
+};
+
+VENT_PUBLISH_GROUP_T noiseGroup =
+{
+    CYBLE_VENTSERVICE_NOISE_CHAR_HANDLE,
+    noiseFields,
+    sizeof(noiseFields) / sizeof(noiseFields[0]),
+    NOISE_MIN_INTERVAL_MS,
+    0u,
+    0,                      /* pack, one byte per band */
+    0u, 0u, 0u, { 0u }, 0u, 0u, 0u, 0u
+};
+
+VENT_PUBLISH_FIELD_T statusFields[VENT_STATUS_FIELDS] =
+{
+    /* size, absDelta, relDelta, order as VENT_STATUS_FIELD_ */
+    { 0u, 0u,                    0u, 0, 0 },
+    { 0u, STATUS_POSITION_DELTA, 0u, 0, 0 },
+    { 0u, STATUS_PRESSURE_DELTA, 0u, 0, 0 },
+    { 0u, 1u,                    0u, 0, 0 },
+    { 0u, 0u,                    0u, 0, 0 },
+};
+
+VENT_PUBLISH_GROUP_T statusGroup =
+{
+    CYBLE_VENTSERVICE_STATUS_CHAR_HANDLE,
+    statusFields,
+    sizeof(statusFields) / sizeof(statusFields[0]),
+    STATUS_MIN_INTERVAL_MS,
+    STATUS_MAX_SILENCE_MS,
+    VentStatus_Pack,
+    0u, 0u, 0u, { 0u }, 0u, 0u, 0u, 0u
+};
+
+/* Counters seen by the last status update, a rise raises a fault */
+uint32 statusOverruns;
+uint32 statusStalls;
+
+/***************************************************************
+ * Scale the filtered pressure into the one byte characteristic
+ **************************************************************/
+void updatePressure()
+{
+    int32 value = VentPressure_GetPa() / VENT_PRESSURE_CHAR_UNIT_PA;
+
+    if (value > 127)
+        value = 127;
+    if (value < -128)
+        value = -128;
+    VentPublish_SetField(&pressureGroup, 0, value);
+}
+
+/***************************************************************
+ * Append a record to the SPI flash log once per interval
+ **************************************************************/
+void updateStore()
+{
+    VENT_LOG_RECORD_T record;
+    uint32 now = VentTimer_GetTimeStamp();
+
+    if (!VentTimer_Elapsed(storeTime, storeInterval))
+        return;
+    storeTime = now;
+
+    record.time = storeBase + now / 1000u;
+    record.temperature = VENT_STORE_NO_VALUE;
+    record.position = VentDamper_GetPosition();
+    record.pressure = (int16)VentPressure_GetPa();
+    VentStore_Append(&record);
+}
+
+/***************************************************************
+ * SW1/SW2 nudge the damper open/closed (repeating while held),
+ * SW3/SW4 open/close fully, holding SW5 hands control back
+ **************************************************************/
+void handleButtons()
+{
+    VENT_BUTTON_T button;
+    int32 target;
+
+    while (VentButton_GetEvent(&button))
+    {
+        if ((button.button == VENT_BUTTON_SW5) && (button.event == VENT_BUTTON_HOLD))
+        {
+            localOverride = 0;
+            continue;
+        }
+        if ((button.event != VENT_BUTTON_PRESS) &&
+            !((button.event == VENT_BUTTON_REPEAT) && (button.button <= VENT_BUTTON_SW2)))
+            continue;
+
+        if (!localOverride)
+        {
+            overrideTarget = VentDamper_GetPosition();
+            if (overrideTarget == VENT_DAMPER_POSITION_NONE)
+            {
+                overrideTarget = 0;
+            }
+        }
+        target = overrideTarget;
+
+        switch (button.button)
+        {
+            case VENT_BUTTON_SW1:
+                target += OVERRIDE_STEP;
+                break;
+            case VENT_BUTTON_SW2:
+                target -= OVERRIDE_STEP;
+                break;
+            case VENT_BUTTON_SW3:
+                target = VENT_DAMPER_POSITION_MAX;
+                break;
+            case VENT_BUTTON_SW4:
+                target = 0;
+                break;
+            default:
+                continue;
+        }
+        if (target < 0)
+            target = 0;
+        if (target > (int32)VENT_DAMPER_POSITION_MAX)
+            target = VENT_DAMPER_POSITION_MAX;
+
+        overrideTarget = (uint16)target;
+        localOverride = 1;
+        overrideTime = VentTimer_GetTimeStamp();
+        VentMotion_MoveTo(overrideTarget, VENT_MOTION_TRAPEZOID);
+    }
+
+    if (localOverride && VentTimer_Elapsed(overrideTime, OVERRIDE_MS))
+    {
+        localOverride = 0;
+    }
+}
+
+/***************************************************************
+ * Stretch sampling, advertising and servo refresh to the
+ * battery tier
+ **************************************************************/
+void applyPowerPolicy()
+{
+    const VENT_BATTERY_POLICY_T *policy = VentBattery_GetPolicy();
+
+    powerTier = VentBattery_GetTier();
+    storeInterval = policy->sampleInterval;
+    pressureGroup.minInterval = policy->sampleInterval;
+    statusGroup.minInterval = policy->sampleInterval;
+    VentAdv_SetTarget(policy->advTarget);
+    VentDamper_SetTiming(VENT_DAMPER_SETTLE_MS, policy->servoRefresh);
+    VentPressure_SetInterval(policy->sampleInterval);
+    VentNoise_SetInterval(policy->sampleInterval);
+}
+
+/***************************************************************
+ * Publish a new battery level through BAS
+ **************************************************************/
+void updateBattery()
+{
+    uint8 level = VentBattery_GetLevel();
+
+    CyBle_BassSetCharacteristicValue(0, CYBLE_BAS_BATTERY_LEVEL, sizeof(level), &level);
+    if (batteryNotify && (CyBle_GetState() == CYBLE_STATE_CONNECTED))
+    {
+        CyBle_BassSendNotification(cyBle_connHandle, 0, CYBLE_BAS_BATTERY_LEVEL, sizeof(level), &level);
+    }
+
+    if (VentBattery_GetTier() != powerTier)
+    {
+        applyPowerPolicy();
+    }
+}
+
+/***************************************************************
+ * Battery level notifications switched by the client
+ **************************************************************/
+void Bas_Handler(uint32 eventCode, void *eventParam)
+{
+    (void)eventParam;
+
+    if (eventCode == CYBLE_EVT_BASS_NOTIFICATION_ENABLED)
+    {
+        batteryNotify = 1;
+    }
+    if (eventCode == CYBLE_EVT_BASS_NOTIFICATION_DISABLED)
+    {
+        batteryNotify = 0;
+    }
+}
+
+/***************************************************************
+ * The hub writes its scan interval and window through SCPS
+ **************************************************************/
+void Scps_Handler(uint32 eventCode, void *eventParam)
+{
+    CYBLE_SCPS_CHAR_VALUE_T *charValue = (CYBLE_SCPS_CHAR_VALUE_T *)eventParam;
+
+    if ((eventCode == CYBLE_EVT_SCPSS_SCAN_INT_WIN_CHAR_WRITE) && (charValue->value->len >= 4u))
+    {
+        VentAdv_SetHubScan(CyBle_Get16ByPtr(charValue->value->val),
+                           CyBle_Get16ByPtr(charValue->value->val + 2));
+    }
+}
+
+/***************************************************************
+ * Copy the band levels of the last noise frame
+ **************************************************************/
+void updateNoise()
+{
+    uint8 band;
+
+    for (band = 0; band < VENT_NOISE_BANDS; band++)
+    {
+        VentPublish_SetField(&noiseGroup, band, VentNoise_GetLevel(band));
+    }
+}
+
+/***************************************************************
+ * Collect the vent state for the status characteristic
+ **************************************************************/
+void updateStatus()
+{
+    uint32 overruns = VentPressure_GetOverruns() + VentNoise_GetStats()->overruns + VentNoise_GetStats()->stalls;
+    uint32 stalls = VentStore_GetStats()->stalls;
+    uint8 faults = 0;
+
+    if (overruns != statusOverruns)
+        faults |= VENT_STATUS_FAULT_OVERRUN;
+    if (stalls != statusStalls)
+        faults |= VENT_STATUS_FAULT_STORAGE;
+    if (VentBattery_GetTier() >= VENT_BATTERY_LOW)
+        faults |= VENT_STATUS_FAULT_BATTERY;
+    if (localOverride)
+        faults |= VENT_STATUS_FLAG_OVERRIDE;
+    if (VentDamper_IsEnergised())
+        faults |= VENT_STATUS_FLAG_MOVING;
+    statusOverruns = overruns;
+    statusStalls = stalls;
+
+    VentPublish_SetField(&statusGroup, VENT_STATUS_FIELD_POSITION, VentDamper_GetPosition());
+    VentPublish_SetField(&statusGroup, VENT_STATUS_FIELD_PRESSURE, VentPressure_GetPa());
+    VentPublish_SetField(&statusGroup, VENT_STATUS_FIELD_BATTERY, VentBattery_GetLevel());
+    VentPublish_SetField(&statusGroup, VENT_STATUS_FIELD_FAULTS, faults);
+}
+
 void Stack_Handler( uint32 eventCode, void * eventParam)
 {
     
     CYBLE_GATTS_WRITE_CMD_REQ_PARAM_T* wrReq;
+    uint8 updateResult;
     
     switch (eventCode)
     {
         case CYBLE_EVT_STACK_ON:
-            CyBle_GappStartAdvertisement(CYBLE_ADVERTISING_FAST);
+            VentAdv_Start(VentTimer_GetTimeStamp());
 		
 		    break;
         case CYBLE_EVT_TIMEOUT:
@@ -35,7 +350,9 @@ void Stack_Handler( uint32 eventCode, void * eventParam)
             }
 	        break;
         case CYBLE_EVT_GAP_DEVICE_DISCONNECTED:
-            CyBle_GappStartAdvertisement(CYBLE_ADVERTISING_FAST);
+            VentPublish_Enable(&noiseGroup, 0);
+            VentPublish_Enable(&statusGroup, 0);
+            VentAdv_Start(VentTimer_GetTimeStamp());
             LED_Scan_Write(1);
             break;
         
@@ -43,52 +360,57 @@ void Stack_Handler( uint32 eventCode, void * eventParam)
 		/* Restart Advertisement if the state is disconnected */
 		if(CyBle_GetState() == CYBLE_STATE_DISCONNECTED )
 		{
-			CyBle_GappStartAdvertisement(CYBLE_ADVERTISING_FAST);
+			VentAdv_Start(VentTimer_GetTimeStamp());
 		}
 
         break;
         case CYBLE_EVT_GATT_CONNECT_IND:
             connectionHandle = *(CYBLE_CONN_HANDLE_T *)eventParam;
+            VentAdv_Connected(VentTimer_GetTimeStamp());
             LED_Scan_Write(0);
             break;
         case CYBLE_EVT_GATTS_WRITE_REQ:
             wrReq = (CYBLE_GATTS_WRITE_REQ_PARAM_T*)eventParam;
             if (wrReq->handleValPair.attrHandle == CYBLE_VENTSERVICE_PRESSURE_CHAR_HANDLE)
             {
-                CyBle_GattsWriteAttributeValue (&wrReq->handleValPair, 0, &connectionHandle, CYBLE_GATT_DB_LOCALLY_INITIATED);
+                /* The value is owned by the pressure pipeline, only the LED follows writes */
                 LED_Conf_Write(wrReq->handleValPair.value.val[0]);
             }
             if (wrReq->handleValPair.attrHandle == CYBLE_VENTSERVICE_SERVO_CHAR_HANDLE)
             {
-                switch (wrReq->handleValPair.value.val[0]) {
-                        case (0):
-                            PWM_Servo_WriteCompare(4315);
-                            //Timer_WritePeriod(1205);
-                            //Timer_Start();
-                        break;
-                        case (1):
-                            PWM_Servo_WriteCompare(4350);
-                            //Timer_WritePeriod(540);
-                            //Timer_Start();
-                        break;
-                        case (2):
-                            PWM_Servo_WriteCompare(4375);
-                            //Timer_WritePeriod(225);
-                            //Timer_Start();
-                        case (3):
-                            PWM_Servo_WriteCompare(4425);
-                        break;
-                        case (4):
-                            PWM_Servo_WriteCompare(4450);
-                        break;
-                        case (5):
-                            PWM_Servo_WriteCompare(4475);
-                        break;
-                    default:
-                            
-                        break;
+                /* Servo characteristic carries the legacy 0-5 steps */
+                if (!localOverride && (wrReq->handleValPair.value.val[0] <= VENT_DAMPER_LEGACY_STEPS))
+                {
+                    VentMotion_MoveTo(VENT_DAMPER_FROM_STEP(wrReq->handleValPair.value.val[0]), VENT_MOTION_SCURVE);
+                }
+            }
+            if (wrReq->handleValPair.attrHandle == CYBLE_VENTSERVICE_UPDATE_CHAR_HANDLE)
+            {
+                /* Firmware patch chunks, the hub repeats a chunk that is refused as busy
+                   and starts over after any other refusal */
+                updateResult = VentUpdate_Write(wrReq->handleValPair.value.val, wrReq->handleValPair.value.len);
+                if (updateResult != VENT_UPDATE_OK)
+                {
+                    CYBLE_GATTS_ERR_PARAM_T err;
+
+                    err.opcode = CYBLE_GATT_WRITE_REQ;
+                    err.attrHandle = wrReq->handleValPair.attrHandle;
+                    err.errorCode = (CYBLE_GATT_ERR_CODE_T)((updateResult == VENT_UPDATE_BUSY) ?
+                                    VENT_UPDATE_ATT_BUSY : VENT_UPDATE_ATT_REFUSED);
+                    CyBle_GattsErrorRsp(connectionHandle, &err);
+                    break;
                 }
             }
+            if (wrReq->handleValPair.attrHandle == CYBLE_VENTSERVICE_NOISE_CLIENT_CHARACTERISTIC_CONFIGURATION_DESC_HANDLE)
+            {
+                CyBle_GattsWriteAttributeValue(&wrReq->handleValPair, 0, &connectionHandle, CYBLE_GATT_DB_PEER_INITIATED);
+                VentPublish_Enable(&noiseGroup, wrReq->handleValPair.value.val[0] & 0x01u);
+            }
+            if (wrReq->handleValPair.attrHandle == CYBLE_VENTSERVICE_STATUS_CLIENT_CHARACTERISTIC_CONFIGURATION_DESC_HANDLE)
+            {
+                CyBle_GattsWriteAttributeValue(&wrReq->handleValPair, 0, &connectionHandle, CYBLE_GATT_DB_PEER_INITIATED);
+                VentPublish_Enable(&statusGroup, wrReq->handleValPair.value.val[0] & 0x01u);
+            }
             CyBle_GattsWriteRsp(connectionHandle);
             break;
         default:
@@ -98,19 +420,90 @@ void Stack_Handler( uint32 eventCode, void * eventParam)
     }
 }
 
+/***************************************************************
+ * Deep Sleep when the BLESS and every module allow it, else
+ * Sleep. Advertising never stops, so the next BLE event wakes
+ * the CPU at the latest, the buttons wake it too.
+ **************************************************************/
+void enterLowPower()
+{
+    CYBLE_BLESS_STATE_T blessState;
+    uint8 intState;
+
+    CyBle_EnterLPM(CYBLE_BLESS_DEEPSLEEP);
+
+    intState = CyEnterCriticalSection();
+    blessState = CyBle_GetBleSsState();
+    if (((blessState == CYBLE_BLESS_STATE_ECO_ON) || (blessState == CYBLE_BLESS_STATE_DEEPSLEEP)) &&
+        !VentPressure_IsBusy() && !VentNoise_IsBusy() && !VentDamper_IsEnergised() &&
+        !VentMotion_IsBusy() && !VentNor_IsTransferring())
+    {
+        /* SCB_1 keeps its setup idle, the SAR has to be parked */
+        ADC_SAR_Seq_1_Sleep();
+        CySysPmDeepSleep();
+        ADC_SAR_Seq_1_Wakeup();
+    }
+    else if (blessState != CYBLE_BLESS_STATE_EVENT_CLOSE)
+    {
+        /* ADC, I2S and DMA keep running in Sleep, the next buffer wakes the CPU */
+        CySysPmSleep();
+    }
+    CyExitCriticalSection(intState);
+}
+
 int main(void)
 {
     CyGlobalIntEnable; /* Enable global interrupts. */
 
     /* Place your initialization/startup code here (e.g. MyInst_Start()) */
 
-    PWM_Servo_Start();
+    VentTimer_Start();
+    VentDamper_Start();
+    VentMotion_Start();
+    VentPublish_Init(&pressureGroup);
+    VentPressure_Start();
+    VentNoise_Start();
+    VentPublish_Init(&noiseGroup);
+    VentPublish_Init(&statusGroup);
+    VentPublish_SetField(&statusGroup, VENT_STATUS_FIELD_TEMPERATURE, VENT_STATUS_NO_TEMPERATURE);
+    VentStore_Start();
+    storeBase = VentStore_LastTime() + 1u;
+    storeTime = VentTimer_GetTimeStamp();
+    VentUpdate_Start();
+    VentAdv_Init();
+    VentBattery_Start();
+    applyPowerPolicy();
+    VentButton_Start();
     CyBle_Start( Stack_Handler );
+    CyBle_ScpsRegisterAttrCallback(Scps_Handler);
+    CyBle_BasRegisterAttrCallback(Bas_Handler);
     LED_Conf_Write(0);
     LED_Scan_Write(1);
     for(;;)
     {
+        VentDamper_Process(VentTimer_GetTimeStamp());
+        if (VentPressure_Process())
+        {
+            updatePressure();
+        }
+        VentPublish_Process(&pressureGroup, VentTimer_GetTimeStamp());
+        if (VentNoise_Process())
+        {
+            updateNoise();
+        }
+        VentPublish_Process(&noiseGroup, VentTimer_GetTimeStamp());
+        if (VentBattery_Process(VentTimer_GetTimeStamp()))
+        {
+            updateBattery();
+        }
+        handleButtons();
+        updateStatus();
+        VentPublish_Process(&statusGroup, VentTimer_GetTimeStamp());
+        updateStore();
+        VentStore_Process();
+        VentUpdate_Process();
         CyBle_ProcessEvents();
+        enterLowPower();
     }
 }
 
@@ -0,0 +1,402 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+
+/* Host tool: protocol benchmark for the dongle or for CySmtSim.
+
+     c++ -std=c++11 -O2 -o CySmtBench CySmtBench.cpp CySmtClient.cpp CySmtFrame.c -lpthread
+     CySmtSim/CySmtSim -p /tmp/cysmt &
+     ./CySmtBench [-f] [-t seconds] [-n commands] [device]
+
+   The device defaults to /tmp/cysmt. Runs, in order:
+     - scan report rate, every report and merged per device
+     - connection to any peer
+     - commands per second with one command in flight and with the
+       whole window
+     - command latency for one command of each group: general, GAP,
+       GATT read and L2CAP
+     - notification rate, every notification and batched
+     - with -f, the command rate again in framed mode
+     - a connect, discover, enable notifications, read, disconnect flow,
+       driven command by command from here and run as one macro on the
+       dongle. Run the simulator with -b 115200 for the UART's share
+
+   Against the dongle the GATT and notification steps need a peer with a
+   notifying characteristic at 0x000A and its CCCD at 0x000B, as the
+   simulator's. Figures from the simulator are host timings, compare them
+   with each other only. */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "CySmtClient.h"
+
+using namespace cysmt;
+using Clock = std::chrono::steady_clock;
+
+/* Keep in step with CySmt_protocol.h */
+const uint16_t CMD_GET_DEVICE_ADDRESS = 0xFE82u;
+const uint16_t CMD_REGISTER_PSM = 0xFD00u;
+const uint16_t CMD_UNREGISTER_PSM = 0xFD01u;
+const uint16_t EVT_CHARACTERISTIC_VALUE_NOTIFICATION = 0x060Cu;
+const uint16_t EVT_CHARACTERISTIC_VALUE_NOTIFICATION_BATCH = 0x0612u;
+const uint16_t EVT_SCAN_PROGRESS_RESULT = 0x068Au;
+const uint16_t EVT_SCAN_AGGREGATED_RESULT = 0x06A5u;
+const uint16_t EVT_ESTABLISH_CONNECTION_RESPONSE = 0x068Fu;
+
+/* Keep in step with CySmt_BleEventHandler.h */
+const uint8_t SCAN_AGGR_PASSTHROUGH = 0u;
+const uint8_t SCAN_AGGR_BATCH = 1u;
+const uint16_t SCAN_AGGR_DEFAULT_WINDOW = 100u;
+const uint8_t NTF_BATCH_OFF = 0u;
+const uint8_t NTF_BATCH_ON = 1u;
+
+/* Handles of the simulator's peer, see simDb in CySmtSimStack.c */
+const uint16_t NTF_VALUE_HANDLE = 0x000Au;
+const uint16_t NTF_CCCD_HANDLE = 0x000Bu;
+const uint16_t L2CAP_PSM = 0x0081u;
+
+static std::atomic<uint64_t> notifications(0);
+static std::atomic<uint64_t> notificationEvents(0);
+
+/* Flow runs, each way */
+const unsigned FLOW_RUNS = 20u;
+
+/* ATT error code ending a discovery */
+const uint16_t ATT_ERR_ATTRIBUTE_NOT_FOUND = 0x0Au;
+
+static double seconds(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static Result check(Result result)
+{
+    if (result.status != 0u)
+    {
+        char text[64];
+
+        snprintf(text, sizeof(text), "command 0x%04X failed with 0x%04X", result.opcode, result.status);
+        throw std::runtime_error(text);
+    }
+    return result;
+}
+
+/* A discovery ends with an attribute not found error response at the end
+   of the range */
+static Result discovered(Result result)
+{
+    if (result.status == ATT_ERR_ATTRIBUTE_NOT_FOUND)
+    {
+        result.status = 0u;
+    }
+    return check(result);
+}
+
+static void scanRate(Client &client, uint8_t mode, double duration)
+{
+    uint64_t reports = 0, records = 0, events = 0;
+
+    check(client.call(cmd::setScanAggregation(mode, SCAN_AGGR_DEFAULT_WINDOW)));
+    std::future<Result> scan = client.send(cmd::startScan());
+    std::this_thread::sleep_for(std::chrono::duration<double>(duration));
+    check(client.call(cmd::stopScan()));
+
+    for (const Event &event : check(scan.get()).events)
+    {
+        if (event.code == EVT_SCAN_PROGRESS_RESULT)
+        {
+            events++;
+            reports++;
+            records++;
+        }
+        else if ((event.code == EVT_SCAN_AGGREGATED_RESULT) && !event.params.empty())
+        {
+            /* Count, then records of 14 bytes, the merged report count at 11, and the data */
+            size_t at = 1u;
+
+            events++;
+            for (uint8_t i = 0; (i < event.params[0]) && (at + 14u <= event.params.size()); i++)
+            {
+                reports += event.params[at + 11u] | (event.params[at + 12u] << 8);
+                records++;
+                at += 14u + event.params[at + 13u];
+            }
+        }
+    }
+    printf("  %-12s %8.0f reports/s in %8.0f events/s, %llu device records\n",
+           (mode == SCAN_AGGR_BATCH) ? "merged" : "every report", reports / duration, events / duration,
+           (unsigned long long)records);
+}
+
+static void commandRate(Client &client, size_t window, unsigned count)
+{
+    client.setWindow(window);
+    Clock::time_point start = Clock::now();
+    for (unsigned i = 0; i < count; i++)
+    {
+        client.send(cmd::getDeviceId(), [](const Result &) {});
+    }
+    client.drain();
+    double elapsed = seconds(start);
+    printf("  window %zu: %8.0f commands/s\n", window, count / elapsed);
+}
+
+static void latency(Client &client, const char *name, const std::vector<Command> &commands, unsigned count)
+{
+    std::vector<double> us;
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        for (const Command &command : commands)
+        {
+            Clock::time_point start = Clock::now();
+            check(client.call(command));
+            us.push_back(seconds(start) * 1e6);
+        }
+    }
+    std::sort(us.begin(), us.end());
+    printf("  %-8s min %7.0f  median %7.0f  p99 %7.0f  max %7.0f us\n", name, us.front(), us[us.size() / 2u],
+           us[(us.size() * 99u) / 100u], us.back());
+}
+
+static void notificationRate(Client &client, const ConnHandle &conn, uint8_t mode, double duration)
+{
+    check(client.call(cmd::setNotificationBatching(mode, 0u, 0u)));
+    check(client.call(cmd::writeCharacteristicDescriptor(conn, NTF_CCCD_HANDLE, {0x01u, 0x00u})));
+    uint64_t before = notifications, beforeEvents = notificationEvents;
+    Clock::time_point start = Clock::now();
+    std::this_thread::sleep_for(std::chrono::duration<double>(duration));
+    double elapsed = seconds(start);
+    uint64_t count = notifications - before, events = notificationEvents - beforeEvents;
+    check(client.call(cmd::writeCharacteristicDescriptor(conn, NTF_CCCD_HANDLE, {0x00u, 0x00u})));
+    printf("  %-12s %8.0f notifications/s in %8.0f events/s\n", (mode == NTF_BATCH_ON) ? "batched" : "every one",
+           count / elapsed, events / elapsed);
+}
+
+static ConnHandle connHandle(const Result &connected)
+{
+    ConnHandle conn;
+
+    for (const Event &event : connected.events)
+    {
+        if ((event.code == EVT_ESTABLISH_CONNECTION_RESPONSE) && (event.params.size() >= 2u))
+        {
+            conn.bdHandle = event.params[0];
+            conn.attId = event.params[1];
+        }
+    }
+    return conn;
+}
+
+static void printFlow(const char *name, std::vector<double> &ms)
+{
+    std::sort(ms.begin(), ms.end());
+    printf("  %-12s min %7.1f  median %7.1f  max %7.1f ms\n", name, ms.front(), ms[ms.size() / 2u], ms.back());
+}
+
+/* The flow from here, one command after the other */
+static double hostFlow(Client &client)
+{
+    Clock::time_point start = Clock::now();
+    ConnHandle conn = connHandle(check(client.call(cmd::establishConnection(BdAddr()))));
+
+    discovered(client.call(cmd::discoverAllPrimaryServices(conn)));
+    discovered(client.call(cmd::discoverAllCharacteristics(conn, 0x0001u, 0xFFFFu)));
+    check(client.call(cmd::writeCharacteristicDescriptor(conn, NTF_CCCD_HANDLE, {0x01u, 0x00u})));
+    check(client.call(cmd::readCharacteristicValue(conn, NTF_VALUE_HANDLE)));
+    check(client.call(cmd::writeCharacteristicDescriptor(conn, NTF_CCCD_HANDLE, {0x00u, 0x00u})));
+    check(client.call(cmd::terminateConnection(conn)));
+    return seconds(start) * 1e3;
+}
+
+/* The same flow as a macro, the connection handle comes from the connect response */
+static Macro flowMacro()
+{
+    const ConnHandle any;
+    Macro macro;
+
+    macro.command(cmd::establishConnection(BdAddr()))
+        .jumpIf(MACRO_IF_STATUS_NE, "end", 0u, 0u)
+        .jumpIf(MACRO_IF_EVENT_NE, "end", 0u, EVT_ESTABLISH_CONNECTION_RESPONSE)
+        .store(0u, 2u)
+        .onConnection(cmd::discoverAllPrimaryServices(any))
+        .jumpIf(MACRO_IF_STATUS_EQ, "characteristics", 0u, ATT_ERR_ATTRIBUTE_NOT_FOUND)
+        .jumpIf(MACRO_IF_STATUS_NE, "disconnect", 0u, 0u)
+        .label("characteristics")
+        .onConnection(cmd::discoverAllCharacteristics(any, 0x0001u, 0xFFFFu))
+        .jumpIf(MACRO_IF_STATUS_EQ, "cccd", 0u, ATT_ERR_ATTRIBUTE_NOT_FOUND)
+        .jumpIf(MACRO_IF_STATUS_NE, "disconnect", 0u, 0u)
+        .label("cccd")
+        .onConnection(cmd::writeCharacteristicDescriptor(any, NTF_CCCD_HANDLE, {0x01u, 0x00u}))
+        .jumpIf(MACRO_IF_STATUS_NE, "disconnect", 0u, 0u)
+        .onConnection(cmd::readCharacteristicValue(any, NTF_VALUE_HANDLE))
+        .onConnection(cmd::writeCharacteristicDescriptor(any, NTF_CCCD_HANDLE, {0x00u, 0x00u}))
+        .label("disconnect")
+        .onConnection(cmd::terminateConnection(any))
+        .label("end")
+        .end();
+    return macro;
+}
+
+static void flows(Client &client)
+{
+    const Command run = cmd::runMacro(flowMacro());
+    std::vector<double> host, macro, dongle;
+    size_t events = 0;
+
+    for (unsigned i = 0; i < FLOW_RUNS; i++)
+    {
+        host.push_back(hostFlow(client));
+
+        Clock::time_point start = Clock::now();
+        Result result = check(client.call(run));
+        macro.push_back(seconds(start) * 1e3);
+
+        /* Status, pc, steps, last opcode, then the dongle's own time in ms */
+        events = result.events.size();
+        const Event &last = result.events.back();
+        if ((last.code == EVT_MACRO_RESULT) && (last.params.size() >= 12u))
+        {
+            dongle.push_back(last.params[8] | (last.params[9] << 8) | (last.params[10] << 16) |
+                             ((uint32_t)last.params[11] << 24));
+        }
+    }
+    printFlow("host-driven", host);
+    printFlow("macro", macro);
+    if (!dongle.empty())
+        printFlow("  on dongle", dongle);
+    printf("  macro program %zu bytes, %zu events back\n", run.params().size(), events);
+}
+
+int main(int argc, char **argv)
+{
+    std::string device = "/tmp/cysmt";
+    double duration = 2.0;
+    unsigned count = 20000u;
+    bool framed = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "ft:n:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'f':
+            framed = true;
+            break;
+        case 't':
+            duration = atof(optarg);
+            break;
+        case 'n':
+            count = (unsigned)strtoul(optarg, nullptr, 0);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-f] [-t seconds] [-n commands] [device]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (optind < argc)
+    {
+        device = argv[optind];
+    }
+
+    try
+    {
+        /* The simulator may still be starting */
+        std::unique_ptr<Client> opened;
+        for (int retry = 0; !opened; retry++)
+        {
+            try
+            {
+                opened.reset(new Client(device, 115200u));
+            }
+            catch (const std::system_error &)
+            {
+                if (retry == 50)
+                    throw;
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+        }
+        Client &client = *opened;
+
+        client.onEvent([](const Event &event) {
+            if (event.code == EVT_CHARACTERISTIC_VALUE_NOTIFICATION)
+            {
+                notifications++;
+                notificationEvents++;
+            }
+            else if ((event.code == EVT_CHARACTERISTIC_VALUE_NOTIFICATION_BATCH) && !event.params.empty())
+            {
+                notifications += event.params[0];
+                notificationEvents++;
+            }
+        });
+
+        check(client.call(cmd::initBleStack()));
+
+        printf("scan, %.1f s each\n", duration);
+        scanRate(client, SCAN_AGGR_PASSTHROUGH, duration);
+        scanRate(client, SCAN_AGGR_BATCH, duration);
+        check(client.call(cmd::setScanAggregation(SCAN_AGGR_PASSTHROUGH, 0u)));
+
+        ConnHandle conn = connHandle(check(client.call(cmd::establishConnection(BdAddr()))));
+
+        printf("command rate, %u commands\n", count);
+        commandRate(client, 1u, count);
+        commandRate(client, DEFAULT_WINDOW, count);
+
+        printf("command latency, one in flight\n");
+        client.setWindow(1u);
+        latency(client, "general", {cmd::getDeviceId()}, 1000u);
+        latency(client, "GAP", {Command(CMD_GET_DEVICE_ADDRESS).u8(0u)}, 1000u);
+        latency(client, "GATT", {cmd::readCharacteristicValue(conn, NTF_VALUE_HANDLE)}, 200u);
+        latency(client, "L2CAP", {Command(CMD_REGISTER_PSM).u16(L2CAP_PSM).u16(1u),
+                                  Command(CMD_UNREGISTER_PSM).u16(L2CAP_PSM)}, 500u);
+        client.setWindow(DEFAULT_WINDOW);
+
+        printf("notifications, %.1f s each\n", duration);
+        notificationRate(client, conn, NTF_BATCH_OFF, duration);
+        notificationRate(client, conn, NTF_BATCH_ON, duration);
+        check(client.call(cmd::setNotificationBatching(NTF_BATCH_OFF, 0u, 0u)));
+
+        if (framed)
+        {
+            client.setFramed();
+            printf("command rate framed, %u commands\n", count);
+            commandRate(client, 1u, count);
+            commandRate(client, DEFAULT_WINDOW, count);
+            CYSMT_LINK_STATS_T stats = client.linkStats();
+            printf("  %u frames sent, %u received, %u damaged, %u resent\n", stats.framesSent,
+                   stats.framesReceived, stats.framesDamaged, stats.framesResent);
+        }
+
+        check(client.call(cmd::terminateConnection(conn)));
+
+        printf("flow, %u runs each way\n", FLOW_RUNS);
+        flows(client);
+    }
+    catch (const std::exception &e)
+    {
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
+
+/* [] END OF FILE */
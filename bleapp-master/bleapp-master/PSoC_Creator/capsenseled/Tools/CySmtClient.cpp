@@ -0,0 +1,769 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#include "CySmtClient.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace cysmt
+{
+
+/* Framed mode: a command unanswered this long gets its frames resent */
+static const int TIMEOUT_MS = 50;
+
+/* Time the dongle takes to switch after it completed CMD_SET_TRANSPORT_MODE */
+static const int SWITCH_MS = 20;
+
+/* Longest event the decoder takes, anything longer is a lost header */
+static const size_t EVENT_MAX = 4096u;
+
+static uint16_t get16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void setSpeed(int fd, uint32_t baud)
+{
+    static const struct
+    {
+        uint32_t baud;
+        speed_t speed;
+    } speeds[] =
+    {
+        { 9600u, B9600 }, { 19200u, B19200 }, { 38400u, B38400 }, { 57600u, B57600 },
+        { 115200u, B115200 }, { 230400u, B230400 }, { 460800u, B460800 }, { 500000u, B500000 },
+        { 576000u, B576000 }, { 921600u, B921600 }, { 1000000u, B1000000 }, { 1152000u, B1152000 },
+        { 1500000u, B1500000 }, { 2000000u, B2000000 }, { 2500000u, B2500000 },
+        { 3000000u, B3000000 }, { 3500000u, B3500000 }, { 4000000u, B4000000 }
+    };
+    struct termios tio;
+
+    for (const auto &s : speeds)
+    {
+        if (s.baud != baud)
+            continue;
+        if ((tcgetattr(fd, &tio) != 0) || (cfsetspeed(&tio, s.speed) != 0) ||
+            (tcsetattr(fd, TCSADRAIN, &tio) != 0))
+            throw std::system_error(errno, std::generic_category(), "tcsetattr");
+        return;
+    }
+    throw std::invalid_argument("baud rate " + std::to_string(baud) + " not supported");
+}
+
+static void makeRaw(int fd)
+{
+    struct termios tio;
+
+    if (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) != 0)
+        throw std::system_error(errno, std::generic_category(), "fcntl");
+    if (isatty(fd))
+    {
+        tcgetattr(fd, &tio);
+        cfmakeraw(&tio);
+        tio.c_cflag |= CLOCAL | CREAD;
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+}
+
+/***************************************************************
+ * Command
+ **************************************************************/
+Command &Command::u8(uint8_t value)
+{
+    params_.push_back(value);
+    return *this;
+}
+
+Command &Command::u16(uint16_t value)
+{
+    params_.push_back((uint8_t)value);
+    params_.push_back((uint8_t)(value >> 8));
+    return *this;
+}
+
+Command &Command::u32(uint32_t value)
+{
+    return u16((uint16_t)value).u16((uint16_t)(value >> 16));
+}
+
+Command &Command::bytes(const void *data, size_t length)
+{
+    const uint8_t *p = static_cast<const uint8_t *>(data);
+
+    params_.insert(params_.end(), p, p + length);
+    return *this;
+}
+
+std::vector<uint8_t> Command::encode() const
+{
+    std::vector<uint8_t> packet;
+
+    packet.reserve(6u + params_.size());
+    packet.push_back(COMMAND_HEADER[0]);
+    packet.push_back(COMMAND_HEADER[1]);
+    packet.push_back((uint8_t)opcode_);
+    packet.push_back((uint8_t)(opcode_ >> 8));
+    packet.push_back((uint8_t)params_.size());
+    packet.push_back((uint8_t)(params_.size() >> 8));
+    packet.insert(packet.end(), params_.begin(), params_.end());
+    return packet;
+}
+
+/***************************************************************
+ * Macro
+ **************************************************************/
+Macro &Macro::u16(uint16_t value)
+{
+    program_.push_back((uint8_t)value);
+    program_.push_back((uint8_t)(value >> 8));
+    return *this;
+}
+
+Macro &Macro::command(const Command &command, uint8_t flags)
+{
+    if (command.params().size() > 0xFFu)
+        throw std::invalid_argument("macro command parameters over 255 bytes");
+    program_.push_back(0x01u);
+    program_.push_back(flags);
+    u16(command.opcode());
+    program_.push_back((uint8_t)command.params().size());
+    program_.insert(program_.end(), command.params().begin(), command.params().end());
+    return *this;
+}
+
+Macro &Macro::onConnection(const Command &command, uint8_t flags)
+{
+    Command rest(command.opcode());
+
+    if (command.params().size() >= 2u)
+        rest.bytes(command.params().data() + 2u, command.params().size() - 2u);
+    return this->command(rest, flags | MACRO_CMD_LOAD);
+}
+
+Macro &Macro::wait(uint16_t event, uint16_t timeoutMs)
+{
+    program_.push_back(0x02u);
+    return u16(event).u16(timeoutMs);
+}
+
+Macro &Macro::jumpIf(uint8_t condition, const std::string &label, uint8_t index, uint16_t value)
+{
+    program_.push_back(0x03u);
+    program_.push_back(condition);
+    program_.push_back(index);
+    u16(value);
+    jumps_.emplace_back(program_.size(), label);
+    return u16(0u);
+}
+
+Macro &Macro::store(uint8_t index, uint8_t length)
+{
+    program_.push_back(0x04u);
+    program_.push_back(index);
+    program_.push_back(length);
+    return *this;
+}
+
+Macro &Macro::delay(uint16_t ms)
+{
+    program_.push_back(0x05u);
+    return u16(ms);
+}
+
+Macro &Macro::end()
+{
+    program_.push_back(0x00u);
+    return *this;
+}
+
+Macro &Macro::label(const std::string &name)
+{
+    labels_[name] = (uint16_t)program_.size();
+    return *this;
+}
+
+std::vector<uint8_t> Macro::encode() const
+{
+    std::vector<uint8_t> program = program_;
+
+    for (const auto &jump : jumps_)
+    {
+        auto it = labels_.find(jump.second);
+
+        if (it == labels_.end())
+            throw std::logic_error("macro label " + jump.second + " not named");
+        program[jump.first] = (uint8_t)it->second;
+        program[jump.first + 1u] = (uint8_t)(it->second >> 8);
+    }
+    return program;
+}
+
+namespace cmd
+{
+Command getDeviceId() { return Command(CMD_GET_DEVICE_ID); }
+Command getFirmwareVersion() { return Command(CMD_GET_FIRMWARE_VERSION); }
+Command initBleStack() { return Command(CMD_INIT_BLE_STACK); }
+Command toolDisconnected() { return Command(CMD_TOOL_DISCONNECTED); }
+Command getRssi() { return Command(CMD_GET_RSSI); }
+Command getNotificationBatchStats() { return Command(CMD_GET_NOTIFICATION_BATCH_STATS); }
+Command getCmdBufferStats() { return Command(CMD_GET_CMD_BUFFER_STATS); }
+Command runMacro(const Macro &macro) { return Command(CMD_RUN_MACRO).bytes(macro.encode()); }
+Command stopMacro() { return Command(CMD_STOP_MACRO); }
+Command startScan() { return Command(CMD_START_SCAN); }
+Command stopScan() { return Command(CMD_STOP_SCAN); }
+
+Command setScanAggregation(uint8_t mode, uint16_t windowMs)
+{
+    return Command(CMD_SET_SCAN_AGGREGATION).u8(mode).u16(windowMs);
+}
+
+Command setNotificationBatching(uint8_t mode, uint16_t maxPayload, uint32_t budgetUs)
+{
+    return Command(CMD_SET_NOTIFICATION_BATCHING).u8(mode).u16(maxPayload).u32(budgetUs);
+}
+
+Command setTransportMode(uint8_t mode, uint32_t baud)
+{
+    return Command(CMD_SET_TRANSPORT_MODE).u8(mode).u32(baud);
+}
+
+Command establishConnection(const BdAddr &addr)
+{
+    return Command(CMD_ESTABLISH_CONNECTION).bytes(addr.addr, sizeof(addr.addr)).u8(addr.type);
+}
+
+Command terminateConnection(const ConnHandle &handle)
+{
+    return Command(CMD_TERMINATE_CONNECTION).conn(handle);
+}
+
+Command discoverAllPrimaryServices(const ConnHandle &handle)
+{
+    return Command(CMD_DISCOVER_ALL_PRIMARY_SERVICES).conn(handle);
+}
+
+Command discoverAllCharacteristics(const ConnHandle &handle, uint16_t start, uint16_t end)
+{
+    return Command(CMD_DISCOVER_ALL_CHARACTERISTICS).conn(handle).u16(start).u16(end);
+}
+
+Command discoverAllDescriptors(const ConnHandle &handle, uint16_t start, uint16_t end)
+{
+    return Command(CMD_DISCOVER_ALL_DESCRIPTORS).conn(handle).u16(start).u16(end);
+}
+
+Command readCharacteristicValue(const ConnHandle &handle, uint16_t attrHandle)
+{
+    return Command(CMD_READ_CHARACTERISTIC_VALUE).conn(handle).u16(attrHandle);
+}
+
+static Command write(uint16_t opcode, const ConnHandle &handle, uint16_t attrHandle, const std::vector<uint8_t> &value)
+{
+    return Command(opcode).conn(handle).u16(attrHandle).u16((uint16_t)value.size()).bytes(value);
+}
+
+Command writeCharacteristicValue(const ConnHandle &handle, uint16_t attrHandle, const std::vector<uint8_t> &value)
+{
+    return write(CMD_WRITE_CHARACTERISTIC_VALUE, handle, attrHandle, value);
+}
+
+Command writeWithoutResponse(const ConnHandle &handle, uint16_t attrHandle, const std::vector<uint8_t> &value)
+{
+    return write(CMD_WRITE_WITHOUT_RESPONSE, handle, attrHandle, value);
+}
+
+Command writeCharacteristicDescriptor(const ConnHandle &handle, uint16_t attrHandle, const std::vector<uint8_t> &value)
+{
+    return write(CMD_WRITE_CHARACTERISTIC_DESCRIPTOR, handle, attrHandle, value);
+}
+
+Command exchangeMtu(const ConnHandle &handle, uint16_t mtu)
+{
+    return Command(CMD_EXCHANGE_GATT_MTU_SIZE).conn(handle).u16(mtu);
+}
+
+Command gattStop(const ConnHandle &handle)
+{
+    return Command(CMD_GATT_STOP).conn(handle);
+}
+}
+
+/***************************************************************
+ * Events
+ **************************************************************/
+bool eventHasCommand(uint16_t code)
+{
+    /* Sent by the dongle with no command opcode, see the CyS_SendEvent() callers */
+    switch (code)
+    {
+    case 0x0404u:   /* EVT_REPORT_STACK_MISC_STATUS */
+    case 0x060Cu:   /* EVT_CHARACTERISTIC_VALUE_NOTIFICATION */
+    case 0x060Du:   /* EVT_CHARACTERISTIC_VALUE_INDICATION */
+    case 0x0612u:   /* EVT_CHARACTERISTIC_VALUE_NOTIFICATION_BATCH */
+    case 0x0684u:   /* EVT_CURRENT_CONNECTION_PARAMETERS_NOTIFICATION */
+    case 0x0690u:   /* EVT_CONNECTION_TERMINATED_NOTIFICATION */
+    case 0x0691u:   /* EVT_SCAN_STOPPED_NOTIFICATION */
+    case 0x0692u:   /* EVT_PAIRING_REQUEST_RECEIVED_NOTIFICATION */
+    case 0x0696u:   /* EVT_UPDATE_CONNECTION_PARAMETERS_NOTIFICATION */
+    case 0x069Du:   /* EVT_DATA_LENGTH_CHANGED_NOTIFICATION */
+    case 0x06A4u:   /* EVT_NEGOTIATED_PAIRING_PARAMETERS */
+    case 0x0500u:   /* EVT_CBFC_CONNECTION_INDICATION */
+    case 0x0502u:   /* EVT_CBFC_DISCONNECT_INDICATION */
+    case 0x0504u:   /* EVT_CBFC_DATA_RECEIVIED_NOTIFICATION */
+    case 0x0505u:   /* EVT_CBFC_RX_CREDIT_INDICATION */
+    case 0x0506u:   /* EVT_CBFC_TX_CREDIT_INDICATION */
+        return false;
+    default:
+        /* HID and audio packets of other firmware */
+        return (code < 0x0461u) || (code > 0x0466u);
+    }
+}
+
+bool EventDecoder::parse(const uint8_t *packet, size_t length, Event &event)
+{
+    size_t at = 6u;
+
+    if ((length < 6u) || (packet[0] != EVENT_HEADER[0]) || (packet[1] != EVENT_HEADER[1]) ||
+        (get16(&packet[2]) + 4u != length) || (get16(&packet[2]) < 2u))
+        return false;
+
+    event.code = get16(&packet[4]);
+    event.command = 0;
+    if (eventHasCommand(event.code) && (length >= at + 2u))
+    {
+        event.command = get16(&packet[at]);
+        at += 2u;
+    }
+    event.params.assign(&packet[at], &packet[length]);
+    return true;
+}
+
+void EventDecoder::reset()
+{
+    packet_.clear();
+    expected_ = 0;
+}
+
+void EventDecoder::feed(const uint8_t *data, size_t length, const Handler &handler)
+{
+    while (length--)
+    {
+        uint8_t byte = *data++;
+
+        if ((packet_.size() < 2u) && (byte != EVENT_HEADER[packet_.size()]))
+        {
+            /* Not a header, or a new one after a lone first byte */
+            skipped_ += packet_.size();
+            packet_.clear();
+            if (byte != EVENT_HEADER[0])
+            {
+                skipped_++;
+                continue;
+            }
+        }
+        packet_.push_back(byte);
+
+        if (packet_.size() == 4u)
+        {
+            expected_ = 4u + get16(&packet_[2]);
+            if ((expected_ < 6u) || (expected_ > EVENT_MAX))
+            {
+                skipped_ += packet_.size();
+                reset();
+            }
+        }
+        else if ((packet_.size() > 4u) && (packet_.size() == expected_))
+        {
+            Event event;
+
+            parse(packet_.data(), packet_.size(), event);
+            reset();
+            handler(std::move(event));
+        }
+    }
+}
+
+/***************************************************************
+ * Client
+ **************************************************************/
+Client::Client(const std::string &device, uint32_t baud)
+{
+    fd_ = open(device.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd_ < 0)
+        throw std::system_error(errno, std::generic_category(), device);
+    try
+    {
+        makeRaw(fd_);
+        setSpeed(fd_, baud);
+    }
+    catch (...)
+    {
+        close(fd_);
+        throw;
+    }
+    start();
+}
+
+Client::Client(int fd) : fd_(fd)
+{
+    makeRaw(fd_);
+    start();
+}
+
+Client::~Client()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    thread_.join();
+    close(fd_);
+}
+
+void Client::start()
+{
+    CySmtLink_Init(&link_, linkWrite, linkDeliver, this);
+    thread_ = std::thread(&Client::reader, this);
+}
+
+void Client::onEvent(EventHandler handler)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    handler_ = std::move(handler);
+}
+
+void Client::setWindow(size_t window)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    window_ = (window != 0u) ? window : 1u;
+    room_.notify_all();
+}
+
+size_t Client::window() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return window_;
+}
+
+bool Client::framed() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return framed_;
+}
+
+CYSMT_LINK_STATS_T Client::linkStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return link_.stats;
+}
+
+std::future<Result> Client::send(const Command &command)
+{
+    auto promise = std::make_shared<std::promise<Result>>();
+    std::future<Result> result = promise->get_future();
+
+    send(command, [promise](const Result &r) { promise->set_value(r); });
+    return result;
+}
+
+void Client::send(const Command &command, Callback callback)
+{
+    std::vector<uint8_t> packet = command.encode();
+    /* The dongle answers these with nothing at all */
+    bool answered = (command.opcode() != CMD_TOOL_DISCONNECTED) && (command.opcode() != CMD_HOST_TIMED_OUT);
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        room_.wait(lock, [this] { return (inFlight_ < window_) || stop_; });
+        if (stop_)
+            throw std::runtime_error("port closed");
+        if (framed_ && (packet.size() > CYSMT_FRAME_BODY_MAX))
+            throw std::length_error("command larger than a frame");
+
+        if (answered)
+        {
+            Pending pending;
+
+            pending.callback = std::move(callback);
+            pending.result.opcode = command.opcode();
+            pending_[command.opcode()].push_back(std::move(pending));
+            inFlight_++;
+        }
+        if (framed_)
+            CySmtLink_Send(&link_, packet.data(), packet.size());
+        else
+            queueBytes(packet.data(), packet.size());
+    }
+    flush(true);
+
+    if (!answered)
+    {
+        Result result;
+
+        result.opcode = command.opcode();
+        callback(result);
+    }
+}
+
+void Client::drain()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    room_.wait(lock, [this] { return (inFlight_ == 0u) || stop_; });
+}
+
+void Client::setFramed(uint32_t baud)
+{
+    Result result;
+
+    drain();
+    result = call(cmd::setTransportMode(CYSMT_TRANSPORT_MODE_FRAMED, baud));
+    if (result.status != 0u)
+        throw std::runtime_error("dongle refused framed mode, status " + std::to_string(result.status));
+
+    /* The dongle switches once its last legacy byte has left */
+    std::this_thread::sleep_for(std::chrono::milliseconds(SWITCH_MS));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (baud != 0u)
+        setSpeed(fd_, baud);
+    CySmtLink_Init(&link_, linkWrite, linkDeliver, this);
+    decoder_.reset();
+    framed_ = true;
+}
+
+/* Called with mutex_ held */
+void Client::queueBytes(const uint8_t *data, size_t length)
+{
+    out_.append(reinterpret_cast<const char *>(data), length);
+}
+
+void Client::flush(bool wait)
+{
+    std::unique_lock<std::mutex> writing(writeMutex_, std::defer_lock);
+
+    /* The reader only writes what fits, it must get back to reading */
+    if (wait)
+        writing.lock();
+    else if (!writing.try_lock())
+        return;
+
+    for (;;)
+    {
+        std::string chunk;
+        size_t done = 0;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (out_.empty())
+                return;
+            chunk.swap(out_);
+        }
+
+        while (done < chunk.size())
+        {
+            ssize_t n = ::write(fd_, &chunk[done], chunk.size() - done);
+
+            if (n > 0)
+            {
+                done += (size_t)n;
+                continue;
+            }
+            if ((n < 0) && (errno != EAGAIN) && (errno != EINTR))
+                throw std::system_error(errno, std::generic_category(), "write");
+            if (!wait)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                out_.insert(0, chunk, done, std::string::npos);
+                return;
+            }
+
+            struct pollfd p = { fd_, POLLOUT, 0 };
+            poll(&p, 1, TIMEOUT_MS);
+        }
+    }
+}
+
+void Client::reader()
+{
+    auto last = std::chrono::steady_clock::now();
+    uint8_t buf[4096];
+
+    for (;;)
+    {
+        std::vector<std::function<void()>> actions;
+        short events = POLLIN;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stop_)
+                break;
+            if (!out_.empty())
+                events |= POLLOUT;
+        }
+
+        struct pollfd p = { fd_, events, 0 };
+        if ((poll(&p, 1, TIMEOUT_MS) < 0) && (errno != EINTR))
+            break;
+
+        if (p.revents & POLLIN)
+        {
+            ssize_t n = read(fd_, buf, sizeof(buf));
+
+            if ((n == 0) || ((n < 0) && (errno != EAGAIN) && (errno != EINTR)))
+                break;
+            if (n > 0)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    process(buf, (size_t)n, actions);
+                }
+                for (auto &action : actions)
+                    action();
+                last = std::chrono::steady_clock::now();
+            }
+        }
+        else if (p.revents & (POLLERR | POLLHUP))
+        {
+            break;
+        }
+        else if (std::chrono::steady_clock::now() - last > std::chrono::milliseconds(TIMEOUT_MS))
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (framed_ && (inFlight_ != 0u))
+                CySmtLink_Timeout(&link_);
+            last = std::chrono::steady_clock::now();
+        }
+
+        try
+        {
+            flush(false);
+        }
+        catch (const std::system_error &)
+        {
+            break;
+        }
+    }
+
+    /* Port gone or client closing: futures still waiting get std::future_error */
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+    pending_.clear();
+    inFlight_ = 0;
+    room_.notify_all();
+}
+
+/* Called with mutex_ held */
+void Client::process(const uint8_t *data, size_t length, std::vector<std::function<void()>> &actions)
+{
+    if (framed_)
+    {
+        linkActions_ = &actions;
+        CySmtLink_Input(&link_, data, length);
+        linkActions_ = nullptr;
+    }
+    else
+    {
+        decoder_.feed(data, length, [this, &actions](Event &&event) { handleEvent(std::move(event), actions); });
+    }
+}
+
+/* Called with mutex_ held */
+void Client::handleEvent(Event &&event, std::vector<std::function<void()>> &actions)
+{
+    auto it = pending_.find(event.command);
+    bool step = false;
+
+    if ((event.command != 0u) && (it == pending_.end()))
+    {
+        /* Answers to the steps of a running macro belong to the macro */
+        it = pending_.find(CMD_RUN_MACRO);
+        step = true;
+    }
+
+    if ((event.command != 0u) && (it != pending_.end()))
+    {
+        Pending &pending = it->second.front();
+
+        if ((event.code == EVT_COMMAND_STATUS) || (event.code == EVT_COMMAND_COMPLETE))
+        {
+            pending.result.status = (event.params.size() >= 2u) ? get16(event.params.data()) : 0u;
+
+            /* The scan gets no complete of its own when stop scan ends it */
+            if ((event.code == EVT_COMMAND_COMPLETE) && (event.command == CMD_STOP_SCAN) &&
+                (pending_.count(CMD_START_SCAN) != 0u))
+                finish(CMD_START_SCAN, actions);
+
+            if ((event.code == EVT_COMMAND_COMPLETE) || (pending.result.status != 0u))
+                finish(event.command, actions);
+        }
+        else if ((event.code == EVT_GATT_ERROR_NOTIFICATION) && !step)
+        {
+            /* The dongle drops the command with no complete, the ATT error code is its status */
+            pending.result.status = (event.params.size() >= 6u) ? event.params[5] : 0u;
+            pending.result.events.push_back(std::move(event));
+            finish(pending.result.opcode, actions);
+        }
+        else
+        {
+            pending.result.events.push_back(std::move(event));
+        }
+        return;
+    }
+
+    if (handler_)
+    {
+        EventHandler handler = handler_;
+
+        actions.push_back([handler, event]() { handler(event); });
+    }
+}
+
+/* Called with mutex_ held */
+void Client::finish(uint16_t opcode, std::vector<std::function<void()>> &actions)
+{
+    auto it = pending_.find(opcode);
+    Pending pending = std::move(it->second.front());
+
+    it->second.pop_front();
+    if (it->second.empty())
+        pending_.erase(it);
+    inFlight_--;
+    room_.notify_all();
+
+    actions.push_back([pending]() { pending.callback(pending.result); });
+}
+
+void Client::linkWrite(void *context, const uint8_t *data, size_t length)
+{
+    static_cast<Client *>(context)->queueBytes(data, length);
+}
+
+void Client::linkDeliver(void *context, const uint8_t *packet, size_t length)
+{
+    Client *client = static_cast<Client *>(context);
+    Event event;
+
+    if (EventDecoder::parse(packet, length, event))
+        client->handleEvent(std::move(event), *client->linkActions_);
+}
+
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,380 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#ifndef _CYSMT_CLIENT_H_
+#define _CYSMT_CLIENT_H_
+
+/* Host library for the CySmart dongle protocol of CySmt_protocol.h, for
+   Linux test rigs. Works on a serial device or any open descriptor such
+   as a pty.
+
+     c++ -std=c++11 -O2 -c CySmtClient.cpp
+     cc -O2 -c CySmtFrame.c
+     c++ -std=c++11 -o rig rig.cpp CySmtClient.o CySmtFrame.o -lpthread
+
+   A command packet is 0x43 0x59, the opcode and the parameter length,
+   both 16 bit little endian, then the parameters. An event packet is
+   0xBD 0xA7, the length of the rest, the event code, for most events the
+   opcode of the command it answers, then the parameters.
+
+   Commands are pipelined: send() writes at once and returns, up to
+   window() commands wait for their answer at the same time. A command
+   ends with EVT_COMMAND_COMPLETE, with EVT_COMMAND_STATUS carrying an
+   error or with EVT_GATT_ERROR_NOTIFICATION, whose ATT error code becomes
+   the status. A scan ends with the complete of the stop scan command. The
+   response events in between are kept in its Result. The dongle runs
+   commands with the same opcode one after the other, so answers are
+   paired with commands by opcode, oldest first. Events that
+   answer no command go to the handler given to onEvent().
+
+   A macro, built with Macro and sent with cmd::runMacro(), runs its
+   commands on the dongle. The response events of its steps go into its
+   Result with EVT_MACRO_RESULT last, its status is that of the macro.
+
+   Callbacks and the event handler run on the reader thread, they must
+   not wait for another command. */
+#include <cstddef>
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "CySmtFrame.h"
+
+namespace cysmt
+{
+
+/* Keep in step with CySmt_protocol.h */
+enum : uint16_t
+{
+    CMD_GET_DEVICE_ID                   = 0xFC00u,
+    CMD_GET_FIRMWARE_VERSION            = 0xFC02u,
+    CMD_INIT_BLE_STACK                  = 0xFC07u,
+    CMD_TOOL_DISCONNECTED               = 0xFC08u,
+    CMD_HOST_TIMED_OUT                  = 0xFC09u,
+    CMD_GET_RSSI                        = 0xFC0Du,
+    CMD_SET_SCAN_AGGREGATION            = 0xFC11u,
+    CMD_SET_NOTIFICATION_BATCHING       = 0xFC12u,
+    CMD_GET_NOTIFICATION_BATCH_STATS    = 0xFC13u,
+    CMD_SET_TRANSPORT_MODE              = CYSMT_SET_TRANSPORT_MODE,
+    CMD_GET_CMD_BUFFER_STATS            = 0xFC15u,
+    CMD_RUN_MACRO                       = 0xFC16u,
+    CMD_STOP_MACRO                      = 0xFC17u,
+
+    CMD_START_SCAN                      = 0xFE93u,
+    CMD_STOP_SCAN                       = 0xFE94u,
+    CMD_ESTABLISH_CONNECTION            = 0xFE97u,
+    CMD_TERMINATE_CONNECTION            = 0xFE98u,
+
+    CMD_DISCOVER_ALL_PRIMARY_SERVICES   = 0xFE00u,
+    CMD_DISCOVER_ALL_CHARACTERISTICS    = 0xFE03u,
+    CMD_DISCOVER_ALL_DESCRIPTORS        = 0xFE05u,
+    CMD_READ_CHARACTERISTIC_VALUE       = 0xFE06u,
+    CMD_WRITE_WITHOUT_RESPONSE          = 0xFE0Au,
+    CMD_WRITE_CHARACTERISTIC_VALUE      = 0xFE0Bu,
+    CMD_WRITE_CHARACTERISTIC_DESCRIPTOR = 0xFE10u,
+    CMD_EXCHANGE_GATT_MTU_SIZE          = 0xFE12u,
+    CMD_GATT_STOP                       = 0xFE13u,
+
+    EVT_GATT_ERROR_NOTIFICATION         = 0x060Eu,
+    EVT_MACRO_RESULT                    = 0x040Fu,
+    EVT_COMMAND_STATUS                  = 0x047Eu,
+    EVT_COMMAND_COMPLETE                = 0x047Fu
+};
+
+/* Keep in step with CySmt_Macro.h */
+enum : uint8_t
+{
+    MACRO_CMD_NO_WAIT                   = 0x01u,
+    MACRO_CMD_LOAD                      = 0x02u
+};
+
+enum : uint8_t
+{
+    MACRO_IF_ALWAYS = 0,
+    MACRO_IF_STATUS_EQ,
+    MACRO_IF_STATUS_NE,
+    MACRO_IF_EVENT_EQ,
+    MACRO_IF_EVENT_NE,
+    MACRO_IF_BYTE_EQ,
+    MACRO_IF_BYTE_NE,
+    MACRO_IF_U16_EQ,
+    MACRO_IF_U16_NE
+};
+
+enum : uint16_t
+{
+    CYS_FW_ERR_MACRO_STOPPED            = 0xFD01u,
+    CYS_FW_ERR_MACRO_TIMEOUT            = 0xFD02u
+};
+
+/* Packet headers, as they appear on the wire */
+const uint8_t COMMAND_HEADER[2] = { 0x43u, 0x59u };
+const uint8_t EVENT_HEADER[2] = { 0xBDu, 0xA7u };
+
+/* Commands in flight at once, one below the dongle's CMD_QUEUE_SLOTS */
+const size_t DEFAULT_WINDOW = 7u;
+
+/* CYBLE_CONN_HANDLE_T */
+struct ConnHandle
+{
+    uint8_t bdHandle = 0;
+    uint8_t attId = 0;
+};
+
+/* CYBLE_GAP_BD_ADDR_T, address least significant byte first */
+struct BdAddr
+{
+    uint8_t addr[6] = {};
+    uint8_t type = 0;
+};
+
+struct Event
+{
+    uint16_t code = 0;
+    /* Opcode of the command the event answers, 0 for none */
+    uint16_t command = 0;
+    std::vector<uint8_t> params;
+};
+
+struct Result
+{
+    uint16_t opcode = 0;
+    /* CYBLE_API_RESULT_T of the dongle, 0 is OK, or the ATT error code
+       of EVT_GATT_ERROR_NOTIFICATION */
+    uint16_t status = 0;
+    /* Response events in the order they came */
+    std::vector<Event> events;
+};
+
+/***************************************************************
+ * Command packet builder, parameters are appended little endian
+ **************************************************************/
+class Command
+{
+public:
+    explicit Command(uint16_t opcode) : opcode_(opcode) {}
+
+    Command &u8(uint8_t value);
+    Command &u16(uint16_t value);
+    Command &u32(uint32_t value);
+    Command &bytes(const void *data, size_t length);
+    Command &bytes(const std::vector<uint8_t> &data) { return bytes(data.data(), data.size()); }
+    Command &conn(const ConnHandle &handle) { return u8(handle.bdHandle).u8(handle.attId); }
+
+    uint16_t opcode() const { return opcode_; }
+    const std::vector<uint8_t> &params() const { return params_; }
+
+    /* The whole packet with its header */
+    std::vector<uint8_t> encode() const;
+
+private:
+    uint16_t opcode_;
+    std::vector<uint8_t> params_;
+};
+
+/***************************************************************
+ * Macro program builder, the instructions are in CySmt_Macro.h
+ **************************************************************/
+class Macro
+{
+public:
+    /* Run a command, with MACRO_CMD_LOAD its parameters follow the bytes
+       kept by store() */
+    Macro &command(const Command &command, uint8_t flags = 0u);
+
+    /* Run a command built for any connection handle on the handle kept
+       by store() */
+    Macro &onConnection(const Command &command, uint8_t flags = 0u);
+
+    Macro &wait(uint16_t event, uint16_t timeoutMs);
+
+    /* Go to label if the condition holds, the label may come later */
+    Macro &jumpIf(uint8_t condition, const std::string &label, uint8_t index = 0u, uint16_t value = 0u);
+
+    /* Keep length captured event parameter bytes from index */
+    Macro &store(uint8_t index, uint8_t length);
+
+    Macro &delay(uint16_t ms);
+    Macro &end();
+
+    /* Name the next instruction */
+    Macro &label(const std::string &name);
+
+    /* The program, throws std::logic_error for a label never named */
+    std::vector<uint8_t> encode() const;
+
+private:
+    Macro &u16(uint16_t value);
+
+    std::vector<uint8_t> program_;
+    std::map<std::string, uint16_t> labels_;
+    /* Jump target offsets to fill in, with their label */
+    std::vector<std::pair<size_t, std::string>> jumps_;
+};
+
+/* Typed builders for the commands rigs use most */
+namespace cmd
+{
+Command getDeviceId();
+Command getFirmwareVersion();
+Command initBleStack();
+Command toolDisconnected();
+Command getRssi();
+Command setScanAggregation(uint8_t mode, uint16_t windowMs);
+Command setNotificationBatching(uint8_t mode, uint16_t maxPayload, uint32_t budgetUs);
+Command getNotificationBatchStats();
+Command setTransportMode(uint8_t mode, uint32_t baud);
+Command getCmdBufferStats();
+Command runMacro(const Macro &macro);
+Command stopMacro();
+
+Command startScan();
+Command stopScan();
+Command establishConnection(const BdAddr &addr);
+Command terminateConnection(const ConnHandle &handle);
+
+Command discoverAllPrimaryServices(const ConnHandle &handle);
+Command discoverAllCharacteristics(const ConnHandle &handle, uint16_t start, uint16_t end);
+Command discoverAllDescriptors(const ConnHandle &handle, uint16_t start, uint16_t end);
+Command readCharacteristicValue(const ConnHandle &handle, uint16_t attrHandle);
+Command writeCharacteristicValue(const ConnHandle &handle, uint16_t attrHandle, const std::vector<uint8_t> &value);
+Command writeWithoutResponse(const ConnHandle &handle, uint16_t attrHandle, const std::vector<uint8_t> &value);
+Command writeCharacteristicDescriptor(const ConnHandle &handle, uint16_t attrHandle, const std::vector<uint8_t> &value);
+Command exchangeMtu(const ConnHandle &handle, uint16_t mtu);
+Command gattStop(const ConnHandle &handle);
+}
+
+/* True for events that carry the opcode of the command they answer */
+bool eventHasCommand(uint16_t code);
+
+/***************************************************************
+ * Event decoder for the plain byte stream of the dongle
+ **************************************************************/
+class EventDecoder
+{
+public:
+    using Handler = std::function<void(Event &&)>;
+
+    /* Feed bytes read from the port, whole events go to handler */
+    void feed(const uint8_t *data, size_t length, const Handler &handler);
+
+    /* Forget a partial event, after the stream was switched */
+    void reset();
+
+    /* Decode one event packet starting at its header, false if it is not one */
+    static bool parse(const uint8_t *packet, size_t length, Event &event);
+
+    /* Bytes skipped looking for an event header */
+    uint64_t skipped() const { return skipped_; }
+
+private:
+    std::vector<uint8_t> packet_;
+    size_t expected_ = 0;
+    uint64_t skipped_ = 0;
+};
+
+/***************************************************************
+ * Pipelined client for one dongle
+ **************************************************************/
+class Client
+{
+public:
+    using Callback = std::function<void(const Result &)>;
+    using EventHandler = std::function<void(const Event &)>;
+
+    /* Open a serial device at baud, throws std::system_error */
+    Client(const std::string &device, uint32_t baud);
+
+    /* Take over an open descriptor, closed with the client */
+    explicit Client(int fd);
+
+    ~Client();
+
+    Client(const Client &) = delete;
+    Client &operator=(const Client &) = delete;
+
+    /* Events that answer no command, set before the first send */
+    void onEvent(EventHandler handler);
+
+    /* Most commands in flight at once, send() waits for room */
+    void setWindow(size_t window);
+    size_t window() const;
+
+    std::future<Result> send(const Command &command);
+    void send(const Command &command, Callback callback);
+
+    /* Send and wait for the answer */
+    Result call(const Command &command) { return send(command).get(); }
+
+    /* Wait until no command is in flight */
+    void drain();
+
+    /* Switch the dongle and this client to framed mode, see CySmtFrame.h.
+       baud 0 keeps the rate. Throws std::runtime_error if the dongle
+       refuses it. */
+    void setFramed(uint32_t baud = 0u);
+    bool framed() const;
+
+    CYSMT_LINK_STATS_T linkStats() const;
+
+private:
+    struct Pending
+    {
+        Callback callback;
+        Result result;
+    };
+
+    void start();
+    void reader();
+    void queueBytes(const uint8_t *data, size_t length);
+    void flush(bool wait);
+    void process(const uint8_t *data, size_t length, std::vector<std::function<void()>> &actions);
+    void handleEvent(Event &&event, std::vector<std::function<void()>> &actions);
+    void finish(uint16_t opcode, std::vector<std::function<void()>> &actions);
+
+    static void linkWrite(void *context, const uint8_t *data, size_t length);
+    static void linkDeliver(void *context, const uint8_t *packet, size_t length);
+
+    int fd_;
+    std::thread thread_;
+    bool stop_ = false;
+
+    /* Guards everything below */
+    mutable std::mutex mutex_;
+    std::condition_variable room_;
+    EventHandler handler_;
+    size_t window_ = DEFAULT_WINDOW;
+    size_t inFlight_ = 0;
+    std::map<uint16_t, std::deque<Pending>> pending_;
+    EventDecoder decoder_;
+    bool framed_ = false;
+    CYSMT_LINK_T link_;
+    std::string out_;
+
+    /* Held while writing, so bytes leave in the order they were queued */
+    std::mutex writeMutex_;
+
+    /* Set by linkDeliver while process() runs */
+    std::vector<std::function<void()>> *linkActions_ = nullptr;
+};
+
+}
+
+#endif /* _CYSMT_CLIENT_H_ */
+
+/* [] END OF FILE */
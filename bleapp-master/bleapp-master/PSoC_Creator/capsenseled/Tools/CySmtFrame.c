@@ -0,0 +1,282 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#include "CySmtFrame.h"
+#include <string.h>
+
+/* Window slot holding a frame the dongle reported GONE */
+#define SLOT_GONE                   (2)
+
+uint16_t CySmtFrame_Crc16(uint16_t crc, const uint8_t *data, size_t length)
+{
+    unsigned k;
+
+    while (length--)
+    {
+        crc ^= (uint16_t)(*data++ << 8);
+        for (k = 0; k < 8u; k++)
+        {
+            crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+size_t CySmtFrame_Encode(uint8_t seq, uint8_t type, const uint8_t *packet, size_t length, uint8_t *out)
+{
+    uint8_t head[CYSMT_FRAME_HEADER_SIZE], crc[CYSMT_FRAME_CRC_SIZE];
+    uint16_t value;
+    size_t code = 0, pos = 1, i;
+    uint8_t run = 1;
+
+    head[0] = seq;
+    head[1] = type;
+    value = CySmtFrame_Crc16(0xFFFFu, head, sizeof(head));
+    value = CySmtFrame_Crc16(value, packet, length);
+    crc[0] = (uint8_t)value;
+    crc[1] = (uint8_t)(value >> 8);
+
+    for (i = 0; i < length + 4u; i++)
+    {
+        uint8_t byte = (i < 2u) ? head[i] : (i < length + 2u) ? packet[i - 2u] : crc[i - length - 2u];
+
+        if (byte != 0u)
+        {
+            out[pos++] = byte;
+            run++;
+        }
+        if ((byte == 0u) || (run == 0xFFu))
+        {
+            out[code] = run;
+            code = pos++;
+            run = 1;
+        }
+    }
+    out[code] = run;
+    out[pos++] = 0x00u;
+    return pos;
+}
+
+int CySmtFrame_Decode(uint8_t *buf, size_t length)
+{
+    size_t in = 0, out = 0;
+
+    while (in < length)
+    {
+        uint8_t code = buf[in++], i;
+
+        if ((code == 0u) || (in + code - 1u > length))
+            return -1;
+        for (i = 1; i < code; i++)
+        {
+            buf[out++] = buf[in++];
+        }
+        if ((code != 0xFFu) && (in < length))
+            buf[out++] = 0x00u;
+    }
+
+    if ((out < CYSMT_FRAME_HEADER_SIZE + CYSMT_FRAME_CRC_SIZE) ||
+        (CySmtFrame_Crc16(0xFFFFu, buf, out - CYSMT_FRAME_CRC_SIZE) !=
+         (uint16_t)(buf[out - 2u] | (buf[out - 1u] << 8))))
+        return -1;
+    return (int)(out - CYSMT_FRAME_HEADER_SIZE - CYSMT_FRAME_CRC_SIZE);
+}
+
+static void sendFrame(CYSMT_LINK_T *link, uint8_t seq, uint8_t type, const uint8_t *packet, size_t length)
+{
+    uint8_t out[CYSMT_FRAME_ENCODED_MAX(CYSMT_FRAME_HEADER_SIZE + CYSMT_FRAME_BODY_MAX + CYSMT_FRAME_CRC_SIZE)];
+
+    link->write(link->context, out, CySmtFrame_Encode(seq, type, packet, length, out));
+}
+
+static void sendNak(CYSMT_LINK_T *link, uint8_t seq)
+{
+    link->nakSent[seq] = 1;
+    link->stats.naksSent++;
+    sendFrame(link, seq, CYSMT_FRAME_TYPE_NAK, NULL, 0);
+}
+
+/* Resend the kept frames from seq up to the newest */
+static void resendFrom(CYSMT_LINK_T *link, uint8_t seq)
+{
+    for (; seq != link->txSeq; seq++)
+    {
+        CYSMT_LINK_SLOT_T *slot = &link->history[seq % CYSMT_LINK_HISTORY];
+
+        if (slot->valid && (slot->seq == seq))
+        {
+            sendFrame(link, seq, CYSMT_FRAME_TYPE_DATA, slot->data, slot->length);
+            link->stats.framesResent++;
+        }
+    }
+}
+
+/* Hand over everything that is now in order */
+static void drain(CYSMT_LINK_T *link)
+{
+    for (;;)
+    {
+        CYSMT_LINK_SLOT_T *slot = &link->window[link->rxExpected % CYSMT_LINK_WINDOW];
+
+        if (!slot->valid || (slot->seq != link->rxExpected))
+            break;
+        if (slot->valid != SLOT_GONE)
+            link->deliver(link->context, slot->data, slot->length);
+        slot->valid = 0;
+        link->nakSent[link->rxExpected++] = 0;
+    }
+    if ((uint8_t)(link->rxHighest - link->rxExpected) >= 0x80u)
+        link->rxHighest = link->rxExpected;
+}
+
+static void hold(CYSMT_LINK_T *link, uint8_t seq, int valid, const uint8_t *packet, size_t length)
+{
+    CYSMT_LINK_SLOT_T *slot = &link->window[seq % CYSMT_LINK_WINDOW];
+
+    if (length != 0u)
+        memcpy(slot->data, packet, length);
+    slot->length = length;
+    slot->seq = seq;
+    slot->valid = valid;
+}
+
+static void receiveData(CYSMT_LINK_T *link, uint8_t seq, const uint8_t *packet, size_t length)
+{
+    uint8_t ahead = (uint8_t)(seq - link->rxExpected), s;
+
+    if (ahead >= 0x80u)
+        return;                     /* resent after it already arrived */
+    if (ahead >= CYSMT_LINK_WINDOW)
+    {
+        if (!link->nakSent[link->rxExpected])
+            sendNak(link, link->rxExpected);
+        return;
+    }
+
+    hold(link, seq, 1, packet, length);
+    if ((uint8_t)(seq + 1u - link->rxExpected) > (uint8_t)(link->rxHighest - link->rxExpected))
+        link->rxHighest = (uint8_t)(seq + 1u);
+
+    /* Ask once for each frame missing in front of this one */
+    for (s = link->rxExpected; s != seq; s++)
+    {
+        CYSMT_LINK_SLOT_T *slot = &link->window[s % CYSMT_LINK_WINDOW];
+
+        if ((!slot->valid || (slot->seq != s)) && !link->nakSent[s])
+            sendNak(link, s);
+    }
+    drain(link);
+}
+
+static void receiveFrame(CYSMT_LINK_T *link)
+{
+    int length = CySmtFrame_Decode(link->frame, link->frameLength);
+    uint8_t seq = link->frame[0];
+
+    if (length < 0)
+    {
+        link->stats.framesDamaged++;
+        return;
+    }
+
+    switch (link->frame[1])
+    {
+    case CYSMT_FRAME_TYPE_DATA:
+        link->stats.framesReceived++;
+        receiveData(link, seq, &link->frame[CYSMT_FRAME_HEADER_SIZE], (size_t)length);
+        break;
+
+    case CYSMT_FRAME_TYPE_NAK:
+        link->stats.naksReceived++;
+        resendFrom(link, seq);
+        break;
+
+    case CYSMT_FRAME_TYPE_GONE:
+        /* Only a frame known to be missing can be given up on */
+        if ((uint8_t)(seq - link->rxExpected) < (uint8_t)(link->rxHighest - link->rxExpected))
+        {
+            link->stats.gone++;
+            hold(link, seq, SLOT_GONE, NULL, 0);
+            drain(link);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+void CySmtLink_Init(CYSMT_LINK_T *link, CYSMT_WRITE_FN write, CYSMT_PACKET_FN deliver, void *context)
+{
+    memset(link, 0, sizeof(*link));
+    link->write = write;
+    link->deliver = deliver;
+    link->context = context;
+}
+
+int CySmtLink_Send(CYSMT_LINK_T *link, const uint8_t *packet, size_t length)
+{
+    CYSMT_LINK_SLOT_T *slot = &link->history[link->txSeq % CYSMT_LINK_HISTORY];
+
+    if (length > CYSMT_FRAME_BODY_MAX)
+        return -1;
+
+    memcpy(slot->data, packet, length);
+    slot->length = length;
+    slot->seq = link->txSeq;
+    slot->valid = 1;
+
+    sendFrame(link, link->txSeq++, CYSMT_FRAME_TYPE_DATA, packet, length);
+    link->stats.framesSent++;
+    return 0;
+}
+
+void CySmtLink_Input(CYSMT_LINK_T *link, const uint8_t *data, size_t length)
+{
+    while (length--)
+    {
+        uint8_t byte = *data++;
+
+        if (byte != 0u)
+        {
+            if (link->frameLength < sizeof(link->frame))
+                link->frame[link->frameLength++] = byte;
+            else
+                link->frameSkip = 1;
+            continue;
+        }
+
+        if (link->frameSkip)
+            link->stats.framesDamaged++;
+        else if (link->frameLength != 0u)
+            receiveFrame(link);
+        link->frameLength = 0;
+        link->frameSkip = 0;
+    }
+}
+
+void CySmtLink_Timeout(CYSMT_LINK_T *link)
+{
+    uint8_t s;
+
+    resendFrom(link, (uint8_t)(link->txSeq - CYSMT_LINK_HISTORY));
+
+    /* The frame after the newest seen may be lost too, the dongle answers GONE if it was never sent */
+    for (s = link->rxExpected; s != (uint8_t)(link->rxHighest + 1u); s++)
+    {
+        CYSMT_LINK_SLOT_T *slot = &link->window[s % CYSMT_LINK_WINDOW];
+
+        if (!slot->valid || (slot->seq != s))
+            sendNak(link, s);
+    }
+}
+
+/* [] END OF FILE */
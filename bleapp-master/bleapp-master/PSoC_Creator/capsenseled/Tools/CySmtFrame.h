@@ -0,0 +1,142 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#ifndef _CYSMT_FRAME_H_
+#define _CYSMT_FRAME_H_
+
+/* Host side of the dongle's framed transport mode, see TRANSPORT_FRAMED in
+   CySmt_TransportLayer.h. The host switches with CMD_SET_TRANSPORT_MODE
+   (0xFC14: mode byte, then the baud rate as uint32, 0 keeps it), waits for
+   the command complete event and a few ms more, then changes its own baud
+   rate and talks frames from sequence number 0 in both directions.
+
+   A frame is COBS(seq, type, packet, CRC-16 little endian) and a 0x00
+   delimiter. The CRC is CRC-16/CCITT-FALSE over seq, type and packet. The
+   packet is the plain protocol packet: 0x43 0x59 commands to the dongle,
+   0xBD 0xA7 events from it.
+
+   The dongle only takes its DATA frames in order. It answers a gap or a
+   damaged frame with one NAK for the frame it expects, the host then sends
+   that frame and every later one again. The host keeps frames that arrive
+   ahead of a gap and sends a NAK for each missing one, the dongle resends
+   them from its history or answers GONE. */
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Keep in step with CySmt_TransportLayer.h */
+#define CYSMT_FRAME_TYPE_DATA       (0x01u)
+#define CYSMT_FRAME_TYPE_NAK        (0x02u)
+#define CYSMT_FRAME_TYPE_GONE       (0x03u)
+#define CYSMT_FRAME_HEADER_SIZE     (2u)
+#define CYSMT_FRAME_CRC_SIZE        (2u)
+#define CYSMT_FRAME_ENCODED_MAX(n)  ((n) + ((n) / 254u) + 2u)
+#define CYSMT_SET_TRANSPORT_MODE    (0xFC14u)
+#define CYSMT_TRANSPORT_MODE_FRAMED (0x01u)
+
+/* Largest packet either side puts in a frame */
+#define CYSMT_FRAME_BODY_MAX        (1024u)
+
+/* Frames kept for resending, and frames held ahead of a gap */
+#define CYSMT_LINK_HISTORY          (16u)
+#define CYSMT_LINK_WINDOW           (16u)
+
+/* Write bytes to the port, and take a packet received in order */
+typedef void (*CYSMT_WRITE_FN)(void *context, const uint8_t *data, size_t length);
+typedef void (*CYSMT_PACKET_FN)(void *context, const uint8_t *packet, size_t length);
+
+typedef struct
+{
+    uint8_t data[CYSMT_FRAME_BODY_MAX];
+    size_t length;
+    uint8_t seq;
+    int valid;
+} CYSMT_LINK_SLOT_T;
+
+typedef struct
+{
+    uint32_t framesSent;
+    uint32_t framesReceived;
+    uint32_t framesResent;
+    uint32_t framesDamaged;
+    uint32_t naksSent;
+    uint32_t naksReceived;
+    uint32_t gone;
+} CYSMT_LINK_STATS_T;
+
+typedef struct
+{
+    CYSMT_WRITE_FN write;
+    CYSMT_PACKET_FN deliver;
+    void *context;
+
+    uint8_t txSeq;
+    CYSMT_LINK_SLOT_T history[CYSMT_LINK_HISTORY];
+
+    uint8_t rxExpected;
+    uint8_t rxHighest;      /* one past the newest DATA frame seen */
+    CYSMT_LINK_SLOT_T window[CYSMT_LINK_WINDOW];
+    uint8_t nakSent[256];
+
+    uint8_t frame[CYSMT_FRAME_ENCODED_MAX(CYSMT_FRAME_HEADER_SIZE + CYSMT_FRAME_BODY_MAX + CYSMT_FRAME_CRC_SIZE)];
+    size_t frameLength;
+    int frameSkip;
+
+    CYSMT_LINK_STATS_T stats;
+} CYSMT_LINK_T;
+
+/***************************************************************
+ * CRC-16/CCITT-FALSE, start with 0xFFFF
+ **************************************************************/
+uint16_t CySmtFrame_Crc16(uint16_t crc, const uint8_t *data, size_t length);
+
+/***************************************************************
+ * Build one frame with its delimiter into out, which holds
+ * CYSMT_FRAME_ENCODED_MAX(length + 4) bytes. Returns its size.
+ **************************************************************/
+size_t CySmtFrame_Encode(uint8_t seq, uint8_t type, const uint8_t *packet, size_t length, uint8_t *out);
+
+/***************************************************************
+ * Decode a frame without its delimiter in place and check it.
+ * Returns the packet length, the packet starts at
+ * buf + CYSMT_FRAME_HEADER_SIZE, or -1 if the frame is damaged.
+ **************************************************************/
+int CySmtFrame_Decode(uint8_t *buf, size_t length);
+
+void CySmtLink_Init(CYSMT_LINK_T *link, CYSMT_WRITE_FN write, CYSMT_PACKET_FN deliver, void *context);
+
+/***************************************************************
+ * Send a packet as the next DATA frame. Returns -1 if it is
+ * larger than CYSMT_FRAME_BODY_MAX.
+ **************************************************************/
+int CySmtLink_Send(CYSMT_LINK_T *link, const uint8_t *packet, size_t length);
+
+/***************************************************************
+ * Feed bytes read from the port, packets are delivered in order
+ **************************************************************/
+void CySmtLink_Input(CYSMT_LINK_T *link, const uint8_t *data, size_t length);
+
+/***************************************************************
+ * Call when a reply is overdue: resends the kept frames and asks
+ * again for the frames missing in front of those held
+ **************************************************************/
+void CySmtLink_Timeout(CYSMT_LINK_T *link);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CYSMT_FRAME_H_ */
+
+/* [] END OF FILE */
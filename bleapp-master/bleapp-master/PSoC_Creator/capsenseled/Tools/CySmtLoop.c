@@ -0,0 +1,377 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+
+/* Host tool: loopback throughput test of the dongle's framed transport
+   mode over a pseudo-terminal, no dongle needed.
+
+     cc -O2 -o CySmtLoop CySmtLoop.c CySmtFrame.c -lpthread
+     ./CySmtLoop [packets] [bit error rate]
+
+   The host side is CySmtFrame.c on the pty master. The slave side runs a
+   model of the dongle's receive path from CySmt_TransportLayer.c: frames
+   are taken in order only, a gap or damaged frame gets one NAK for the
+   expected frame, and NAKs from the host are served from a 16 frame
+   history. The model echoes every command back as an event. Both
+   directions flip bits at the given rate, default 1e-4 per byte. */
+#define _XOPEN_SOURCE 600
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "CySmtFrame.h"
+
+/* Commands in flight, below the dongle's CMD_QUEUE_SLOTS and both histories */
+#define WINDOW                      (7u)
+#define PACKET_MAX                  (240u)
+#define TIMEOUT_MS                  (50)
+
+/* Keep in step with TRANSPORT_TX_HISTORY_FRAMES */
+#define DONGLE_HISTORY              (16u)
+
+typedef struct
+{
+    uint8_t *data;
+    size_t len;
+    size_t cap;
+} BUF_T;
+
+typedef struct
+{
+    int fd;
+    BUF_T out;
+    double errorRate;
+    unsigned seed;
+    unsigned long flips;
+} PORT_T;
+
+/* Dongle model */
+typedef struct
+{
+    PORT_T port;
+    uint8_t frame[CYSMT_FRAME_ENCODED_MAX(CYSMT_FRAME_HEADER_SIZE + CYSMT_FRAME_BODY_MAX + CYSMT_FRAME_CRC_SIZE)];
+    size_t frameLength;
+    uint8_t expected;
+    int nakSent;
+    uint8_t txSeq;
+    struct
+    {
+        uint8_t data[CYSMT_FRAME_BODY_MAX];
+        size_t length;
+        uint8_t seq;
+        int valid;
+    } history[DONGLE_HISTORY];
+    unsigned long naks, resent, gone;
+} DONGLE_T;
+
+typedef struct
+{
+    PORT_T port;
+    CYSMT_LINK_T link;
+    unsigned long received;
+    unsigned long bytes;
+    int failed;
+} HOST_T;
+
+static volatile int stop;
+
+static void put(BUF_T *b, const uint8_t *data, size_t n)
+{
+    if (b->len + n > b->cap)
+    {
+        while (b->len + n > b->cap)
+            b->cap = b->cap ? b->cap * 2u : 4096u;
+        b->data = realloc(b->data, b->cap);
+        if (b->data == NULL)
+        {
+            perror("realloc");
+            exit(1);
+        }
+    }
+    memcpy(&b->data[b->len], data, n);
+    b->len += n;
+}
+
+/* Queue bytes for the port, flipping bits on the way */
+static void portWrite(void *context, const uint8_t *data, size_t length)
+{
+    PORT_T *port = context;
+    size_t start = port->out.len, i;
+
+    put(&port->out, data, length);
+    for (i = 0; i < length; i++)
+    {
+        if ((double)rand_r(&port->seed) / RAND_MAX < port->errorRate)
+        {
+            port->out.data[start + i] ^= (uint8_t)(1u << (rand_r(&port->seed) & 7));
+            port->flips++;
+        }
+    }
+}
+
+static void portFlush(PORT_T *port)
+{
+    ssize_t n;
+
+    if (port->out.len == 0u)
+        return;
+    n = write(port->fd, port->out.data, port->out.len);
+    if (n > 0)
+    {
+        memmove(port->out.data, &port->out.data[n], port->out.len - (size_t)n);
+        port->out.len -= (size_t)n;
+    }
+    else if ((n < 0) && (errno != EAGAIN))
+    {
+        perror("write");
+        exit(1);
+    }
+}
+
+static void dongleSend(DONGLE_T *d, uint8_t seq, uint8_t type, const uint8_t *packet, size_t length)
+{
+    uint8_t out[CYSMT_FRAME_ENCODED_MAX(CYSMT_FRAME_HEADER_SIZE + CYSMT_FRAME_BODY_MAX + CYSMT_FRAME_CRC_SIZE)];
+
+    portWrite(&d->port, out, CySmtFrame_Encode(seq, type, packet, length, out));
+}
+
+static void dongleNak(DONGLE_T *d)
+{
+    if (!d->nakSent)
+    {
+        d->nakSent = 1;
+        d->naks++;
+        dongleSend(d, d->expected, CYSMT_FRAME_TYPE_NAK, NULL, 0);
+    }
+}
+
+static void dongleFrame(DONGLE_T *d)
+{
+    int length = CySmtFrame_Decode(d->frame, d->frameLength);
+    uint8_t seq = d->frame[0];
+
+    if (length < 0)
+    {
+        dongleNak(d);
+        return;
+    }
+
+    if (d->frame[1] == CYSMT_FRAME_TYPE_DATA)
+    {
+        if (seq == d->expected)
+        {
+            uint8_t *packet = &d->frame[CYSMT_FRAME_HEADER_SIZE];
+            int slot = d->txSeq % DONGLE_HISTORY;
+
+            d->expected++;
+            d->nakSent = 0;
+
+            /* Echo the command as an event */
+            packet[0] = 0xBDu;
+            packet[1] = 0xA7u;
+            memcpy(d->history[slot].data, packet, (size_t)length);
+            d->history[slot].length = (size_t)length;
+            d->history[slot].seq = d->txSeq;
+            d->history[slot].valid = 1;
+            dongleSend(d, d->txSeq++, CYSMT_FRAME_TYPE_DATA, packet, (size_t)length);
+        }
+        else if ((uint8_t)(seq - d->expected) < 0x80u)
+        {
+            dongleNak(d);
+        }
+    }
+    else if (d->frame[1] == CYSMT_FRAME_TYPE_NAK)
+    {
+        int slot = seq % DONGLE_HISTORY;
+
+        if (d->history[slot].valid && (d->history[slot].seq == seq))
+        {
+            d->resent++;
+            dongleSend(d, seq, CYSMT_FRAME_TYPE_DATA, d->history[slot].data, d->history[slot].length);
+        }
+        else
+        {
+            d->gone++;
+            dongleSend(d, seq, CYSMT_FRAME_TYPE_GONE, NULL, 0);
+        }
+    }
+}
+
+static void *dongleThread(void *arg)
+{
+    DONGLE_T *d = arg;
+    uint8_t buf[4096];
+
+    while (!stop)
+    {
+        struct pollfd p = { d->port.fd, POLLIN | (d->port.out.len ? POLLOUT : 0), 0 };
+        ssize_t n, i;
+
+        if (poll(&p, 1, 10) <= 0)
+            continue;
+        n = read(d->port.fd, buf, sizeof(buf));
+        for (i = 0; i < n; i++)
+        {
+            if (buf[i] != 0u)
+            {
+                if (d->frameLength < sizeof(d->frame))
+                    d->frame[d->frameLength++] = buf[i];
+            }
+            else
+            {
+                if (d->frameLength != 0u)
+                    dongleFrame(d);
+                d->frameLength = 0;
+            }
+        }
+        portFlush(&d->port);
+    }
+    return NULL;
+}
+
+static size_t makePacket(unsigned long i, uint8_t *packet)
+{
+    size_t length = (i * 7919u) % (PACKET_MAX - 6u), k;
+
+    packet[0] = 0x43u;
+    packet[1] = 0x59u;
+    packet[2] = (uint8_t)i;
+    packet[3] = (uint8_t)(i >> 8);
+    packet[4] = (uint8_t)length;
+    packet[5] = (uint8_t)(length >> 8);
+    for (k = 0; k < length; k++)
+    {
+        /* Zeros now and then, COBS has something to do */
+        packet[6 + k] = ((k + i) % 11u == 0u) ? 0u : (uint8_t)(i * 31u + k);
+    }
+    return length + 6u;
+}
+
+static void hostDeliver(void *context, const uint8_t *packet, size_t length)
+{
+    HOST_T *h = context;
+    uint8_t expect[PACKET_MAX];
+    size_t n = makePacket(h->received, expect);
+
+    expect[0] = 0xBDu;
+    expect[1] = 0xA7u;
+    if ((n != length) || (memcmp(expect, packet, n) != 0))
+    {
+        fprintf(stderr, "event %lu does not match its command\n", h->received);
+        h->failed = 1;
+    }
+    h->received++;
+    h->bytes += length;
+}
+
+static double now(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv)
+{
+    static DONGLE_T dongle;
+    static HOST_T host;
+    unsigned long packets = (argc > 1) ? strtoul(argv[1], NULL, 0) : 20000u;
+    double errorRate = (argc > 2) ? atof(argv[2]) : 1e-4;
+    unsigned long sent = 0, timeouts = 0;
+    double start, last, elapsed;
+    struct termios tio;
+    pthread_t thread;
+    uint8_t buf[4096];
+    int master, slave;
+
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    if ((master < 0) || (grantpt(master) != 0) || (unlockpt(master) != 0))
+    {
+        perror("posix_openpt");
+        return 1;
+    }
+    slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+    if (slave < 0)
+    {
+        perror(ptsname(master));
+        return 1;
+    }
+    tcgetattr(slave, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(slave, TCSANOW, &tio);
+    fcntl(master, F_SETFL, O_NONBLOCK);
+    fcntl(slave, F_SETFL, O_NONBLOCK);
+
+    dongle.port.fd = slave;
+    dongle.port.errorRate = errorRate;
+    dongle.port.seed = 1;
+    host.port.fd = master;
+    host.port.errorRate = errorRate;
+    host.port.seed = 2;
+    CySmtLink_Init(&host.link, portWrite, hostDeliver, &host);
+    pthread_create(&thread, NULL, dongleThread, &dongle);
+
+    start = last = now();
+    while ((host.received < packets) && !host.failed)
+    {
+        struct pollfd p = { master, POLLIN, 0 };
+        unsigned long before = host.received;
+        ssize_t n;
+
+        while ((sent < packets) && (sent - host.received < WINDOW))
+        {
+            uint8_t packet[PACKET_MAX];
+
+            CySmtLink_Send(&host.link, packet, makePacket(sent++, packet));
+        }
+        portFlush(&host.port);
+
+        if (poll(&p, 1, 10) > 0)
+        {
+            n = read(master, buf, sizeof(buf));
+            if (n > 0)
+                CySmtLink_Input(&host.link, buf, (size_t)n);
+        }
+        if (host.received != before)
+        {
+            last = now();
+        }
+        else if (now() - last > TIMEOUT_MS / 1000.0)
+        {
+            timeouts++;
+            CySmtLink_Timeout(&host.link);
+            last = now();
+        }
+        portFlush(&host.port);
+    }
+    elapsed = now() - start;
+    stop = 1;
+    pthread_join(thread, NULL);
+
+    printf("%lu packets, %lu event bytes in %.2f s, %.0f packets/s, %.2f MB/s each way\n",
+           host.received, host.bytes, elapsed, host.received / elapsed, host.bytes / elapsed / 1e6);
+    printf("bits flipped: %lu to the dongle, %lu to the host\n", host.port.flips, dongle.port.flips);
+    printf("host: %u damaged, %u NAKs sent, %u NAKs received, %u frames resent, %u gone, %lu timeouts\n",
+           host.link.stats.framesDamaged, host.link.stats.naksSent, host.link.stats.naksReceived,
+           host.link.stats.framesResent, host.link.stats.gone, timeouts);
+    printf("dongle: %lu NAKs sent, %lu frames resent, %lu GONE\n", dongle.naks, dongle.resent, dongle.gone);
+    return host.failed ? 1 : 0;
+}
+
+/* [] END OF FILE */
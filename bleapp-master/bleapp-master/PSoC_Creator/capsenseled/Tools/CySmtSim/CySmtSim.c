@@ -0,0 +1,150 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+
+/* Host tool: the dongle's CySmart firmware on Linux, for measuring the
+   protocol without a dongle. The command, event and command buffer modules
+   of BLE_4_2_Dongle_CySmart_256K01.cydsn are built unchanged, on a
+   simulated BLE stack (CySmtSimStack.c) and a transport on a
+   pseudo-terminal (CySmtSimTransport.c). The CYBLE types come from the
+   generated BLE component of HubBLE.cydsn, a GAP central as the dongle's.
+   The pty transport stands in for the DMA one with framed mode, whose
+   switches are off in CySmt_TransportLayer.h until checked on a board.
+
+     D=../../BLE_4_2_Dongle_CySmart_256K01.cydsn
+     cc -O2 -DTRANSPORT_RX_DMA -DTRANSPORT_TX_DMA -DTRANSPORT_FRAMED \
+        -I. -I.. -I$D -I$D/CySmt_InterfaceModule \
+        -I../../HubBLE.cydsn/Generated_Source/PSoC4 -o CySmtSim \
+        CySmtSim.c CySmtSimStack.c CySmtSimTransport.c ../CySmtFrame.c \
+        $D/CySmt_InterfaceModule/CySmt_protocol.c \
+        $D/CySmt_InterfaceModule/CySmt_CommandLayer.c \
+        $D/CySmt_InterfaceModule/CySmt_BleEventHandler.c \
+        $D/CySmt_InterfaceModule/CySmt_CmdBuffer.c \
+        $D/CySmt_InterfaceModule/CySmt_Macro.c
+     ./CySmtSim [-p link] [-i interval us] [-n notifications per event]
+                [-s notification size] [-d advertisers] [-b baud]
+
+   The pty name is printed on start, -p also links it from a fixed path.
+   Timing is that of the host CPU and the connection interval given with
+   -i, not of the dongle's radio, and of the UART only as far as -b paces
+   the bytes: use it to compare protocol changes with each other, not as
+   dongle figures. See CySmtBench.cpp. */
+#include "CySmtSim.h"
+#include "CySmt_BleEventHandler.h"
+#include "CySmt_CommandLayer.h"
+#include "CySmt_CmdBuffer.h"
+#include "CySmt_Macro.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+SIM_CONFIG_T simConfig =
+{
+    7500u,  /* 7.5 ms, the shortest BLE connection interval */
+    4u,
+    20u,
+    16u,
+    0u
+};
+
+static uint64 simStart;
+
+uint64 Sim_Now(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return ((uint64)t.tv_sec * 1000000u) + ((uint64)t.tv_nsec / 1000u) - simStart;
+}
+
+int main(int argc, char **argv)
+{
+    const char *linkName = NULL;
+    int32 next;
+    int opt;
+
+    while((opt = getopt(argc, argv, "p:i:n:s:d:b:")) != -1)
+    {
+        switch(opt)
+        {
+            case 'p':
+                linkName = optarg;
+                break;
+            case 'i':
+                simConfig.connIntervalUs = (uint32)strtoul(optarg, NULL, 0);
+                break;
+            case 'n':
+                simConfig.ntfPerEvent = (uint8)strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                simConfig.ntfLength = (uint16)strtoul(optarg, NULL, 0);
+                break;
+            case 'd':
+                simConfig.advDevices = (uint8)strtoul(optarg, NULL, 0);
+                break;
+            case 'b':
+                simConfig.uartBaud = (uint32)strtoul(optarg, NULL, 0);
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-p link] [-i interval us] [-n notifications per event] "
+                                "[-s notification size] [-d advertisers] [-b baud]\n", argv[0]);
+                return 1;
+        }
+    }
+    if(0u == simConfig.advDevices)
+    {
+        simConfig.advDevices = 1u;
+    }
+
+    simStart = Sim_Now();
+    if(!SimTransport_Open(linkName))
+    {
+        return 1;
+    }
+    CySmt_CmdBufferInit();
+
+    /* The CySmart branch of the dongle's main loop */
+    for(;;)
+    {
+        CyBle_ProcessEvents();
+
+        /* Send batched notifications once the connection event is over */
+        CyS_NotificationBatchProcess();
+
+        /* Free-up the Write request buffer on primary command completion, if allocated */
+        if(!primaryCmdInProgress)
+        {
+            CySmt_ReleaseCmdBuffers();
+        }
+
+        Transport_Process();
+
+        /* Send merged advertisement reports whose window has passed */
+        CyS_ScanAggregationProcess();
+
+        /* Run the next macro step, ahead of host commands */
+        CySmt_MacroProcess();
+
+        if(newCmdRxDoneFlag)
+        {
+            CySmt_ProcessCommands();
+        }
+
+        next = SimStack_NextEventUs();
+        if(0 != next)
+        {
+            SimTransport_Wait(next);
+        }
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,90 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#ifndef _CYSMT_SIM_H_
+#define _CYSMT_SIM_H_
+
+/* Shared by the parts of the dongle simulator, see CySmtSim.c */
+#include "main.h"
+
+/* Largest attribute value of the simulated peer */
+#define SIM_ATTR_VALUE_MAX          (512u)
+
+/* Event generators pause while more bytes than this wait for the host */
+#define SIM_TX_BACKLOG_MAX          (4096u)
+
+typedef struct
+{
+    /* Connection interval in us, stack responses and notification bursts wait
+       for the next connection event. 0 answers at once */
+    uint32 connIntervalUs;
+    /* Notifications sent per connection event once the host enables them */
+    uint8 ntfPerEvent;
+    /* Notification value length, cut to the negotiated MTU */
+    uint16 ntfLength;
+    /* Advertisers reporting while scanning, as fast as the host takes their reports */
+    uint8 advDevices;
+    /* Bytes cross the pty no faster than a UART at this rate sends them, 10 bits a
+       byte each way. 0 passes them at once */
+    uint32 uartBaud;
+}SIM_CONFIG_T;
+
+extern SIM_CONFIG_T simConfig;
+
+/* Microseconds since the simulator started */
+uint64 Sim_Now(void);
+
+/***************************************************************
+ * Simulated BLE stack, CySmtSimStack.c
+ **************************************************************/
+
+/* Microseconds until the stack has work, 0 if it has some now, -1 for none */
+int32 SimStack_NextEventUs(void);
+
+/***************************************************************
+ * Transport on a pseudo-terminal, CySmtSimTransport.c
+ **************************************************************/
+
+/* Open the pty and print its name, also linked from link unless NULL */
+bool SimTransport_Open(const char *link);
+
+/* Event bytes not yet taken by the host */
+uint32 SimTransport_TxBacklog(void);
+
+/* Sleep until the host sends or takes bytes, at most timeoutUs and never over 1 ms, -1 for 1 ms */
+void SimTransport_Wait(int32 timeoutUs);
+
+/***************************************************************
+ * RX side of the UART and the DMA, CySmtSimUart.c
+ **************************************************************/
+
+/* Bytes the RX FIFO of the SCB holds */
+#define SIM_UART_FIFO_SIZE          (8u)
+
+typedef struct
+{
+    uint32 rxBytes;
+    /* Bytes lost to a full RX FIFO */
+    uint32 rxOverflows;
+    /* Transport_RX_ISR runs and DMA completion callbacks */
+    uint32 rxInterrupts;
+    uint32 dmaInterrupts;
+    uint32 timerRestarts;
+}SIM_UART_STATS_T;
+
+extern SIM_UART_STATS_T simUartStats;
+
+/* One byte off the line into the RX FIFO, the DMA and the RX interrupt act on it at once */
+void SimUart_Receive(uint8 byte);
+
+#endif /* _CYSMT_SIM_H_ */
+
+/* [] END OF FILE */
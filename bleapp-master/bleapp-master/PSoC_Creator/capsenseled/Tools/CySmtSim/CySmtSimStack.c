@@ -0,0 +1,1007 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+
+/* Simulated BLE stack for the host build of the dongle firmware.
+
+   API calls the firmware makes are answered the way the stack does: with
+   a return code, and for procedures with the events CyS_GenericEventHandler
+   expects, delivered from CyBle_ProcessEvents() at the next connection
+   event. The peer is one GATT server with the attributes of simDb, always
+   in range. Calls the simulator does not model return
+   CYBLE_ERROR_INVALID_OPERATION, which the dongle sends out as the command
+   status. */
+#include "CySmtSim.h"
+#include <string.h>
+
+/* Stack events waiting for their connection event */
+#define SIM_EVENT_QUEUE             (64u)
+
+/* Server receive MTU of the simulated peer */
+#define SIM_PEER_MTU                (512u)
+#define SIM_DEFAULT_MTU             (23u)
+
+/* Reason of a disconnect asked for by the host, Remote User Terminated Connection */
+#define SIM_DISCONNECT_REASON       (0x13u)
+
+/* Handles of the simulated peer the firmware is driven through */
+#define SIM_NTF_VALUE_HANDLE        (0x000Au)
+#define SIM_NTF_CCCD_HANDLE         (0x000Bu)
+
+typedef struct
+{
+    uint32 event;
+    uint64 due;
+    /* Attribute handle, MTU or item length, by event */
+    uint16 handle;
+    uint16 length;
+    uint8 data[SIM_ATTR_VALUE_MAX];
+}SIM_EVENT_T;
+
+typedef struct
+{
+    CYBLE_GATT_DB_ATTR_HANDLE_T handle;
+    uint16 type;
+    uint16 length;
+    uint8 value[SIM_ATTR_VALUE_MAX];
+}SIM_ATTR_T;
+
+/* GAP, GATT and one custom service with a notifying and a writable characteristic */
+static SIM_ATTR_T simDb[] =
+{
+    {0x0001u, 0x2800u, 2u, {0x00u, 0x18u}},
+    {0x0002u, 0x2803u, 5u, {0x02u, 0x03u, 0x00u, 0x00u, 0x2Au}},
+    {0x0003u, 0x2A00u, 8u, {'C', 'y', 'S', 'm', 't', 'S', 'i', 'm'}},
+    {0x0004u, 0x2800u, 2u, {0x01u, 0x18u}},
+    {0x0005u, 0x2803u, 5u, {0x20u, 0x06u, 0x00u, 0x05u, 0x2Au}},
+    {0x0006u, 0x2A05u, 4u, {0x01u, 0x00u, 0xFFu, 0xFFu}},
+    {0x0007u, 0x2902u, 2u, {0x00u, 0x00u}},
+    {0x0008u, 0x2800u, 2u, {0xF0u, 0xFFu}},
+    {0x0009u, 0x2803u, 5u, {0x1Au, 0x0Au, 0x00u, 0xF1u, 0xFFu}},
+    {0x000Au, 0xFFF1u, 20u, {0x00u}},
+    {0x000Bu, 0x2902u, 2u, {0x00u, 0x00u}},
+    {0x000Cu, 0x2803u, 5u, {0x0Cu, 0x0Du, 0x00u, 0xF2u, 0xFFu}},
+    {0x000Du, 0xFFF2u, 0u, {0x00u}},
+};
+
+#define SIM_DB_SIZE                 (sizeof(simDb) / sizeof(simDb[0]))
+
+/* Last handle of each service, the last one runs to the end of the range */
+static const CYBLE_GATT_DB_ATTR_HANDLE_T simServiceEnd[] = {0x0003u, 0x0007u, CYBLE_GATT_ATTR_HANDLE_END_RANGE};
+
+/* Stack globals the firmware reads and writes */
+CYBLE_STATE_T cyBle_state = CYBLE_STATE_STOPPED;
+CYBLE_CONN_HANDLE_T cyBle_connHandle;
+CYBLE_GAP_AUTH_INFO_T cyBle_authInfo;
+CYBLE_GAPC_DISC_INFO_T cyBle_discoveryInfo;
+CYBLE_GAPC_CONN_PARAM_T cyBle_connectionParameters;
+volatile uint8 cyBle_eventHandlerFlag;
+
+static CYBLE_CALLBACK_T simCallback = NULL;
+static SIM_EVENT_T simQueue[SIM_EVENT_QUEUE];
+static uint8 simQueueHead = 0;
+static uint8 simQueueCount = 0;
+
+static CYBLE_BLESS_STATE_T simBlessState = CYBLE_BLESS_STATE_EVENT_CLOSE;
+static uint16 simMtu = SIM_DEFAULT_MTU;
+static bool simScanning = false;
+static uint8 simAdvNext = 0;
+static uint32 simNtfCount = 0;
+static uint64 simNextConnEvent = 0;
+static CYBLE_GAP_BD_ADDR_T simLocalAddr = {{0x01u, 0x00u, 0x00u, 0x50u, 0xA0u, 0x00u}, 0x00u};
+static CYBLE_BLESS_PWR_IN_DB_T simTxPower;
+
+/* Start of the next connection event, the current one if it is running */
+static uint64 Sim_ConnEvent(void)
+{
+    uint64 now = Sim_Now();
+
+    if((0u == simConfig.connIntervalUs) || (cyBle_state != CYBLE_STATE_CONNECTED))
+    {
+        return now;
+    }
+    if(simNextConnEvent < now)
+    {
+        simNextConnEvent += ((now - simNextConnEvent + simConfig.connIntervalUs - 1u) /
+                              simConfig.connIntervalUs) * simConfig.connIntervalUs;
+    }
+    return simNextConnEvent;
+}
+
+/* Queues an event, NULL if the queue is full */
+static SIM_EVENT_T *Sim_Queue(uint32 event, uint64 due)
+{
+    SIM_EVENT_T *entry;
+
+    if(SIM_EVENT_QUEUE == simQueueCount)
+    {
+        return NULL;
+    }
+    entry = &simQueue[(simQueueHead + simQueueCount) % SIM_EVENT_QUEUE];
+    simQueueCount++;
+    entry->event = event;
+    entry->due = due;
+    entry->handle = 0;
+    entry->length = 0;
+    return entry;
+}
+
+static bool Sim_QueueRoom(uint8 events)
+{
+    return (simQueueCount + events) <= SIM_EVENT_QUEUE;
+}
+
+/* Removes the queued events for which drop returns true */
+static void Sim_Drop(bool (*drop)(uint32 event))
+{
+    uint8 kept = 0;
+    uint8 i;
+
+    for(i = 0; i < simQueueCount; i++)
+    {
+        SIM_EVENT_T *entry = &simQueue[(simQueueHead + i) % SIM_EVENT_QUEUE];
+
+        if(!drop(entry->event))
+        {
+            if(i != kept)
+            {
+                simQueue[(simQueueHead + kept) % SIM_EVENT_QUEUE] = *entry;
+            }
+            kept++;
+        }
+    }
+    simQueueCount = kept;
+}
+
+static bool Sim_IsGattResponse(uint32 event)
+{
+    return (CYBLE_EVT_GATTC_ERROR_RSP == event) || (CYBLE_EVT_GATTC_READ_BY_GROUP_TYPE_RSP == event) ||
+           (CYBLE_EVT_GATTC_READ_BY_TYPE_RSP == event) || (CYBLE_EVT_GATTC_FIND_INFO_RSP == event) ||
+           (CYBLE_EVT_GATTC_READ_RSP == event) || (CYBLE_EVT_GATTC_WRITE_RSP == event) ||
+           (CYBLE_EVT_GATTC_XCHNG_MTU_RSP == event) || (CYBLE_EVT_GATTC_LONG_PROCEDURE_END == event);
+}
+
+static bool Sim_IsScanReport(uint32 event)
+{
+    return CYBLE_EVT_GAPC_SCAN_PROGRESS_RESULT == event;
+}
+
+static bool Sim_IsConnectionEvent(uint32 event)
+{
+    return Sim_IsGattResponse(event) || (CYBLE_EVT_GATTC_HANDLE_VALUE_NTF == event) ||
+           (CYBLE_EVT_GATT_CONNECT_IND == event) || (CYBLE_EVT_GAP_DEVICE_CONNECTED == event);
+}
+
+static SIM_ATTR_T *Sim_FindAttr(CYBLE_GATT_DB_ATTR_HANDLE_T handle)
+{
+    uint8 i;
+
+    for(i = 0; i < SIM_DB_SIZE; i++)
+    {
+        if(simDb[i].handle == handle)
+        {
+            return &simDb[i];
+        }
+    }
+    return NULL;
+}
+
+static CYBLE_API_RESULT_T Sim_ErrorRsp(CYBLE_GATT_PDU_T opCode, CYBLE_GATT_DB_ATTR_HANDLE_T handle,
+                                       CYBLE_GATT_ERR_CODE_T error)
+{
+    SIM_EVENT_T *entry = Sim_Queue(CYBLE_EVT_GATTC_ERROR_RSP, Sim_ConnEvent());
+
+    if(NULL == entry)
+    {
+        return CYBLE_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    entry->handle = handle;
+    entry->data[0] = (uint8)opCode;
+    entry->data[1] = (uint8)error;
+    return CYBLE_ERROR_OK;
+}
+
+/* Common checks of a GATT client request, room for a response and an error */
+static CYBLE_API_RESULT_T Sim_GattcCheck(void)
+{
+    if(CYBLE_STATE_CONNECTED != cyBle_state)
+    {
+        return CYBLE_ERROR_INVALID_STATE;
+    }
+    return Sim_QueueRoom(2u) ? CYBLE_ERROR_OK : CYBLE_ERROR_MEMORY_ALLOCATION_FAILED;
+}
+
+/* Queues the next connection event's notifications and advertisement reports once the host keeps up */
+static void Sim_Generate(void)
+{
+    uint64 due;
+    uint8 i;
+
+    if(SimTransport_TxBacklog() > SIM_TX_BACKLOG_MAX)
+    {
+        return;
+    }
+
+    if((CYBLE_STATE_CONNECTED == cyBle_state) && (0u != (simDb[SIM_NTF_CCCD_HANDLE - 1u].value[0] & 0x01u)) &&
+       (0u == simQueueCount))
+    {
+        due = Sim_ConnEvent();
+        for(i = 0; (i < simConfig.ntfPerEvent) && Sim_QueueRoom(1u); i++)
+        {
+            SIM_EVENT_T *entry = Sim_Queue(CYBLE_EVT_GATTC_HANDLE_VALUE_NTF, due);
+
+            entry->handle = SIM_NTF_VALUE_HANDLE;
+            entry->length = (simConfig.ntfLength > (simMtu - 3u)) ? (simMtu - 3u) : simConfig.ntfLength;
+            memset(entry->data, (uint8)simNtfCount, entry->length);
+            memcpy(entry->data, &simNtfCount, (entry->length < sizeof(simNtfCount)) ? entry->length : sizeof(simNtfCount));
+            simNtfCount++;
+        }
+        simNextConnEvent = due + simConfig.connIntervalUs;
+    }
+
+    if(simScanning && (0u == simQueueCount))
+    {
+        for(i = 0; (i < simConfig.advDevices) && Sim_QueueRoom(1u); i++)
+        {
+            Sim_Queue(CYBLE_EVT_GAPC_SCAN_PROGRESS_RESULT, Sim_Now())->handle = simAdvNext++;
+        }
+    }
+}
+
+/* Builds the event parameters the stack passes for entry and calls the firmware */
+static void Sim_Deliver(SIM_EVENT_T *entry)
+{
+    union
+    {
+        CYBLE_CONN_HANDLE_T connHandle;
+        CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T connParam;
+        CYBLE_GAPC_ADV_REPORT_T advReport;
+        CYBLE_GATTC_READ_BY_GRP_RSP_PARAM_T readByGroup;
+        CYBLE_GATTC_FIND_INFO_RSP_PARAM_T findInfo;
+        CYBLE_GATTC_READ_RSP_PARAM_T readRsp;
+        CYBLE_GATTC_HANDLE_VALUE_NTF_PARAM_T notification;
+        CYBLE_GATT_XCHG_MTU_PARAM_T mtu;
+        CYBLE_GATTC_ERR_RSP_PARAM_T error;
+        uint8 status;
+    }param;
+    uint8 advData[16] = {0x02u, 0x01u, 0x06u, 0x0Bu, 0x09u, 'C', 'y', 'S', 'm', 't', 'A', 'd', 'v', ' ', '0', '0'};
+    uint8 advAddr[CYBLE_GAP_BD_ADDR_SIZE] = {0x00u, 0x00u, 0x00u, 0x50u, 0xA0u, 0x00u};
+    void *eventParam = &param;
+
+    memset(&param, 0, sizeof(param));
+    param.connHandle = cyBle_connHandle;
+
+    switch(entry->event)
+    {
+        case CYBLE_EVT_STACK_ON:
+        case CYBLE_EVT_GATTC_STOP_CMD_COMPLETE:
+            eventParam = NULL;
+            break;
+
+        case CYBLE_EVT_GATT_CONNECT_IND:
+            cyBle_state = CYBLE_STATE_CONNECTED;
+            simNextConnEvent = Sim_Now();
+            break;
+
+        case CYBLE_EVT_GAP_DEVICE_CONNECTED:
+            param.connParam.status = CYBLE_ERROR_OK;
+            param.connParam.connIntv = (0u != simConfig.connIntervalUs) ?
+                                       (uint16)(simConfig.connIntervalUs / 1250u) : 6u;
+            param.connParam.connLatency = 0u;
+            param.connParam.supervisionTO = 100u;
+            break;
+
+        case CYBLE_EVT_GAP_DEVICE_DISCONNECTED:
+        case CYBLE_EVT_GAPC_SCAN_START_STOP:
+            param.status = entry->data[0];
+            break;
+
+        case CYBLE_EVT_GAPC_SCAN_PROGRESS_RESULT:
+            /* Advertisers take turns, each with its own address and a drifting RSSI */
+            advAddr[0] = (uint8)(entry->handle % simConfig.advDevices);
+            advData[14] = (uint8)('0' + (advAddr[0] / 10u));
+            advData[15] = (uint8)('0' + (advAddr[0] % 10u));
+            param.advReport.eventType = CYBLE_GAPC_CONN_UNDIRECTED_ADV;
+            param.advReport.peerAddrType = 0u;
+            param.advReport.peerBdAddr = advAddr;
+            param.advReport.dataLen = sizeof(advData);
+            param.advReport.data = advData;
+            param.advReport.rssi = (int8)(-40 - (int8)((entry->handle / simConfig.advDevices) % 40u));
+            break;
+
+        case CYBLE_EVT_GATTC_READ_BY_GROUP_TYPE_RSP:
+        case CYBLE_EVT_GATTC_READ_BY_TYPE_RSP:
+            param.readByGroup.attrData.attrValue = entry->data;
+            param.readByGroup.attrData.length = entry->handle;
+            param.readByGroup.attrData.attrLen = entry->length;
+            break;
+
+        case CYBLE_EVT_GATTC_FIND_INFO_RSP:
+            param.findInfo.handleValueList.list = entry->data;
+            param.findInfo.handleValueList.byteCount = entry->length;
+            param.findInfo.uuidFormat = CYBLE_GATT_16_BIT_UUID_FORMAT;
+            break;
+
+        case CYBLE_EVT_GATTC_READ_RSP:
+            param.readRsp.value.val = entry->data;
+            param.readRsp.value.len = entry->length;
+            param.readRsp.value.actualLen = entry->length;
+            break;
+
+        case CYBLE_EVT_GATTC_HANDLE_VALUE_NTF:
+            param.notification.handleValPair.attrHandle = entry->handle;
+            param.notification.handleValPair.value.val = entry->data;
+            param.notification.handleValPair.value.len = entry->length;
+            param.notification.handleValPair.value.actualLen = entry->length;
+            break;
+
+        case CYBLE_EVT_GATTC_XCHNG_MTU_RSP:
+            param.mtu.mtu = entry->handle;
+            break;
+
+        case CYBLE_EVT_GATTC_ERROR_RSP:
+            param.error.opCode = (CYBLE_GATT_PDU_T)entry->data[0];
+            param.error.attrHandle = entry->handle;
+            param.error.errorCode = (CYBLE_GATT_ERR_CODE_T)entry->data[1];
+            break;
+
+        default:
+            /* CYBLE_CONN_HANDLE_T, e.g. CYBLE_EVT_GATTC_WRITE_RSP */
+            break;
+    }
+
+    if(NULL != simCallback)
+    {
+        simCallback(entry->event, eventParam);
+    }
+}
+
+/* Microseconds until the stack has work, 0 if it has some now, -1 for none */
+int32 SimStack_NextEventUs(void)
+{
+    uint64 now = Sim_Now();
+    uint64 due;
+
+    if(0u == simQueueCount)
+    {
+        bool streaming = (CYBLE_STATE_CONNECTED == cyBle_state) &&
+                         (0u != (simDb[SIM_NTF_CCCD_HANDLE - 1u].value[0] & 0x01u));
+
+        if((!streaming && !simScanning) || (SimTransport_TxBacklog() > SIM_TX_BACKLOG_MAX))
+        {
+            return -1;
+        }
+        due = (streaming && (0u != simConfig.connIntervalUs)) ? simNextConnEvent : now;
+    }
+    else
+    {
+        due = simQueue[simQueueHead].due;
+    }
+    return (due <= now) ? 0 : (int32)(due - now);
+}
+
+/*******************************************************************************
+* Stack control
+*******************************************************************************/
+
+CYBLE_API_RESULT_T CyBle_Start(CYBLE_CALLBACK_T callbackFunc)
+{
+    simCallback = callbackFunc;
+    simQueueCount = 0;
+    simScanning = false;
+    simMtu = SIM_DEFAULT_MTU;
+    simDb[SIM_NTF_CCCD_HANDLE - 1u].value[0] = 0u;
+    cyBle_state = CYBLE_STATE_DISCONNECTED;
+    (void)Sim_Queue(CYBLE_EVT_STACK_ON, Sim_Now());
+    return CYBLE_ERROR_OK;
+}
+
+void CyBle_ProcessEvents(void)
+{
+    uint64 now = Sim_Now();
+    uint8 count;
+
+    Sim_Generate();
+
+    /* Events the firmware queues from its callback wait for the next pass */
+    for(count = simQueueCount; (0u != count) && (0u != simQueueCount) && (simQueue[simQueueHead].due <= now); count--)
+    {
+        SIM_EVENT_T entry = simQueue[simQueueHead];
+
+        simQueueHead = (simQueueHead + 1u) % SIM_EVENT_QUEUE;
+        simQueueCount--;
+
+        /* The radio is busy for the events of a connection event, the firmware sees it close after them */
+        simBlessState = Sim_IsConnectionEvent(entry.event) ? CYBLE_BLESS_STATE_ACTIVE : CYBLE_BLESS_STATE_EVENT_CLOSE;
+        Sim_Deliver(&entry);
+    }
+    simBlessState = CYBLE_BLESS_STATE_EVENT_CLOSE;
+}
+
+CYBLE_BLESS_STATE_T CyBle_GetBleSsState(void)
+{
+    return simBlessState;
+}
+
+CYBLE_API_RESULT_T CyBle_StoreBondingData(uint8 isForceWrite)
+{
+    (void)isForceWrite;
+    return CYBLE_ERROR_OK;
+}
+
+CYBLE_API_RESULT_T CyBle_IsLLControlProcPending(void)
+{
+    return CYBLE_ERROR_OK;
+}
+
+uint16 CyBle_Get16ByPtr(const uint8 ptr[])
+{
+    return (uint16)(ptr[0] | ((uint16)ptr[1] << 8));
+}
+
+void CyBle_Set16ByPtr(uint8 ptr[], uint16 value)
+{
+    ptr[0] = LO8(value);
+    ptr[1] = HI8(value);
+}
+
+CYBLE_API_RESULT_T CyBle_GetBleClockCfgParam(CYBLE_BLESS_CLK_CFG_PARAMS_T *bleSsClockConfig)
+{
+    memset(bleSsClockConfig, 0, sizeof(*bleSsClockConfig));
+    return CYBLE_ERROR_OK;
+}
+
+CYBLE_API_RESULT_T CyBle_SetBleClockCfgParam(CYBLE_BLESS_CLK_CFG_PARAMS_T *bleSsClockConfig)
+{
+    (void)bleSsClockConfig;
+    return CYBLE_ERROR_OK;
+}
+
+CYBLE_API_RESULT_T CyBle_GetStackLibraryVersion(CYBLE_STACK_LIB_VERSION_T *stackVersion)
+{
+    stackVersion->majorVersion = 3u;
+    stackVersion->minorVersion = 0u;
+    stackVersion->patch = 0u;
+    stackVersion->buildNumber = 0u;
+    return CYBLE_ERROR_OK;
+}
+
+CYBLE_API_RESULT_T CyBle_GetDeviceAddress(CYBLE_GAP_BD_ADDR_T *bdAddr)
+{
+    memcpy(bdAddr->bdAddr, simLocalAddr.bdAddr, sizeof(bdAddr->bdAddr));
+    return CYBLE_ERROR_OK;
+}
+
+CYBLE_API_RESULT_T CyBle_SetDeviceAddress(CYBLE_GAP_BD_ADDR_T *bdAddr)
+{
+    simLocalAddr = *bdAddr;
+    return CYBLE_ERROR_OK;
+}
+
+int8 CyBle_GetRssi(void)
+{
+    return -60;
+}
+
+CYBLE_API_RESULT_T CyBle_GetTxPowerLevel(CYBLE_BLESS_PWR_IN_DB_T *bleSsPwrLvl)
+{
+    bleSsPwrLvl->blePwrLevelInDbm = simTxPower.blePwrLevelInDbm;
+    return CYBLE_ERROR_OK;
+}
+
+CYBLE_API_RESULT_T CyBle_SetTxPowerLevel(CYBLE_BLESS_PWR_IN_DB_T *bleSsPwrLvl)
+{
+    simTxPower = *bleSsPwrLvl;
+    return CYBLE_ERROR_OK;
+}
+
+/*******************************************************************************
+* GAP
+*******************************************************************************/
+
+CYBLE_API_RESULT_T CyBle_GapSetIoCap(CYBLE_GAP_IOCAP_T ioCap)
+{
+    (void)ioCap;
+    return CYBLE_ERROR_OK;
+}
+
+CYBLE_API_RESULT_T CyBle_GapcStartScan(uint8 scanningIntervalType)
+{
+    (void)scanningIntervalType;
+    if(CYBLE_STATE_DISCONNECTED != cyBle_state)
+    {
+        return CYBLE_ERROR_INVALID_STATE;
+    }
+    cyBle_state = CYBLE_STATE_SCANNING;
+    simScanning = true;
+    (void)Sim_Queue(CYBLE_EVT_GAPC_SCAN_START_STOP, Sim_Now());
+    return CYBLE_ERROR_OK;
+}
+
+void CyBle_GapcStopScan(void)
+{
+    SIM_EVENT_T *entry;
+
+    if(!simScanning)
+    {
+        return;
+    }
+    simScanning = false;
+    cyBle_state = CYBLE_STATE_DISCONNECTED;
+    Sim_Drop(Sim_IsScanReport);
+    entry = Sim_Queue(CYBLE_EVT_GAPC_SCAN_START_STOP, Sim_Now());
+    entry->data[0] = CYBLE_ERROR_OK;
+}
+
+CYBLE_API_RESULT_T CyBle_GapcConnectDevice(const CYBLE_GAP_BD_ADDR_T *address)
+{
+    uint64 due = Sim_Now() + simConfig.connIntervalUs;
+
+    (void)address;
+    if(CYBLE_STATE_DISCONNECTED != cyBle_state)
+    {
+        return CYBLE_ERROR_INVALID_STATE;
+    }
+    if(!Sim_QueueRoom(2u))
+    {
+        return CYBLE_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    cyBle_state = CYBLE_STATE_CONNECTING;
+    (void)Sim_Queue(CYBLE_EVT_GATT_CONNECT_IND, due);
+    (void)Sim_Queue(CYBLE_EVT_GAP_DEVICE_CONNECTED, due);
+    return CYBLE_ERROR_OK;
+}
+
+CYBLE_API_RESULT_T CyBle_GapcCancelDeviceConnection(void)
+{
+    if(CYBLE_STATE_CONNECTING != cyBle_state)
+    {
+        return CYBLE_ERROR_INVALID_STATE;
+    }
+    Sim_Drop(Sim_IsConnectionEvent);
+    cyBle_state = CYBLE_STATE_DISCONNECTED;
+    return CYBLE_ERROR_OK;
+}
+
+CYBLE_API_RESULT_T CyBle_GapDisconnect(uint8 bdHandle)
+{
+    SIM_EVENT_T *entry;
+
+    (void)bdHandle;
+    if(CYBLE_STATE_CONNECTED != cyBle_state)
+    {
+        return CYBLE_ERROR_INVALID_STATE;
+    }
+    Sim_Drop(Sim_IsConnectionEvent);
+    cyBle_state = CYBLE_STATE_DISCONNECTED;
+    simMtu = SIM_DEFAULT_MTU;
+    simDb[SIM_NTF_CCCD_HANDLE - 1u].value[0] = 0u;
+    entry = Sim_Queue(CYBLE_EVT_GAP_DEVICE_DISCONNECTED, Sim_Now());
+    entry->data[0] = SIM_DISCONNECT_REASON;
+    return CYBLE_ERROR_OK;
+}
+
+/*******************************************************************************
+* GATT client
+*******************************************************************************/
+
+CYBLE_API_RESULT_T CyBle_GattGetMtuSize(uint16 *mtu)
+{
+    *mtu = simMtu;
+    return CYBLE_ERROR_OK;
+}
+
+CYBLE_API_RESULT_T CyBle_GattcExchangeMtuReq(CYBLE_CONN_HANDLE_T connHandle, uint16 mtu)
+{
+    CYBLE_API_RESULT_T status = Sim_GattcCheck();
+
+    (void)connHandle;
+    if(CYBLE_ERROR_OK == status)
+    {
+        simMtu = (mtu < SIM_PEER_MTU) ? mtu : SIM_PEER_MTU;
+        Sim_Queue(CYBLE_EVT_GATTC_XCHNG_MTU_RSP, Sim_ConnEvent())->handle = SIM_PEER_MTU;
+    }
+    return status;
+}
+
+CYBLE_API_RESULT_T CyBle_GattcDiscoverAllPrimaryServices(CYBLE_CONN_HANDLE_T connHandle)
+{
+    CYBLE_API_RESULT_T status = Sim_GattcCheck();
+    SIM_EVENT_T *entry;
+    uint8 service = 0;
+    uint8 i;
+
+    (void)connHandle;
+    if(CYBLE_ERROR_OK != status)
+    {
+        return status;
+    }
+
+    /* Start and end handle, then the 16 bit UUID of each service */
+    entry = Sim_Queue(CYBLE_EVT_GATTC_READ_BY_GROUP_TYPE_RSP, Sim_ConnEvent());
+    entry->handle = 6u;
+    for(i = 0; i < SIM_DB_SIZE; i++)
+    {
+        if(0x2800u == simDb[i].type)
+        {
+            CyBle_Set16ByPtr(&entry->data[entry->length], simDb[i].handle);
+            CyBle_Set16ByPtr(&entry->data[entry->length + 2u], simServiceEnd[service++]);
+            memcpy(&entry->data[entry->length + 4u], simDb[i].value, 2u);
+            entry->length += entry->handle;
+        }
+    }
+    return CYBLE_ERROR_OK;
+}
+
+CYBLE_API_RESULT_T CyBle_GattcDiscoverAllCharacteristics(CYBLE_CONN_HANDLE_T connHandle,
+                                                        CYBLE_GATT_ATTR_HANDLE_RANGE_T range)
+{
+    CYBLE_API_RESULT_T status = Sim_GattcCheck();
+    CYBLE_GATT_DB_ATTR_HANDLE_T last = 0;
+    SIM_EVENT_T *entry;
+    uint8 i;
+
+    (void)connHandle;
+    if(CYBLE_ERROR_OK != status)
+    {
+        return status;
+    }
+
+    /* Declaration handle, properties, value handle and 16 bit UUID of each characteristic */
+    entry = Sim_Queue(CYBLE_EVT_GATTC_READ_BY_TYPE_RSP, Sim_ConnEvent());
+    entry->handle = 7u;
+    for(i = 0; i < SIM_DB_SIZE; i++)
+    {
+        if((0x2803u == simDb[i].type) && (simDb[i].handle >= range.startHandle) &&
+           (simDb[i].handle <= range.endHandle))
+        {
+            CyBle_Set16ByPtr(&entry->data[entry->length], simDb[i].handle);
+            memcpy(&entry->data[entry->length + 2u], simDb[i].value, 5u);
+            entry->length += entry->handle;
+            last = simDb[i].handle;
+        }
+    }
+
+    if(0u == entry->length)
+    {
+        /* Nothing in range, the procedure ends with an error response only */
+        simQueueCount--;
+        return Sim_ErrorRsp(CYBLE_GATT_READ_BY_TYPE_REQ, range.startHandle, CYBLE_GATT_ERR_ATTRIBUTE_NOT_FOUND);
+    }
+    if(last != range.endHandle)
+    {
+        /* The stack reads on past the last characteristic */
+        (void)Sim_ErrorRsp(CYBLE_GATT_READ_BY_TYPE_REQ, last + 1u, CYBLE_GATT_ERR_ATTRIBUTE_NOT_FOUND);
+    }
+    return CYBLE_ERROR_OK;
+}
+
+CYBLE_API_RESULT_T CyBle_GattcDiscoverAllCharacteristicDescriptors(CYBLE_CONN_HANDLE_T connHandle,
+                                                                  CYBLE_GATTC_FIND_INFO_REQ_T *findInfoReqParam)
+{
+    CYBLE_API_RESULT_T status = Sim_GattcCheck();
+    CYBLE_GATT_DB_ATTR_HANDLE_T last = 0;
+    SIM_EVENT_T *entry;
+    uint8 i;
+
+    (void)connHandle;
+    if(CYBLE_ERROR_OK != status)
+    {
+        return status;
+    }
+
+    /* Handle and 16 bit type of each attribute in range */
+    entry = Sim_Queue(CYBLE_EVT_GATTC_FIND_INFO_RSP, Sim_ConnEvent());
+    for(i = 0; i < SIM_DB_SIZE; i++)
+    {
+        if((simDb[i].handle >= findInfoReqParam->startHandle) && (simDb[i].handle <= findInfoReqParam->endHandle))
+        {
+            CyBle_Set16ByPtr(&entry->data[entry->length], simDb[i].handle);
+            CyBle_Set16ByPtr(&entry->data[entry->length + 2u], simDb[i].type);
+            entry->length += 4u;
+            last = simDb[i].handle;
+        }
+    }
+
+    if(0u == entry->length)
+    {
+        simQueueCount--;
+        return Sim_ErrorRsp(CYBLE_GATT_FIND_INFO_REQ, findInfoReqParam->startHandle,
+                            CYBLE_GATT_ERR_ATTRIBUTE_NOT_FOUND);
+    }
+    if(last != findInfoReqParam->endHandle)
+    {
+        (void)Sim_ErrorRsp(CYBLE_GATT_FIND_INFO_REQ, last + 1u, CYBLE_GATT_ERR_ATTRIBUTE_NOT_FOUND);
+    }
+    return CYBLE_ERROR_OK;
+}
+
+CYBLE_API_RESULT_T CyBle_GattcReadCharacteristicValue(CYBLE_CONN_HANDLE_T connHandle,
+                                                     CYBLE_GATTC_READ_REQ_T readReqParam)
+{
+    CYBLE_API_RESULT_T status = Sim_GattcCheck();
+    SIM_ATTR_T *attr = Sim_FindAttr(readReqParam);
+    SIM_EVENT_T *entry;
+
+    (void)connHandle;
+    if(CYBLE_ERROR_OK != status)
+    {
+        return status;
+    }
+    if(NULL == attr)
+    {
+        return Sim_ErrorRsp(CYBLE_GATT_READ_REQ, readReqParam, CYBLE_GATT_ERR_INVALID_HANDLE);
+    }
+
+    entry = Sim_Queue(CYBLE_EVT_GATTC_READ_RSP, Sim_ConnEvent());
+    entry->length = (attr->length > (simMtu - 1u)) ? (simMtu - 1u) : attr->length;
+    memcpy(entry->data, attr->value, entry->length);
+    return CYBLE_ERROR_OK;
+}
+
+/* Stores a written value, false for an unknown handle or a value past SIM_ATTR_VALUE_MAX */
+static bool Sim_WriteAttr(CYBLE_GATT_HANDLE_VALUE_PAIR_T *pair, uint16 offset)
+{
+    SIM_ATTR_T *attr = Sim_FindAttr(pair->attrHandle);
+
+    if((NULL == attr) || ((offset + pair->value.len) > SIM_ATTR_VALUE_MAX))
+    {
+        return false;
+    }
+    memcpy(&attr->value[offset], pair->value.val, pair->value.len);
+    attr->length = offset + pair->value.len;
+    return true;
+}
+
+static CYBLE_API_RESULT_T Sim_Write(uint32 event, CYBLE_GATT_PDU_T opCode,
+                                    CYBLE_GATT_HANDLE_VALUE_PAIR_T *pair, uint16 offset)
+{
+    CYBLE_API_RESULT_T status = Sim_GattcCheck();
+
+    if(CYBLE_ERROR_OK != status)
+    {
+        return status;
+    }
+    if(!Sim_WriteAttr(pair, offset))
+    {
+        return Sim_ErrorRsp(opCode, pair->attrHandle, CYBLE_GATT_ERR_INVALID_HANDLE);
+    }
+    (void)Sim_Queue(event, Sim_ConnEvent());
+    return CYBLE_ERROR_OK;
+}
+
+CYBLE_API_RESULT_T CyBle_GattcWriteCharacteristicValue(CYBLE_CONN_HANDLE_T connHandle,
+                                                      CYBLE_GATTC_WRITE_REQ_T *writeReqParam)
+{
+    (void)connHandle;
+    return Sim_Write(CYBLE_EVT_GATTC_WRITE_RSP, CYBLE_GATT_WRITE_REQ, writeReqParam, 0u);
+}
+
+CYBLE_API_RESULT_T CyBle_GattcWriteCharacteristicDescriptors(CYBLE_CONN_HANDLE_T connHandle,
+                                                            CYBLE_GATTC_WRITE_REQ_T *writeReqParam)
+{
+    (void)connHandle;
+    return Sim_Write(CYBLE_EVT_GATTC_WRITE_RSP, CYBLE_GATT_WRITE_REQ, writeReqParam, 0u);
+}
+
+CYBLE_API_RESULT_T CyBle_GattcWriteLongCharacteristicValues(CYBLE_CONN_HANDLE_T connHandle,
+                                                           CYBLE_GATTC_PREP_WRITE_REQ_T *writePrepReqParam)
+{
+    (void)connHandle;
+    return Sim_Write(CYBLE_EVT_GATTC_LONG_PROCEDURE_END, CYBLE_GATT_PREPARE_WRITE_REQ,
+                     &writePrepReqParam->handleValuePair, writePrepReqParam->offset);
+}
+
+CYBLE_API_RESULT_T CyBle_GattcWriteWithoutResponse(CYBLE_CONN_HANDLE_T connHandle,
+                                                  CYBLE_GATTC_WRITE_CMD_REQ_T *writeCmdReqParam)
+{
+    (void)connHandle;
+    if(CYBLE_STATE_CONNECTED != cyBle_state)
+    {
+        return CYBLE_ERROR_INVALID_STATE;
+    }
+
+    /* No response, a bad handle goes unnoticed as on air */
+    (void)Sim_WriteAttr(writeCmdReqParam, 0u);
+    return CYBLE_ERROR_OK;
+}
+
+void CyBle_GattcStopCmd(void)
+{
+    Sim_Drop(Sim_IsGattResponse);
+    (void)Sim_Queue(CYBLE_EVT_GATTC_STOP_CMD_COMPLETE, Sim_Now());
+}
+
+CYBLE_GATT_ERR_CODE_T CyBle_GattsWriteAttributeValue(CYBLE_GATT_HANDLE_VALUE_PAIR_T *handleValuePair,
+                                                     uint16 offset, CYBLE_CONN_HANDLE_T *connHandle, uint8 flags)
+{
+    (void)handleValuePair;
+    (void)offset;
+    (void)connHandle;
+    (void)flags;
+    return CYBLE_GATT_ERR_NONE;
+}
+
+/*******************************************************************************
+* L2CAP, PSM registration only
+*******************************************************************************/
+
+CYBLE_API_RESULT_T CyBle_L2capCbfcRegisterPsm(uint16 l2capPsm, uint16 creditLwm)
+{
+    (void)l2capPsm;
+    (void)creditLwm;
+    return CYBLE_ERROR_OK;
+}
+
+CYBLE_API_RESULT_T CyBle_L2capCbfcUnregisterPsm(uint16 l2capPsm)
+{
+    (void)l2capPsm;
+    return CYBLE_ERROR_OK;
+}
+
+/*******************************************************************************
+* Not modelled, the dongle reports CYBLE_ERROR_INVALID_OPERATION to the host
+*******************************************************************************/
+
+#define SIM_NOT_MODELLED            return CYBLE_ERROR_INVALID_OPERATION
+
+CYBLE_API_RESULT_T CyBle_GapAddDeviceToResolvingList(const CYBLE_GAP_RESOLVING_DEVICE_INFO_T *rpaInfo)
+{ (void)rpaInfo; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapAddDeviceToWhiteList(CYBLE_GAP_BD_ADDR_T *bdAddr)
+{ (void)bdAddr; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapAuthPassKeyReply(uint8 bdHandle, uint32 passkey, uint8 accept)
+{ (void)bdHandle; (void)passkey; (void)accept; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapAuthReq(uint8 bdHandle, CYBLE_GAP_AUTH_INFO_T *authInfo)
+{ (void)bdHandle; (void)authInfo; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapAuthSendKeyPress(uint8 bdHandle, CYBLE_GAP_KEYPRESS_NOTIFY_TYPE notificationType)
+{ (void)bdHandle; (void)notificationType; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapClearResolvingList(void)
+{ SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapConvertOctetToTime(CYBLE_GAP_PHY_TYPE_T phy, uint16 octets, uint16 *pTime)
+{ (void)phy; (void)octets; (void)pTime; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapGenerateDeviceAddress(CYBLE_GAP_BD_ADDR_T *bdAddr, CYBLE_GAP_ADDR_TYPE_T addrType, uint8 *irk)
+{ (void)bdAddr; (void)addrType; (void)irk; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapGenerateKeys(uint8 keysFlag, CYBLE_GAP_SMP_KEY_DIST_T *keyInfo)
+{ (void)keysFlag; (void)keyInfo; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapGenerateLocalP256Keys(void)
+{ SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapGenerateOobData(const uint8 *pRand)
+{ (void)pRand; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapGetBondedDevicesByRank(CYBLE_GAP_DEVICE_ADDR_LIST_T *bondedDevList)
+{ (void)bondedDevList; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapGetChannelMap(uint8 bdHandle, uint8 *channelMap)
+{ (void)bdHandle; (void)channelMap; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapGetDataLength(CYBLE_GAP_DATA_LENGTH_T *readParam)
+{ (void)readParam; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapGetDevSecurityKeyInfo(uint8 *keyFlags, CYBLE_GAP_SMP_KEY_DIST_T *keys)
+{ (void)keyFlags; (void)keys; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapGetDevicesFromWhiteList(uint8 *count, CYBLE_GAP_BD_ADDR_T *addr)
+{ (void)count; (void)addr; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapGetPeerBdAddr(uint8 bdHandle, CYBLE_GAP_BD_ADDR_T *peerBdAddr)
+{ (void)bdHandle; (void)peerBdAddr; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapGetPeerBdHandle(uint8 *bdHandle, CYBLE_GAP_BD_ADDR_T *peerBdAddr)
+{ (void)bdHandle; (void)peerBdAddr; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapGetPeerDevSecurity(uint8 bdHandle, CYBLE_GAP_AUTH_INFO_T *security)
+{ (void)bdHandle; (void)security; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapGetPeerDevSecurityKeyInfo(uint8 bdHandle, uint8 *keysFlag, CYBLE_GAP_SMP_KEY_DIST_T *keyInfo)
+{ (void)bdHandle; (void)keysFlag; (void)keyInfo; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapReadLocalResolvableAddress(const CYBLE_GAP_BD_ADDR_T *peerIdentityAddr, uint8 *localResolvableAddress)
+{ (void)peerIdentityAddr; (void)localResolvableAddress; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapReadPeerResolvableAddress(const CYBLE_GAP_BD_ADDR_T *peerIdentityAddr, uint8 *peerResolvableAddress)
+{ (void)peerIdentityAddr; (void)peerResolvableAddress; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapReadResolvingList(CYBLE_GAP_RESOLVING_LIST_T *resolvingList)
+{ (void)resolvingList; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapRemoveBondedDevice(CYBLE_GAP_BD_ADDR_T *bdAddr)
+{ (void)bdAddr; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapRemoveDeviceFromResolvingList(const CYBLE_GAP_BD_ADDR_T *peerIdentityAddr)
+{ (void)peerIdentityAddr; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapRemoveDeviceFromWhiteList(CYBLE_GAP_BD_ADDR_T *bdAddr)
+{ (void)bdAddr; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapSetAddressResolutionEnable(uint8 enableDisable)
+{ (void)enableDisable; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapSetDataLength(uint8 bdHandle, uint16 connMaxTxOctets, uint16 connMaxTxTime)
+{ (void)bdHandle; (void)connMaxTxOctets; (void)connMaxTxTime; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapSetIdAddress(const CYBLE_GAP_BD_ADDR_T *bdAddr)
+{ (void)bdAddr; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapSetOobData(uint8 bdHandle, uint8 oobFlag, uint8 *key, uint8 *oobData, uint8 *oobDataLen)
+{ (void)bdHandle; (void)oobFlag; (void)key; (void)oobData; (void)oobDataLen; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapSetResolvablePvtAddressTimeOut(uint16 rpaTimeOut)
+{ (void)rpaTimeOut; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapSetSecureConnectionsOnlyMode(uint8 state)
+{ (void)state; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapSetSecurityKeys(uint8 keysFlag, CYBLE_GAP_SMP_KEY_DIST_T *keyInfo)
+{ (void)keysFlag; (void)keyInfo; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapSetSuggestedDataLength(uint16 suggestedTxOctets, uint16 suggestedTxTime)
+{ (void)suggestedTxOctets; (void)suggestedTxTime; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapcConnectionParamUpdateRequest(uint8 bdHandle, CYBLE_GAP_CONN_UPDATE_PARAM_T *connParam)
+{ (void)bdHandle; (void)connParam; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapcResolveDevice(const uint8 *bdAddr, const uint8 *irk)
+{ (void)bdAddr; (void)irk; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapcSetHostChannelClassification(uint8 *channelMap)
+{ (void)channelMap; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GapcSetRemoteAddr(uint8 bdHandle, CYBLE_GAP_BD_ADDR_T remoteAddr)
+{ (void)bdHandle; (void)remoteAddr; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GattcConfirmation(CYBLE_CONN_HANDLE_T connHandle)
+{ (void)connHandle; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GattcDiscoverCharacteristicByUuid(CYBLE_CONN_HANDLE_T connHandle, CYBLE_GATTC_READ_BY_TYPE_REQ_T *readByTypeReqParam)
+{ (void)connHandle; (void)readByTypeReqParam; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GattcDiscoverPrimaryServiceByUuid(CYBLE_CONN_HANDLE_T connHandle, CYBLE_GATT_VALUE_T value)
+{ (void)connHandle; (void)value; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GattcFindIncludedServices(CYBLE_CONN_HANDLE_T connHandle, CYBLE_GATT_ATTR_HANDLE_RANGE_T *range)
+{ (void)connHandle; (void)range; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GattcReadCharacteristicDescriptors(CYBLE_CONN_HANDLE_T connHandle, CYBLE_GATTC_READ_REQ_T readReqParam)
+{ (void)connHandle; (void)readReqParam; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GattcReadLongCharacteristicDescriptors(CYBLE_CONN_HANDLE_T connHandle, CYBLE_GATTC_READ_BLOB_REQ_T *readBlobReqParam)
+{ (void)connHandle; (void)readBlobReqParam; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GattcReadLongCharacteristicValues(CYBLE_CONN_HANDLE_T connHandle, CYBLE_GATTC_READ_BLOB_REQ_T *readBlobReqParam)
+{ (void)connHandle; (void)readBlobReqParam; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GattcReadMultipleCharacteristicValues(CYBLE_CONN_HANDLE_T connHandle, CYBLE_GATTC_READ_MULT_REQ_T *readMultiReqParam)
+{ (void)connHandle; (void)readMultiReqParam; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GattcReadUsingCharacteristicUuid(CYBLE_CONN_HANDLE_T connHandle, CYBLE_GATTC_READ_BY_TYPE_REQ_T *readByTypeReqParam)
+{ (void)connHandle; (void)readByTypeReqParam; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GattcReliableWrites(CYBLE_CONN_HANDLE_T connHandle, CYBLE_GATTC_PREP_WRITE_REQ_T *writePrepReqParam, uint8 numOfRequests)
+{ (void)connHandle; (void)writePrepReqParam; (void)numOfRequests; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GattcSendExecuteWriteReq(CYBLE_CONN_HANDLE_T connHandle, uint8 flag)
+{ (void)connHandle; (void)flag; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GattcSignedWriteWithoutRsp(CYBLE_CONN_HANDLE_T connHandle, CYBLE_GATTC_SIGNED_WRITE_CMD_REQ_T *signedWriteWithoutRspParam)
+{ (void)connHandle; (void)signedWriteWithoutRspParam; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_GattcWriteLongCharacteristicDescriptors(CYBLE_CONN_HANDLE_T connHandle, CYBLE_GATTC_PREP_WRITE_REQ_T *writePrepReqParam)
+{ (void)connHandle; (void)writePrepReqParam; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_L2capCbfcConnectReq(uint8 bdHandle, uint16 remotePsm, uint16 localPsm, CYBLE_L2CAP_CBFC_CONNECT_PARAM_T *param)
+{ (void)bdHandle; (void)remotePsm; (void)localPsm; (void)param; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_L2capCbfcConnectRsp(uint16 localCid, uint16 response, CYBLE_L2CAP_CBFC_CONNECT_PARAM_T *param)
+{ (void)localCid; (void)response; (void)param; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_L2capCbfcSendFlowControlCredit(uint16 localCid, uint16 credit)
+{ (void)localCid; (void)credit; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_L2capChannelDataWrite(uint8 bdHandle, uint16 localCid, uint8 *buffer, uint16 bufferLen)
+{ (void)bdHandle; (void)localCid; (void)buffer; (void)bufferLen; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_L2capDisconnectReq(uint16 localCid)
+{ (void)localCid; SIM_NOT_MODELLED; }
+CYBLE_API_RESULT_T CyBle_L2capLeConnectionParamUpdateResponse(uint8 bdHandle, uint16 result)
+{ (void)bdHandle; (void)result; SIM_NOT_MODELLED; }
+
+/*******************************************************************************
+* Application and board functions the CySmart module calls
+*******************************************************************************/
+
+void BLE_Init(void)
+{
+    /* Application mode is not simulated */
+}
+
+void BLE_DeInit(void)
+{
+    simCallback = NULL;
+    simQueueCount = 0;
+    simScanning = false;
+    cyBle_state = CYBLE_STATE_STOPPED;
+}
+
+void Led_Stop(void)
+{
+}
+
+uint32 Timer_Get_Time_Stamp(void)
+{
+    return (uint32)(Sim_Now() / 1000u);
+}
+
+uint32 Timer_Get_Time_Stamp_Us(void)
+{
+    return (uint32)Sim_Now();
+}
+
+bool Timer_Time_Elapsed(uint32 time_stamp, uint32 interval)
+{
+    return (Timer_Get_Time_Stamp() - time_stamp) >= interval;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,591 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+
+/* Transport layer of the dongle on a pseudo-terminal, in place of
+   CySmt_TransportLayer.c. The host opens the pty slave like the dongle's
+   serial port.
+
+   Commands wait in CMD_QUEUE_SLOTS slots as on the dongle and the last
+   free slot is kept for commands CySmt_IsConcurrentCmd() lets run next to
+   a primary command. A packet is only taken into a slot once it is whole,
+   while none is free the host's bytes stay unread. A payload above
+   MAX_PAYLOAD_SIZE is queued without it and its bytes are scanned again
+   as stream, as the dongle does. The 10 ms inter-byte timeout is not
+   modelled, a pty loses no bytes.
+
+   Framed mode uses the host side framing of CySmtFrame.c for both
+   directions. Over a pty no frame is lost or damaged, so it behaves as the
+   dongle's in order receiver does: a frame is only read once the packet of
+   the one before found a slot.
+
+   With simConfig.uartBaud set, bytes in either direction are held until a
+   UART at that rate would have sent them, one after the other. */
+#define _XOPEN_SOURCE 600
+#define _GNU_SOURCE
+#include "CySmtSim.h"
+#include "CySmtFrame.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Command packet header, then opcode and length */
+#define SIM_PACKET_HEADER_SIZE      (2u + COMMAND_HEADER_SIZE)
+
+typedef struct
+{
+    uint8 *data;
+    size_t len;
+    size_t cap;
+}BUF_T;
+
+/* Chunks of bytes on a paced line */
+#define SIM_PACE_MARKS              (1024u)
+
+typedef struct
+{
+    /* When the last byte of each chunk is through */
+    uint64 due[SIM_PACE_MARKS];
+    uint32 bytes[SIM_PACE_MARKS];
+    uint16 head;
+    uint16 count;
+    /* When the line has sent everything given to it */
+    uint64 lineFree;
+}SIM_PACE_T;
+
+typedef struct
+{
+    /* Packet size from the opcode on, 0 while the slot is free */
+    uint16 size;
+    uint8 data[PRIMARY_CMD_BUFF_SIZE];
+}SIM_CMD_SLOT_T;
+
+/* Globals of CySmt_TransportLayer.c the CySmart module uses */
+uint8 primaryCmdRxBuf[PRIMARY_CMD_BUFF_SIZE];
+uint8 secondaryCmdRxBuf[SECONDARY_CMD_BUFF_SIZE];
+volatile bool newCmdRxDoneFlag = false;
+bool txInStackCallback = false;
+
+static int simFd = -1;
+static int simSlaveFd = -1;
+
+static SIM_CMD_SLOT_T cmdSlot[CMD_QUEUE_SLOTS];
+static uint8 cmdOrder[CMD_QUEUE_SLOTS];
+static uint8 cmdCount = 0;
+
+/* Command bytes read but not yet in a slot, plain packets in both modes */
+static BUF_T rxBuf;
+
+/* Framed bytes read but not yet fed to the link */
+static BUF_T rxRaw;
+
+/* Host bytes read but still on the paced line */
+static BUF_T rxLine;
+
+/* Event bytes not yet written to the pty */
+static BUF_T txBuf;
+
+static SIM_PACE_T rxPace;
+static SIM_PACE_T txPace;
+
+/* Event opened by Transport_OpenFrame */
+static BUF_T txFrame;
+static uint16 txFrameLeft = 0;
+
+static CY_TX_STATS txStats;
+
+static uint8 transportMode = TRANSPORT_MODE_LEGACY;
+static bool modeSwitchPending = false;
+static uint8 pendingMode;
+static CYSMT_LINK_T frameLink;
+
+static void put(BUF_T *b, const uint8 *data, size_t n)
+{
+    if(b->len + n > b->cap)
+    {
+        while(b->len + n > b->cap)
+        {
+            b->cap = b->cap ? b->cap * 2u : 4096u;
+        }
+        b->data = realloc(b->data, b->cap);
+        if(NULL == b->data)
+        {
+            perror("realloc");
+            exit(1);
+        }
+    }
+    memcpy(&b->data[b->len], data, n);
+    b->len += n;
+}
+
+static void drop(BUF_T *b, size_t n)
+{
+    memmove(b->data, &b->data[n], b->len - n);
+    b->len -= n;
+}
+
+/* Puts n bytes on the line after those before */
+static void Sim_PaceAdd(SIM_PACE_T *p, size_t n)
+{
+    uint64 now = Sim_Now();
+    uint16 last;
+
+    if(p->lineFree < now)
+    {
+        p->lineFree = now;
+    }
+    p->lineFree += ((uint64)n * 10000000u) / simConfig.uartBaud;
+
+    if(SIM_PACE_MARKS == p->count)
+    {
+        /* Full, the newest chunk grows */
+        last = (uint16)((p->head + p->count - 1u) % SIM_PACE_MARKS);
+        p->bytes[last] += (uint32)n;
+    }
+    else
+    {
+        last = (uint16)((p->head + p->count) % SIM_PACE_MARKS);
+        p->bytes[last] = (uint32)n;
+        p->count++;
+    }
+    p->due[last] = p->lineFree;
+}
+
+/* Bytes through the line by now */
+static size_t Sim_PaceReady(const SIM_PACE_T *p)
+{
+    uint64 now = Sim_Now();
+    size_t n = 0;
+    uint16 i;
+
+    for(i = 0; (i < p->count) && (p->due[(p->head + i) % SIM_PACE_MARKS] <= now); i++)
+    {
+        n += p->bytes[(p->head + i) % SIM_PACE_MARKS];
+    }
+    return n;
+}
+
+/* Takes n bytes that are through off the line */
+static void Sim_PaceTake(SIM_PACE_T *p, size_t n)
+{
+    while((0u != n) && (0u != p->count))
+    {
+        if(p->bytes[p->head] > n)
+        {
+            p->bytes[p->head] -= (uint32)n;
+            return;
+        }
+        n -= p->bytes[p->head];
+        p->head = (uint16)((p->head + 1u) % SIM_PACE_MARKS);
+        p->count--;
+    }
+}
+
+/* Microseconds until the next chunk is through, -1 for none */
+static int32 Sim_PaceNextUs(const SIM_PACE_T *p)
+{
+    uint64 now = Sim_Now();
+    uint64 due;
+
+    if(0u == p->count)
+    {
+        return -1;
+    }
+    due = p->due[p->head];
+    return (due <= now) ? 0 : (((due - now) > 1000u) ? 1000 : (int32)(due - now));
+}
+
+/* All event bytes go to the pty through here */
+static void Sim_TxPut(const uint8 *data, size_t n)
+{
+    put(&txBuf, data, n);
+    if(0u != simConfig.uartBaud)
+    {
+        Sim_PaceAdd(&txPace, n);
+    }
+}
+
+static void Sim_LinkWrite(void *context, const uint8_t *data, size_t length)
+{
+    (void)context;
+    Sim_TxPut(data, length);
+}
+
+/* A packet received in framed mode, a damaged one is dropped as the dongle does at the frame end */
+static void Sim_LinkDeliver(void *context, const uint8_t *packet, size_t length)
+{
+    (void)context;
+    if((length >= SIM_PACKET_HEADER_SIZE) && (0x43u == packet[0]) && (0x59u == packet[1]) &&
+       ((SIM_PACKET_HEADER_SIZE + CyBle_Get16ByPtr(&packet[4])) == length))
+    {
+        put(&rxBuf, packet, length);
+    }
+}
+
+/* Moves whole packets from rxBuf into free slots, stops at the first that finds none */
+static void Sim_Parse(void)
+{
+    size_t used = 0;
+
+    while((rxBuf.len - used) >= 2u)
+    {
+        const uint8 *packet = &rxBuf.data[used];
+        uint16 payload;
+        uint16 size;
+        uint8 reserve;
+        uint8 i;
+
+        if((0x43u != packet[0]) || (0x59u != packet[1]))
+        {
+            used++;
+            continue;
+        }
+        if((rxBuf.len - used) < SIM_PACKET_HEADER_SIZE)
+        {
+            break;
+        }
+
+        payload = CyBle_Get16ByPtr(&packet[4]);
+        size = COMMAND_HEADER_SIZE;
+        if(payload <= MAX_PAYLOAD_SIZE)
+        {
+            if((rxBuf.len - used) < (SIM_PACKET_HEADER_SIZE + payload))
+            {
+                break;
+            }
+            size += payload;
+        }
+
+        reserve = CySmt_IsConcurrentCmd(CyBle_Get16ByPtr(&packet[2])) ? 0u : 1u;
+        if((cmdCount + reserve) >= CMD_QUEUE_SLOTS)
+        {
+            break;
+        }
+
+        for(i = 0; 0 != cmdSlot[i].size; i++)
+        {
+            /* A free slot exists as cmdCount is below CMD_QUEUE_SLOTS */
+        }
+        cmdSlot[i].size = size;
+        memcpy(cmdSlot[i].data, &packet[2], size);
+        cmdOrder[cmdCount++] = i;
+        newCmdRxDoneFlag = true;
+
+        /* An oversized payload is scanned again as stream */
+        used += 2u + size;
+    }
+    drop(&rxBuf, used);
+}
+
+/* Sends the event collected in txFrame */
+static void Sim_CommitFrame(void)
+{
+    if(TRANSPORT_MODE_FRAMED == transportMode)
+    {
+        if(CySmtLink_Send(&frameLink, txFrame.data, txFrame.len) < 0)
+        {
+            txStats.framesDropped++;
+            txStats.bytesDropped += txFrame.len;
+        }
+    }
+    else
+    {
+        Sim_TxPut(txFrame.data, txFrame.len);
+    }
+    txStats.framesSent++;
+    if(txBuf.len > txStats.peakUsed)
+    {
+        txStats.peakUsed = (txBuf.len > 0xFFFFu) ? 0xFFFFu : (uint16)txBuf.len;
+    }
+    txFrame.len = 0;
+    txFrameLeft = 0;
+}
+
+bool SimTransport_Open(const char *linkName)
+{
+    struct termios tio;
+    const char *name;
+
+    simFd = posix_openpt(O_RDWR | O_NOCTTY);
+    if((simFd < 0) || (grantpt(simFd) != 0) || (unlockpt(simFd) != 0))
+    {
+        perror("posix_openpt");
+        return false;
+    }
+    name = ptsname(simFd);
+
+    /* Kept open so the pty outlives the host closing its side */
+    simSlaveFd = open(name, O_RDWR | O_NOCTTY);
+    if(simSlaveFd < 0)
+    {
+        perror(name);
+        return false;
+    }
+    tcgetattr(simSlaveFd, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(simSlaveFd, TCSANOW, &tio);
+    fcntl(simFd, F_SETFL, O_NONBLOCK);
+    signal(SIGPIPE, SIG_IGN);
+
+    if(NULL != linkName)
+    {
+        unlink(linkName);
+        if(symlink(name, linkName) != 0)
+        {
+            perror(linkName);
+            return false;
+        }
+    }
+    printf("%s\n", name);
+    fflush(stdout);
+
+    CySmtLink_Init(&frameLink, Sim_LinkWrite, Sim_LinkDeliver, NULL);
+    return true;
+}
+
+uint32 SimTransport_TxBacklog(void)
+{
+    return (uint32)(txBuf.len + txFrame.len);
+}
+
+void SimTransport_Wait(int32 timeoutUs)
+{
+    struct pollfd p = {simFd, POLLIN, 0};
+    struct timespec t;
+    int32 paceUs;
+
+    if((timeoutUs < 0) || (timeoutUs > 1000))
+    {
+        timeoutUs = 1000;
+    }
+
+    /* Host bytes are only of use while they can be taken */
+    if((0u != rxBuf.len) || (0u != rxRaw.len) || (0u != rxLine.len))
+    {
+        p.events = 0;
+    }
+    if(0u == simConfig.uartBaud)
+    {
+        if(0u != txBuf.len)
+        {
+            p.events |= POLLOUT;
+        }
+    }
+    else
+    {
+        /* Wake when the next chunk is through the line */
+        paceUs = Sim_PaceNextUs(&txPace);
+        if(0 == paceUs)
+        {
+            p.events |= POLLOUT;
+        }
+        else if((paceUs > 0) && (paceUs < timeoutUs))
+        {
+            timeoutUs = paceUs;
+        }
+        paceUs = Sim_PaceNextUs(&rxPace);
+        if((paceUs >= 0) && (paceUs < timeoutUs))
+        {
+            timeoutUs = paceUs;
+        }
+    }
+    t.tv_sec = 0;
+    t.tv_nsec = (long)timeoutUs * 1000L;
+    (void)ppoll(&p, 1, &t, NULL);
+}
+
+/*******************************************************************************
+* The interface of CySmt_TransportLayer.h
+*******************************************************************************/
+
+/* Feeds framed bytes up to each delimiter into the link, until a packet has to wait */
+static void Sim_FeedFrames(void)
+{
+    size_t i = 0;
+
+    while((0u == rxBuf.len) && (i < rxRaw.len))
+    {
+        size_t start = i;
+
+        while((i < rxRaw.len) && (0u != rxRaw.data[i]))
+        {
+            i++;
+        }
+        if(i == rxRaw.len)
+        {
+            /* Partial frame, the link keeps it */
+            CySmtLink_Input(&frameLink, &rxRaw.data[start], i - start);
+            break;
+        }
+        i++;
+        CySmtLink_Input(&frameLink, &rxRaw.data[start], i - start);
+        Sim_Parse();
+    }
+    drop(&rxRaw, i);
+}
+
+void Transport_Process(void)
+{
+    uint8 buf[4096];
+    size_t ready;
+    ssize_t n;
+
+    /* Events first, the host may be waiting for room to send more */
+    ready = (0u != simConfig.uartBaud) ? Sim_PaceReady(&txPace) : txBuf.len;
+    if(0u != ready)
+    {
+        n = write(simFd, txBuf.data, ready);
+        if(n > 0)
+        {
+            drop(&txBuf, (size_t)n);
+            Sim_PaceTake(&txPace, (size_t)n);
+        }
+    }
+
+    if(modeSwitchPending && Transport_TxIdle())
+    {
+        modeSwitchPending = false;
+        transportMode = pendingMode;
+        rxBuf.len = 0;
+        rxRaw.len = 0;
+        rxLine.len = 0;
+        rxPace.count = 0;
+        CySmtLink_Init(&frameLink, Sim_LinkWrite, Sim_LinkDeliver, NULL);
+    }
+
+    Sim_Parse();
+    Sim_FeedFrames();
+    if((0u != rxBuf.len) || (0u != rxRaw.len))
+    {
+        /* A packet waits for a slot, the host's bytes stay in the pty */
+        return;
+    }
+
+    if(0u == rxLine.len)
+    {
+        n = read(simFd, buf, sizeof(buf));
+        if(n <= 0)
+        {
+            return;
+        }
+        put(&rxLine, buf, (size_t)n);
+        if(0u != simConfig.uartBaud)
+        {
+            Sim_PaceAdd(&rxPace, (size_t)n);
+        }
+    }
+
+    ready = (0u != simConfig.uartBaud) ? Sim_PaceReady(&rxPace) : rxLine.len;
+    if(0u == ready)
+    {
+        return;
+    }
+
+    if(TRANSPORT_MODE_FRAMED == transportMode)
+    {
+        put(&rxRaw, rxLine.data, ready);
+        drop(&rxLine, ready);
+        Sim_PaceTake(&rxPace, ready);
+        Sim_FeedFrames();
+    }
+    else
+    {
+        put(&rxBuf, rxLine.data, ready);
+        drop(&rxLine, ready);
+        Sim_PaceTake(&rxPace, ready);
+        Sim_Parse();
+    }
+}
+
+bool Transport_TxIdle(void)
+{
+    return (0u == txBuf.len) && (0u == txFrameLeft);
+}
+
+void Transport_OpenFrame(uint16 length)
+{
+    if(0u != txFrameLeft)
+    {
+        Sim_CommitFrame();
+    }
+    txFrame.len = 0;
+    txFrameLeft = length;
+}
+
+void Transport_Write(const uint8 *data, uint32 length)
+{
+    uint32 count;
+
+    while(0u != length)
+    {
+        if(0u == txFrameLeft)
+        {
+            /* Bytes with no frame open go out as a frame of their own */
+            Transport_OpenFrame((length > CYSMT_FRAME_BODY_MAX) ? CYSMT_FRAME_BODY_MAX : (uint16)length);
+        }
+        count = (length < txFrameLeft) ? length : txFrameLeft;
+        put(&txFrame, data, count);
+        data += count;
+        length -= count;
+        txFrameLeft -= (uint16)count;
+        if(0u == txFrameLeft)
+        {
+            Sim_CommitFrame();
+        }
+    }
+}
+
+const CY_TX_STATS *Transport_GetTxStats(void)
+{
+    return &txStats;
+}
+
+bool Transport_SetMode(uint8 mode, uint32 baud)
+{
+    /* A pty has no baud rate, any is taken */
+    (void)baud;
+    if(mode > TRANSPORT_MODE_FRAMED)
+    {
+        return false;
+    }
+    pendingMode = mode;
+    modeSwitchPending = true;
+    return true;
+}
+
+uint8 *Transport_PeekCmd(uint8 position, uint16 *size)
+{
+    if(position >= cmdCount)
+    {
+        return NULL;
+    }
+    *size = cmdSlot[cmdOrder[position]].size;
+    return cmdSlot[cmdOrder[position]].data;
+}
+
+void Transport_ReleaseCmd(uint8 position)
+{
+    if(position < cmdCount)
+    {
+        cmdSlot[cmdOrder[position]].size = 0;
+        cmdCount--;
+        memmove(&cmdOrder[position], &cmdOrder[position + 1u], cmdCount - position);
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,348 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+
+/* The dongle's UART SCB and the DMA channels, for running the
+   real CySmt_TransportLayer.c on the host, see CySmtTransportBench.c.
+
+   A received byte goes into the RX FIFO, or is lost with the overflow
+   interrupt while it is full. While it holds a byte the trigger reaches
+   every enabled channel reading UART_RX_FIFO_RD_PTR, which moves it as its
+   descriptor says: an element per trigger, then chain, invalidate and
+   interrupt as the actions ask. Which trigger group input that takes on
+   the part is not modelled. The RX interrupt runs Transport_RX_ISR as
+   soon as one of its enabled sources is set, so with the interrupt path
+   the FIFO never holds more than the byte that raised it. */
+#include "CySmtSim.h"
+#include "CySmt_TransportLayer.h"
+#include <string.h>
+
+typedef struct
+{
+    cydma_init_struct config;
+    void *src;
+    void *dst;
+    int32 index;
+    bool valid;
+}SIM_DMA_DESCR_T;
+
+typedef struct
+{
+    SIM_DMA_DESCR_T descr[CYDMA_DESCR_NR];
+    int32 next;
+    bool allocated;
+    bool enabled;
+    cydma_callback_t callback;
+}SIM_DMA_CH_T;
+
+reg32 simUartRxFifoCtrl;
+reg32 simUartRxFifoRd;
+uint32 simUartRxIntr;
+uint32 simUartRxIntrMask = UART_INTR_RX_NOT_EMPTY;
+reg32 simUartTxFifoCtrl;
+reg32 simUartTxFifoWr;
+reg32 simTrOutCtl[CYDMA_CH_NR];
+
+SIM_UART_STATS_T simUartStats;
+
+static uint8 simRxFifo[SIM_UART_FIFO_SIZE];
+static uint8 simRxHead = 0;
+static uint8 simRxCount = 0;
+
+static SIM_DMA_CH_T simDma[CYDMA_CH_NR];
+static uint32 simDmaIntrMask = 0;
+static bool simDmaIntrEnabled = false;
+
+/* One trigger on channel, returns false if it has no valid descriptor to serve it */
+static bool SimDma_Request(int32 channel)
+{
+    SIM_DMA_CH_T *ch = &simDma[channel];
+    SIM_DMA_DESCR_T *d = &ch->descr[ch->next];
+    uint32 size = (CYDMA_BYTE == d->config.dataElementSize) ? 1u :
+                  ((CYDMA_HALFWORD == d->config.dataElementSize) ? 2u : 4u);
+    uint8 *dst = (uint8 *)d->dst;
+    const uint8 *src = (const uint8 *)d->src;
+
+    if(!ch->enabled || !d->valid)
+    {
+        return false;
+    }
+
+    if(0u != (d->config.addressIncrement & CYDMA_INC_SRC_ADDR))
+    {
+        src += (uint32)d->index * size;
+    }
+    if(0u != (d->config.addressIncrement & CYDMA_INC_DST_ADDR))
+    {
+        dst += (uint32)d->index * size;
+    }
+    memcpy(dst, src, size);
+
+    if(++d->index < d->config.numDataElements)
+    {
+        return true;
+    }
+
+    /* Descriptor done, the index stays at its end until it is validated again */
+    if(0u != (d->config.actions & CYDMA_INVALIDATE))
+    {
+        d->valid = false;
+    }
+    if(0u != (d->config.actions & CYDMA_CHAIN))
+    {
+        ch->next ^= 1;
+    }
+    else
+    {
+        ch->enabled = false;
+    }
+    if((0u != (d->config.actions & CYDMA_GENERATE_IRQ)) && simDmaIntrEnabled &&
+       (0u != (simDmaIntrMask & (1uL << channel))) && (NULL != ch->callback))
+    {
+        simUartStats.dmaInterrupts++;
+        ch->callback();
+    }
+    return true;
+}
+
+/* Moves FIFO bytes with any channel the RX trigger reaches */
+static void SimUart_RxTrigger(void)
+{
+    int32 channel;
+
+    for(channel = 0; (channel < CYDMA_CH_NR) && (0u != simRxCount); channel++)
+    {
+        if(simDma[channel].enabled && (simDma[channel].descr[simDma[channel].next].src == (void *)UART_RX_FIFO_RD_PTR))
+        {
+            while(0u != simRxCount)
+            {
+                simUartRxFifoRd = simRxFifo[simRxHead];
+                if(!SimDma_Request(channel))
+                {
+                    break;
+                }
+                simRxHead = (uint8)((simRxHead + 1u) % SIM_UART_FIFO_SIZE);
+                simRxCount--;
+            }
+        }
+    }
+}
+
+/* Runs the RX interrupt if one of its enabled sources is set */
+static void SimUart_RxInterrupt(void)
+{
+    if(0u != simRxCount)
+    {
+        simUartRxIntr |= UART_INTR_RX_NOT_EMPTY;
+    }
+    if(0u != (simUartRxIntr & simUartRxIntrMask))
+    {
+        simUartStats.rxInterrupts++;
+        Transport_RX_ISR();
+    }
+}
+
+void SimUart_Receive(uint8 byte)
+{
+    simUartStats.rxBytes++;
+    if(SIM_UART_FIFO_SIZE == simRxCount)
+    {
+        simUartStats.rxOverflows++;
+        simUartRxIntr |= UART_INTR_RX_OVERFLOW;
+    }
+    else
+    {
+        simRxFifo[(simRxHead + simRxCount) % SIM_UART_FIFO_SIZE] = byte;
+        simRxCount++;
+    }
+
+    SimUart_RxTrigger();
+    SimUart_RxInterrupt();
+}
+
+/***************************************************************
+ * UART
+ **************************************************************/
+
+uint32 UART_SpiUartGetRxBufferSize(void)
+{
+    return simRxCount;
+}
+
+uint32 UART_SpiUartReadRxData(void)
+{
+    uint8 byte = 0u;
+
+    if(0u != simRxCount)
+    {
+        byte = simRxFifo[simRxHead];
+        simRxHead = (uint8)((simRxHead + 1u) % SIM_UART_FIFO_SIZE);
+        simRxCount--;
+    }
+    return byte;
+}
+
+void UART_ClearRxInterruptSource(uint32 interruptSource)
+{
+    simUartRxIntr &= ~interruptSource;
+}
+
+void UART_SetRxInterruptMode(uint32 interruptMask)
+{
+    simUartRxIntrMask = interruptMask;
+}
+
+/* Events leave at once, the bench only receives */
+void UART_SpiUartPutArray(const uint8 wrBuf[], uint32 count)
+{
+    (void)wrBuf;
+    (void)count;
+}
+
+uint32 UART_SpiUartGetTxBufferSize(void)
+{
+    return 0u;
+}
+
+/***************************************************************
+ * Timer_10ms, the bench feeds bytes without gaps and never
+ * lets it expire
+ **************************************************************/
+
+void Timer_10ms_Start(void)
+{
+    simUartStats.timerRestarts++;
+}
+
+void Timer_10ms_Stop(void)
+{
+}
+
+uint32 Timer_10ms_GetInterruptSource(void)
+{
+    return 0u;
+}
+
+void Timer_10ms_ClearInterrupt(uint32 interruptMask)
+{
+    (void)interruptMask;
+}
+
+void isr_10ms_ClearPending(void)
+{
+}
+
+/***************************************************************
+ * CyDma
+ **************************************************************/
+
+void CyDmaEnable(void)
+{
+}
+
+int32 CyDmaChAlloc(void)
+{
+    int32 channel;
+
+    for(channel = 0; channel < CYDMA_CH_NR; channel++)
+    {
+        if(!simDma[channel].allocated)
+        {
+            simDma[channel].allocated = true;
+            return channel;
+        }
+    }
+    return CYDMA_INVALID_CHANNEL;
+}
+
+void CyDmaChEnable(int32 channel)
+{
+    simDma[channel].enabled = true;
+    SimUart_RxTrigger();
+}
+
+void CyDmaChDisable(int32 channel)
+{
+    simDma[channel].enabled = false;
+}
+
+void CyDmaSetNextDescriptor(int32 channel, int32 descriptor)
+{
+    simDma[channel].next = descriptor;
+}
+
+void CyDmaSetConfiguration(int32 channel, int32 descriptor, const cydma_init_struct *config)
+{
+    simDma[channel].descr[descriptor].config = *config;
+}
+
+void CyDmaValidateDescriptor(int32 channel, int32 descriptor)
+{
+    simDma[channel].descr[descriptor].valid = true;
+    simDma[channel].descr[descriptor].index = 0;
+}
+
+uint32 CyDmaGetDescriptorStatus(int32 channel, int32 descriptor)
+{
+    return (uint32)simDma[channel].descr[descriptor].index & CYDMA_TRANSFER_INDEX;
+}
+
+void CyDmaSetSrcAddress(int32 channel, int32 descriptor, void *srcAddress)
+{
+    simDma[channel].descr[descriptor].src = srcAddress;
+}
+
+void CyDmaSetDstAddress(int32 channel, int32 descriptor, void *dstAddress)
+{
+    simDma[channel].descr[descriptor].dst = dstAddress;
+}
+
+cydma_callback_t CyDmaSetInterruptCallback(int32 channel, cydma_callback_t callback)
+{
+    cydma_callback_t old = simDma[channel].callback;
+
+    simDma[channel].callback = callback;
+    return old;
+}
+
+void CyDmaSetInterruptSourceMask(uint32 interruptMask)
+{
+    simDmaIntrMask = interruptMask;
+}
+
+uint32 CyDmaGetInterruptSourceMask(void)
+{
+    return simDmaIntrMask;
+}
+
+/***************************************************************
+ * CyLib, interrupts are never nested on the host
+ **************************************************************/
+
+void CyIntEnable(uint8 number)
+{
+    if(CYDMA_INTR_NUMBER == number)
+    {
+        simDmaIntrEnabled = true;
+    }
+}
+
+uint8 CyEnterCriticalSection(void)
+{
+    return 0u;
+}
+
+void CyExitCriticalSection(uint8 savedIntrStatus)
+{
+    (void)savedIntrStatus;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,359 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+
+/* Host benchmark: the receive side of the dongle's CySmt_TransportLayer.c,
+   built unchanged, fed command packets back to back through the UART and
+   DMA model of CySmtSimUart.c. Built once as it ships, framing each byte
+   in Transport_RX_ISR, and once with -DTRANSPORT_RX_DMA, framing the
+   circular buffer from Transport_Process:
+
+     D=../../BLE_4_2_Dongle_CySmart_256K01.cydsn
+     for v in isr ring; do
+       cc -O2 -I. -I.. -I$D -I$D/CySmt_InterfaceModule \
+          -I../../HubBLE.cydsn/Generated_Source/PSoC4 \
+          $([ $v = ring ] && echo -DTRANSPORT_RX_DMA) -o CySmtTransportBench-$v \
+          CySmtTransportBench.c CySmtSimUart.c \
+          $D/CySmt_InterfaceModule/CySmt_TransportLayer.c
+     done
+     ./CySmtTransportBench-isr [-t seconds]; ./CySmtTransportBench-ring [-t seconds]
+
+   The packets are numbered through their op-code and carry a payload
+   derived from it, 3 in 4 of up to 16 bytes and the rest up to
+   MAX_PAYLOAD_SIZE, so each one taken from the command slots is checked
+   and the gaps are counted as lost.
+
+   First the host time per byte, with every packet taken from its slot as
+   soon as it is complete. That is host CPU time for the model and the
+   transport together, use it to compare the two paths, not as dongle
+   figures. Then the line: bytes arrive at the baud rate with 10 bits
+   each, and a main loop pass every loop period takes at most one packet
+   from the slots, as CySmt_ProcessCommands() starts one primary command
+   per pass. Received is what reached the slots intact, lost what was
+   dropped or overrun on the way. Times there are simulated, not measured. */
+#include "CySmtSim.h"
+#include "CySmt_TransportLayer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef TRANSPORT_RX_DMA
+#define BENCH_PATH                  "ring"
+#else
+#define BENCH_PATH                  "isr"
+#endif /* TRANSPORT_RX_DMA */
+
+/* Bytes of the host time run, and how often its main loop runs */
+#define BENCH_COST_BYTES            (32uL * 1024uL * 1024uL)
+#define BENCH_COST_PASS_BYTES       (64u)
+
+/* Passes after the line stops, to take what the slots and the ring still hold */
+#define BENCH_DRAIN_PASSES          (10000u)
+
+/* Sync bytes, then the command header */
+#define BENCH_PACKET_MAX            (2u + COMMAND_HEADER_SIZE + MAX_PAYLOAD_SIZE)
+
+static const uint32 benchBaud[] = { 115200u, 1000000u, 3000000u };
+static const uint32 benchLoopUs[] = { 50u, 200u, 1000u };
+
+typedef struct
+{
+    /* Packet being sent and the next byte of it */
+    uint8 packet[BENCH_PACKET_MAX];
+    uint16 length;
+    uint16 sent;
+    uint16 seq;
+    uint32 random;
+    uint32 packetsSent;
+    uint64 payloadSent;
+}BENCH_LINE_T;
+
+typedef struct
+{
+    uint16 expected;
+    uint32 received;
+    uint32 lost;
+    uint32 corrupt;
+    uint64 payload;
+}BENCH_RX_T;
+
+static BENCH_LINE_T line;
+static BENCH_RX_T rx;
+
+/* The dongle's byte order */
+uint16 CyBle_Get16ByPtr(const uint8 ptr[])
+{
+    return (uint16)(ptr[0] | ((uint16)ptr[1] << 8));
+}
+
+/* Every packet is a primary command, one slot stays free as on the dongle */
+bool CySmt_IsConcurrentCmd(uint16 opcode)
+{
+    (void)opcode;
+    return false;
+}
+
+static uint8 Bench_PayloadByte(uint16 seq, uint16 i)
+{
+    return (uint8)((seq * 7u) + i);
+}
+
+static void Bench_LineReset(void)
+{
+    memset(&line, 0, sizeof(line));
+    line.random = 1u;
+}
+
+/* Next byte on the line, a new packet after the last one */
+static uint8 Bench_LineByte(void)
+{
+    uint16 payload;
+    uint16 i;
+
+    if(line.sent == line.length)
+    {
+        line.random = (line.random * 1103515245u) + 12345u;
+        if(0u != ((line.random >> 16) & 3u))
+        {
+            payload = (uint16)((line.random >> 18) % 17u);
+        }
+        else
+        {
+            payload = (uint16)(17u + ((line.random >> 18) % (MAX_PAYLOAD_SIZE - 16u)));
+        }
+
+        line.packet[0] = 0x43u;
+        line.packet[1] = 0x59u;
+        line.packet[2] = (uint8)line.seq;
+        line.packet[3] = (uint8)(line.seq >> 8);
+        line.packet[4] = (uint8)payload;
+        line.packet[5] = (uint8)(payload >> 8);
+        for(i = 0; i < payload; i++)
+        {
+            line.packet[6u + i] = Bench_PayloadByte(line.seq, i);
+        }
+        line.length = (uint16)(6u + payload);
+        line.sent = 0;
+        line.seq++;
+        line.packetsSent++;
+        line.payloadSent += payload;
+    }
+    return line.packet[line.sent++];
+}
+
+/* Takes the oldest packet from the slots and checks it, returns false if there is none */
+static bool Bench_TakeCmd(void)
+{
+    uint8 *packet;
+    uint16 size;
+    uint16 seq;
+    uint16 payload;
+    uint16 i;
+    bool intact;
+
+    packet = Transport_PeekCmd(0, &size);
+    if(NULL == packet)
+    {
+        return false;
+    }
+
+    seq = CyBle_Get16ByPtr(packet);
+    payload = CyBle_Get16ByPtr(&packet[2]);
+    intact = (size == (COMMAND_HEADER_SIZE + payload));
+    for(i = 0; intact && (i < payload); i++)
+    {
+        intact = (packet[COMMAND_HEADER_SIZE + i] == Bench_PayloadByte(seq, i));
+    }
+
+    if(intact)
+    {
+        rx.lost += (uint16)(seq - rx.expected);
+        rx.expected = (uint16)(seq + 1u);
+        rx.received++;
+        rx.payload += payload;
+    }
+    else
+    {
+        rx.corrupt++;
+    }
+    Transport_ReleaseCmd(0);
+    return true;
+}
+
+/* One pass of the dongle's main loop, at most one packet taken when once is set */
+static void Bench_MainLoop(bool once)
+{
+    uint16 size;
+#ifdef TRANSPORT_RX_DMA
+    bool taken;
+
+    do
+    {
+        Transport_Process();
+        taken = false;
+        if(newCmdRxDoneFlag)
+        {
+            newCmdRxDoneFlag = false;
+            taken = Bench_TakeCmd();
+            while(!once && Bench_TakeCmd())
+            {
+            }
+        }
+    } while(!once && taken);
+#else
+    if(newCmdRxDoneFlag)
+    {
+        newCmdRxDoneFlag = false;
+        (void)Bench_TakeCmd();
+        while(!once && Bench_TakeCmd())
+        {
+        }
+    }
+#endif /* TRANSPORT_RX_DMA */
+
+    if(NULL != Transport_PeekCmd(0, &size))
+    {
+        newCmdRxDoneFlag = true;
+    }
+}
+
+static void Bench_Reset(void)
+{
+    while(Bench_TakeCmd())
+    {
+    }
+    memset(&rx, 0, sizeof(rx));
+    memset(&simUartStats, 0, sizeof(simUartStats));
+    Bench_LineReset();
+}
+
+static uint64 Bench_NowNs(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return ((uint64)t.tv_sec * 1000000000u) + (uint64)t.tv_nsec;
+}
+
+/* Host time per byte, every packet taken as soon as it is complete */
+static void Bench_Cost(void)
+{
+    uint64 start;
+    uint64 ns;
+    uint32 i;
+
+    Bench_Reset();
+    start = Bench_NowNs();
+    for(i = 0; (i < BENCH_COST_BYTES) || (line.sent != line.length); i++)
+    {
+        SimUart_Receive(Bench_LineByte());
+#ifdef TRANSPORT_RX_DMA
+        if(0u == (i % BENCH_COST_PASS_BYTES))
+#else
+        if(newCmdRxDoneFlag)
+#endif /* TRANSPORT_RX_DMA */
+        {
+            Bench_MainLoop(false);
+        }
+    }
+    Bench_MainLoop(false);
+    ns = Bench_NowNs() - start;
+
+    printf("%s: host %.2f ns/byte (%.0f MB/s), %u packets received, %u lost, %u corrupt\n",
+           BENCH_PATH, (double)ns / i, (double)i * 1000.0 / (double)ns,
+           (unsigned)rx.received, (unsigned)rx.lost, (unsigned)rx.corrupt);
+}
+
+/* Bytes at baud for seconds, a main loop pass every loopUs */
+static void Bench_Line(uint32 baud, uint32 loopUs, uint32 seconds)
+{
+    double byteNs = 1e10 / (double)baud;
+    double endNs = (double)seconds * 1e9;
+    double nextPassNs = (double)loopUs * 1000.0;
+    double now;
+    uint32 lostAtEnd;
+    uint32 i;
+
+    Bench_Reset();
+    for(i = 1u; ; i++)
+    {
+        now = (double)i * byteNs;
+        if((now > endNs) && (line.sent == line.length))
+        {
+            break;
+        }
+        while(nextPassNs <= now)
+        {
+            Bench_MainLoop(true);
+            nextPassNs += (double)loopUs * 1000.0;
+        }
+        SimUart_Receive(Bench_LineByte());
+    }
+    for(i = 0; i < BENCH_DRAIN_PASSES; i++)
+    {
+        Bench_MainLoop(true);
+    }
+
+    /* Packets after the last one received never arrived either */
+    lostAtEnd = (uint32)(uint16)(line.seq - rx.expected);
+
+    printf("%s: %7u baud, loop %4u us: %6.0f packets/s sent, %6.0f received, %6.0f lost, "
+           "%5.1f kB/s payload, %6.0f interrupts/s, %u overflows\n",
+           BENCH_PATH, (unsigned)baud, (unsigned)loopUs,
+           (double)line.packetsSent / seconds, (double)rx.received / seconds,
+           (double)(rx.lost + lostAtEnd + rx.corrupt) / seconds,
+           (double)rx.payload / seconds / 1000.0,
+           (double)(simUartStats.rxInterrupts + simUartStats.dmaInterrupts) / seconds,
+           (unsigned)simUartStats.rxOverflows);
+}
+
+int main(int argc, char **argv)
+{
+    uint32 seconds = 2u;
+    uint32 b;
+    uint32 l;
+    int opt;
+
+    while((opt = getopt(argc, argv, "t:")) != -1)
+    {
+        switch(opt)
+        {
+            case 't':
+                seconds = (uint32)strtoul(optarg, NULL, 0);
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-t seconds]\n", argv[0]);
+                return 1;
+        }
+    }
+    if(0u == seconds)
+    {
+        seconds = 1u;
+    }
+
+#ifdef TRANSPORT_RX_DMA
+    Transport_Start();
+#endif /* TRANSPORT_RX_DMA */
+
+    Bench_Cost();
+    for(b = 0; b < (sizeof(benchBaud) / sizeof(benchBaud[0])); b++)
+    {
+        for(l = 0; l < (sizeof(benchLoopUs) / sizeof(benchLoopUs[0])); l++)
+        {
+            Bench_Line(benchBaud[b], benchLoopUs[l], seconds);
+        }
+    }
+    return 0;
+}
+
+/* [] END OF FILE */
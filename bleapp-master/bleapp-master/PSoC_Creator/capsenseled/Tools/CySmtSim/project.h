@@ -0,0 +1,80 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+
+/* Stands in for the generated project.h of the dongle when its firmware is
+   built on the host, see CySmtSim.c. The dongle project keeps no generated
+   sources in the tree, the BLE_1 component of HubBLE is a GAP central on
+   the same stack and provides the CYBLE types and configuration. */
+#include <stdint.h>
+
+/* cytypes.h makes uint32 and int32 a long, 64 bit on Linux. Its typedefs are
+   moved aside so the 32 bit ones below are seen everywhere else */
+#define uint32 cytypes_uint32
+#define int32 cytypes_int32
+#include "../../HubBLE.cydsn/Generated_Source/PSoC4/cytypes.h"
+#undef uint32
+#undef int32
+typedef uint32_t uint32;
+typedef int32_t int32;
+
+#include "../../HubBLE.cydsn/Generated_Source/PSoC4/project.h"
+
+/* Set by the UART component of the dongle */
+#define UART_UART_TX_BUFFER_SIZE    (512u)
+
+/* UART and Timer_10ms components of the dongle, as far as CySmt_TransportLayer.c
+   uses them without TRANSPORT_FRAMED, modelled by CySmtSimUart.c for
+   CySmtTransportBench.c. The register bits are those of the SCB in HubBLE. */
+#define UART_INTR_RX_NOT_EMPTY                  SCB_1_INTR_RX_NOT_EMPTY
+#define UART_INTR_RX_OVERFLOW                   SCB_1_INTR_RX_OVERFLOW
+#define UART_INTR_RX_BREAK_DETECT               SCB_1_INTR_RX_BREAK_DETECT
+#define UART_RX_FIFO_CTRL_TRIGGER_LEVEL_MASK    SCB_1_RX_FIFO_CTRL_TRIGGER_LEVEL_MASK
+
+extern reg32 simUartRxFifoCtrl;
+extern reg32 simUartRxFifoRd;
+extern uint32 simUartRxIntr;
+extern uint32 simUartRxIntrMask;
+
+#define UART_RX_FIFO_CTRL_REG                   (simUartRxFifoCtrl)
+#define UART_RX_FIFO_RD_PTR                     (&simUartRxFifoRd)
+#define UART_CHECK_INTR_RX_MASKED(sourceMask)   (0u != (simUartRxIntr & simUartRxIntrMask & (sourceMask)))
+
+extern reg32 simUartTxFifoCtrl;
+extern reg32 simUartTxFifoWr;
+
+#define UART_TX_FIFO_CTRL_REG                   (simUartTxFifoCtrl)
+#define UART_TX_FIFO_CTRL_TRIGGER_LEVEL_MASK    SCB_1_TX_FIFO_CTRL_TRIGGER_LEVEL_MASK
+#define UART_TX_FIFO_WR_PTR                     (&simUartTxFifoWr)
+#define UART_GET_TX_FIFO_SR_VALID               (0u)
+
+uint32 UART_SpiUartGetRxBufferSize(void);
+uint32 UART_SpiUartReadRxData(void);
+void UART_ClearRxInterruptSource(uint32 interruptSource);
+void UART_SetRxInterruptMode(uint32 interruptMask);
+void UART_SpiUartPutArray(const uint8 wrBuf[], uint32 count);
+uint32 UART_SpiUartGetTxBufferSize(void);
+
+#define Timer_10ms_INTR_MASK_TC                 (0x01u)
+
+void Timer_10ms_Start(void);
+void Timer_10ms_Stop(void);
+uint32 Timer_10ms_GetInterruptSource(void);
+void Timer_10ms_ClearInterrupt(uint32 interruptMask);
+void isr_10ms_ClearPending(void);
+
+/* Trigger group 0 outputs, a host array */
+extern reg32 simTrOutCtl[CYDMA_CH_NR];
+
+#undef CYREG_PERI_TR_GROUP_TR_OUT_CTL0
+#define CYREG_PERI_TR_GROUP_TR_OUT_CTL0         ((uintptr_t)simTrOutCtl)
+
+/* [] END OF FILE */
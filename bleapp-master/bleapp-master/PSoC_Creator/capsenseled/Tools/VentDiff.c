@@ -0,0 +1,339 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+
+/* Host tool: builds a vent firmware delta patch between two PSoC Creator
+   .hex images, in the format VentCommon/VentUpdate.h describes.
+
+     cc -O2 -o VentDiff VentDiff.c
+     ./VentDiff [-x exclude] old.hex new.hex patch.bin
+
+   Only the internal flash (addresses below 0x10000000) goes into the
+   images, the checksum, protection and metadata records are dropped.
+
+   exclude is where .cy_checksum_exclude starts in the old build, the
+   .map file has it. The rows there are rewritten on the vent, bonding
+   data and damper calibration, so the old image ends before them: they
+   are neither CRCed nor copied from. Leave it out only for a build that
+   rewrites none of its flash. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+
+/* Keep in step with VentUpdate.h */
+#define VENT_UPDATE_MAGIC           (0x31504456uL)
+#define VENT_UPDATE_OP_END          (0x00u)
+#define VENT_UPDATE_OP_COPY         (0x01u)
+#define VENT_UPDATE_OP_INSERT       (0x02u)
+#define VENT_UPDATE_OP_FILL         (0x03u)
+
+#define FLASH_MAX                   (256u * 1024u)
+#define FLASH_END                   (0x10000000uL)
+
+/* Matcher: 8 byte seeds hashed over the whole old image */
+#define SEED_LEN                    (8u)
+#define HASH_BITS                   (16u)
+#define CHAIN_MAX                   (256u)
+
+/* Shortest runs worth an operation over literal bytes */
+#define MIN_FILL                    (12u)
+#define MIN_COPY                    (8u)
+
+typedef struct
+{
+    uint8_t *data;
+    size_t len;
+    size_t cap;
+} BUF_T;
+
+static void put(BUF_T *b, uint8_t v)
+{
+    if (b->len == b->cap)
+    {
+        b->cap = b->cap ? b->cap * 2u : 4096u;
+        b->data = realloc(b->data, b->cap);
+        if (b->data == NULL)
+        {
+            perror("realloc");
+            exit(1);
+        }
+    }
+    b->data[b->len++] = v;
+}
+
+static void putVarint(BUF_T *b, uint32_t v)
+{
+    while (v >= 0x80u)
+    {
+        put(b, (uint8_t)(v | 0x80u));
+        v >>= 7;
+    }
+    put(b, (uint8_t)v);
+}
+
+static void put32(BUF_T *b, uint32_t v)
+{
+    put(b, (uint8_t)v);
+    put(b, (uint8_t)(v >> 8));
+    put(b, (uint8_t)(v >> 16));
+    put(b, (uint8_t)(v >> 24));
+}
+
+static uint32_t crc32(const uint8_t *p, size_t n)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    unsigned k;
+
+    while (n--)
+    {
+        crc ^= *p++;
+        for (k = 0; k < 8u; k++)
+        {
+            crc = (crc & 1u) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        }
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+static unsigned hexByte(const char *s)
+{
+    unsigned v;
+
+    sscanf(s, "%2x", &v);
+    return v;
+}
+
+/***************************************************************
+ * Read the flash part of an Intel HEX file, returns its size
+ **************************************************************/
+static size_t readHex(const char *path, uint8_t *image)
+{
+    char line[600];
+    uint32_t base = 0;
+    size_t size = 0;
+    FILE *f = fopen(path, "r");
+
+    if (f == NULL)
+    {
+        perror(path);
+        exit(1);
+    }
+    memset(image, 0, FLASH_MAX);
+
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        unsigned count, addr, type, i, sum = 0;
+
+        if (line[0] != ':')
+            continue;
+        count = hexByte(&line[1]);
+        addr = (hexByte(&line[3]) << 8) | hexByte(&line[5]);
+        type = hexByte(&line[7]);
+        for (i = 0; i < count + 5u; i++)
+        {
+            sum += hexByte(&line[1 + 2u * i]);
+        }
+        if ((sum & 0xFFu) != 0u)
+        {
+            fprintf(stderr, "%s: bad checksum\n", path);
+            exit(1);
+        }
+
+        if (type == 0x04u)
+        {
+            base = (hexByte(&line[9]) << 24) | (hexByte(&line[11]) << 16);
+        }
+        else if ((type == 0x00u) && ((base + addr) < FLASH_END))
+        {
+            for (i = 0; i < count; i++)
+            {
+                uint32_t a = base + addr + i;
+
+                if (a >= FLASH_MAX)
+                {
+                    fprintf(stderr, "%s: image larger than the flash\n", path);
+                    exit(1);
+                }
+                image[a] = (uint8_t)hexByte(&line[9 + 2u * i]);
+                if (a + 1u > size)
+                    size = a + 1u;
+            }
+        }
+        else if (type == 0x01u)
+        {
+            break;
+        }
+    }
+    fclose(f);
+    return size;
+}
+
+static uint32_t seedHash(const uint8_t *p)
+{
+    uint32_t a, b;
+
+    memcpy(&a, p, 4);
+    memcpy(&b, p + 4, 4);
+    return ((a * 2654435761u) ^ (b * 2246822519u)) >> (32u - HASH_BITS);
+}
+
+static void flushInsert(BUF_T *patch, const uint8_t *lit, size_t n)
+{
+    if (n == 0u)
+        return;
+    put(patch, VENT_UPDATE_OP_INSERT);
+    putVarint(patch, (uint32_t)n);
+    while (n--)
+    {
+        put(patch, *lit++);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    static uint8_t oldImg[FLASH_MAX], newImg[FLASH_MAX];
+    size_t oldLen, newLen, i, lit = 0;
+    unsigned long exclude = FLASH_MAX;
+    int32_t *head, *prev;
+    uint32_t oldPos = 0;
+    size_t copyBytes = 0, fillBytes = 0, insertBytes = 0, ops = 0;
+    BUF_T patch = { NULL, 0, 0 };
+    FILE *f;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "x:")) != -1)
+    {
+        if (opt != 'x')
+            break;
+        exclude = strtoul(optarg, NULL, 0);
+    }
+    if ((opt != -1) || (argc - optind != 3))
+    {
+        fprintf(stderr, "usage: %s [-x exclude] old.hex new.hex patch.bin\n", argv[0]);
+        return 2;
+    }
+    oldLen = readHex(argv[optind], oldImg);
+    newLen = readHex(argv[optind + 1], newImg);
+    if (oldLen > exclude)
+        oldLen = exclude;
+
+    /* Seed index, chains run from the newest position backwards */
+    head = malloc(sizeof(int32_t) << HASH_BITS);
+    prev = malloc(sizeof(int32_t) * (oldLen + 1u));
+    memset(head, 0xFF, sizeof(int32_t) << HASH_BITS);
+    for (i = 0; i + SEED_LEN <= oldLen; i++)
+    {
+        uint32_t h = seedHash(&oldImg[i]);
+
+        prev[i] = head[h];
+        head[h] = (int32_t)i;
+    }
+
+    put32(&patch, VENT_UPDATE_MAGIC);
+    put32(&patch, (uint32_t)oldLen);
+    put32(&patch, crc32(oldImg, oldLen));
+    put32(&patch, (uint32_t)newLen);
+    put32(&patch, crc32(newImg, newLen));
+
+    i = 0;
+    while (i < newLen)
+    {
+        size_t run = 1, bestLen = 0, bestPos = 0, len;
+        unsigned chain = 0;
+        int32_t cand;
+
+        while ((i + run < newLen) && (newImg[i + run] == newImg[i]))
+            run++;
+
+        /* Continue where the last copy left off, code that only moved
+           keeps matching at the same distance */
+        if (oldPos < oldLen)
+        {
+            for (len = 0; (i + len < newLen) && (oldPos + len < oldLen) &&
+                          (newImg[i + len] == oldImg[oldPos + len]); len++)
+            {
+            }
+            bestLen = len;
+            bestPos = oldPos;
+        }
+        if (i + SEED_LEN <= newLen)
+        {
+            for (cand = head[seedHash(&newImg[i])]; (cand >= 0) && (chain < CHAIN_MAX); cand = prev[cand], chain++)
+            {
+                for (len = 0; (i + len < newLen) && ((size_t)cand + len < oldLen) &&
+                              (newImg[i + len] == oldImg[cand + len]); len++)
+                {
+                }
+                if (len > bestLen)
+                {
+                    bestLen = len;
+                    bestPos = (size_t)cand;
+                }
+            }
+        }
+
+        if ((run >= MIN_FILL) && (run >= bestLen))
+        {
+            flushInsert(&patch, &newImg[i - lit], lit);
+            ops += (lit != 0u);
+            lit = 0;
+            put(&patch, VENT_UPDATE_OP_FILL);
+            putVarint(&patch, (uint32_t)run);
+            put(&patch, newImg[i]);
+            fillBytes += run;
+            ops++;
+            i += run;
+        }
+        else if ((bestLen >= MIN_COPY) || ((bestLen >= 4u) && (bestPos == oldPos)))
+        {
+            int32_t delta = (int32_t)bestPos - (int32_t)oldPos;
+
+            flushInsert(&patch, &newImg[i - lit], lit);
+            ops += (lit != 0u);
+            lit = 0;
+            put(&patch, VENT_UPDATE_OP_COPY);
+            putVarint(&patch, (uint32_t)bestLen);
+            putVarint(&patch, (uint32_t)((delta << 1) ^ (delta >> 31)));
+            oldPos = (uint32_t)(bestPos + bestLen);
+            copyBytes += bestLen;
+            ops++;
+            i += bestLen;
+        }
+        else
+        {
+            lit++;
+            insertBytes++;
+            i++;
+        }
+    }
+    flushInsert(&patch, &newImg[i - lit], lit);
+    ops += (lit != 0u);
+    put(&patch, VENT_UPDATE_OP_END);
+
+    f = fopen(argv[optind + 2], "wb");
+    if ((f == NULL) || (fwrite(patch.data, 1, patch.len, f) != patch.len))
+    {
+        perror(argv[optind + 2]);
+        return 1;
+    }
+    fclose(f);
+
+    printf("old %zu bytes, new %zu bytes, patch %zu bytes (%.1f%%)\n",
+           oldLen, newLen, patch.len, 100.0 * (double)patch.len / (double)newLen);
+    printf("copy %zu, fill %zu, insert %zu bytes in %zu operations\n",
+           copyBytes, fillBytes, insertBytes, ops);
+    printf("%zu writes of 20 bytes\n", (patch.len + 19u) / 20u);
+    return 0;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,261 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+
+/* Host test: VentControl closed around a room model, the way capsenseled
+   runs it. Every temperature sample goes through VentControl_Update() and
+   the moves it asks for through VentMotion to VentDamper, the room warms
+   or cools with the damper position VentDamper drives. Checks settling
+   and overshoot, anti-windup against an unreachable setpoint, the travel
+   limits and rate limit, cooling, and the Control characteristic record.
+
+     cc -O2 -Wall -Wextra -I. -I../../VentCommon \
+        -I../../Proc_VentBLE.cydsn/Generated_Source/PSoC4 -o VentControlTest \
+        VentControlTest.c VentSimHw.c ../../VentCommon/VentControl.c \
+        ../../VentCommon/VentMotion.c ../../VentCommon/VentDamper.c \
+        ../../VentCommon/VentTimer.c
+     ./VentControlTest
+
+   Exits non-zero on the first failed check. */
+#include "VentSim.h"
+#include "VentControl.h"
+#include "VentMotion.h"
+
+#define CHECK(cond, ...) \
+    do { if (!(cond)) { printf("FAIL: " __VA_ARGS__); printf("\n"); return 1; } } while (0)
+
+/* Room: loses heat to the outside through TEST_LOSS_S, the supply air
+   pulls it toward its own temperature through TEST_SUPPLY_S with the
+   damper wide open, in proportion to the opening. Fully open holds the
+   room at 26.25 degC with the figures below. */
+#define TEST_OUTSIDE                (15.0)
+#define TEST_SUPPLY_WARM            (30.0)
+#define TEST_SUPPLY_COLD            (12.0)
+#define TEST_LOSS_S                 (1800.0)
+#define TEST_SUPPLY_S               (600.0)
+
+/* Main loop pass and DS18B20 conversion, ms */
+#define TEST_STEP_MS                (100u)
+#define TEST_SAMPLE_MS              (1000u)
+
+typedef struct
+{
+    double outside;
+    double supply;
+    double room;
+} TEST_ROOM_T;
+
+typedef struct
+{
+    uint32 moves;
+    uint32 settleMs;        /* last time the room was outside the band */
+    double peak;            /* furthest past the setpoint, degC */
+    double errSum;          /* over the last quarter of the run */
+    uint32 errCount;
+    uint16 minPosition;
+    uint16 maxPosition;
+    int32  maxStepPerMin;   /* controller output, permille */
+} TEST_RUN_T;
+
+static VENT_CONTROL_T ctl;
+static TEST_ROOM_T room;
+
+/***************************************************************
+ * Sensor reading in 1/100 degC, at the DS18B20's 1/16 degC
+ **************************************************************/
+static int16 Test_Sensor(double t)
+{
+    int32 sixteenths = (int32)((t * 16.0) + ((t >= 0.0) ? 0.5 : -0.5));
+
+    return (int16)((sixteenths * 100) / 16);
+}
+
+/***************************************************************
+ * Run the loop for the given time and collect figures against
+ * the setpoint. band is the settling band in degC.
+ **************************************************************/
+static void Test_Run(uint32 ms, double band, TEST_RUN_T *run)
+{
+    double setpoint = ctl.setpoint / 100.0;
+    double sign = (ctl.direction == VENT_CONTROL_HEATING) ? 1.0 : -1.0;
+    uint32 t, sinceSample = 0, minuteStart = 0;
+    uint16 position, minuteOutput = ctl.output;
+    int32 step;
+
+    run->moves = 0;
+    run->settleMs = 0;
+    run->peak = 0.0;
+    run->errSum = 0.0;
+    run->errCount = 0;
+    run->minPosition = 0xFFFFu;
+    run->maxPosition = 0;
+    run->maxStepPerMin = 0;
+
+    for (t = 0; t < ms; t += TEST_STEP_MS)
+    {
+        double open = VentDamper_GetPosition() / (double)VENT_DAMPER_POSITION_MAX;
+
+        room.room += (TEST_STEP_MS / 1000.0) *
+                     (((room.outside - room.room) / TEST_LOSS_S) + ((open * (room.supply - room.room)) / TEST_SUPPLY_S));
+
+        sinceSample += TEST_STEP_MS;
+        if (sinceSample >= TEST_SAMPLE_MS)
+        {
+            sinceSample = 0;
+            if (VentControl_Update(&ctl, Test_Sensor(room.room), VentTimer_GetTimeStamp(), &position))
+            {
+                VentMotion_MoveTo(position, VENT_MOTION_SCURVE);
+                run->moves++;
+            }
+        }
+        VentDamper_Process(VentTimer_GetTimeStamp());
+        VentSim_Run(TEST_STEP_MS);
+
+        if ((t - minuteStart) >= 60000u)
+        {
+            step = (int32)ctl.output - minuteOutput;
+            if (step < 0)
+                step = -step;
+            if (step > run->maxStepPerMin)
+                run->maxStepPerMin = step;
+            minuteStart = t;
+            minuteOutput = ctl.output;
+        }
+        if (ctl.output < run->minPosition)
+            run->minPosition = ctl.output;
+        if (ctl.output > run->maxPosition)
+            run->maxPosition = ctl.output;
+        if (((room.room - setpoint) * sign) > run->peak)
+            run->peak = (room.room - setpoint) * sign;
+        if ((room.room > (setpoint + band)) || (room.room < (setpoint - band)))
+            run->settleMs = t + TEST_STEP_MS;
+        if (t >= ((ms / 4u) * 3u))
+        {
+            run->errSum += room.room - setpoint;
+            run->errCount++;
+        }
+    }
+}
+
+/***************************************************************
+ * Settings record with the given values
+ **************************************************************/
+static void Test_Record(uint8 *data, int16 setpoint, uint16 minPosition, uint16 maxPosition,
+                        uint16 maxRate, int8 direction, uint8 enabled)
+{
+    VENT_CONTROL_T settings = ctl;
+
+    settings.setpoint = setpoint;
+    settings.minPosition = minPosition;
+    settings.maxPosition = maxPosition;
+    settings.maxRate = maxRate;
+    settings.direction = direction;
+    settings.enabled = enabled;
+    VentControl_Pack(&settings, data);
+}
+
+int main(void)
+{
+    uint8 data[VENT_CONTROL_CHAR_LEN], back[VENT_CONTROL_CHAR_LEN];
+    VENT_CONTROL_T before;
+    TEST_RUN_T run;
+    uint32 i;
+
+    VentTimer_Start();
+    VentDamper_Start();
+    VentMotion_Start();
+    VentControl_Init(&ctl);
+    VentDamper_SetPosition(0);
+
+    /* Heating from 18 degC to the 21 degC default */
+    room.outside = TEST_OUTSIDE;
+    room.supply = TEST_SUPPLY_WARM;
+    room.room = 18.0;
+    VentControl_Enable(&ctl, 1, VentDamper_GetPosition());
+    Test_Run(4u * 3600000u, 0.25, &run);
+    printf("heating 18 -> 21 degC: within 0.25 after %.1f min, overshoot %.2f degC, "
+           "error %.3f degC, %u moves, damper %u permille\n",
+           run.settleMs / 60000.0, run.peak, run.errSum / run.errCount, (unsigned)run.moves, ctl.output);
+    CHECK(run.settleMs <= (90u * 60000u), "heating settles after %.1f min", run.settleMs / 60000.0);
+    CHECK(run.peak <= 1.0, "heating overshoots %.2f degC", run.peak);
+    CHECK((run.errSum / run.errCount) < 0.1 && (run.errSum / run.errCount) > -0.1, "steady error %.3f degC",
+          run.errSum / run.errCount);
+    CHECK(run.maxStepPerMin <= (int32)ctl.maxRate + 1, "output moved %d permille in a minute, limit %u",
+          (int)run.maxStepPerMin, ctl.maxRate);
+
+    /* Unreachable setpoint: the output sits at the top without winding
+       the integral up, so it comes off as soon as the setpoint drops */
+    VentControl_SetSetpoint(&ctl, 3000);
+    Test_Run(2u * 3600000u, 0.25, &run);
+    CHECK(ctl.output == ctl.maxPosition, "saturated output %u", ctl.output);
+    CHECK((ctl.integral >> 8) <= (int32)ctl.maxPosition, "integral wound up to %d permille",
+          (int)(ctl.integral >> 8));
+    printf("setpoint 30 degC: room %.2f degC at full open, integral %d permille\n", room.room,
+           (int)(ctl.integral >> 8));
+    VentControl_SetSetpoint(&ctl, 2100);
+    Test_Run(4u * 3600000u, 0.25, &run);
+    printf("back to 21 degC: within 0.25 after %.1f min, error %.3f degC\n",
+           run.settleMs / 60000.0, run.errSum / run.errCount);
+    CHECK(run.settleMs <= (120u * 60000u), "recovery settles after %.1f min", run.settleMs / 60000.0);
+
+    /* Travel limits and a slower rate from a Control record */
+    Test_Record(data, 3000, 100u, 600u, 60u, VENT_CONTROL_HEATING, 1u);
+    CHECK(VentControl_Unpack(&ctl, data, sizeof(data), VentDamper_GetPosition()) == VENT_CONTROL_OK, "record refused");
+    Test_Run(3600000u, 0.25, &run);
+    CHECK(run.maxPosition <= 600u, "output %u above the limit", run.maxPosition);
+    CHECK(run.maxStepPerMin <= 61, "output moved %d permille in a minute, limit 60", (int)run.maxStepPerMin);
+    Test_Record(data, 1500, 100u, 600u, 60u, VENT_CONTROL_HEATING, 1u);
+    CHECK(VentControl_Unpack(&ctl, data, sizeof(data), VentDamper_GetPosition()) == VENT_CONTROL_OK, "record refused");
+    Test_Run(3600000u, 0.25, &run);
+    CHECK(run.minPosition >= 100u, "output %u below the limit", run.minPosition);
+    CHECK(ctl.output == 100u, "output %u, not at the lower limit", ctl.output);
+    printf("limits 100-600 permille at 60 permille/min: held, fastest minute %d permille\n", (int)run.maxStepPerMin);
+
+    /* Cooling: warm room, cold supply, the loop runs the other way */
+    room.outside = 30.0;
+    room.supply = TEST_SUPPLY_COLD;
+    room.room = 27.0;
+    Test_Record(data, 2400, 0u, VENT_DAMPER_POSITION_MAX, VENT_CONTROL_MAX_RATE, VENT_CONTROL_COOLING, 1u);
+    CHECK(VentControl_Unpack(&ctl, data, sizeof(data), VentDamper_GetPosition()) == VENT_CONTROL_OK, "record refused");
+    Test_Run(4u * 3600000u, 0.25, &run);
+    printf("cooling 27 -> 24 degC: within 0.25 after %.1f min, overshoot %.2f degC, error %.3f degC\n",
+           run.settleMs / 60000.0, run.peak, run.errSum / run.errCount);
+    CHECK(run.settleMs <= (90u * 60000u), "cooling settles after %.1f min", run.settleMs / 60000.0);
+    CHECK(run.peak <= 1.0, "cooling overshoots %.2f degC", run.peak);
+
+    /* Record round trip, and bad records change nothing */
+    VentControl_Pack(&ctl, data);
+    before = ctl;
+    CHECK(VentControl_Unpack(&ctl, data, sizeof(data), VentDamper_GetPosition()) == VENT_CONTROL_OK, "own record refused");
+    VentControl_Pack(&ctl, back);
+    for (i = 0; i < sizeof(data); i++)
+    {
+        CHECK(data[i] == back[i], "record byte %u changed", (unsigned)i);
+    }
+    CHECK(VentControl_Unpack(&ctl, data, sizeof(data) - 1u, 0) == VENT_CONTROL_BAD_LENGTH, "short record taken");
+    Test_Record(data, 2100, 700u, 600u, 300u, VENT_CONTROL_HEATING, 1u);
+    CHECK(VentControl_Unpack(&ctl, data, sizeof(data), 0) == VENT_CONTROL_BAD_VALUE, "inverted limits taken");
+    Test_Record(data, 2100, 0u, 1001u, 300u, VENT_CONTROL_HEATING, 1u);
+    CHECK(VentControl_Unpack(&ctl, data, sizeof(data), 0) == VENT_CONTROL_BAD_VALUE, "limit past the travel taken");
+    Test_Record(data, 2100, 0u, 1000u, 300u, 0, 1u);
+    CHECK(VentControl_Unpack(&ctl, data, sizeof(data), 0) == VENT_CONTROL_BAD_VALUE, "direction 0 taken");
+    Test_Record(data, 2100, 0u, 1000u, 300u, VENT_CONTROL_HEATING, 2u);
+    CHECK(VentControl_Unpack(&ctl, data, sizeof(data), 0) == VENT_CONTROL_BAD_VALUE, "enabled 2 taken");
+    VentControl_Pack(&ctl, data);
+    CHECK((ctl.setpoint == before.setpoint) && (ctl.maxPosition == before.maxPosition) &&
+          (ctl.direction == before.direction) && (ctl.enabled == before.enabled), "refused record applied");
+    printf("record: round trip exact, bad length and values refused\n");
+
+    printf("PASS\n");
+    return 0;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,122 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+
+/* Host test: VentDamper position to PWM_Servo compare mapping over the
+   whole range, with the default table and with a per-unit calibration
+   written through VentDamper_SaveCalibration().
+
+     cc -O2 -Wall -Wextra -I. -I../../VentCommon \
+        -I../../Proc_VentBLE.cydsn/Generated_Source/PSoC4 -o VentDamperTest \
+        VentDamperTest.c VentSimHw.c ../../VentCommon/VentDamper.c \
+        ../../VentCommon/VentTimer.c
+     ./VentDamperTest
+
+   Exits non-zero on the first failed check. */
+#include "VentSim.h"
+#include "VentDamper.h"
+
+#define CHECK(cond, ...) \
+    do { if (!(cond)) { printf("FAIL: " __VA_ARGS__); printf("\n"); return 1; } } while (0)
+
+/* The servo switch the Servo characteristic ran before VentDamper */
+static const uint16 legacyCompare[VENT_DAMPER_LEGACY_STEPS + 1u] = { 4315u, 4350u, 4375u, 4425u, 4450u, 4475u };
+
+/***************************************************************
+ * Every position against straight line interpolation of table,
+ * monotonic if the table is
+ **************************************************************/
+static int CheckRange(const uint16 table[VENT_DAMPER_CAL_POINTS], const char *name)
+{
+    uint32 position, seg, frac;
+    int32 expect, got, last = -1;
+    int32 dir = (table[VENT_DAMPER_CAL_POINTS - 1u] >= table[0]) ? 1 : -1;
+
+    for (position = 0; position <= 0xFFFFu; position++)
+    {
+        uint32 clamped = (position > VENT_DAMPER_POSITION_MAX) ? VENT_DAMPER_POSITION_MAX : position;
+
+        seg = clamped / VENT_DAMPER_CAL_STEP;
+        frac = clamped % VENT_DAMPER_CAL_STEP;
+        if (seg == (VENT_DAMPER_CAL_POINTS - 1u))
+        {
+            seg--;
+            frac = VENT_DAMPER_CAL_STEP;
+        }
+        /* Truncating toward zero like the firmware, within one count of exact */
+        expect = table[seg] + ((((int32)table[seg + 1u] - table[seg]) * (int32)frac) / (int32)VENT_DAMPER_CAL_STEP);
+        got = VentDamper_ToCompare((uint16)position);
+
+        CHECK(got == expect, "%s: position %u gives %d, expected %d", name, (unsigned)position, (int)got, (int)expect);
+        if (position <= VENT_DAMPER_POSITION_MAX)
+        {
+            CHECK((last < 0) || (((got - last) * dir) >= 0), "%s: not monotonic at %u", name, (unsigned)position);
+            last = got;
+        }
+    }
+    printf("%s: positions 0-65535 match the table, %u-%u\n", name,
+           (unsigned)VentDamper_ToCompare(0), (unsigned)VentDamper_ToCompare(VENT_DAMPER_POSITION_MAX));
+    return 0;
+}
+
+int main(void)
+{
+    uint16 table[VENT_DAMPER_CAL_POINTS];
+    uint32 i;
+
+    VentTimer_Start();
+    VentDamper_Start();
+
+    /* Default table: legacy steps unchanged */
+    for (i = 0; i <= VENT_DAMPER_LEGACY_STEPS; i++)
+    {
+        uint16 got = VentDamper_ToCompare(VENT_DAMPER_FROM_STEP(i));
+
+        CHECK(got == legacyCompare[i], "step %u gives %u, the servo switch gave %u",
+              (unsigned)i, (unsigned)got, (unsigned)legacyCompare[i]);
+    }
+    printf("default: legacy steps 0-%u exact\n", (unsigned)VENT_DAMPER_LEGACY_STEPS);
+
+    for (i = 0; i < VENT_DAMPER_CAL_POINTS; i++)
+    {
+        table[i] = VentDamper_ToCompare((uint16)(i * VENT_DAMPER_CAL_STEP));
+        printf("  %4u permille -> %u\n", (unsigned)(i * VENT_DAMPER_CAL_STEP), (unsigned)table[i]);
+    }
+    if (CheckRange(table, "default"))
+        return 1;
+
+    /* A unit whose servo runs the other way, with a kink in the middle */
+    for (i = 0; i < VENT_DAMPER_CAL_POINTS; i++)
+    {
+        table[i] = (uint16)(4600u - (i * 30u) - ((i > 5u) ? ((i - 5u) * 12u) : 0u));
+    }
+    CHECK(VentDamper_SaveCalibration(table) == CY_SYS_FLASH_SUCCESS, "calibration row not written");
+    CHECK(ventSimFlashRows == 1u, "%u rows written for one calibration", (unsigned)ventSimFlashRows);
+    if (CheckRange(table, "calibrated"))
+        return 1;
+
+    /* Drive and release */
+    VentDamper_SetPosition(VENT_DAMPER_FROM_STEP(3));
+    CHECK(ventSimServoRunning && (ventSimServoCompare == table[6]), "SetPosition did not drive the servo");
+    VentSim_Run(VENT_DAMPER_SETTLE_MS - 10u);
+    VentDamper_Process(VentTimer_GetTimeStamp());
+    CHECK(VentDamper_IsEnergised(), "released before the settle time");
+    VentSim_Run(20u);
+    VentDamper_Process(VentTimer_GetTimeStamp());
+    CHECK(!VentDamper_IsEnergised() && !ventSimServoRunning, "not released after the settle time");
+    CHECK(VentDamper_GetStats()->driveTime >= VENT_DAMPER_SETTLE_MS, "drive time %u ms",
+          (unsigned)VentDamper_GetStats()->driveTime);
+
+    printf("PASS\n");
+    return 0;
+}
+
+/* [] END OF FILE */
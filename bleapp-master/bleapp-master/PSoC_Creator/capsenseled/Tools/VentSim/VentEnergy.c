@@ -0,0 +1,161 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+
+/* Host tool: energy per damper move with VentDamper's move-then-release,
+   against a servo that is driven all the time as before.
+
+     cc -O2 -Wall -Wextra -I. -I../../VentCommon \
+        -I../../Proc_VentBLE.cydsn/Generated_Source/PSoC4 -o VentEnergy \
+        VentEnergy.c VentSimHw.c ../../VentCommon/VentDamper.c \
+        ../../VentCommon/VentTimer.c
+     ./VentEnergy [-m moves per hour] [-H hours] [-r refresh ms]
+
+   The firmware runs unchanged on the simulated clock with a main loop pass
+   every ms. The current drawn each ms comes from the PWM and pin state it
+   leaves behind and the supply figures below, so the results are as good
+   as those figures: take them from the servo and board at hand. */
+#include "VentSim.h"
+#include "VentDamper.h"
+#include <stdlib.h>
+#include <unistd.h>
+
+/* Supply and servo, a small analog hobby servo */
+#define ENERGY_SUPPLY_MV            (3000u)
+#define ENERGY_SERVO_MOVE_UA        (180000u)   /* slewing */
+#define ENERGY_SERVO_HOLD_UA        (8000u)     /* driven, at the target */
+#define ENERGY_SERVO_TRAVEL_MS      (450u)      /* full travel at full speed */
+
+/* PSoC 4 BLE: CPU asleep with HFCLK on for TCPWM, and deep sleep */
+#define ENERGY_MCU_SLEEP_UA         (1300u)
+#define ENERGY_MCU_DEEPSLEEP_UA     (2u)
+
+typedef struct
+{
+    uint32 moves;
+    uint64 servoUaMs;       /* servo charge, uA ms */
+    uint64 mcuUaMs;
+    uint32 drivenMs;
+} ENERGY_RESULT_T;
+
+/***************************************************************
+ * Run the damper for the given time with random moves
+ **************************************************************/
+static void Energy_Run(uint32 settle, uint32 refresh, uint32 movesPerHour, uint32 hours,
+                       ENERGY_RESULT_T *result)
+{
+    uint32 ms, total = hours * 3600000u;
+    uint32 gap = 3600000u / movesPerHour;
+    uint32 slewUntil = 0;
+    uint16 servoAt = 0, target;
+
+    srand(1);
+    VentDamper_SetTiming(settle, refresh);
+    VentDamper_SetPosition(0);
+    result->moves = 0;
+    result->servoUaMs = 0;
+    result->mcuUaMs = 0;
+    result->drivenMs = 0;
+
+    for (ms = 0; ms < total; ms++)
+    {
+        if ((ms % gap) == (gap / 2u))
+        {
+            target = (uint16)((rand() % 11) * 100);
+            VentDamper_SetPosition(target);
+            result->moves++;
+        }
+        VentDamper_Process(VentTimer_GetTimeStamp());
+
+        /* The servo slews only while it is driven */
+        if (ventSimServoRunning && (ventSimServoDriveMode == Servo_DM_STRONG))
+        {
+            target = VentDamper_GetPosition();
+            if (target != servoAt)
+            {
+                slewUntil = ms + (ENERGY_SERVO_TRAVEL_MS * (uint32)abs((int)target - servoAt)) / VENT_DAMPER_POSITION_MAX;
+                servoAt = target;
+            }
+            result->servoUaMs += (ms < slewUntil) ? ENERGY_SERVO_MOVE_UA : ENERGY_SERVO_HOLD_UA;
+            result->mcuUaMs += ENERGY_MCU_SLEEP_UA;
+            result->drivenMs++;
+        }
+        else
+        {
+            result->mcuUaMs += ENERGY_MCU_DEEPSLEEP_UA;
+        }
+        VentSim_Run(1u);
+    }
+}
+
+/***************************************************************
+ * One line of results, energy in mJ
+ **************************************************************/
+static void Energy_Print(const char *name, const ENERGY_RESULT_T *r, uint32 hours)
+{
+    double servoMj = (double)r->servoUaMs * ENERGY_SUPPLY_MV / 1e9;
+    double mcuMj = (double)r->mcuUaMs * ENERGY_SUPPLY_MV / 1e9;
+    double avgUa = (double)(r->servoUaMs + r->mcuUaMs) / ((double)hours * 3600000.0);
+
+    printf("%-22s %6u %10.1f %10.1f %12.2f %10.1f\n", name, (unsigned)r->moves,
+           (double)r->drivenMs / r->moves, (servoMj + mcuMj) / r->moves, servoMj + mcuMj, avgUa);
+}
+
+int main(int argc, char **argv)
+{
+    static const uint32 settleTimes[] = { 300u, 600u, 1000u };
+    uint32 movesPerHour = 12u, hours = 24u, refresh = 0u;
+    ENERGY_RESULT_T result;
+    char name[32];
+    uint8 i;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "m:H:r:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'm':
+                movesPerHour = (uint32)strtoul(optarg, NULL, 0);
+                break;
+            case 'H':
+                hours = (uint32)strtoul(optarg, NULL, 0);
+                break;
+            case 'r':
+                refresh = (uint32)strtoul(optarg, NULL, 0);
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-m moves per hour] [-H hours] [-r refresh ms]\n", argv[0]);
+                return 1;
+        }
+    }
+    if ((movesPerHour == 0u) || (hours == 0u))
+        return 1;
+
+    VentTimer_Start();
+    VentDamper_Start();
+
+    printf("%u moves/h for %u h, refresh %u ms\n", (unsigned)movesPerHour, (unsigned)hours, (unsigned)refresh);
+    printf("%-22s %6s %10s %10s %12s %10s\n", "", "moves", "driven ms", "mJ/move", "total mJ", "avg uA");
+
+    /* Before: the PWM drives the servo until the next move */
+    Energy_Run(0xFFFFFFFFu, 0u, movesPerHour, hours, &result);
+    Energy_Print("always driven", &result, hours);
+
+    for (i = 0; i < (sizeof(settleTimes) / sizeof(settleTimes[0])); i++)
+    {
+        sprintf(name, "release after %u ms", (unsigned)settleTimes[i]);
+        Energy_Run(settleTimes[i], refresh, movesPerHour, hours, &result);
+        Energy_Print(name, &result, hours);
+    }
+    return 0;
+}
+
+/* [] END OF FILE */
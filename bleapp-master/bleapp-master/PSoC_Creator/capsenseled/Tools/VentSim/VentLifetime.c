@@ -0,0 +1,224 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+
+/* Host tool: battery lifetime of Proc_VentBLE for each VentBattery power
+   tier. The average current of a tier is built up from what its policy
+   sets: samples (history record and notification), advertising at the
+   interval VentAdv picks for the tier's target, servo refreshes, battery
+   measurements, plus the connection events and the sleep floor. Then the
+   cells are run down with VentBattery measuring them as on the vent, so
+   the tiers follow each other as they would.
+
+     cc -O2 -Wall -Wextra -I. -I../../VentCommon \
+        -I../../Proc_VentBLE.cydsn/Generated_Source/PSoC4 -o VentLifetime \
+        VentLifetime.c VentSimHw.c ../../VentCommon/VentBattery.c \
+        ../../VentCommon/VentAdv.c ../../VentCommon/VentTimer.c
+     ./VentLifetime [-c connected %] [-s]
+
+   -s takes CPU sleep as the floor, a main loop that never reaches deep
+   sleep. Exits non-zero when the currents in the VentBattery policy table,
+   which VentBattery_Lifetime() projects with, are more than 20 % off the
+   model, or the projection is more than 15 % off the run down. The
+   figures below are as good as their sources: take them from the board
+   at hand. */
+#include "VentSim.h"
+#include "VentBattery.h"
+#include "VentAdv.h"
+#include "VentDamper.h"
+#include <stdlib.h>
+#include <unistd.h>
+
+#define CHECK(cond, ...) \
+    do { if (!(cond)) { printf("FAIL: " __VA_ARGS__); printf("\n"); return 1; } } while (0)
+
+/* Charge per event (nC) and floors (nA) */
+#define LIFE_CONN_EVENT_NC          (2000u)     /* empty connection event */
+#define LIFE_SAMPLE_NC              (5000u)     /* wake, pressure, one notification */
+#define LIFE_RECORD_NC              (400u)      /* share of a NOR page program, 32 records */
+#define LIFE_MEASURE_NC             (100u)      /* one injection conversion */
+#define LIFE_SERVO_HOLD_UA          (8000u)     /* servo driven at its target, as VentEnergy */
+#define LIFE_SLEEP_NA               (1300000u)  /* CPU sleep, HFCLK on */
+#define LIFE_DEEPSLEEP_NA           (VENT_ADV_SLEEP_NA)
+
+/* The vent asks for this connection interval, the hub may pick less */
+#define LIFE_CONN_INTERVAL_US       ((uint32)CYBLE_GAPP_CONNECTION_INTERVAL_MAX * 1250u)
+
+/* Run down in steps of a minute */
+#define LIFE_STEP_MS                (60000u)
+
+/* Table currents and projection must stay this close to the model (%) */
+#define LIFE_TABLE_TOLERANCE        (20u)
+#define LIFE_PROJECTION_TOLERANCE   (15u)
+
+typedef struct
+{
+    uint8  seen;
+    uint8  minLevel;
+    VENT_BATTERY_POLICY_T policy;
+    uint16 advInterval;
+    uint32 floor;           /* every part in nA */
+    uint32 conn;
+    uint32 adv;
+    uint32 sample;
+    uint32 servo;
+    uint32 measure;
+    uint32 total;
+    double days;            /* spent in the tier during the run down */
+} LIFE_TIER_T;
+
+static const char *tierName[VENT_BATTERY_TIERS] = { "normal", "save", "low", "critical" };
+
+/* Discharge curve VentBattery reads the level from, falling voltage */
+static const uint16 curveMv[] = { 3100u, 2800u, 2600u, 2400u, 2200u, 2000u };
+static const uint8 curveLevel[] = { 100u, 80u, 50u, 20u, 5u, 0u };
+
+CYBLE_GAPP_DISC_MODE_INFO_T cyBle_discoveryModeInfo;
+
+CYBLE_API_RESULT_T CyBle_GappStartAdvertisement(uint8 advertisingIntervalType)
+{
+    (void)advertisingIntervalType;
+    return CYBLE_ERROR_OK;
+}
+
+/***************************************************************
+ * Cell voltage at a share of the charge left, in 1/1000
+ **************************************************************/
+static uint16 Life_Mv(uint32 permille)
+{
+    uint8 i;
+
+    for (i = 1; i < sizeof(curveMv) / sizeof(curveMv[0]); i++)
+    {
+        if (permille >= (curveLevel[i] * 10u))
+        {
+            return (uint16)(curveMv[i] + ((permille - curveLevel[i] * 10u) * (uint32)(curveMv[i - 1] - curveMv[i])) /
+                                         ((curveLevel[i - 1] - curveLevel[i]) * 10u));
+        }
+    }
+    return curveMv[i - 1];
+}
+
+/***************************************************************
+ * Average current of the tier VentBattery is in now
+ **************************************************************/
+static void Life_Budget(LIFE_TIER_T *t, uint32 connected, uint8 cpuSleep)
+{
+    const VENT_BATTERY_POLICY_T *p = VentBattery_GetPolicy();
+    const VENT_ADV_REPORT_T *adv;
+
+    VentAdv_SetTarget(p->advTarget);
+    adv = VentAdv_GetReport();
+
+    t->policy = *p;
+    t->advInterval = adv->interval;
+    t->floor = cpuSleep ? LIFE_SLEEP_NA : LIFE_DEEPSLEEP_NA;
+    t->conn = (uint32)(((uint64)LIFE_CONN_EVENT_NC * 1000000u * connected) / (LIFE_CONN_INTERVAL_US * 100u));
+    t->adv = ((adv->current - VENT_ADV_SLEEP_NA) * (100u - connected)) / 100u;
+    t->sample = ((LIFE_SAMPLE_NC + LIFE_RECORD_NC) * 1000u) / p->sampleInterval;
+    t->servo = (p->servoRefresh != 0u) ?
+               (uint32)(((uint64)LIFE_SERVO_HOLD_UA * 1000u * VENT_DAMPER_SETTLE_MS) / p->servoRefresh) : 0u;
+    t->measure = (LIFE_MEASURE_NC * 1000u) / p->measureInterval;
+    t->total = t->floor + t->conn + t->adv + t->sample + t->servo + t->measure;
+}
+
+int main(int argc, char *argv[])
+{
+    static LIFE_TIER_T tiers[VENT_BATTERY_TIERS];
+    uint32 connected = 50u;
+    uint8 cpuSleep = 0;
+    double charge, capacity = (double)VENT_BATTERY_CAPACITY_MAH * 3600.0 * 1e6;   /* nA s */
+    double days = 0.0, projected;
+    uint32 now = 0;
+    VENT_BATTERY_TIER_T tier;
+    LIFE_TIER_T *t;
+    uint8 i;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "c:s")) != -1)
+    {
+        if (opt == 'c')
+            connected = (uint32)atoi(optarg);
+        else if (opt == 's')
+            cpuSleep = 1;
+        else
+            return 2;
+    }
+    if (connected > 100u)
+        return 2;
+
+    VentTimer_Start();
+    VentAdv_Init();
+    VentBattery_Start();
+
+    /* Run the cells down, VentBattery picks the tier as on the vent */
+    charge = capacity;
+    VentSim_SetSupply(Life_Mv(1000u));
+    VentBattery_Process(now);
+    VentBattery_Process(now);
+    projected = VentBattery_Lifetime() / 24.0;
+    while ((charge > 0.0) && (VentBattery_GetLevel() > 0u))
+    {
+        tier = VentBattery_GetTier();
+        t = &tiers[tier];
+        if (!t->seen)
+        {
+            t->seen = 1;
+            t->minLevel = VentBattery_GetPolicy()->minLevel;
+            Life_Budget(t, connected, cpuSleep);
+        }
+        charge -= (double)t->total * (LIFE_STEP_MS / 1000u);
+        t->days += LIFE_STEP_MS / 86400000.0;
+        days += LIFE_STEP_MS / 86400000.0;
+
+        now += LIFE_STEP_MS;
+        VentSim_SetSupply(Life_Mv((charge > 0.0) ? (uint32)((charge * 1000.0) / capacity) : 0u));
+        VentBattery_Process(now);
+        VentBattery_Process(now);
+    }
+
+    printf("%u %% connected at %u ms, %s between events, %u mAh\n\n", (unsigned)connected,
+           (unsigned)(LIFE_CONN_INTERVAL_US / 1000u), cpuSleep ? "CPU sleep" : "deep sleep",
+           (unsigned)VENT_BATTERY_CAPACITY_MAH);
+    printf("%-8s %5s %7s %7s %7s | %7s %7s %7s %7s %7s %7s | %7s %7s | %8s %8s\n",
+           "tier", "from", "sample", "adv", "refresh", "floor", "conn", "adv", "sample", "servo", "measure",
+           "uA", "table", "alone d", "run d");
+    for (i = 0; i < VENT_BATTERY_TIERS; i++)
+    {
+        t = &tiers[i];
+        CHECK(t->seen, "tier %s never reached", tierName[i]);
+        printf("%-8s %4u%% %6.0fs %5.0fms %6.0fs | %7.1f %7.1f %7.1f %7.1f %7.1f %7.2f | %7.1f %7u | %8.0f %8.0f\n",
+               tierName[i], t->minLevel, t->policy.sampleInterval / 1000.0, t->advInterval * 0.625,
+               t->policy.servoRefresh / 1000.0, t->floor / 1000.0, t->conn / 1000.0, t->adv / 1000.0,
+               t->sample / 1000.0, t->servo / 1000.0, t->measure / 1000.0, t->total / 1000.0,
+               (unsigned)t->policy.current, capacity / t->total / 86400.0, t->days);
+    }
+    printf("\nrun down from full: %.0f days, VentBattery_Lifetime() projected %.0f days at full\n", days, projected);
+
+    if (!cpuSleep && (connected == 50u))
+    {
+        for (i = 0; i < VENT_BATTERY_TIERS; i++)
+        {
+            t = &tiers[i];
+            CHECK((t->policy.current * 1000u * 100u <= t->total * (100u + LIFE_TABLE_TOLERANCE)) &&
+                  (t->policy.current * 1000u * 100u >= t->total * (100u - LIFE_TABLE_TOLERANCE)),
+                  "%s table current %u uA, model %.1f uA", tierName[i], (unsigned)t->policy.current,
+                  t->total / 1000.0);
+        }
+        CHECK((projected <= days * (100u + LIFE_PROJECTION_TOLERANCE) / 100.0) &&
+              (projected >= days * (100u - LIFE_PROJECTION_TOLERANCE) / 100.0),
+              "projected %.0f days, run down %.0f days", projected, days);
+        printf("PASS\n");
+    }
+    return 0;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,237 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+
+/* Host test: VentLog downloads the way the Log characteristic serves
+   them. The hub side reads slot after slot and decodes the rows, the
+   records must be exactly the ones logged before slot 0 was written,
+   however many records the vent keeps adding meanwhile.
+
+     cc -O2 -Wall -Wextra -I. -I../../VentCommon \
+        -I../../Proc_VentBLE.cydsn/Generated_Source/PSoC4 -o VentLogTest \
+        VentLogTest.c VentSimHw.c ../../VentCommon/VentLog.c \
+        ../../VentCommon/VentTimer.c
+     ./VentLogTest
+
+   Exits non-zero on the first failed check. */
+#include "VentSim.h"
+#include "VentLog.h"
+#include "VentTimer.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK(cond, ...) \
+    do { if (!(cond)) { printf("FAIL: " __VA_ARGS__); printf("\n"); return 1; } } while (0)
+
+/* Every record the vent logged, in order */
+#define TEST_MAX_RECORDS            (20000u)
+
+static VENT_LOG_RECORD_T logged[TEST_MAX_RECORDS];
+static uint32 loggedCount;
+
+/* What the hub decoded */
+static VENT_LOG_RECORD_T received[TEST_MAX_RECORDS];
+static uint32 receivedCount;
+
+/***************************************************************
+ * Log the next record of a slow random walk, a minute apart
+ **************************************************************/
+static void Test_Log(void)
+{
+    VENT_LOG_RECORD_T r;
+
+    if (loggedCount == 0u)
+    {
+        r.time = 1000u;
+        r.temperature = 2100;
+        r.position = 500u;
+        r.pressure = 0;
+    }
+    else
+    {
+        r = logged[loggedCount - 1u];
+        r.time += 60u;
+        r.temperature = (int16)(r.temperature + (rand() % 25) - 12);
+        r.position = (uint16)((r.position + (rand() % 41) + 980u) % 1001u);
+        r.pressure = (int16)((rand() % 9) - 4);
+    }
+    logged[loggedCount++] = r;
+    VentLog_Append(&r);
+}
+
+/***************************************************************
+ * Unsigned varint, returns the bytes used
+ **************************************************************/
+static uint32 Test_Varint(const uint8 *p, uint32 *value)
+{
+    uint32 n = 0, shift = 0;
+
+    *value = 0;
+    do
+    {
+        *value |= (uint32)(p[n] & 0x7Fu) << shift;
+        shift += 7u;
+    } while (p[n++] & 0x80u);
+    return n;
+}
+
+static int32 Test_Zigzag(uint32 v)
+{
+    return (int32)(v >> 1) ^ -(int32)(v & 1u);
+}
+
+/***************************************************************
+ * Decode a downloaded row the way the hub does
+ **************************************************************/
+static void Test_Decode(const uint8 *row, uint16 size)
+{
+    VENT_LOG_ROW_HEADER_T h;
+    VENT_LOG_RECORD_T r;
+    uint32 at = sizeof(h), v;
+    uint16 i;
+
+    memcpy(&h, row, sizeof(h));
+    if ((h.magic != VENT_LOG_ROW_MAGIC) || ((sizeof(h) + h.length) != size))
+        return;
+
+    r = h.first;
+    received[receivedCount++] = r;
+    for (i = 1; i < h.count; i++)
+    {
+        at += Test_Varint(&row[at], &v);
+        r.time += v;
+        at += Test_Varint(&row[at], &v);
+        r.temperature = (int16)(r.temperature + Test_Zigzag(v));
+        at += Test_Varint(&row[at], &v);
+        r.position = (uint16)(r.position + Test_Zigzag(v));
+        at += Test_Varint(&row[at], &v);
+        r.pressure = (int16)(r.pressure + Test_Zigzag(v));
+        received[receivedCount++] = r;
+    }
+}
+
+/***************************************************************
+ * Download the whole log, logging between the slots. Checks the
+ * records against the ones logged before the start.
+ **************************************************************/
+static int Test_Download(uint32 recordsPerSlot, uint32 *rows)
+{
+    uint8 row[CY_FLASH_SIZEOF_ROW];
+    uint32 before, first, i;
+    uint16 slot, size;
+
+    before = loggedCount;
+    receivedCount = 0;
+    *rows = 0;
+    VentLog_DownloadStart(VentTimer_GetTimeStamp());
+    for (slot = 0; ; slot++)
+    {
+        size = VentLog_DownloadRow(slot, row, VentTimer_GetTimeStamp());
+        if (size == 0u)
+            break;
+        CHECK(size <= CY_FLASH_SIZEOF_ROW, "slot %u is %u bytes", slot, size);
+        Test_Decode(row, size);
+        (*rows)++;
+        for (i = 0; i < recordsPerSlot; i++)
+        {
+            Test_Log();
+        }
+        VentSim_Run(100u);
+    }
+    VentLog_DownloadEnd(VentTimer_GetTimeStamp());
+
+    /* The newest records up to the start, in order, none missing */
+    CHECK(receivedCount != 0u, "nothing downloaded");
+    first = before - receivedCount;
+    for (i = 0; i < receivedCount; i++)
+    {
+        CHECK(memcmp(&received[i], &logged[first + i], sizeof(VENT_LOG_RECORD_T)) == 0,
+              "record %u of %u differs (time %u, expected %u)", (unsigned)i, (unsigned)receivedCount,
+              (unsigned)received[i].time, (unsigned)logged[first + i].time);
+    }
+    return 0;
+}
+
+int main(void)
+{
+    uint32 i, rows, dropped, written;
+
+    VentTimer_Start();
+    VentLog_Start();
+    srand(1);
+
+    /* Empty log */
+    VentLog_DownloadStart(VentTimer_GetTimeStamp());
+    CHECK(VentLog_DownloadRow(0, (uint8 *)received, VentTimer_GetTimeStamp()) == 0u, "empty log has a row");
+    VentLog_DownloadEnd(VentTimer_GetTimeStamp());
+
+    /* A few rows, the partly filled one is part of the download */
+    for (i = 0; i < 50u; i++)
+    {
+        Test_Log();
+    }
+    if (Test_Download(0u, &rows))
+        return 1;
+    CHECK(receivedCount == 50u, "%u of 50 records downloaded", (unsigned)receivedCount);
+    printf("young log: %u records in %u rows\n", (unsigned)receivedCount, (unsigned)rows);
+
+    /* Wrapped ring, nothing logged during the download */
+    for (i = 0; i < 3000u; i++)
+    {
+        Test_Log();
+    }
+    if (Test_Download(0u, &rows))
+        return 1;
+    CHECK(rows == VENT_LOG_ROWS, "%u rows in a full ring", (unsigned)rows);
+    printf("full ring: %u records in %u rows, %.1f records per row\n", (unsigned)receivedCount, (unsigned)rows,
+           (double)VentLog_GetStats()->recordsWritten / VentLog_GetStats()->rowsWritten);
+
+    /* The vent logs two rows' worth between two slots: the rows still to be
+       read stay as they were, what cannot be stored is counted */
+    dropped = VentLog_GetStats()->recordsDropped;
+    written = VentLog_GetStats()->rowsWritten;
+    if (Test_Download(120u, &rows))
+        return 1;
+    CHECK(rows == VENT_LOG_ROWS, "%u rows while logging", (unsigned)rows);
+    printf("logging 120 records per slot: %u records match, %u rows written, %u records dropped\n",
+           (unsigned)receivedCount, (unsigned)(VentLog_GetStats()->rowsWritten - written),
+           (unsigned)(VentLog_GetStats()->recordsDropped - dropped));
+
+    CHECK(VentLog_GetStats()->recordsDropped != dropped, "nothing dropped while logging");
+
+    /* After the download the log takes everything again. A full ring
+       later the gap the drops left is overwritten and the next download
+       ends with the newest record. */
+    dropped = VentLog_GetStats()->recordsDropped;
+    for (i = 0; i < 3000u; i++)
+    {
+        Test_Log();
+    }
+    CHECK(VentLog_GetStats()->recordsDropped == dropped, "records dropped without a download");
+    if (Test_Download(1u, &rows))
+        return 1;
+    CHECK(VentLog_GetStats()->recordsDropped == dropped, "slow logging dropped records");
+    printf("logging 1 record per slot: %u records match, none dropped\n", (unsigned)receivedCount);
+
+    /* A download nobody reads ends on its own */
+    VentLog_DownloadStart(VentTimer_GetTimeStamp());
+    VentSim_Run(VENT_LOG_DOWNLOAD_TIMEOUT - 1000u);
+    CHECK(VentLog_DownloadProcess(VentTimer_GetTimeStamp()), "download ended early");
+    VentSim_Run(2000u);
+    CHECK(!VentLog_DownloadProcess(VentTimer_GetTimeStamp()), "idle download still running");
+    CHECK(VentLog_DownloadRow(1, (uint8 *)received, VentTimer_GetTimeStamp()) == 0u, "row served after the timeout");
+    printf("idle download closed after %u ms\n", (unsigned)VENT_LOG_DOWNLOAD_TIMEOUT);
+
+    printf("PASS\n");
+    return 0;
+}
+
+/* [] END OF FILE */
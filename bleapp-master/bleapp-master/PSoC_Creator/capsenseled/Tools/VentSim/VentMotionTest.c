@@ -0,0 +1,190 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+
+/* Host test: VentMotion profiles frame by frame. Checks the peak step and
+   acceleration against the limits, the move time against the shortest one
+   the limits allow, preemption and the queue, and reports how long the
+   main loop calls keep interrupts disabled.
+
+     cc -O2 -Wall -Wextra -I. -I../../VentCommon \
+        -I../../Proc_VentBLE.cydsn/Generated_Source/PSoC4 -o VentMotionTest \
+        VentMotionTest.c VentSimHw.c ../../VentCommon/VentMotion.c \
+        ../../VentCommon/VentDamper.c ../../VentCommon/VentTimer.c -lm
+     ./VentMotionTest
+
+   Exits non-zero on the first failed check. */
+#include "VentSim.h"
+#include "VentMotion.h"
+#include <math.h>
+#include <stdlib.h>
+
+#define CHECK(cond, ...) \
+    do { if (!(cond)) { printf("FAIL: " __VA_ARGS__); printf("\n"); return 1; } } while (0)
+
+/* Longest move the test follows */
+#define TEST_MAX_FRAMES             (2000u)
+
+/* Positions are driven in whole permille, allow one for rounding */
+#define TEST_ROUNDING               (1)
+
+typedef struct
+{
+    uint32 frames;
+    int32  peakStep;
+    int32  peakAccel;
+    uint16 last;
+} TEST_TRACE_T;
+
+static const char *profileName[] = { "trapezoid", "s-curve" };
+
+/***************************************************************
+ * Run frames until the engine is idle, tracing the position
+ **************************************************************/
+static void Test_Follow(TEST_TRACE_T *trace, uint32 maxFrames)
+{
+    int32 pos = VentDamper_GetPosition();
+    int32 step, lastStep = 0;
+
+    trace->frames = 0;
+    trace->peakStep = 0;
+    trace->peakAccel = 0;
+    while (VentMotion_IsBusy() && (trace->frames < maxFrames))
+    {
+        VentSim_RunTicks(VENT_MOTION_FRAME_TICKS);
+        step = (int32)VentDamper_GetPosition() - pos;
+        pos = VentDamper_GetPosition();
+
+        if (abs(step) > trace->peakStep)
+            trace->peakStep = abs(step);
+        if (abs(step - lastStep) > trace->peakAccel)
+            trace->peakAccel = abs(step - lastStep);
+        lastStep = step;
+        trace->frames++;
+    }
+    trace->last = VentDamper_GetPosition();
+}
+
+/***************************************************************
+ * Shortest move under the speed and acceleration limits, frames
+ **************************************************************/
+static double Test_Shortest(double distance, double speed, double accel)
+{
+    if (distance >= ((speed * speed) / accel))
+        return (distance / speed) + (speed / accel);
+    return 2.0 * sqrt(distance / accel);
+}
+
+int main(void)
+{
+    static const uint16 distances[] = { 1u, 10u, 37u, 100u, 250u, 500u, 1000u };
+    TEST_TRACE_T trace;
+    VENT_SIM_LOCK_STATS_T lock;
+    double shortest;
+    uint16 from, to;
+    uint8 p, d, dir;
+    uint32 accel;
+
+    VentTimer_Start();
+    VentDamper_Start();
+    VentMotion_Start();
+    VentDamper_SetPosition(0);
+
+    printf("%-9s %8s %7s %9s %9s %9s\n", "profile", "distance", "frames", "shortest", "peak step", "peak acc");
+    for (p = 0; p < 2u; p++)
+    {
+        for (d = 0; d < (sizeof(distances) / sizeof(distances[0])); d++)
+        {
+            for (dir = 0; dir < 2u; dir++)
+            {
+                from = dir ? distances[d] : 0u;
+                to = dir ? 0u : distances[d];
+
+                VentMotion_MoveTo(from, VENT_MOTION_TRAPEZOID);
+                Test_Follow(&trace, TEST_MAX_FRAMES);
+                VentMotion_MoveTo(to, (VENT_MOTION_PROFILE_T)p);
+                Test_Follow(&trace, TEST_MAX_FRAMES);
+
+                shortest = Test_Shortest(distances[d], VENT_MOTION_MAX_SPEED, VENT_MOTION_MAX_ACCEL);
+                CHECK(trace.last == to, "%s %u->%u ends at %u", profileName[p], from, to, trace.last);
+                CHECK(trace.peakStep <= ((int32)VENT_MOTION_MAX_SPEED + TEST_ROUNDING),
+                      "%s %u->%u steps %d permille", profileName[p], from, to, (int)trace.peakStep);
+                /* The trapezoid snaps to the target once it is within one frame of
+                   braking, the S-curve never accelerates faster than the limit */
+                CHECK((p == VENT_MOTION_TRAPEZOID) || (trace.peakAccel <= ((int32)VENT_MOTION_MAX_ACCEL + 2 * TEST_ROUNDING)),
+                      "%s %u->%u accelerates %d permille/frame", profileName[p], from, to, (int)trace.peakAccel);
+                CHECK(trace.frames <= (uint32)(((p == VENT_MOTION_TRAPEZOID) ? 1.0 : 1.6) * shortest) + 3u,
+                      "%s %u->%u takes %u frames, shortest %.1f", profileName[p], from, to,
+                      (unsigned)trace.frames, shortest);
+                CHECK(VentMotion_GetStats()->frames == trace.frames, "frame count %u, traced %u",
+                      (unsigned)VentMotion_GetStats()->frames, (unsigned)trace.frames);
+                if (dir == 0u)
+                {
+                    printf("%-9s %8u %7u %9.1f %9d %9d\n", profileName[p], distances[d], (unsigned)trace.frames,
+                           shortest, (int)trace.peakStep, (int)trace.peakAccel);
+                }
+            }
+        }
+    }
+
+    /* A later command preempts the move in flight */
+    for (p = 0; p < 2u; p++)
+    {
+        VentMotion_MoveTo(0, VENT_MOTION_TRAPEZOID);
+        Test_Follow(&trace, TEST_MAX_FRAMES);
+        VentMotion_MoveTo(1000, (VENT_MOTION_PROFILE_T)p);
+        Test_Follow(&trace, 30u);
+        CHECK(VentMotion_IsBusy(), "%s move finished early", profileName[p]);
+        VentMotion_MoveTo(200, (VENT_MOTION_PROFILE_T)p);
+        Test_Follow(&trace, TEST_MAX_FRAMES);
+        CHECK((trace.last == 200u) && (trace.peakStep <= ((int32)VENT_MOTION_MAX_SPEED + TEST_ROUNDING)),
+              "%s preempted move ends at %u, peak step %d", profileName[p], trace.last, (int)trace.peakStep);
+    }
+    printf("preemption: both profiles turn around within the limits\n");
+
+    /* Queued moves run in order, a full queue refuses more */
+    VentMotion_MoveTo(0, VENT_MOTION_TRAPEZOID);
+    Test_Follow(&trace, TEST_MAX_FRAMES);
+    CHECK(VentMotion_Queue(300, VENT_MOTION_SCURVE), "first move not taken");
+    for (d = 0; d < VENT_MOTION_QUEUE_LEN; d++)
+    {
+        CHECK(VentMotion_Queue((uint16)(400u + (d * 100u)), (VENT_MOTION_PROFILE_T)(d & 1u)), "move %u not queued", d);
+    }
+    CHECK(!VentMotion_Queue(999, VENT_MOTION_SCURVE), "full queue took a move");
+    Test_Follow(&trace, 10u * TEST_MAX_FRAMES);
+    CHECK(trace.last == (400u + ((VENT_MOTION_QUEUE_LEN - 1u) * 100u)), "queue ends at %u", trace.last);
+    printf("queue: %u moves run in order, the next one is refused\n", (unsigned)(VENT_MOTION_QUEUE_LEN + 1u));
+
+    /* Interrupts off in the main loop calls, with the slowest acceleration
+       the limits take, which gives the longest square root */
+    for (accel = 1u; accel <= ((uint32)VENT_MOTION_MAX_ACCEL << VENT_MOTION_SHIFT); accel <<= 8)
+    {
+        VentMotion_SetLimits((uint32)VENT_MOTION_MAX_SPEED << VENT_MOTION_SHIFT, accel);
+        ventSimLockTiming = 1;
+        ventSimLock.count = 0;
+        ventSimLock.totalNs = 0;
+        ventSimLock.maxNs = 0;
+        for (d = 0; d < 200u; d++)
+        {
+            VentMotion_MoveTo((d & 1u) ? 0u : VENT_DAMPER_POSITION_MAX, VENT_MOTION_SCURVE);
+            VentMotion_Queue((d & 1u) ? VENT_DAMPER_POSITION_MAX : 0u, VENT_MOTION_SCURVE);
+        }
+        lock = ventSimLock;
+        ventSimLockTiming = 0;
+        printf("lock, accel %u/256: %u sections, mean %.0f ns, longest %u ns\n", (unsigned)accel,
+               (unsigned)lock.count, (double)lock.totalNs / lock.count, (unsigned)lock.maxNs);
+    }
+
+    printf("PASS\n");
+    return 0;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,310 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+
+/* Host benchmark: VentNoise fed through the simulated I2S_1 rx FIFO and
+   DMA channel, a frame at a time, with the time VentNoise_Process()
+   takes per frame. Without a file the input is a tone at the centre of
+   each band in turn over a little noise, and the band it sits in has to
+   come out loudest. A 16 bit PCM WAV, mono or stereo, is played instead
+   when given, at the I2S_1 sample rate by picking the nearest sample.
+   Then the capture runs in bursts, and with rx_dma0 wired to no
+   channel, where every capture has to end as a stall.
+
+     cc -O2 -Wall -Wextra -DVENT_NOISE_DMA -I. -I../../VentCommon \
+        -I../../Proc_VentBLE.cydsn/Generated_Source/PSoC4 -o VentNoiseBench \
+        VentNoiseBench.c VentSimHw.c VentSimI2s.c ../../VentCommon/VentNoise.c \
+        ../../VentCommon/VentTimer.c -lm
+     ./VentNoiseBench [file.wav]
+
+   Cycles are host cycles, the times tell how the filter bank scales, not
+   what the M0 takes. Exits non-zero on the first failed check. */
+#include "VentSim.h"
+#include "VentNoise.h"
+#include "VentTimer.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK(cond, ...) \
+    do { if (!(cond)) { printf("FAIL: " __VA_ARGS__); printf("\n"); return 1; } } while (0)
+
+/* One frame of I2S_1 time in LFCLK ticks */
+#define BENCH_FRAME_TICKS           (((uint64)VENT_NOISE_FRAME * VENT_SIM_LFCLK_HZ) / VENT_NOISE_SAMPLE_HZ)
+
+/* Tone frames per band, the first ones let the DC removal settle */
+#define BENCH_TONE_FRAMES           (40u)
+#define BENCH_TONE_SETTLE           (8u)
+#define BENCH_TONE_AMPLITUDE        (8000.0)
+
+/* The band of the tone has to lead the others by this many 1/4 log2
+   steps (6 dB) */
+#define BENCH_TONE_MARGIN           (8u)
+
+#define BENCH_BURST_INTERVAL        (1000u)
+#define BENCH_BURST_SECONDS         (20u)
+
+typedef struct
+{
+    uint32 frames;
+    uint64 ns;
+    uint64 maxNs;
+    uint64 cycles;
+} BENCH_TIME_T;
+
+static const uint16 bandHz[VENT_NOISE_BANDS] =
+{
+    VENT_NOISE_BAND0_HZ, VENT_NOISE_BAND1_HZ, VENT_NOISE_BAND2_HZ, VENT_NOISE_BAND3_HZ
+};
+
+static BENCH_TIME_T timing;
+
+static uint64 Bench_Cycles(void)
+{
+#if defined(__x86_64__)
+    /* x86intrin.h does not go with the CMSIS macros */
+    uint32 lo, hi;
+
+    __asm__ volatile ("rdtsc" : "=a" (lo), "=d" (hi));
+    return ((uint64)hi << 32) | lo;
+#else
+    return 0;
+#endif
+}
+
+/***************************************************************
+ * One pass of the main loop, timed when a frame was analysed
+ **************************************************************/
+static uint8 Bench_Process(void)
+{
+    uint64 ns = VentSim_HostNs();
+    uint64 cycles = Bench_Cycles();
+    uint8 ready = VentNoise_Process();
+
+    cycles = Bench_Cycles() - cycles;
+    ns = VentSim_HostNs() - ns;
+    if (ready)
+    {
+        timing.frames++;
+        timing.ns += ns;
+        timing.cycles += cycles;
+        if (ns > timing.maxNs)
+            timing.maxNs = ns;
+    }
+    return ready;
+}
+
+/***************************************************************
+ * One frame of samples through the rx FIFO, then its I2S time
+ **************************************************************/
+static uint8 Bench_Frame(const int16 *left, const int16 *right)
+{
+    uint16 i;
+
+    for (i = 0; i < VENT_NOISE_FRAME; i++)
+    {
+        VentSim_I2sFeed(left[i], right[i]);
+    }
+    VentSim_RunTicks(BENCH_FRAME_TICKS);
+    return Bench_Process();
+}
+
+static void Bench_Tone(int16 *out, uint32 start, uint16 hz)
+{
+    uint16 i;
+
+    for (i = 0; i < VENT_NOISE_FRAME; i++)
+    {
+        double t = (double)(start + i) / VENT_NOISE_SAMPLE_HZ;
+
+        out[i] = (int16)(BENCH_TONE_AMPLITUDE * sin(2.0 * 3.14159265358979 * hz * t) +
+                         (rand() % 401) - 200 + 300);
+    }
+}
+
+/***************************************************************
+ * Samples of a 16 bit PCM WAV, left and right, resampled to the
+ * I2S_1 rate. Returns the count, 0 if the file does not fit.
+ **************************************************************/
+static uint32 Bench_ReadWav(const char *path, int16 **left, int16 **right)
+{
+    FILE *f = fopen(path, "rb");
+    uint8 *data = NULL, *pcm = NULL;
+    uint8 header[12];
+    uint8 chunk[8];
+    uint32 size, rate = 0, frames = 0, count = 0, i, at;
+    uint16 format = 0, channels = 0, bits = 0;
+
+    if ((f == NULL) || (fread(header, 1, sizeof(header), f) != sizeof(header)) ||
+        (memcmp(header, "RIFF", 4) != 0) || (memcmp(&header[8], "WAVE", 4) != 0))
+        goto done;
+
+    while (fread(chunk, 1, sizeof(chunk), f) == sizeof(chunk))
+    {
+        size = chunk[4] | ((uint32)chunk[5] << 8) | ((uint32)chunk[6] << 16) | ((uint32)chunk[7] << 24);
+        free(data);
+        data = malloc(size + 1u);
+        if ((data == NULL) || (fread(data, 1, size + (size & 1u), f) < size))
+            goto done;
+        if ((memcmp(chunk, "fmt ", 4) == 0) && (size >= 16u))
+        {
+            format = (uint16)(data[0] | (data[1] << 8));
+            channels = (uint16)(data[2] | (data[3] << 8));
+            rate = data[4] | ((uint32)data[5] << 8) | ((uint32)data[6] << 16) | ((uint32)data[7] << 24);
+            bits = (uint16)(data[14] | (data[15] << 8));
+        }
+        else if (memcmp(chunk, "data", 4) == 0)
+        {
+            pcm = data;
+            data = NULL;
+            if ((format == 1u) && (bits == 16u) && (channels >= 1u) && (channels <= 2u) && (rate != 0u))
+                frames = size / (2u * channels);
+            break;
+        }
+    }
+    if (frames == 0u)
+        goto done;
+
+    count = (uint32)(((uint64)frames * VENT_NOISE_SAMPLE_HZ) / rate);
+    *left = malloc(count * sizeof(int16));
+    *right = malloc(count * sizeof(int16));
+    if ((*left == NULL) || (*right == NULL))
+    {
+        count = 0;
+        goto done;
+    }
+    for (i = 0; i < count; i++)
+    {
+        at = (uint32)(((uint64)i * rate) / VENT_NOISE_SAMPLE_HZ) * 2u * channels;
+        (*left)[i] = (int16)(pcm[at] | (pcm[at + 1u] << 8));
+        at += 2u * (channels - 1u);
+        (*right)[i] = (int16)(pcm[at] | (pcm[at + 1u] << 8));
+    }
+
+done:
+    free(data);
+    free(pcm);
+    if (f != NULL)
+        fclose(f);
+    return count;
+}
+
+static void Bench_Report(const char *name)
+{
+    double budgetNs = (double)VENT_NOISE_FRAME * 1e9 / VENT_NOISE_SAMPLE_HZ;
+
+    printf("%s: %u frames, %.0f ns mean %.0f ns max per frame", name, (unsigned)timing.frames,
+           (double)timing.ns / timing.frames, (double)timing.maxNs);
+    if (timing.cycles != 0u)
+        printf(", %.0f host cycles per frame", (double)timing.cycles / timing.frames);
+    printf(", %.4f %% of the %.1f ms frame\n", 100.0 * timing.ns / timing.frames / budgetNs, budgetNs / 1e6);
+}
+
+int main(int argc, char *argv[])
+{
+    int16 left[VENT_NOISE_FRAME], right[VENT_NOISE_FRAME];
+    int16 *wavLeft = NULL, *wavRight = NULL;
+    uint32 samples, at, frames, start;
+    uint8 tone, b, loudest, second;
+
+    VentTimer_Start();
+    VentNoise_Start();
+    printf("%u Hz, %u samples per frame, DMA channel %u\n", (unsigned)VENT_NOISE_SAMPLE_HZ,
+           (unsigned)VENT_NOISE_FRAME, (unsigned)NoiseDma_CHANNEL);
+
+    if (argc > 1)
+    {
+        samples = Bench_ReadWav(argv[1], &wavLeft, &wavRight);
+        CHECK(samples >= VENT_NOISE_FRAME, "%s is no 16 bit PCM WAV of a frame or more", argv[1]);
+        for (at = 0; at + VENT_NOISE_FRAME <= samples; at += VENT_NOISE_FRAME)
+        {
+            if (Bench_Frame(&wavLeft[at], &wavRight[at]))
+            {
+                printf("%8.3f s", (double)at / VENT_NOISE_SAMPLE_HZ);
+                for (b = 0; b < VENT_NOISE_BANDS; b++)
+                {
+                    printf(" %5u Hz %3u", (unsigned)bandHz[b], (unsigned)VentNoise_GetLevel(b));
+                }
+                printf("\n");
+            }
+        }
+        Bench_Report(argv[1]);
+        free(wavLeft);
+        free(wavRight);
+    }
+    else
+    {
+        srand(1);
+        for (tone = 0; tone < VENT_NOISE_BANDS; tone++)
+        {
+            for (frames = 0; frames < BENCH_TONE_FRAMES; frames++)
+            {
+                Bench_Tone(left, frames * VENT_NOISE_FRAME, bandHz[tone]);
+                memcpy(right, left, sizeof(right));
+                CHECK(Bench_Frame(left, right), "no frame at %u Hz", (unsigned)bandHz[tone]);
+                if (frames < BENCH_TONE_SETTLE)
+                    continue;
+
+                loudest = VentNoise_GetLevel(tone);
+                second = 0;
+                for (b = 0; b < VENT_NOISE_BANDS; b++)
+                {
+                    if ((b != tone) && (VentNoise_GetLevel(b) > second))
+                        second = VentNoise_GetLevel(b);
+                }
+                CHECK(loudest >= second + BENCH_TONE_MARGIN, "%u Hz tone: band level %u, next %u",
+                      (unsigned)bandHz[tone], (unsigned)loudest, (unsigned)second);
+            }
+            printf("%5u Hz tone:", (unsigned)bandHz[tone]);
+            for (b = 0; b < VENT_NOISE_BANDS; b++)
+            {
+                printf(" %3u", (unsigned)VentNoise_GetLevel(b));
+            }
+            printf("\n");
+        }
+        Bench_Report("tones");
+    }
+    CHECK(ventSimI2sDropped == 0u, "%u rx bytes no DMA channel took", (unsigned)ventSimI2sDropped);
+    CHECK((VentNoise_GetStats()->overruns == 0u) && (VentNoise_GetStats()->stalls == 0u),
+          "%u overruns, %u stalls", (unsigned)VentNoise_GetStats()->overruns,
+          (unsigned)VentNoise_GetStats()->stalls);
+
+    /* Bursts, I2S_1 off in between */
+    memset(left, 0, sizeof(left));
+    memset(right, 0, sizeof(right));
+    VentNoise_SetInterval(BENCH_BURST_INTERVAL);
+    start = VentNoise_GetStats()->frames;
+    for (frames = 0; frames < (BENCH_BURST_SECONDS * VENT_NOISE_SAMPLE_HZ) / VENT_NOISE_FRAME; frames++)
+    {
+        Bench_Frame(left, right);
+    }
+    frames = VentNoise_GetStats()->frames - start;
+    printf("bursts: %u frames analysed in %u s\n", (unsigned)frames, (unsigned)BENCH_BURST_SECONDS);
+    CHECK((frames >= BENCH_BURST_SECONDS - 1u) && (frames <= BENCH_BURST_SECONDS + 1u),
+          "%u burst frames in %u s", (unsigned)frames, (unsigned)BENCH_BURST_SECONDS);
+
+    /* rx_dma0 left unconnected, the DMA never runs */
+    ventSimI2sRxChannel = CYDMA_INVALID_CHANNEL;
+    start = VentNoise_GetStats()->frames;
+    for (frames = 0; frames < (BENCH_BURST_SECONDS * VENT_NOISE_SAMPLE_HZ) / VENT_NOISE_FRAME; frames++)
+    {
+        Bench_Frame(left, right);
+    }
+    printf("no trigger route: %u frames, %u stalls\n", (unsigned)(VentNoise_GetStats()->frames - start),
+           (unsigned)VentNoise_GetStats()->stalls);
+    CHECK((VentNoise_GetStats()->frames == start) && (VentNoise_GetStats()->stalls >= BENCH_BURST_SECONDS - 1u) &&
+          !VentNoise_IsBusy(), "stalled bursts not given up");
+
+    printf("PASS\n");
+    return 0;
+}
+
+/* [] END OF FILE */
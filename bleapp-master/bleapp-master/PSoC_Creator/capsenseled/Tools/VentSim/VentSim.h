@@ -0,0 +1,127 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#ifndef _VENT_SIM_H_
+#define _VENT_SIM_H_
+
+/* Host build of the VentCommon modules. The modules are compiled unchanged
+   against project.h of this directory, VentSimHw.c answers the component
+   and CyLib calls they make. Time is simulated in LFCLK ticks and only
+   moves in VentSim_Run(), which also runs the WDT counter interrupts that
+   fall due, so a test drives the firmware the way its main loop does. The
+   host tools built on it carry their own build line. */
+#include <project.h>
+#include <stdio.h>
+
+/***************************************************************
+ * Simulated clock and WDT
+ **************************************************************/
+
+#define VENT_SIM_LFCLK_HZ           (32768u)
+
+/* LFCLK ticks since the start */
+extern uint64 ventSimTicks;
+
+/* Advance the clock by ms, running due WDT interrupt callbacks */
+void VentSim_Run(uint32 ms);
+
+/* Same in LFCLK ticks */
+void VentSim_RunTicks(uint64 ticks);
+
+/***************************************************************
+ * Critical sections, timed on the host clock
+ **************************************************************/
+
+typedef struct
+{
+    uint32 count;
+    uint64 totalNs;
+    uint64 maxNs;
+} VENT_SIM_LOCK_STATS_T;
+
+extern VENT_SIM_LOCK_STATS_T ventSimLock;
+
+/* Time critical sections only when set, the host clock is slow to read */
+extern uint8 ventSimLockTiming;
+
+/* Host clock in ns, for timing firmware code */
+uint64 VentSim_HostNs(void);
+
+/***************************************************************
+ * PWM_Servo and the Servo pin
+ **************************************************************/
+
+extern uint32 ventSimServoCompare;
+extern uint8 ventSimServoRunning;
+extern uint8 ventSimServoDriveMode;
+
+/***************************************************************
+ * SAR injection channel. A conversion ends at once: the result
+ * register always holds what the tool last put there and the
+ * end-of-conversion flag reads set.
+ **************************************************************/
+
+/* Counts of the internal reference at a supply of mv */
+void VentSim_SetSupply(uint16 mv);
+
+/***************************************************************
+ * Internal flash
+ **************************************************************/
+
+/* Rows written by CySysFlashWriteRow() */
+extern uint32 ventSimFlashRows;
+
+/***************************************************************
+ * SPI NOR in a file, VentSimNor.c built in place of VentNor.c
+ **************************************************************/
+
+/* SCB_1 bit rate, typical page program and sector erase times of a
+   25-series part */
+#define VENT_SIM_NOR_SPI_HZ         (1000000u)
+#define VENT_SIM_NOR_PROGRAM_US     (700u)
+#define VENT_SIM_NOR_ERASE_US       (45000u)
+
+/* Programs and erases started */
+extern uint32 ventSimNorOps;
+
+/* 1 if the last power cut hit a program, 2 an erase */
+extern uint8 ventSimNorCutDuring;
+
+/* Create path as an erased flash, returns 0 on a file error */
+uint8 VentSim_NorOpen(const char *path);
+
+/* The power fails at a random point of the ops-th program or erase
+   from now. The file keeps what was written up to then. */
+void VentSim_NorCutAfter(uint32 ops);
+
+/* Returns non-zero once the power has failed, the flash then ignores
+   the firmware until VentSim_NorPowerOn() */
+uint8 VentSim_NorPowerLost(void);
+void VentSim_NorPowerOn(void);
+
+/***************************************************************
+ * I2S_1 and the DMA channels, VentSimI2s.c. A rx DMA request
+ * reaches the channel the schematic wires rx_dma0 to,
+ * NoiseDma_CHANNEL unless a test cuts the wire.
+ **************************************************************/
+
+/* Channel the rx DMA requests go to, CYDMA_INVALID_CHANNEL for none */
+extern int32 ventSimI2sRxChannel;
+
+/* Rx FIFO bytes no channel took */
+extern uint32 ventSimI2sDropped;
+
+/* One sample from the microphone while I2S_1 receives */
+void VentSim_I2sFeed(int16 left, int16 right);
+
+#endif /* _VENT_SIM_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,270 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+
+/* Component and CyLib calls of the VentCommon modules, answered on the
+   host, see VentSim.h. Only what the modules use is modelled. */
+#include "VentSim.h"
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+/* WDT counters 0 and 1 interrupt on match, counter 2 only counts */
+#define SIM_WDT_INT_COUNTERS        (2u)
+
+typedef struct
+{
+    uint32 mode;
+    uint32 match;
+    uint8  clearOnMatch;
+    uint8  enabled;
+    uint64 next;
+    cyWdtCallback callback;
+} SIM_WDT_T;
+
+uint64 ventSimTicks;
+VENT_SIM_LOCK_STATS_T ventSimLock;
+uint8 ventSimLockTiming;
+uint32 ventSimServoCompare;
+uint8 ventSimServoRunning;
+uint8 ventSimServoDriveMode;
+uint32 ventSimFlashRows;
+
+static SIM_WDT_T simWdt[SIM_WDT_INT_COUNTERS];
+static uint8 simCounter2Enabled;
+static uint64 simMs;
+
+static uint8 simLockDepth;
+static uint64 simLockStart;
+
+/***************************************************************
+ * Clock
+ **************************************************************/
+
+uint64 VentSim_HostNs(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return ((uint64)t.tv_sec * 1000000000u) + (uint64)t.tv_nsec;
+}
+
+void VentSim_RunTicks(uint64 ticks)
+{
+    uint64 end = ventSimTicks + ticks;
+    SIM_WDT_T *due;
+    uint8 i;
+
+    for (;;)
+    {
+        due = 0;
+        for (i = 0; i < SIM_WDT_INT_COUNTERS; i++)
+        {
+            if (simWdt[i].enabled && (simWdt[i].mode != CY_SYS_WDT_MODE_NONE) &&
+                (simWdt[i].next <= end) && ((due == 0) || (simWdt[i].next < due->next)))
+            {
+                due = &simWdt[i];
+            }
+        }
+        if (due == 0)
+            break;
+
+        ventSimTicks = due->next;
+        due->next += (due->match != 0u) ? due->match : 1u;
+        if (due->callback != 0)
+        {
+            due->callback();
+        }
+    }
+    ventSimTicks = end;
+}
+
+void VentSim_Run(uint32 ms)
+{
+    /* Whole ms map to ticks without drift */
+    uint64 from = (simMs * VENT_SIM_LFCLK_HZ) / 1000u;
+
+    simMs += ms;
+    VentSim_RunTicks(((simMs * VENT_SIM_LFCLK_HZ) / 1000u) - from);
+}
+
+/***************************************************************
+ * CyLib
+ **************************************************************/
+
+uint8 CyEnterCriticalSection(void)
+{
+    if ((simLockDepth++ == 0u) && ventSimLockTiming)
+    {
+        simLockStart = VentSim_HostNs();
+    }
+    return 0;
+}
+
+void CyExitCriticalSection(uint8 savedIntrStatus)
+{
+    uint64 ns;
+
+    (void)savedIntrStatus;
+    if ((--simLockDepth == 0u) && ventSimLockTiming)
+    {
+        ns = VentSim_HostNs() - simLockStart;
+        ventSimLock.count++;
+        ventSimLock.totalNs += ns;
+        if (ns > ventSimLock.maxNs)
+            ventSimLock.maxNs = ns;
+    }
+}
+
+/***************************************************************
+ * WDT
+ **************************************************************/
+
+void CySysWdtLock(void)
+{
+}
+
+void CySysWdtUnlock(void)
+{
+}
+
+void CySysWdtSetMode(uint32 counterNum, uint32 mode)
+{
+    if (counterNum < SIM_WDT_INT_COUNTERS)
+        simWdt[counterNum].mode = mode;
+}
+
+void CySysWdtSetClearOnMatch(uint32 counterNum, uint32 enable)
+{
+    if (counterNum < SIM_WDT_INT_COUNTERS)
+        simWdt[counterNum].clearOnMatch = (uint8)enable;
+}
+
+void CySysWdtSetMatch(uint32 counterNum, uint32 match)
+{
+    if (counterNum < SIM_WDT_INT_COUNTERS)
+        simWdt[counterNum].match = match;
+}
+
+void CySysWdtEnable(uint32 counterMask)
+{
+    uint8 i;
+
+    for (i = 0; i < SIM_WDT_INT_COUNTERS; i++)
+    {
+        if (((counterMask >> (8u * i)) & 1u) && !simWdt[i].enabled)
+        {
+            simWdt[i].enabled = 1;
+            simWdt[i].next = ventSimTicks + simWdt[i].match;
+        }
+    }
+    if (counterMask & CY_SYS_WDT_COUNTER2_MASK)
+        simCounter2Enabled = 1;
+}
+
+void CySysWdtDisable(uint32 counterMask)
+{
+    uint8 i;
+
+    for (i = 0; i < SIM_WDT_INT_COUNTERS; i++)
+    {
+        if ((counterMask >> (8u * i)) & 1u)
+            simWdt[i].enabled = 0;
+    }
+    if (counterMask & CY_SYS_WDT_COUNTER2_MASK)
+        simCounter2Enabled = 0;
+}
+
+uint32 CySysWdtGetCount(uint32 counterNum)
+{
+    if ((counterNum == CY_SYS_WDT_COUNTER2) && simCounter2Enabled)
+        return (uint32)ventSimTicks;
+    return 0;
+}
+
+cyWdtCallback CySysWdtSetInterruptCallback(uint32 counterNum, cyWdtCallback function)
+{
+    cyWdtCallback last = 0;
+
+    if (counterNum < SIM_WDT_INT_COUNTERS)
+    {
+        last = simWdt[counterNum].callback;
+        simWdt[counterNum].callback = function;
+    }
+    return last;
+}
+
+/***************************************************************
+ * SAR injection channel, the 1.024 V reference on a 12 bit scale
+ * of VDDA
+ **************************************************************/
+
+reg32 ventSimSarIntr;
+reg32 ventSimSarInjConfig;
+reg32 ventSimSarInjResult;
+
+void VentSim_SetSupply(uint16 mv)
+{
+    ventSimSarInjResult = (1024u * 4096u) / mv;
+    ventSimSarIntr = ADC_SAR_Seq_1_INJ_EOC_MASK;
+}
+
+/***************************************************************
+ * Internal flash, rows of the program image. The const tables
+ * the modules rewrite live in .rodata, which is made writable
+ * for the copy.
+ **************************************************************/
+
+uint32 CySysFlashWriteRow(uint32 rowNum, const uint8 rowData[])
+{
+    uint8 *row = (uint8 *)(CY_FLASH_BASE + ((uintptr_t)rowNum * CY_FLASH_SIZEOF_ROW));
+    uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t start = (uintptr_t)row & ~(page - 1u);
+
+    if (mprotect((void *)start, ((uintptr_t)row + CY_FLASH_SIZEOF_ROW) - start, PROT_READ | PROT_WRITE) != 0)
+        return CY_SYS_FLASH_INVALID_ADDR;
+
+    memcpy(row, rowData, CY_FLASH_SIZEOF_ROW);
+    ventSimFlashRows++;
+    return CY_SYS_FLASH_SUCCESS;
+}
+
+/***************************************************************
+ * PWM_Servo and the Servo pin
+ **************************************************************/
+
+void PWM_Servo_Init(void)
+{
+    ventSimServoRunning = 0;
+}
+
+void PWM_Servo_Enable(void)
+{
+    ventSimServoRunning = 1;
+}
+
+void PWM_Servo_Stop(void)
+{
+    ventSimServoRunning = 0;
+}
+
+void PWM_Servo_WriteCompare(uint32 compare)
+{
+    ventSimServoCompare = compare;
+}
+
+void Servo_SetDriveMode(uint8 mode)
+{
+    ventSimServoDriveMode = mode;
+}
+
+/* [] END OF FILE */
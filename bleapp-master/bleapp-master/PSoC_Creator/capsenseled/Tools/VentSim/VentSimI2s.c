@@ -0,0 +1,224 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+
+/* I2S_1 and the DMA channels, see VentSim.h. The rx FIFO hands the
+   bytes of a sample to the DMA one request at a time, MSB first, left
+   then right channel. A request reaches the channel rx_dma0 is wired
+   to, ventSimI2sRxChannel. The descriptors run as the
+   DMA runs them: an element per request, then chain, invalidate and
+   interrupt as their actions say. */
+#include "VentSim.h"
+#include <string.h>
+
+/* 16 bit left and right words of one sample */
+#define SIM_I2S_SAMPLE_BYTES        (4u)
+
+typedef struct
+{
+    cydma_init_struct config;
+    void *src;
+    void *dst;
+    int32 index;
+    uint8 valid;
+} SIM_DMA_DESCR_T;
+
+typedef struct
+{
+    SIM_DMA_DESCR_T descr[CYDMA_DESCR_NR];
+    int32 next;
+    uint8 enabled;
+    cydma_callback_t callback;
+} SIM_DMA_CH_T;
+
+reg8 ventSimI2sRxFifo;
+int32 ventSimI2sRxChannel = NoiseDma_CHANNEL;
+uint32 ventSimI2sDropped;
+
+static SIM_DMA_CH_T simDma[CYDMA_CH_NR];
+static uint32 simDmaIntrMask;
+static uint8 simDmaIntrEnabled;
+static uint8 simI2sRunning;
+static uint8 simI2sRx;
+
+/***************************************************************
+ * One transfer request on a channel, returns 0 if it had no
+ * valid descriptor to serve it
+ **************************************************************/
+static uint8 VentSim_DmaRequest(int32 channel)
+{
+    SIM_DMA_CH_T *ch = &simDma[channel];
+    SIM_DMA_DESCR_T *d = &ch->descr[ch->next];
+    uint32 size = (d->config.dataElementSize == CYDMA_BYTE) ? 1u :
+                  ((d->config.dataElementSize == CYDMA_HALFWORD) ? 2u : 4u);
+    uint8 *dst = (uint8 *)d->dst;
+    const uint8 *src = (const uint8 *)d->src;
+
+    if (!ch->enabled || !d->valid)
+        return 0;
+
+    if (d->config.addressIncrement & CYDMA_INC_SRC_ADDR)
+        src += (uint32)d->index * size;
+    if (d->config.addressIncrement & CYDMA_INC_DST_ADDR)
+        dst += (uint32)d->index * size;
+    memcpy(dst, src, size);
+
+    if (++d->index < d->config.numDataElements)
+        return 1;
+
+    /* Descriptor done */
+    d->index = 0;
+    if (d->config.actions & CYDMA_INVALIDATE)
+    {
+        d->valid = 0;
+    }
+    if (d->config.actions & CYDMA_CHAIN)
+    {
+        ch->next ^= 1;
+    }
+    else
+    {
+        ch->enabled = 0;
+    }
+    if ((d->config.actions & CYDMA_GENERATE_IRQ) && simDmaIntrEnabled &&
+        (simDmaIntrMask & (1uL << channel)) && (ch->callback != NULL))
+    {
+        ch->callback();
+    }
+    return 1;
+}
+
+/***************************************************************
+ * Microphone
+ **************************************************************/
+
+void VentSim_I2sFeed(int16 left, int16 right)
+{
+    uint8 bytes[SIM_I2S_SAMPLE_BYTES];
+    uint8 i;
+
+    if (!simI2sRunning || !simI2sRx)
+        return;
+
+    bytes[0] = (uint8)((uint16)left >> 8);
+    bytes[1] = (uint8)left;
+    bytes[2] = (uint8)((uint16)right >> 8);
+    bytes[3] = (uint8)right;
+    for (i = 0; i < SIM_I2S_SAMPLE_BYTES; i++)
+    {
+        ventSimI2sRxFifo = bytes[i];
+        if ((ventSimI2sRxChannel == CYDMA_INVALID_CHANNEL) || !VentSim_DmaRequest(ventSimI2sRxChannel))
+        {
+            ventSimI2sDropped++;
+        }
+    }
+}
+
+/***************************************************************
+ * I2S_1
+ **************************************************************/
+
+void I2S_1_Start(void)
+{
+    simI2sRunning = 1;
+}
+
+void I2S_1_Stop(void)
+{
+    simI2sRunning = 0;
+    simI2sRx = 0;
+}
+
+void I2S_1_EnableRx(void)
+{
+    simI2sRx = 1;
+}
+
+void I2S_1_DisableRx(void)
+{
+    simI2sRx = 0;
+}
+
+void I2S_1_ClearRxFIFO(void)
+{
+}
+
+/***************************************************************
+ * CyDma
+ **************************************************************/
+
+void CyDmaEnable(void)
+{
+}
+
+void CyDmaChEnable(int32 channel)
+{
+    simDma[channel].enabled = 1;
+}
+
+void CyDmaChDisable(int32 channel)
+{
+    simDma[channel].enabled = 0;
+}
+
+void CyDmaSetNextDescriptor(int32 channel, int32 descriptor)
+{
+    simDma[channel].next = descriptor;
+}
+
+void CyDmaSetConfiguration(int32 channel, int32 descriptor, const cydma_init_struct *config)
+{
+    simDma[channel].descr[descriptor].config = *config;
+}
+
+void CyDmaValidateDescriptor(int32 channel, int32 descriptor)
+{
+    simDma[channel].descr[descriptor].valid = 1;
+    simDma[channel].descr[descriptor].index = 0;
+}
+
+void CyDmaSetSrcAddress(int32 channel, int32 descriptor, void *srcAddress)
+{
+    simDma[channel].descr[descriptor].src = srcAddress;
+}
+
+void CyDmaSetDstAddress(int32 channel, int32 descriptor, void *dstAddress)
+{
+    simDma[channel].descr[descriptor].dst = dstAddress;
+}
+
+cydma_callback_t CyDmaSetInterruptCallback(int32 channel, cydma_callback_t callback)
+{
+    cydma_callback_t old = simDma[channel].callback;
+
+    simDma[channel].callback = callback;
+    return old;
+}
+
+void CyDmaSetInterruptSourceMask(uint32 interruptMask)
+{
+    simDmaIntrMask = interruptMask;
+}
+
+uint32 CyDmaGetInterruptSourceMask(void)
+{
+    return simDmaIntrMask;
+}
+
+void CyIntEnable(uint8 number)
+{
+    if (number == CYDMA_INTR_NUMBER)
+    {
+        simDmaIntrEnabled = 1;
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,255 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+
+/* VentNor answered from a file, built in place of VentNor.c, see
+   VentSim.h. Transfers take their time on the SPI clock, a program or
+   erase runs for the typical time of the part while the firmware polls
+   the status register. A power cut freezes the file in the middle of an
+   operation with part of its bits changed. */
+#include "VentSim.h"
+#include "VentNor.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Command and 3 address bytes */
+#define SIM_NOR_HEADER_LEN          (4u)
+
+/* Status register read, command and one byte */
+#define SIM_NOR_STATUS_LEN          (2u)
+
+enum
+{
+    SIM_NOR_IDLE,
+    SIM_NOR_PROGRAM,
+    SIM_NOR_ERASE
+};
+
+uint32 ventSimNorOps;
+uint8 ventSimNorCutDuring;
+
+static int simNorFile = -1;
+static uint64 simNorNs;
+
+/* Program or erase in progress, applied to the file when it ends */
+static uint8 simNorOp;
+static uint32 simNorAddress;
+static uint8 simNorData[VENT_NOR_SECTOR_SIZE];
+static uint16 simNorLen;
+static uint64 simNorStart;
+static uint64 simNorEnd;
+
+/* Power cut */
+static uint32 simNorCutOp;
+static uint64 simNorCutTick;
+static uint8 simNorLost;
+
+/***************************************************************
+ * Let ns of SPI or flash time pass
+ **************************************************************/
+static void VentSim_NorWait(uint64 ns)
+{
+    uint64 from = (simNorNs * VENT_SIM_LFCLK_HZ) / 1000000000u;
+
+    simNorNs += ns;
+    VentSim_RunTicks(((simNorNs * VENT_SIM_LFCLK_HZ) / 1000000000u) - from);
+}
+
+static uint64 VentSim_NorBytesNs(uint32 bytes)
+{
+    return ((uint64)bytes * 8u * 1000000000u) / VENT_SIM_NOR_SPI_HZ;
+}
+
+/***************************************************************
+ * Write the operation to the file. part is the share of the
+ * bits that changed, in 1/65536, 65536 for all of them.
+ **************************************************************/
+static void VentSim_NorApply(uint32 part)
+{
+    uint8 old[VENT_NOR_SECTOR_SIZE];
+    uint8 want, flip, mask;
+    uint16 i;
+    uint8 b;
+
+    if (pread(simNorFile, old, simNorLen, simNorAddress) != (ssize_t)simNorLen)
+        return;
+    for (i = 0; i < simNorLen; i++)
+    {
+        /* Programming only clears bits, erasing only sets them */
+        want = (simNorOp == SIM_NOR_PROGRAM) ? (uint8)(old[i] & simNorData[i]) : 0xFFu;
+        flip = (uint8)(old[i] ^ want);
+        if (part < 65536u)
+        {
+            mask = 0;
+            for (b = 0; b < 8u; b++)
+            {
+                if ((uint32)(rand() & 0xFFFF) < part)
+                    mask |= (uint8)(1u << b);
+            }
+            flip &= mask;
+        }
+        old[i] ^= flip;
+    }
+    if (pwrite(simNorFile, old, simNorLen, simNorAddress) != (ssize_t)simNorLen)
+        return;
+    simNorOp = SIM_NOR_IDLE;
+}
+
+/***************************************************************
+ * End the operation if its time is up, or cut it short if the
+ * power fails first. Returns non-zero once the power is gone.
+ **************************************************************/
+static uint8 VentSim_NorUpdate(void)
+{
+    if (simNorLost)
+        return 1;
+
+    if ((simNorCutTick != 0u) && (ventSimTicks >= simNorCutTick))
+    {
+        /* The cut point decides, however late it is noticed */
+        if ((simNorOp != SIM_NOR_IDLE) && (simNorCutTick < simNorEnd))
+        {
+            VentSim_NorApply((uint32)(((simNorCutTick - simNorStart) * 65536u) / (simNorEnd - simNorStart)));
+        }
+        else if (simNorOp != SIM_NOR_IDLE)
+        {
+            VentSim_NorApply(65536u);
+        }
+        simNorLost = 1;
+        simNorCutTick = 0;
+        return 1;
+    }
+
+    if ((simNorOp != SIM_NOR_IDLE) && (ventSimTicks >= simNorEnd))
+    {
+        VentSim_NorApply(65536u);
+    }
+    return 0;
+}
+
+/***************************************************************
+ * Start a program or erase, arming the power cut on the one
+ * it was asked for
+ **************************************************************/
+static void VentSim_NorBegin(uint8 op, uint32 address, uint16 len, uint32 us)
+{
+    uint64 ticks = ((uint64)us * VENT_SIM_LFCLK_HZ) / 1000000u;
+
+    simNorOp = op;
+    simNorAddress = address;
+    simNorLen = len;
+    simNorStart = ventSimTicks;
+    simNorEnd = ventSimTicks + ((ticks != 0u) ? ticks : 1u);
+
+    ventSimNorOps++;
+    if ((simNorCutOp != 0u) && (--simNorCutOp == 0u))
+    {
+        simNorCutTick = simNorStart + 1u + ((uint64)rand() % (simNorEnd - simNorStart));
+        ventSimNorCutDuring = op;
+    }
+}
+
+/***************************************************************
+ * Backing file and power
+ **************************************************************/
+
+uint8 VentSim_NorOpen(const char *path)
+{
+    static uint8 erased[VENT_NOR_SECTOR_SIZE];
+    uint32 address;
+
+    simNorFile = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (simNorFile < 0)
+        return 0;
+    memset(erased, 0xFF, sizeof(erased));
+    for (address = 0; address < VENT_NOR_SIZE; address += VENT_NOR_SECTOR_SIZE)
+    {
+        if (pwrite(simNorFile, erased, sizeof(erased), address) != (ssize_t)sizeof(erased))
+            return 0;
+    }
+    return 1;
+}
+
+void VentSim_NorCutAfter(uint32 ops)
+{
+    simNorCutOp = ops;
+    ventSimNorCutDuring = SIM_NOR_IDLE;
+}
+
+uint8 VentSim_NorPowerLost(void)
+{
+    return VentSim_NorUpdate();
+}
+
+void VentSim_NorPowerOn(void)
+{
+    simNorOp = SIM_NOR_IDLE;
+    simNorLost = 0;
+    simNorCutOp = 0;
+    simNorCutTick = 0;
+}
+
+/***************************************************************
+ * VentNor
+ **************************************************************/
+
+void VentNor_Start(void)
+{
+}
+
+uint8 VentNor_IsBusy(void)
+{
+    if (VentSim_NorUpdate())
+        return 0;
+    VentSim_NorWait(VentSim_NorBytesNs(SIM_NOR_STATUS_LEN));
+    return (uint8)(VentSim_NorUpdate() ? 0u : (simNorOp != SIM_NOR_IDLE));
+}
+
+uint8 VentNor_IsTransferring(void)
+{
+    /* Transfers end before the call that started them returns */
+    return 0;
+}
+
+void VentNor_Read(uint32 address, uint8 *buffer, uint16 len)
+{
+    while (VentNor_IsBusy())
+    {
+    }
+    if (VentSim_NorUpdate() || (pread(simNorFile, buffer, len, address) != (ssize_t)len))
+    {
+        memset(buffer, 0xFF, len);
+        return;
+    }
+    VentSim_NorWait(VentSim_NorBytesNs(SIM_NOR_HEADER_LEN + (uint32)len));
+}
+
+void VentNor_ProgramPage(uint32 address, const uint8 *data, uint16 len)
+{
+    if (VentSim_NorUpdate())
+        return;
+    VentSim_NorWait(VentSim_NorBytesNs(1u + SIM_NOR_HEADER_LEN + (uint32)len));
+    memcpy(simNorData, data, len);
+    VentSim_NorBegin(SIM_NOR_PROGRAM, address, len, VENT_SIM_NOR_PROGRAM_US);
+}
+
+void VentNor_EraseSector(uint32 address)
+{
+    if (VentSim_NorUpdate())
+        return;
+    VentSim_NorWait(VentSim_NorBytesNs(1u + SIM_NOR_HEADER_LEN));
+    VentSim_NorBegin(SIM_NOR_ERASE, address & ~(uint32)(VENT_NOR_SECTOR_SIZE - 1u), VENT_NOR_SECTOR_SIZE,
+                     VENT_SIM_NOR_ERASE_US);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,312 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+
+/* Host test: VentStore on a file backed SPI NOR. Measures the append
+   throughput the flash sustains, then cuts the power at random points
+   of programs and erases, restarts the store and checks what it
+   recovered: no record changed or missing in the middle, nothing lost
+   that a flush had written, at most the page buffers lost at the end.
+   Runs with a young log and with a full ring, reports the recovery
+   times.
+
+     cc -O2 -Wall -Wextra -I. -I../../VentCommon \
+        -I../../Proc_VentBLE.cydsn/Generated_Source/PSoC4 -o VentStoreTest \
+        VentStoreTest.c VentSimHw.c VentSimNor.c ../../VentCommon/VentStore.c \
+        ../../VentCommon/VentTimer.c
+     ./VentStoreTest [flash file]
+
+   Exits non-zero on the first failed check. */
+#include "VentSim.h"
+#include "VentStore.h"
+#include "VentTimer.h"
+#include "VentDamper.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK(cond, ...) \
+    do { if (!(cond)) { printf("FAIL: " __VA_ARGS__); printf("\n"); return 1; } } while (0)
+
+#define TEST_RECORDS_PER_PAGE       (VENT_NOR_PAGE_SIZE / VENT_STORE_RECORD_SIZE)
+
+/* Records not programmed yet when the power fails: the page being
+   filled and the one waiting for or in the program */
+#define TEST_MAX_LOST               (2u * TEST_RECORDS_PER_PAGE)
+
+/* Times of the last appends, to count what a power cut lost */
+#define TEST_RECENT                 (4096u)
+
+/* The head of the log is checked from this many records back */
+#define TEST_HEAD_CHECK             (1500u)
+
+#define TEST_YOUNG_CUTS             (300u)
+#define TEST_FULL_CUTS              (60u)
+
+static uint32 firstTime;
+static uint32 nextTime;
+static uint32 durableTime;
+
+static uint32 recent[TEST_RECENT];
+static uint32 recentCount;
+
+typedef struct
+{
+    uint32 cuts;
+    uint32 cutsInErase;
+    uint32 torn;
+    uint32 discarded;
+    uint32 lostMax;
+    uint32 lostTotal;
+    uint32 recoveryMax;
+    uint32 recoveryTotal;
+} TEST_CUT_STATS_T;
+
+/***************************************************************
+ * Records follow from their time, the gaps from a hash of it.
+ * Every few hundred records a gap closes the sector early.
+ **************************************************************/
+static uint32 Test_Hash(uint32 v)
+{
+    v ^= v >> 16;
+    v *= 0x45D9F3Bu;
+    v ^= v >> 16;
+    return v;
+}
+
+static void Test_Record(uint32 time, VENT_LOG_RECORD_T *r)
+{
+    uint32 h = Test_Hash(time);
+
+    r->time = time;
+    r->temperature = (int16)(1500 + (int32)(h % 1500u));
+    r->position = (uint16)((h >> 11) % (VENT_DAMPER_POSITION_MAX + 1u));
+    r->pressure = (int16)((int32)((h >> 21) % 401u) - 200);
+}
+
+static uint32 Test_NextTime(uint32 time)
+{
+    return time + (((Test_Hash(time) % 700u) == 0u) ? 70000u : 1u);
+}
+
+/***************************************************************
+ * One pass of the main loop: a record, the store, 1 ms
+ **************************************************************/
+static void Test_Step(uint32 ms)
+{
+    VENT_LOG_RECORD_T r;
+
+    Test_Record(nextTime, &r);
+    VentStore_Append(&r);
+    recent[recentCount++ % TEST_RECENT] = nextTime;
+    nextTime = Test_NextTime(nextTime);
+    VentStore_Process();
+    if (ms != 0u)
+    {
+        VentSim_Run(ms);
+    }
+}
+
+/***************************************************************
+ * Walk the log from time on, records must be the ones appended
+ * and follow each other. Returns the count and the last time.
+ **************************************************************/
+static int Test_Walk(uint32 time, uint32 max, uint32 *count, uint32 *last)
+{
+    VENT_LOG_RECORD_T r, want;
+    uint32 cursor;
+
+    *count = 0;
+    if (!VentStore_Find(time, &cursor))
+        return 0;
+    while ((*count < max) && VentStore_Next(&cursor, &r))
+    {
+        Test_Record(r.time, &want);
+        CHECK((r.temperature == want.temperature) && (r.position == want.position) &&
+              (r.pressure == want.pressure), "record at %u changed", (unsigned)r.time);
+        CHECK((*count != 0u) || (r.time >= time), "search for %u found %u", (unsigned)time, (unsigned)r.time);
+        CHECK((*count == 0u) || (r.time == Test_NextTime(*last)), "%u follows %u",
+              (unsigned)r.time, (unsigned)*last);
+        *last = r.time;
+        (*count)++;
+    }
+    return 0;
+}
+
+/***************************************************************
+ * Restart after a power cut and check both ends of the log
+ **************************************************************/
+static int Test_Recover(TEST_CUT_STATS_T *cut, uint8 young)
+{
+    uint32 from, count, last = 0, lost, t;
+
+    VentSim_NorPowerOn();
+    VentStore_Start();
+
+    cut->cuts++;
+    cut->cutsInErase += (ventSimNorCutDuring == 2u);
+    cut->torn += (VentStore_GetStats()->discarded != 0u);
+    cut->discarded += VentStore_GetStats()->discarded;
+    cut->recoveryTotal += VentStore_GetStats()->recoveryTime;
+    if (VentStore_GetStats()->recoveryTime > cut->recoveryMax)
+        cut->recoveryMax = VentStore_GetStats()->recoveryTime;
+
+    /* Oldest records */
+    if (Test_Walk(0, 600u, &count, &last))
+        return 1;
+    CHECK(count != 0u, "log empty after the cut");
+    if (young)
+    {
+        VENT_LOG_RECORD_T r;
+        uint32 cursor;
+
+        VentStore_Find(0, &cursor);
+        VentStore_Next(&cursor, &r);
+        CHECK(r.time == firstTime, "oldest record %u, expected %u", (unsigned)r.time, (unsigned)firstTime);
+    }
+
+    /* Newest records up to the end */
+    from = recent[(recentCount - TEST_HEAD_CHECK) % TEST_RECENT];
+    if (Test_Walk(from, TEST_HEAD_CHECK + 1u, &count, &last))
+        return 1;
+    CHECK((count != 0u) && (VentStore_LastTime() == last), "log ends at %u, last time %u",
+          (unsigned)last, (unsigned)VentStore_LastTime());
+    CHECK(last >= durableTime, "flushed record %u lost, log ends at %u", (unsigned)durableTime, (unsigned)last);
+
+    /* Count the appends after the last record kept */
+    for (lost = 0; (lost < TEST_HEAD_CHECK) && (recent[(recentCount - 1u - lost) % TEST_RECENT] != last); lost++)
+    {
+    }
+    CHECK(lost <= TEST_MAX_LOST, "%u records lost", (unsigned)lost);
+    cut->lostTotal += lost;
+    if (lost > cut->lostMax)
+        cut->lostMax = lost;
+
+    /* A search lands on the record asked for */
+    t = recent[(recentCount - 1u - lost - ((uint32)rand() % (TEST_HEAD_CHECK - lost))) % TEST_RECENT];
+    if (Test_Walk(t, 1u, &count, &last))
+        return 1;
+    CHECK((count == 1u) && (last == t), "search for %u found %u", (unsigned)t, (unsigned)last);
+
+    /* The firmware continues after the last record it found */
+    recentCount -= lost;
+    nextTime = Test_NextTime(recent[(recentCount - 1u) % TEST_RECENT]);
+    return 0;
+}
+
+/***************************************************************
+ * Run the main loop into a power cut after up to maxOps flash
+ * operations, flushing now and then, and recover
+ **************************************************************/
+static int Test_Cut(TEST_CUT_STATS_T *cut, uint32 maxOps, uint8 young)
+{
+    VentSim_NorCutAfter(1u + ((uint32)rand() % maxOps));
+    while (!VentSim_NorPowerLost())
+    {
+        Test_Step(1u);
+        if ((rand() % 3000) == 0)
+        {
+            VentStore_Flush();
+            if (!VentSim_NorPowerLost())
+            {
+                durableTime = recent[(recentCount - 1u) % TEST_RECENT];
+            }
+        }
+    }
+    return Test_Recover(cut, young);
+}
+
+static void Test_Report(const char *name, const TEST_CUT_STATS_T *cut)
+{
+    printf("%s: %u cuts (%u in an erase), %u torn pages cleared (%u slots), lost mean %.1f max %u records, "
+           "recovery mean %u ms max %u ms\n", name, (unsigned)cut->cuts, (unsigned)cut->cutsInErase,
+           (unsigned)cut->torn, (unsigned)cut->discarded, (double)cut->lostTotal / cut->cuts,
+           (unsigned)cut->lostMax, (unsigned)(cut->recoveryTotal / cut->cuts), (unsigned)cut->recoveryMax);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *path = (argc > 1) ? argv[1] : "VentStoreTest.nor";
+    TEST_CUT_STATS_T young, full;
+    VENT_LOG_RECORD_T oldest;
+    uint32 i, count, last = 0, cursor;
+    uint64 ticks, ns;
+
+    CHECK(VentSim_NorOpen(path), "cannot create %s", path);
+    VentTimer_Start();
+    VentStore_Start();
+    srand(1);
+    firstTime = nextTime = 1000u;
+
+    /* Append flat out, only the flash sets the pace */
+    ticks = ventSimTicks;
+    ns = VentSim_HostNs();
+    for (i = 0; i < 100000u; i++)
+    {
+        Test_Step(0u);
+    }
+    VentStore_Flush();
+    ns = VentSim_HostNs() - ns;
+    ticks = ventSimTicks - ticks;
+    durableTime = recent[(recentCount - 1u) % TEST_RECENT];
+    printf("append: %.0f records/s on the flash, %u pages, %u erases, %u stalls, %.0f ns host time per record\n",
+           100000.0 * VENT_SIM_LFCLK_HZ / (double)ticks, (unsigned)VentStore_GetStats()->pagesWritten,
+           (unsigned)VentStore_GetStats()->sectorsErased, (unsigned)VentStore_GetStats()->stalls,
+           (double)ns / 100000.0);
+    if (Test_Walk(0, 0xFFFFFFFFu, &count, &last))
+        return 1;
+    CHECK(count == recentCount, "%u of %u records read back", (unsigned)count, (unsigned)recentCount);
+
+    /* Power cuts while the log grows */
+    memset(&young, 0, sizeof(young));
+    for (i = 0; i < TEST_YOUNG_CUTS; i++)
+    {
+        if (Test_Cut(&young, 200u, 1u))
+            return 1;
+    }
+    Test_Report("young log", &young);
+    if (Test_Walk(0, 0xFFFFFFFFu, &count, &last))
+        return 1;
+    printf("young log: %u records read back in order\n", (unsigned)count);
+
+    /* Fill the ring until the oldest sector goes */
+    do
+    {
+        for (i = 0; i < VENT_STORE_RECORDS_PER_SECTOR; i++)
+        {
+            Test_Step(0u);
+        }
+        VentStore_Find(0, &cursor);
+        VentStore_Next(&cursor, &oldest);
+    } while (oldest.time == firstTime);
+    for (i = 0; i < (4u * VENT_STORE_RECORDS_PER_SECTOR); i++)
+    {
+        Test_Step(0u);
+    }
+
+    /* Power cuts with a full ring, the tail erase is the one cut */
+    memset(&full, 0, sizeof(full));
+    for (i = 0; i < TEST_FULL_CUTS; i++)
+    {
+        if (Test_Cut(&full, 40u, 0u))
+            return 1;
+    }
+    Test_Report("full ring", &full);
+    if (Test_Walk(0, 0xFFFFFFFFu, &count, &last))
+        return 1;
+    printf("full ring: %u records in %u sectors read back in order\n", (unsigned)count,
+           (unsigned)VENT_NOR_LOG_SECTORS);
+
+    remove(path);
+    printf("PASS\n");
+    return 0;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,70 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+
+/* Stands in for the generated project.h when VentCommon modules are built
+   on the host, see VentSim.h. Proc_VentBLE.cydsn has the most components
+   of the vent projects and declares every API the modules call. */
+#include <stdint.h>
+
+/* cytypes.h makes uint32 and int32 a long, 64 bit on Linux. Its typedefs are
+   moved aside so the 32 bit ones below are seen everywhere else */
+#define uint32 cytypes_uint32
+#define int32 cytypes_int32
+#include "../../Proc_VentBLE.cydsn/Generated_Source/PSoC4/cytypes.h"
+#undef uint32
+#undef int32
+typedef uint32_t uint32;
+typedef int32_t int32;
+
+#include "../../Proc_VentBLE.cydsn/Generated_Source/PSoC4/project.h"
+
+/* Flash starts at the program image, so the row numbers the modules work out
+   for their const tables fit a uint32 as on the device. A tool that needs a
+   particular image at the flash base, such as the running firmware for
+   VentUpdate, builds with -DVENT_SIM_IMAGE and fills ventSimImage. */
+#ifdef VENT_SIM_IMAGE
+extern uint8 ventSimImage[];
+#define VENT_SIM_FLASH_BASE         ((uintptr_t)ventSimImage)
+#else
+extern const uint8 __executable_start[];
+#define VENT_SIM_FLASH_BASE         ((uintptr_t)__executable_start)
+#endif
+
+#undef CY_FLASH_BASE
+#define CY_FLASH_BASE               VENT_SIM_FLASH_BASE
+
+/* SAR registers behind the injection channel VentBattery converts on,
+   host variables VentSimHw.c keeps, see VentSim.h */
+extern reg32 ventSimSarIntr;
+extern reg32 ventSimSarInjConfig;
+extern reg32 ventSimSarInjResult;
+
+#undef CYREG_SAR_INTR
+#define CYREG_SAR_INTR              ((uintptr_t)&ventSimSarIntr)
+#undef CYREG_SAR_INJ_CHAN_CONFIG
+#define CYREG_SAR_INJ_CHAN_CONFIG   ((uintptr_t)&ventSimSarInjConfig)
+#undef CYREG_SAR_INJ_RESULT
+#define CYREG_SAR_INJ_RESULT        ((uintptr_t)&ventSimSarInjResult)
+
+/* I2S_1 rx FIFO, VentSimI2s.c */
+extern reg8 ventSimI2sRxFifo;
+
+#undef I2S_1_bI2S_Rx_CH_0__dpRx_u0__F0_REG
+#define I2S_1_bI2S_Rx_CH_0__dpRx_u0__F0_REG ((uintptr_t)&ventSimI2sRxFifo)
+
+/* The channel cyfitter.h gives the NoiseDma component once it is in
+   TopDesign, VentNoise builds with -DVENT_NOISE_DMA on the host */
+#ifndef NoiseDma_CHANNEL
+#define NoiseDma_CHANNEL            (0u)
+#endif
+
+/* [] END OF FILE */
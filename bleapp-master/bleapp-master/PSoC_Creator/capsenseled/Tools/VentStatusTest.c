@@ -0,0 +1,191 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+
+/* Host test: the status record codec of VentCommon/VentStatusCodec.h.
+   Packs records against a bit writer built from the layout table of the
+   header, round trips random states, checks the clamping and "not
+   fitted" values, that later versions with appended fields decode and
+   that the status UUID of every vent model is recognised.
+
+     cc -O2 -Wall -Wextra -I../VentCommon -o VentStatusTest VentStatusTest.c \
+        ../VentCommon/VentStatusCodec.c
+     ./VentStatusTest
+
+   Exits non-zero on the first failed check. */
+#include "VentStatusCodec.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK(cond, ...) \
+    do { if (!(cond)) { printf("FAIL: " __VA_ARGS__); printf("\n"); return 1; } } while (0)
+
+#define TEST_ROUND_TRIPS            (100000u)
+
+/* Layout v1 as the header documents it */
+static const uint8_t fieldWidth[] = { 4u, 8u, 12u, 10u, 12u, 7u, 8u };
+
+/* A status of v1 pinned in bytes, the layout must never move */
+static const VENT_STATUS_T pinnedStatus = { 1u, 0xA5u, 345, 512u, -17, 86u, 0x52u };
+static const uint8_t pinnedRecord[VENT_STATUS_V1_LEN] = { 0x51u, 0x9Au, 0x15u, 0x00u, 0xBEu, 0xBFu, 0x55u, 0x0Au };
+
+/***************************************************************
+ * Reference packer, one field after the other LSB first
+ **************************************************************/
+static void Test_Pack(const uint32_t *values, uint8_t count, uint8_t *record)
+{
+    uint16_t bit = 0;
+    uint8_t f, i;
+
+    for (f = 0; f < count; f++)
+    {
+        for (i = 0; i < fieldWidth[f]; i++, bit++)
+        {
+            if (values[f] & (1uL << i))
+                record[bit >> 3] |= (uint8_t)(1u << (bit & 7u));
+        }
+    }
+}
+
+static void Test_Values(const VENT_STATUS_T *s, uint32_t *values)
+{
+    values[0] = s->version;
+    values[1] = s->sequence;
+    values[2] = (uint32_t)s->temperature & 0xFFFu;
+    values[3] = s->position;
+    values[4] = (uint32_t)s->pressure & 0xFFFu;
+    values[5] = s->battery;
+    values[6] = s->faults;
+}
+
+static int Test_Same(const VENT_STATUS_T *a, const VENT_STATUS_T *b)
+{
+    return (a->version == b->version) && (a->sequence == b->sequence) && (a->temperature == b->temperature) &&
+           (a->position == b->position) && (a->pressure == b->pressure) && (a->battery == b->battery) &&
+           (a->faults == b->faults);
+}
+
+/***************************************************************
+ * Random state with every field in range
+ **************************************************************/
+static void Test_Random(VENT_STATUS_T *s)
+{
+    s->version = VENT_STATUS_VERSION;
+    s->sequence = (uint8_t)rand();
+    s->temperature = (int16_t)((rand() % 4095) - 2047);
+    s->position = (uint16_t)(rand() % 1024);
+    s->pressure = (int16_t)((rand() % 4095) - 2047);
+    s->battery = (uint8_t)(rand() % 128);
+    s->faults = (uint8_t)rand();
+}
+
+int main(void)
+{
+    static const uint8_t statusUuid[VENT_STATUS_UUID_LEN] = VENT_STATUS_UUID;
+    uint8_t record[VENT_STATUS_MAX_LEN], want[VENT_STATUS_MAX_LEN], uuid[VENT_STATUS_UUID_LEN];
+    uint32_t values[sizeof(fieldWidth) + 1u];
+    VENT_STATUS_T in, out;
+    uint32_t i, bits = 0;
+    uint8_t len;
+
+    for (i = 0; i < sizeof(fieldWidth); i++)
+    {
+        bits += fieldWidth[i];
+    }
+    CHECK(bits == VENT_STATUS_V1_BITS, "layout has %u bits, header says %u", (unsigned)bits,
+          (unsigned)VENT_STATUS_V1_BITS);
+    CHECK(VENT_STATUS_V1_LEN <= VENT_STATUS_MAX_LEN, "v1 record longer than %u bytes", (unsigned)VENT_STATUS_MAX_LEN);
+
+    /* Pinned record */
+    memset(record, 0xEE, sizeof(record));
+    len = VentStatus_Encode(&pinnedStatus, record);
+    CHECK((len == VENT_STATUS_V1_LEN) && (memcmp(record, pinnedRecord, len) == 0),
+          "pinned record %02X %02X %02X %02X %02X %02X %02X %02X", record[0], record[1], record[2], record[3],
+          record[4], record[5], record[6], record[7]);
+
+    /* Random states against the reference packer and back */
+    srand(1);
+    for (i = 0; i < TEST_ROUND_TRIPS; i++)
+    {
+        Test_Random(&in);
+        memset(record, 0xEE, sizeof(record));
+        memset(want, 0, sizeof(want));
+        len = VentStatus_Encode(&in, record);
+        Test_Values(&in, values);
+        Test_Pack(values, sizeof(fieldWidth), want);
+        CHECK((len == VENT_STATUS_V1_LEN) && (memcmp(record, want, len) == 0), "state %u packs wrong", (unsigned)i);
+        CHECK(VentStatus_Decode(record, len, &out) && Test_Same(&in, &out), "state %u does not round trip",
+              (unsigned)i);
+    }
+    printf("%u random states round trip\n", (unsigned)TEST_ROUND_TRIPS);
+
+    /* Out of range values clamp, the "not fitted" values stay reserved */
+    VentStatus_Clear(&in);
+    VentStatus_Decode(record, VentStatus_Encode(&in, record), &out);
+    CHECK(Test_Same(&in, &out) && (out.temperature == VENT_STATUS_NO_TEMPERATURE) &&
+          (out.position == VENT_STATUS_NO_POSITION) && (out.pressure == VENT_STATUS_NO_PRESSURE) &&
+          (out.battery == VENT_STATUS_NO_BATTERY), "cleared status does not round trip");
+    in.temperature = 5000;
+    in.position = 4000u;
+    in.pressure = -5000;
+    in.battery = 200u;
+    VentStatus_Decode(record, VentStatus_Encode(&in, record), &out);
+    CHECK((out.temperature == 2047) && (out.position == VENT_STATUS_NO_POSITION) && (out.pressure == -2047) &&
+          (out.battery == VENT_STATUS_NO_BATTERY), "clamped to %d %u %d %u", out.temperature,
+          (unsigned)out.position, out.pressure, (unsigned)out.battery);
+    in.temperature = -2048;
+    in.pressure = 2048;
+    VentStatus_Decode(record, VentStatus_Encode(&in, record), &out);
+    CHECK((out.temperature == VENT_STATUS_NO_TEMPERATURE) && (out.pressure == 2047),
+          "edge values %d %d", out.temperature, out.pressure);
+
+    /* A later version with a field appended decodes the v1 fields */
+    Test_Random(&in);
+    Test_Values(&in, values);
+    values[0] = 2u;
+    values[sizeof(fieldWidth)] = 0x5Au;
+    memset(want, 0, sizeof(want));
+    Test_Pack(values, sizeof(fieldWidth), want);
+    want[VENT_STATUS_V1_LEN] = 0x5Au;
+    in.version = 2u;
+    CHECK(VentStatus_Decode(want, VENT_STATUS_V1_LEN + 1u, &out) && Test_Same(&in, &out),
+          "version 2 record not decoded");
+    want[0] |= 0x0Fu;
+    CHECK(VentStatus_Decode(want, VENT_STATUS_MAX_LEN, &out) && (out.version == 15u), "version 15 record not decoded");
+
+    /* No version, or too short */
+    want[0] &= 0xF0u;
+    CHECK(!VentStatus_Decode(want, VENT_STATUS_V1_LEN, &out), "version 0 record decoded");
+    VentStatus_Encode(&pinnedStatus, record);
+    CHECK(!VentStatus_Decode(record, VENT_STATUS_V1_LEN - 1u, &out), "short record decoded");
+    printf("versions 1, 2 and 15 decode, version 0 and short records do not\n");
+
+    /* Status UUID with any model alias, nothing else */
+    memcpy(uuid, statusUuid, sizeof(uuid));
+    CHECK(VentStatus_IsUuid(uuid), "status UUID not recognised");
+    uuid[VENT_STATUS_UUID_ALIAS] = 0x12u;
+    uuid[VENT_STATUS_UUID_ALIAS + 1u] = 0xBAu;
+    CHECK(VentStatus_IsUuid(uuid), "status UUID with alias BA12 not recognised");
+    for (i = 0; i < VENT_STATUS_UUID_LEN; i++)
+    {
+        if ((i == VENT_STATUS_UUID_ALIAS) || (i == VENT_STATUS_UUID_ALIAS + 1u))
+            continue;
+        uuid[i] ^= 0x01u;
+        CHECK(!VentStatus_IsUuid(uuid), "UUID with byte %u changed taken as status", (unsigned)i);
+        uuid[i] ^= 0x01u;
+    }
+
+    printf("PASS\n");
+    return 0;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,274 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+
+/* Host harness: a VentDiff patch applied by VentUpdate.c as on the vent.
+   The old image is the simulated internal flash, the staging area a file
+   backed NOR (Tools/VentSim). The hub writes one chunk per connection
+   event and repeats the busy ones, the main loop turns every ms.
+
+     cc -O2 -o VentDiff VentDiff.c
+     ./VentDiff -x 0x15300 ../VentBLE.cydsn/CortexM0/ARM_GCC_493/Debug/VentBLE.hex \
+        ../Proc_VentBLE.cydsn/CortexM0/ARM_GCC_493/Debug/Proc_VentBLE.hex patch.bin
+     cc -O2 -Wall -Wextra -DVENT_SIM_IMAGE -IVentSim -I../VentCommon \
+        -I../Proc_VentBLE.cydsn/Generated_Source/PSoC4 -o VentUpdateTest \
+        VentUpdateTest.c VentSim/VentSimHw.c VentSim/VentSimNor.c \
+        ../VentCommon/VentUpdate.c ../VentCommon/VentTimer.c
+     ./VentUpdateTest old.hex new.hex patch.bin [flash file]
+
+   Runs the patch on a vent whose rows past the old image were rewritten,
+   checks the staged image byte for byte, then refuses a patch for another
+   build and a corrupted one, whose remaining chunks must not start a new
+   patch. Reports the time to stage and the longest VentUpdate_Process()
+   call. Exits non-zero on the first failed check. */
+#include "VentSim.h"
+#include "VentUpdate.h"
+#include "VentTimer.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK(cond, ...) \
+    do { if (!(cond)) { printf("FAIL: " __VA_ARGS__); printf("\n"); return 1; } } while (0)
+
+/* One write per connection event at the interval the vent asks for */
+#define TEST_WRITE_US               ((uint32)CYBLE_GAPP_CONNECTION_INTERVAL_MIN * 1250u)
+
+/* Give up on a run that stops making progress (ms) */
+#define TEST_TIMEOUT_MS             (600000u)
+
+typedef struct
+{
+    uint32 chunks;
+    uint32 busy;
+    uint32 refused;
+    uint32 acceptedAfterFail;
+    uint32 ms;
+    uint32 checkCalls;
+    uint64 maxCallNs;
+    uint64 totalCallNs;
+    uint32 calls;
+    uint32 norOps;
+} TEST_RUN_T;
+
+uint8 ventSimImage[CY_FLASH_SIZE];
+
+static uint8 newImage[CY_FLASH_SIZE];
+static uint8 staged[CY_FLASH_SIZE];
+
+/***************************************************************
+ * Flash part of an Intel HEX file, returns its size
+ **************************************************************/
+static uint32 Test_ReadHex(const char *path, uint8 *image)
+{
+    char line[600];
+    unsigned count, addr, type, i, v;
+    uint32 base = 0, size = 0, a;
+    FILE *f = fopen(path, "r");
+
+    if (f == NULL)
+        return 0;
+    memset(image, 0, CY_FLASH_SIZE);
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        if ((line[0] != ':') || (sscanf(line, ":%2x%4x%2x", &count, &addr, &type) != 3))
+            continue;
+        if (type == 0x04u)
+        {
+            sscanf(&line[9], "%4x", &v);
+            base = (uint32)v << 16;
+        }
+        else if ((type == 0x00u) && ((base + addr) < CY_FLASH_SIZE))
+        {
+            for (i = 0; i < count; i++)
+            {
+                a = base + addr + i;
+                if (a >= CY_FLASH_SIZE)
+                    break;
+                sscanf(&line[9 + 2u * i], "%2x", &v);
+                image[a] = (uint8)v;
+                if (a + 1u > size)
+                    size = a + 1u;
+            }
+        }
+        else if (type == 0x01u)
+        {
+            break;
+        }
+    }
+    fclose(f);
+    return size;
+}
+
+static uint32 Test_Get32(const uint8 *p)
+{
+    return (uint32)p[0] | ((uint32)p[1] << 8) | ((uint32)p[2] << 16) | ((uint32)p[3] << 24);
+}
+
+/***************************************************************
+ * Main loop pass: VentUpdate_Process() timed on the host clock
+ **************************************************************/
+static void Test_Process(TEST_RUN_T *run)
+{
+    uint8 checking = (VentUpdate_GetState() == VENT_UPDATE_RECEIVING) && (VentUpdate_GetStats()->copyBytes == 0u) &&
+                     (VentUpdate_GetStats()->insertBytes == 0u) && (VentUpdate_GetStats()->fillBytes == 0u);
+    uint32 ops = ventSimNorOps;
+    uint64 ns = VentSim_HostNs();
+
+    VentUpdate_Process();
+    ns = VentSim_HostNs() - ns;
+    run->calls++;
+    run->totalCallNs += ns;
+    if (ns > run->maxCallNs)
+        run->maxCallNs = ns;
+
+    /* Passes until the first operation, the header erase does not count */
+    run->checkCalls += checking && (ventSimNorOps == ops);
+}
+
+/***************************************************************
+ * Write the patch as the hub does, until it is staged, failed
+ * and its chunks are used up, or the time runs out
+ **************************************************************/
+static void Test_Run(const uint8 *patch, uint32 length, TEST_RUN_T *run)
+{
+    uint64 nextWrite = ventSimTicks;
+    uint32 pos = 0, start = VentTimer_GetTimeStamp();
+    uint32 ops = ventSimNorOps;
+    uint16 n;
+    uint8 result, failed;
+
+    memset(run, 0, sizeof(*run));
+    while ((VentTimer_GetTimeStamp() - start) < TEST_TIMEOUT_MS)
+    {
+        if ((pos < length) && (ventSimTicks >= nextWrite))
+        {
+            n = (uint16)(((length - pos) < VENT_UPDATE_CHUNK_MAX) ? (length - pos) : VENT_UPDATE_CHUNK_MAX);
+            /* The header of the next run starts over after a failure, nothing else may */
+            failed = (VentUpdate_GetState() == VENT_UPDATE_FAILED) && (pos != 0u);
+            result = VentUpdate_Write(&patch[pos], n);
+            if (result == VENT_UPDATE_BUSY)
+            {
+                run->busy++;
+            }
+            else
+            {
+                /* The hub moves on after a refusal too, as a careless one would */
+                run->chunks++;
+                run->refused += (result != VENT_UPDATE_OK);
+                run->acceptedAfterFail += failed && (result == VENT_UPDATE_OK);
+                pos += n;
+            }
+            nextWrite = ventSimTicks + (((uint64)TEST_WRITE_US * VENT_SIM_LFCLK_HZ) / 1000000u);
+        }
+        Test_Process(run);
+        if ((VentUpdate_GetState() == VENT_UPDATE_STAGED) ||
+            ((VentUpdate_GetState() == VENT_UPDATE_FAILED) && (pos >= length)))
+            break;
+        VentSim_Run(1);
+    }
+    run->ms = VentTimer_GetTimeStamp() - start;
+    run->norOps = ventSimNorOps - ops;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *path = (argc > 4) ? argv[4] : "VentUpdateTest.nor";
+    static uint8 patch[CY_FLASH_SIZE];
+    uint8 header[16];
+    uint32 oldSize, newSize, patchLen, i;
+    const VENT_UPDATE_STATS_T *stats = VentUpdate_GetStats();
+    TEST_RUN_T run;
+    FILE *f;
+
+    if ((argc < 4) || (argc > 5))
+    {
+        printf("usage: %s old.hex new.hex patch.bin [flash file]\n", argv[0]);
+        return 2;
+    }
+    CHECK(Test_ReadHex(argv[1], ventSimImage) != 0u, "cannot read %s", argv[1]);
+    newSize = Test_ReadHex(argv[2], newImage);
+    CHECK(newSize != 0u, "cannot read %s", argv[2]);
+    f = fopen(argv[3], "rb");
+    CHECK(f != NULL, "cannot read %s", argv[3]);
+    patchLen = (uint32)fread(patch, 1, sizeof(patch), f);
+    fclose(f);
+    CHECK((patchLen > VENT_UPDATE_HEADER_LEN) && (Test_Get32(patch) == VENT_UPDATE_MAGIC), "%s is no patch", argv[3]);
+    oldSize = Test_Get32(&patch[4]);
+    CHECK(Test_Get32(&patch[12]) == newSize, "patch is for a %u byte image", (unsigned)Test_Get32(&patch[12]));
+
+    CHECK(VentSim_NorOpen(path), "cannot create %s", path);
+    VentTimer_Start();
+    VentNor_Start();
+    VentUpdate_Start();
+
+    /* Bonding and calibration rows past the old image differ on every vent */
+    srand(1);
+    for (i = oldSize; i < CY_FLASH_SIZE; i++)
+    {
+        ventSimImage[i] = (uint8)rand();
+    }
+
+    Test_Run(patch, patchLen, &run);
+    CHECK(VentUpdate_GetState() == VENT_UPDATE_STAGED, "not staged, error %u", stats->error);
+    VentNor_Read(VENT_UPDATE_HEADER_ADDR, header, sizeof(header));
+    CHECK((Test_Get32(&header[0]) == VENT_UPDATE_STAGED_MAGIC) && (Test_Get32(&header[4]) == newSize) &&
+          (Test_Get32(&header[8]) == Test_Get32(&patch[16])), "staging header wrong");
+    for (i = 0; i < newSize; i += VENT_NOR_PAGE_SIZE)
+    {
+        VentNor_Read(VENT_UPDATE_IMAGE_ADDR + i, &staged[i], VENT_NOR_PAGE_SIZE);
+    }
+    for (i = 0; (i < newSize) && (staged[i] == newImage[i]); i++)
+    {
+    }
+    CHECK(i == newSize, "staged image differs at 0x%05X", (unsigned)i);
+
+    printf("old image %u bytes, new %u bytes, patch %u bytes in %u writes\n", (unsigned)oldSize,
+           (unsigned)newSize, (unsigned)patchLen, (unsigned)run.chunks);
+    printf("copy %u, fill %u, insert %u bytes, %u pages, %u NOR operations\n", (unsigned)stats->copyBytes,
+           (unsigned)stats->fillBytes, (unsigned)stats->insertBytes, (unsigned)stats->pagesWritten,
+           (unsigned)run.norOps);
+    printf("staged in %.1f s at %.2f ms per write, %u writes refused as busy\n", run.ms / 1000.0,
+           TEST_WRITE_US / 1000.0, (unsigned)run.busy);
+    printf("first operation after %u main loop passes, %u bytes of the old image CRCed per pass\n",
+           (unsigned)run.checkCalls, (unsigned)VENT_UPDATE_CHECK_SLICE);
+    printf("VentUpdate_Process: %u calls, longest %.1f us, mean %.2f us on the host\n", (unsigned)run.calls,
+           run.maxCallNs / 1000.0, (double)run.totalCallNs / run.calls / 1000.0);
+
+    /* A patch for another build fails the check before any operation */
+    ventSimImage[oldSize / 2u] ^= 0x01u;
+    Test_Run(patch, patchLen, &run);
+    ventSimImage[oldSize / 2u] ^= 0x01u;
+    CHECK((VentUpdate_GetState() == VENT_UPDATE_FAILED) && (stats->error == VENT_UPDATE_WRONG_IMAGE) &&
+          (stats->copyBytes + stats->fillBytes + stats->insertBytes == 0u), "other build: error %u", stats->error);
+    CHECK((run.acceptedAfterFail == 0u) && (run.refused != 0u), "%u chunks taken after the failure",
+          (unsigned)run.acceptedAfterFail);
+    printf("other build refused, %u chunks after it refused\n", (unsigned)run.refused);
+
+    /* A corrupted patch fails, the rest of it does not start a new one */
+    patch[patchLen / 2u] ^= 0x40u;
+    Test_Run(patch, patchLen, &run);
+    patch[patchLen / 2u] ^= 0x40u;
+    CHECK((VentUpdate_GetState() == VENT_UPDATE_FAILED) &&
+          ((stats->error == VENT_UPDATE_BAD_CRC) || (stats->error == VENT_UPDATE_BAD_PATCH)),
+          "corrupted patch: state %u error %u", VentUpdate_GetState(), stats->error);
+    CHECK(run.acceptedAfterFail == 0u, "%u chunks taken after the failure", (unsigned)run.acceptedAfterFail);
+    printf("corrupted patch failed with error %u, %u chunks after it refused\n", stats->error,
+           (unsigned)run.refused);
+
+    /* And the hub starting over succeeds */
+    Test_Run(patch, patchLen, &run);
+    CHECK(VentUpdate_GetState() == VENT_UPDATE_STAGED, "restart not staged, error %u", stats->error);
+
+    printf("PASS\n");
+    return 0;
+}
+
+/* [] END OF FILE */
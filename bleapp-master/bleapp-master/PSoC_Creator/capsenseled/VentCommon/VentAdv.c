@@ -0,0 +1,181 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#include "VentAdv.h"
+
+/* 0.625 ms units to us */
+#define VENT_ADV_UNIT_US            (625u)
+
+/* Random advDelay of 0-10 ms added to every event, and the on-air time of
+   one event on all three channels */
+#define VENT_ADV_DELAY_US           (5000u)
+#define VENT_ADV_EVENT_US           (10000u)
+
+static VENT_ADV_REPORT_T report;
+static uint32 target;
+static uint16 planned;
+static uint32 advStart;
+
+/***************************************************************
+ * Expected latency in ms. An event fully inside the scan window
+ * is seen in the first window, otherwise every event has a
+ * window / interval chance to land in one.
+ **************************************************************/
+uint32 VentAdv_Latency(uint16 interval)
+{
+    uint32 scan = (uint32)report.scanInterval * VENT_ADV_UNIT_US;
+    uint32 window = (uint32)report.scanWindow * VENT_ADV_UNIT_US;
+    uint32 period = (uint32)interval * VENT_ADV_UNIT_US + VENT_ADV_DELAY_US;
+    uint64 latency;
+
+    if (period + VENT_ADV_EVENT_US <= window)
+    {
+        /* Wait for the next window, then half an interval */
+        latency = ((uint64)(scan - window) * (scan - window)) / (2u * scan) + period / 2u;
+    }
+    else
+    {
+        latency = ((uint64)period * scan) / window;
+    }
+    return (uint32)(latency / 1000u);
+}
+
+/***************************************************************
+ * Expected average current in nA while advertising
+ **************************************************************/
+uint32 VentAdv_Current(uint16 interval)
+{
+    uint32 period = (uint32)interval * VENT_ADV_UNIT_US + VENT_ADV_DELAY_US;
+
+    return (uint32)(((uint64)VENT_ADV_EVENT_CHARGE_NC * 1000000u) / period) + VENT_ADV_SLEEP_NA;
+}
+
+/***************************************************************
+ * Longest interval that still meets the target, latency only
+ * grows with the interval so a binary search finds it
+ **************************************************************/
+static void VentAdv_Plan(void)
+{
+    uint16 lo = VENT_ADV_INTERVAL_MIN;
+    uint16 hi = VENT_ADV_INTERVAL_MAX;
+
+    while (lo < hi)
+    {
+        uint16 mid = (uint16)((lo + hi + 1u) / 2u);
+
+        if (VentAdv_Latency(mid) <= target)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = (uint16)(mid - 1u);
+        }
+    }
+    planned = lo;
+
+    /* Measured misses shorten the interval until the next hub update */
+    report.interval = (uint16)(planned >> report.backoff);
+    if (report.interval < VENT_ADV_INTERVAL_MIN)
+    {
+        report.interval = VENT_ADV_INTERVAL_MIN;
+    }
+    report.latency = VentAdv_Latency(report.interval);
+    report.current = VentAdv_Current(report.interval);
+}
+
+/***************************************************************
+ * Assume the default hub scan and pick an interval
+ **************************************************************/
+void VentAdv_Init(void)
+{
+    report.observed = 0;
+    report.worst = 0;
+    report.connections = 0;
+    target = VENT_ADV_TARGET_MS;
+    VentAdv_SetHubScan(VENT_ADV_HUB_SCAN_INTERVAL, VENT_ADV_HUB_SCAN_WINDOW);
+}
+
+/***************************************************************
+ * Hub scan parameters from the SCPS characteristic
+ **************************************************************/
+void VentAdv_SetHubScan(uint16 scanInterval, uint16 scanWindow)
+{
+    /* Same ranges as the LE Set Scan Parameters command */
+    if ((scanInterval < 0x0004u) || (scanInterval > 0x4000u) ||
+        (scanWindow < 0x0004u) || (scanWindow > scanInterval))
+        return;
+
+    report.scanInterval = scanInterval;
+    report.scanWindow = scanWindow;
+    report.backoff = 0;
+    VentAdv_Plan();
+}
+
+/***************************************************************
+ * Change the discovery latency target
+ **************************************************************/
+void VentAdv_SetTarget(uint32 latency)
+{
+    target = latency;
+    VentAdv_Plan();
+}
+
+/***************************************************************
+ * Start advertising with the chosen interval
+ **************************************************************/
+CYBLE_API_RESULT_T VentAdv_Start(uint32 now)
+{
+    /* Keep advertising until a connection, the interval is the power knob */
+    cyBle_discoveryModeInfo.advParam->advIntvMin = report.interval;
+    cyBle_discoveryModeInfo.advParam->advIntvMax = report.interval;
+    cyBle_discoveryModeInfo.advTo = 0u;
+
+    advStart = now;
+    return CyBle_GappStartAdvertisement(CYBLE_ADVERTISING_CUSTOM);
+}
+
+/***************************************************************
+ * Measure the discovery latency of this connection
+ **************************************************************/
+void VentAdv_Connected(uint32 now)
+{
+    report.observed = now - advStart;
+    if (report.observed > report.worst)
+    {
+        report.worst = report.observed;
+    }
+    report.connections++;
+
+    if (report.observed > target * VENT_ADV_OBSERVE_FACTOR)
+        return;
+
+    if ((report.observed > target) && (report.backoff < VENT_ADV_MAX_BACKOFF))
+    {
+        report.backoff++;
+        VentAdv_Plan();
+    }
+    else if ((report.observed < target / 2u) && (report.backoff != 0u))
+    {
+        report.backoff--;
+        VentAdv_Plan();
+    }
+}
+
+/***************************************************************
+ * Chosen interval with its expected latency and current
+ **************************************************************/
+const VENT_ADV_REPORT_T *VentAdv_GetReport(void)
+{
+    return &report;
+}
+
+/* [] END OF FILE */
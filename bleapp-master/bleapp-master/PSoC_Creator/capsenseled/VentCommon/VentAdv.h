@@ -0,0 +1,89 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#ifndef _VENT_ADV_H_
+#define _VENT_ADV_H_
+
+#include <project.h>
+
+/* Intervals are in 0.625 ms units as on air and in the SCPS value */
+#define VENT_ADV_INTERVAL_MIN       (0x0020u)
+#define VENT_ADV_INTERVAL_MAX       (0x4000u)
+
+/* Hub scan assumed until it tells us (60 ms interval, 30 ms window) */
+#define VENT_ADV_HUB_SCAN_INTERVAL  (0x0060u)
+#define VENT_ADV_HUB_SCAN_WINDOW    (0x0030u)
+
+/* Expected time from advertising start to the hub seeing the vent (ms) */
+#define VENT_ADV_TARGET_MS          (1000u)
+
+/* Current model: charge of one advertising event on three channels and
+   the deep sleep floor between events */
+#define VENT_ADV_EVENT_CHARGE_NC    (15000u)
+#define VENT_ADV_SLEEP_NA           (1300u)
+
+/* Observed latencies above target halve the interval, up to this many
+   times. Much longer ones mean the hub was not looking and are ignored. */
+#define VENT_ADV_MAX_BACKOFF        (4u)
+#define VENT_ADV_OBSERVE_FACTOR     (8u)
+
+typedef struct
+{
+    uint16 scanInterval;    /* hub, 0.625 ms units */
+    uint16 scanWindow;
+    uint16 interval;        /* chosen advertising interval */
+    uint32 latency;         /* expected discovery latency, ms */
+    uint32 current;         /* expected average current, nA */
+    uint32 observed;        /* last measured latency, ms */
+    uint32 worst;           /* longest measured latency, ms */
+    uint32 connections;
+    uint8  backoff;
+} VENT_ADV_REPORT_T;
+
+/***************************************************************
+ * Assume the default hub scan and pick an interval
+ **************************************************************/
+void VentAdv_Init(void);
+
+/***************************************************************
+ * Hub scan parameters from the SCPS Scan Interval Window
+ * characteristic, both in 0.625 ms units
+ **************************************************************/
+void VentAdv_SetHubScan(uint16 scanInterval, uint16 scanWindow);
+
+/***************************************************************
+ * Change the discovery latency target (ms)
+ **************************************************************/
+void VentAdv_SetTarget(uint32 target);
+
+/***************************************************************
+ * Start advertising with the chosen interval, replaces
+ * CyBle_GappStartAdvertisement(CYBLE_ADVERTISING_FAST)
+ **************************************************************/
+CYBLE_API_RESULT_T VentAdv_Start(uint32 now);
+
+/***************************************************************
+ * Called on connection, measures the actual discovery latency
+ * and backs off the interval when it missed the target
+ **************************************************************/
+void VentAdv_Connected(uint32 now);
+
+/***************************************************************
+ * Expected latency and current for a given interval
+ **************************************************************/
+uint32 VentAdv_Latency(uint16 interval);
+uint32 VentAdv_Current(uint16 interval);
+
+const VENT_ADV_REPORT_T *VentAdv_GetReport(void);
+
+#endif /* _VENT_ADV_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,203 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#include "VentBattery.h"
+
+#define VENT_BATTERY_INJ_CONFIG     (*(reg32 *)CYREG_SAR_INJ_CHAN_CONFIG)
+#define VENT_BATTERY_INJ_RESULT     (*(reg32 *)CYREG_SAR_INJ_RESULT)
+#define VENT_BATTERY_COUNTS         (4096u)
+
+typedef struct
+{
+    uint16 mv;
+    uint8  level;
+} VENT_BATTERY_POINT_T;
+
+/* Discharge curve of two alkaline cells in series, falling voltage */
+static const VENT_BATTERY_POINT_T curve[] =
+{
+    { 3100u, 100u },
+    { 2800u,  80u },
+    { 2600u,  50u },
+    { 2400u,  20u },
+    { 2200u,   5u },
+    { 2000u,   0u },
+};
+
+/* Each tier stretches the sampling, advertising and servo refresh.
+   The currents are the ones Tools/VentSim/VentLifetime.c models for
+   the tier in deep sleep, connected half the time. */
+static const VENT_BATTERY_POLICY_T policy[VENT_BATTERY_TIERS] =
+{
+    /* minLevel, measure, sample, advTarget, servoRefresh, current */
+    { 100u,  600000u,   1000u,  1000u,  600000u,  50u },
+    {  50u,  600000u,   5000u,  3000u, 1800000u,  30u },
+    {  20u,  300000u,  30000u, 10000u,       0u,  23u },
+    {   5u,  300000u, 300000u, 30000u,       0u,  22u },
+};
+
+static uint32 filtered;
+static uint8  level;
+static VENT_BATTERY_TIER_T tier;
+static uint32 measureTime;
+static uint8  measured;
+static uint8  converting;
+
+/***************************************************************
+ * Level from the discharge curve, linear between points
+ **************************************************************/
+static uint8 VentBattery_Level(uint16 mv)
+{
+    uint8 i;
+
+    if (mv >= curve[0].mv)
+        return curve[0].level;
+
+    for (i = 1; i < sizeof(curve) / sizeof(curve[0]); i++)
+    {
+        if (mv >= curve[i].mv)
+        {
+            return (uint8)(curve[i].level +
+                           ((uint32)(mv - curve[i].mv) * (curve[i - 1].level - curve[i].level)) /
+                           (curve[i - 1].mv - curve[i].mv));
+        }
+    }
+    return 0;
+}
+
+/***************************************************************
+ * Tier for the level, a boundary has to be crossed by the
+ * hysteresis before the tier changes
+ **************************************************************/
+static VENT_BATTERY_TIER_T VentBattery_Tier(uint8 percent)
+{
+    VENT_BATTERY_TIER_T next = VENT_BATTERY_NORMAL;
+
+    while (((uint8)(next + 1) < VENT_BATTERY_TIERS) && (percent < policy[next + 1].minLevel))
+    {
+        next++;
+    }
+
+    /* Going back up needs the level clearly above the boundary */
+    if ((next < tier) && (percent < (policy[tier].minLevel + VENT_BATTERY_HYSTERESIS)))
+        return tier;
+    return next;
+}
+
+/***************************************************************
+ * Start with a full battery
+ **************************************************************/
+void VentBattery_Start(void)
+{
+    filtered = (uint32)curve[0].mv << VENT_BATTERY_IIR_SHIFT;
+    level = curve[0].level;
+    tier = VENT_BATTERY_NORMAL;
+    converting = 0;
+    measured = 0;
+}
+
+/***************************************************************
+ * Queue an injection conversion behind the running scan and
+ * pick up its result on a later call
+ **************************************************************/
+uint8 VentBattery_Process(uint32 now)
+{
+    uint32 counts;
+    uint8 previous = level;
+
+    if (!converting)
+    {
+        if (measured && ((uint32)(now - measureTime) < policy[tier].measureInterval))
+            return 0;
+
+        measureTime = now;
+        measured = 1;
+        ADC_SAR_Seq_1_SAR_INTR_REG = ADC_SAR_Seq_1_INJ_EOC_MASK;
+        VENT_BATTERY_INJ_CONFIG = ADC_SAR_Seq_1_INJ_CHAN_EN | ADC_SAR_Seq_1_INJ_TAILGATING |
+                                  VENT_BATTERY_INJ_ADDR;
+        converting = 1;
+        return 0;
+    }
+
+    if ((ADC_SAR_Seq_1_SAR_INTR_REG & ADC_SAR_Seq_1_INJ_EOC_MASK) == 0u)
+        return 0;
+    ADC_SAR_Seq_1_SAR_INTR_REG = ADC_SAR_Seq_1_INJ_EOC_MASK;
+    converting = 0;
+
+    counts = VENT_BATTERY_INJ_RESULT & (VENT_BATTERY_COUNTS - 1u);
+    if (counts == 0u)
+        return 0;
+
+    filtered += ((VENT_BATTERY_REF_MV * VENT_BATTERY_COUNTS) / counts) -
+                (filtered >> VENT_BATTERY_IIR_SHIFT);
+    level = VentBattery_Level(VentBattery_GetMv());
+    tier = VentBattery_Tier(level);
+
+    return (uint8)(level != previous);
+}
+
+/***************************************************************
+ * Filtered supply in mV
+ **************************************************************/
+uint16 VentBattery_GetMv(void)
+{
+    return (uint16)(filtered >> VENT_BATTERY_IIR_SHIFT);
+}
+
+/***************************************************************
+ * Battery level in percent
+ **************************************************************/
+uint8 VentBattery_GetLevel(void)
+{
+    return level;
+}
+
+/***************************************************************
+ * Current power tier
+ **************************************************************/
+VENT_BATTERY_TIER_T VentBattery_GetTier(void)
+{
+    return tier;
+}
+
+/***************************************************************
+ * Settings of the current tier
+ **************************************************************/
+const VENT_BATTERY_POLICY_T *VentBattery_GetPolicy(void)
+{
+    return &policy[tier];
+}
+
+/***************************************************************
+ * Hours left, the charge of each tier band is drawn at that
+ * tier's modelled current
+ **************************************************************/
+uint32 VentBattery_Lifetime(void)
+{
+    uint32 hours = 0;
+    uint8 top = level;
+    uint8 i;
+
+    for (i = (uint8)tier; i < VENT_BATTERY_TIERS; i++)
+    {
+        uint8 bottom = ((i + 1u) < VENT_BATTERY_TIERS) ? policy[i + 1u].minLevel : 0u;
+
+        if (top > bottom)
+        {
+            /* mAh * 1000 / uA = h */
+            hours += ((uint32)VENT_BATTERY_CAPACITY_MAH * 10u * (top - bottom)) / policy[i].current;
+            top = bottom;
+        }
+    }
+    return hours;
+}
+
+/* [] END OF FILE */
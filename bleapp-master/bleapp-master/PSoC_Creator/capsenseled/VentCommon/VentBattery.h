@@ -0,0 +1,83 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#ifndef _VENT_BATTERY_H_
+#define _VENT_BATTERY_H_
+
+#include <project.h>
+
+/* The ADC is referenced to VDDA, so the supply is found by converting the
+   internal 1.024 V reference on the injection channel:
+   VDD = ref * 4096 / counts. The SARMUX address of the reference is not
+   verified, confirm it against the SARMUX table of the part in use. */
+#define VENT_BATTERY_INJ_ADDR       (0x70u)
+#define VENT_BATTERY_REF_MV         (1024u)
+
+/* Supply filter, each measurement moves 1/4 of the way */
+#define VENT_BATTERY_IIR_SHIFT      (2u)
+
+/* Cell capacity for the lifetime estimate (mAh), 2 x AA alkaline */
+#define VENT_BATTERY_CAPACITY_MAH   (2500u)
+
+/* Level must move this far past a tier boundary to change tier (%) */
+#define VENT_BATTERY_HYSTERESIS     (3u)
+
+typedef enum
+{
+    VENT_BATTERY_NORMAL,
+    VENT_BATTERY_SAVE,
+    VENT_BATTERY_LOW,
+    VENT_BATTERY_CRITICAL,
+    VENT_BATTERY_TIERS
+} VENT_BATTERY_TIER_T;
+
+/* Power settings for one tier, every interval in ms */
+typedef struct
+{
+    uint8  minLevel;        /* tier applies from this level down (%) */
+    uint32 measureInterval;
+    uint32 sampleInterval;  /* history records and pressure notifications */
+    uint32 advTarget;       /* discovery latency target for VentAdv */
+    uint32 servoRefresh;    /* VentDamper refresh, 0 = never */
+    uint32 current;         /* modelled average current (uA) */
+} VENT_BATTERY_POLICY_T;
+
+/***************************************************************
+ * Start with a full battery, the first measurement follows
+ * right away
+ **************************************************************/
+void VentBattery_Start(void);
+
+/***************************************************************
+ * Run the measurement, returns 1 when the level changed
+ **************************************************************/
+uint8 VentBattery_Process(uint32 now);
+
+/***************************************************************
+ * Filtered supply (mV) and level (%)
+ **************************************************************/
+uint16 VentBattery_GetMv(void);
+uint8 VentBattery_GetLevel(void);
+
+/***************************************************************
+ * Current tier and its settings
+ **************************************************************/
+VENT_BATTERY_TIER_T VentBattery_GetTier(void);
+const VENT_BATTERY_POLICY_T *VentBattery_GetPolicy(void);
+
+/***************************************************************
+ * Hours left at the modelled current of the tiers still ahead
+ **************************************************************/
+uint32 VentBattery_Lifetime(void);
+
+#endif /* _VENT_BATTERY_H_ */
+
+/* [] END OF FILE */
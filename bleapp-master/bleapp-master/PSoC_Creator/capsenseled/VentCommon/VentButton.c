@@ -0,0 +1,196 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#include "VentButton.h"
+
+#define VENT_BUTTON_HOLD_TICKS      (VENT_BUTTON_HOLD_MS / VENT_BUTTON_TICK_MS)
+#define VENT_BUTTON_REPEAT_TICKS    (VENT_BUTTON_REPEAT_MS / VENT_BUTTON_TICK_MS)
+
+typedef struct
+{
+    uint8 (*read)(void);
+    uint8 (*clear)(void);
+} VENT_BUTTON_PIN_T;
+
+static const VENT_BUTTON_PIN_T pins[VENT_BUTTON_COUNT] =
+{
+    { SW1_Read, SW1_ClearInterrupt },
+    { SW2_Read, SW2_ClearInterrupt },
+    { SW3_Read, SW3_ClearInterrupt },
+    { SW4_Read, SW4_ClearInterrupt },
+    { SW5_Read, SW5_ClearInterrupt },
+};
+
+/* Debounced state, samples that disagree with it and time held */
+static uint8  pressed[VENT_BUTTON_COUNT];
+static uint8  bounce[VENT_BUTTON_COUNT];
+static uint16 heldTicks[VENT_BUTTON_COUNT];
+static volatile uint8 sampling;
+
+static VENT_BUTTON_T queue[VENT_BUTTON_QUEUE];
+static volatile uint8 queueHead;
+static volatile uint8 queueTail;
+static uint32 overruns;
+
+/***************************************************************
+ * Start or stop the sample interrupt
+ **************************************************************/
+static void VentButton_RunTimer(uint8 run)
+{
+    CySysWdtUnlock();
+    if (run)
+    {
+        CySysWdtEnable(VENT_BUTTON_COUNTER_MASK);
+    }
+    else
+    {
+        CySysWdtDisable(VENT_BUTTON_COUNTER_MASK);
+    }
+    CySysWdtLock();
+    sampling = run;
+}
+
+/***************************************************************
+ * Add an event, called from the sample interrupt
+ **************************************************************/
+static void VentButton_Queue(uint8 button, uint8 event)
+{
+    uint8 next = (uint8)((queueHead + 1u) % VENT_BUTTON_QUEUE);
+
+    if (next == queueTail)
+    {
+        overruns++;
+        return;
+    }
+    queue[queueHead].button = button;
+    queue[queueHead].event = event;
+    queueHead = next;
+}
+
+/***************************************************************
+ * Any edge on a SW pin starts sampling
+ **************************************************************/
+CY_ISR(VentButton_PinIsr)
+{
+    uint8 i;
+
+    for (i = 0; i < VENT_BUTTON_COUNT; i++)
+    {
+        (void)pins[i].clear();
+    }
+    if (!sampling)
+    {
+        VentButton_RunTimer(1);
+    }
+}
+
+/***************************************************************
+ * Debounce every button and time the holds, stops itself once
+ * all buttons are settled and released
+ **************************************************************/
+static void VentButton_Tick(void)
+{
+    uint8 busy = 0;
+    uint8 i;
+
+    for (i = 0; i < VENT_BUTTON_COUNT; i++)
+    {
+        uint8 level = (uint8)(pins[i].read() != 0u);
+        uint8 down = (uint8)(level != VENT_BUTTON_ACTIVE_LOW);
+
+        if (down != pressed[i])
+        {
+            if (++bounce[i] >= VENT_BUTTON_DEBOUNCE)
+            {
+                pressed[i] = down;
+                bounce[i] = 0;
+                heldTicks[i] = 0;
+                VentButton_Queue(i, down ? VENT_BUTTON_PRESS : VENT_BUTTON_RELEASE);
+            }
+        }
+        else
+        {
+            bounce[i] = 0;
+        }
+
+        if (pressed[i])
+        {
+            heldTicks[i]++;
+            if (heldTicks[i] == VENT_BUTTON_HOLD_TICKS)
+            {
+                VentButton_Queue(i, VENT_BUTTON_HOLD);
+            }
+            else if (heldTicks[i] >= VENT_BUTTON_HOLD_TICKS + VENT_BUTTON_REPEAT_TICKS)
+            {
+                heldTicks[i] = VENT_BUTTON_HOLD_TICKS;
+                VentButton_Queue(i, VENT_BUTTON_REPEAT);
+            }
+        }
+
+        if (pressed[i] || bounce[i])
+        {
+            busy = 1;
+        }
+    }
+
+    if (!busy)
+    {
+        VentButton_RunTimer(0);
+    }
+}
+
+/***************************************************************
+ * Hook the pin interrupts and the WDT counter
+ **************************************************************/
+void VentButton_Start(void)
+{
+    CySysWdtUnlock();
+    CySysWdtSetMode(VENT_BUTTON_COUNTER, CY_SYS_WDT_MODE_INT);
+    CySysWdtSetMatch(VENT_BUTTON_COUNTER, VENT_BUTTON_TICKS);
+    CySysWdtSetClearOnMatch(VENT_BUTTON_COUNTER, 1u);
+    CySysWdtLock();
+    CySysWdtSetInterruptCallback(VENT_BUTTON_COUNTER, VentButton_Tick);
+
+    SW1_SetInterruptMode(SW1_0_INTR, SW1_INTR_BOTH);
+    SW2_SetInterruptMode(SW2_0_INTR, SW2_INTR_BOTH);
+    SW3_SetInterruptMode(SW3_0_INTR, SW3_INTR_BOTH);
+    SW4_SetInterruptMode(SW4_0_INTR, SW4_INTR_BOTH);
+    SW5_SetInterruptMode(SW5_0_INTR, SW5_INTR_BOTH);
+
+    /* GPIO interrupts also wake the part from Deep Sleep */
+    CyIntSetVector(VENT_BUTTON_PORT0_IRQ, VentButton_PinIsr);
+    CyIntSetVector(VENT_BUTTON_PORT1_IRQ, VentButton_PinIsr);
+    CyIntEnable(VENT_BUTTON_PORT0_IRQ);
+    CyIntEnable(VENT_BUTTON_PORT1_IRQ);
+}
+
+/***************************************************************
+ * Take the oldest event
+ **************************************************************/
+uint8 VentButton_GetEvent(VENT_BUTTON_T *event)
+{
+    if (queueTail == queueHead)
+        return 0;
+
+    *event = queue[queueTail];
+    queueTail = (uint8)((queueTail + 1u) % VENT_BUTTON_QUEUE);
+    return 1;
+}
+
+/***************************************************************
+ * Events lost because the queue was full
+ **************************************************************/
+uint32 VentButton_GetOverruns(void)
+{
+    return overruns;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,83 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#ifndef _VENT_BUTTON_H_
+#define _VENT_BUTTON_H_
+
+#include <project.h>
+#include "VentTimer.h"
+
+/* WDT counter sampling the buttons. Runs from LFCLK and is only enabled
+   from the first edge until every button is released again, so the CPU
+   sleeps between presses. */
+#define VENT_BUTTON_COUNTER         CY_SYS_WDT_COUNTER1
+#define VENT_BUTTON_COUNTER_MASK    CY_SYS_WDT_COUNTER1_MASK
+
+/* GPIO port interrupt lines of the SW pins (ports 0 and 1) */
+#define VENT_BUTTON_PORT0_IRQ       (0u)
+#define VENT_BUTTON_PORT1_IRQ       (1u)
+
+/* Sample period, the pin must read the same this many samples in a row */
+#define VENT_BUTTON_TICK_MS         (10u)
+#define VENT_BUTTON_TICKS           (VENT_TIMER_LFCLK_HZ * VENT_BUTTON_TICK_MS / 1000u)
+#define VENT_BUTTON_DEBOUNCE        (3u)
+
+/* Held this long gives a hold event, then a repeat event every period (ms) */
+#define VENT_BUTTON_HOLD_MS         (800u)
+#define VENT_BUTTON_REPEAT_MS       (200u)
+
+/* Buttons pull the pin low */
+#define VENT_BUTTON_ACTIVE_LOW      (1u)
+
+#define VENT_BUTTON_QUEUE           (8u)
+
+typedef enum
+{
+    VENT_BUTTON_SW1,
+    VENT_BUTTON_SW2,
+    VENT_BUTTON_SW3,
+    VENT_BUTTON_SW4,
+    VENT_BUTTON_SW5,
+    VENT_BUTTON_COUNT
+} VENT_BUTTON_ID_T;
+
+typedef enum
+{
+    VENT_BUTTON_PRESS,
+    VENT_BUTTON_HOLD,
+    VENT_BUTTON_REPEAT,
+    VENT_BUTTON_RELEASE
+} VENT_BUTTON_EVENT_T;
+
+typedef struct
+{
+    uint8 button;
+    uint8 event;
+} VENT_BUTTON_T;
+
+/***************************************************************
+ * Hook the pin interrupts and the WDT counter
+ **************************************************************/
+void VentButton_Start(void);
+
+/***************************************************************
+ * Take the oldest event, returns 0 if there is none
+ **************************************************************/
+uint8 VentButton_GetEvent(VENT_BUTTON_T *event);
+
+/***************************************************************
+ * Events lost because the queue was full
+ **************************************************************/
+uint32 VentButton_GetOverruns(void);
+
+#endif /* _VENT_BUTTON_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,217 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#include "VentControl.h"
+#include "VentDamper.h"
+
+/***************************************************************
+ * Load the default gains and limits, controller disabled
+ **************************************************************/
+void VentControl_Init(VENT_CONTROL_T *ctl)
+{
+    ctl->setpoint = 2100;
+    ctl->minPosition = 0;
+    ctl->maxPosition = VENT_DAMPER_POSITION_MAX;
+    ctl->kp = VENT_CONTROL_KP;
+    ctl->ki = VENT_CONTROL_KI;
+    ctl->maxRate = VENT_CONTROL_MAX_RATE;
+    ctl->direction = VENT_CONTROL_HEATING;
+    ctl->enabled = 0;
+    ctl->primed = 0;
+    ctl->integral = 0;
+    ctl->output = 0;
+    ctl->commanded = 0;
+    ctl->lastTime = 0;
+}
+
+/***************************************************************
+ * Turn the controller on or off
+ **************************************************************/
+void VentControl_Enable(VENT_CONTROL_T *ctl, uint8 enable, uint16 position)
+{
+    if (enable && !ctl->enabled)
+    {
+        if (position > VENT_DAMPER_POSITION_MAX)
+            position = ctl->minPosition;
+
+        /* The first update rebuilds the integral around this position */
+        ctl->output = position;
+        ctl->commanded = position;
+        ctl->primed = 0;
+    }
+    ctl->enabled = enable;
+}
+
+/***************************************************************
+ * Setpoint in 1/100 degC
+ **************************************************************/
+void VentControl_SetSetpoint(VENT_CONTROL_T *ctl, int16 setpoint)
+{
+    ctl->setpoint = setpoint;
+}
+
+/***************************************************************
+ * Damper travel the controller may use
+ **************************************************************/
+void VentControl_SetLimits(VENT_CONTROL_T *ctl, uint16 minPosition, uint16 maxPosition)
+{
+    if (maxPosition > VENT_DAMPER_POSITION_MAX)
+        maxPosition = VENT_DAMPER_POSITION_MAX;
+    if (minPosition > maxPosition)
+        minPosition = maxPosition;
+
+    ctl->minPosition = minPosition;
+    ctl->maxPosition = maxPosition;
+}
+
+/***************************************************************
+ * Gains and rate limit
+ **************************************************************/
+void VentControl_SetGains(VENT_CONTROL_T *ctl, uint16 kp, uint16 ki, uint16 maxRate)
+{
+    /* The next update rebuilds the integral for the new gains */
+    if ((kp != ctl->kp) || (ki != ctl->ki))
+        ctl->primed = 0;
+
+    ctl->kp = kp;
+    ctl->ki = ki;
+    ctl->maxRate = maxRate;
+}
+
+/***************************************************************
+ * Settings as a Control characteristic record
+ **************************************************************/
+void VentControl_Pack(const VENT_CONTROL_T *ctl, uint8 *data)
+{
+    data[0] = (uint8)ctl->setpoint;
+    data[1] = (uint8)((uint16)ctl->setpoint >> 8);
+    data[2] = (uint8)ctl->minPosition;
+    data[3] = (uint8)(ctl->minPosition >> 8);
+    data[4] = (uint8)ctl->maxPosition;
+    data[5] = (uint8)(ctl->maxPosition >> 8);
+    data[6] = (uint8)ctl->kp;
+    data[7] = (uint8)(ctl->kp >> 8);
+    data[8] = (uint8)ctl->ki;
+    data[9] = (uint8)(ctl->ki >> 8);
+    data[10] = (uint8)ctl->maxRate;
+    data[11] = (uint8)(ctl->maxRate >> 8);
+    data[12] = (uint8)ctl->direction;
+    data[13] = ctl->enabled;
+}
+
+/***************************************************************
+ * Apply a Control characteristic record
+ **************************************************************/
+uint8 VentControl_Unpack(VENT_CONTROL_T *ctl, const uint8 *data, uint16 length, uint16 position)
+{
+    uint16 minPosition, maxPosition;
+    int8 direction;
+
+    if (length != VENT_CONTROL_CHAR_LEN)
+        return VENT_CONTROL_BAD_LENGTH;
+
+    minPosition = (uint16)(data[2] | ((uint16)data[3] << 8));
+    maxPosition = (uint16)(data[4] | ((uint16)data[5] << 8));
+    direction = (int8)data[12];
+    if ((maxPosition > VENT_DAMPER_POSITION_MAX) || (minPosition > maxPosition) ||
+        ((direction != VENT_CONTROL_HEATING) && (direction != VENT_CONTROL_COOLING)) || (data[13] > 1u))
+        return VENT_CONTROL_BAD_VALUE;
+
+    /* Reversing the loop turns the integral upside down */
+    if (direction != ctl->direction)
+        ctl->primed = 0;
+
+    ctl->setpoint = (int16)(data[0] | ((uint16)data[1] << 8));
+    ctl->direction = direction;
+    VentControl_SetLimits(ctl, minPosition, maxPosition);
+    VentControl_SetGains(ctl, (uint16)(data[6] | ((uint16)data[7] << 8)),
+                         (uint16)(data[8] | ((uint16)data[9] << 8)),
+                         (uint16)(data[10] | ((uint16)data[11] << 8)));
+    VentControl_Enable(ctl, data[13], position);
+    return VENT_CONTROL_OK;
+}
+
+/***************************************************************
+ * Run one step with a new temperature sample
+ **************************************************************/
+uint8 VentControl_Update(VENT_CONTROL_T *ctl, int16 temperature, uint32 now, uint16 *position)
+{
+    int32 error, p, out, step, diff;
+    int32 lo = (int32)ctl->minPosition << 8;
+    int32 hi = (int32)ctl->maxPosition << 8;
+    int32 integral;
+    uint32 dt;
+
+    if (!ctl->enabled)
+        return 0;
+
+    error = ((int32)ctl->setpoint - temperature) * ctl->direction;
+
+    /* Proportional part, permille << 8 */
+    p = (error * (int32)ctl->kp * 256) / 100;
+
+    if (!ctl->primed)
+    {
+        /* Bumpless start, the integral holds whatever P does not */
+        ctl->integral = ((int32)ctl->output << 8) - p;
+        ctl->lastTime = now;
+        ctl->primed = 1;
+        return 0;
+    }
+
+    dt = now - ctl->lastTime;
+    ctl->lastTime = now;
+    if (dt > VENT_CONTROL_MAX_DT)
+        dt = VENT_CONTROL_MAX_DT;
+
+    /* Integral part, ki is per degC per minute */
+    integral = ctl->integral + (int32)(((int64)error * ctl->ki * dt * 256) / (100 * 60000L));
+
+    /* Anti-windup: stop integrating into a saturated output */
+    out = p + integral;
+    if (out > hi)
+    {
+        out = hi;
+        if (integral > ctl->integral)
+            integral = ctl->integral;
+    }
+    else if (out < lo)
+    {
+        out = lo;
+        if (integral < ctl->integral)
+            integral = ctl->integral;
+    }
+    ctl->integral = integral;
+
+    /* Rate limit, at least one permille per step so it always converges */
+    out = (out + 128) >> 8;
+    step = (int32)(((uint32)ctl->maxRate * dt) / 60000u);
+    if (step < 1)
+        step = 1;
+    diff = out - (int32)ctl->output;
+    if (diff > step)
+        out = ctl->output + step;
+    else if (diff < -step)
+        out = ctl->output - step;
+    ctl->output = (uint16)out;
+
+    diff = (int32)ctl->output - (int32)ctl->commanded;
+    if ((diff >= (int32)VENT_CONTROL_MIN_MOVE) || (diff <= -(int32)VENT_CONTROL_MIN_MOVE) ||
+        ((ctl->output != ctl->commanded) && ((ctl->output == ctl->minPosition) || (ctl->output == ctl->maxPosition))))
+    {
+        ctl->commanded = ctl->output;
+        *position = ctl->output;
+        return 1;
+    }
+    return 0;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,116 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#ifndef _VENT_CONTROL_H_
+#define _VENT_CONTROL_H_
+
+#include <project.h>
+
+/* Schedule command byte with the top bit set carries a setpoint for
+   the on-vent controller, 10.00 degC + 0.25 degC steps (10.00 - 41.75) */
+#define VENT_CONTROL_SETPOINT_FLAG  (0x80u)
+#define VENT_CONTROL_SETPOINT_BASE  (1000)
+#define VENT_CONTROL_SETPOINT_STEP  (25)
+#define VENT_CONTROL_DECODE_SETPOINT(b) \
+    ((int16)(VENT_CONTROL_SETPOINT_BASE + (((b) & 0x7Fu) * VENT_CONTROL_SETPOINT_STEP)))
+#define VENT_CONTROL_ENCODE_SETPOINT(t) \
+    ((uint8)(VENT_CONTROL_SETPOINT_FLAG | (((t) - VENT_CONTROL_SETPOINT_BASE) / VENT_CONTROL_SETPOINT_STEP)))
+
+/* Defaults, positions in permille */
+#define VENT_CONTROL_KP             (200u)  /* permille per degC */
+#define VENT_CONTROL_KI             (100u)  /* permille per degC per minute */
+#define VENT_CONTROL_MAX_RATE       (300u)  /* permille per minute */
+#define VENT_CONTROL_MIN_MOVE       (10u)   /* smaller corrections are not worth a servo move */
+#define VENT_CONTROL_MAX_DT         (10000u) /* longer sample gaps are clamped (ms) */
+
+/* Supply air is warm: open when the room is below the setpoint */
+#define VENT_CONTROL_HEATING        (1)
+#define VENT_CONTROL_COOLING        (-1)
+
+/* Control characteristic, the settings in one record (little endian):
+     setpoint int16 (1/100 degC), minPosition uint16, maxPosition uint16,
+     kp uint16, ki uint16, maxRate uint16, direction int8, enabled uint8 */
+#define VENT_CONTROL_CHAR_LEN       (14u)
+
+/* VentControl_Unpack results */
+#define VENT_CONTROL_OK             (0u)
+#define VENT_CONTROL_BAD_LENGTH     (1u)
+#define VENT_CONTROL_BAD_VALUE      (2u)
+
+typedef struct
+{
+    /* Settings written by the hub, temperatures in 1/100 degC */
+    int16  setpoint;
+    uint16 minPosition;
+    uint16 maxPosition;
+    uint16 kp;
+    uint16 ki;
+    uint16 maxRate;
+    int8   direction;
+
+    /* State */
+    uint8  enabled;
+    uint8  primed;
+    int32  integral;        /* permille << 8 */
+    uint16 output;
+    uint16 commanded;
+    uint32 lastTime;
+} VENT_CONTROL_T;
+
+/***************************************************************
+ * Load the default gains and limits, controller disabled
+ **************************************************************/
+void VentControl_Init(VENT_CONTROL_T *ctl);
+
+/***************************************************************
+ * Turn the controller on or off. Enabling starts bumpless from
+ * the given damper position.
+ **************************************************************/
+void VentControl_Enable(VENT_CONTROL_T *ctl, uint8 enable, uint16 position);
+
+/***************************************************************
+ * Setpoint in 1/100 degC
+ **************************************************************/
+void VentControl_SetSetpoint(VENT_CONTROL_T *ctl, int16 setpoint);
+
+/***************************************************************
+ * Damper travel the controller may use, in permille
+ **************************************************************/
+void VentControl_SetLimits(VENT_CONTROL_T *ctl, uint16 minPosition, uint16 maxPosition);
+
+/***************************************************************
+ * Gains and rate limit, units as VENT_CONTROL_KP, _KI and
+ * _MAX_RATE. A running controller restarts bumpless.
+ **************************************************************/
+void VentControl_SetGains(VENT_CONTROL_T *ctl, uint16 kp, uint16 ki, uint16 maxRate);
+
+/***************************************************************
+ * Settings as a Control characteristic record, writes
+ * VENT_CONTROL_CHAR_LEN bytes
+ **************************************************************/
+void VentControl_Pack(const VENT_CONTROL_T *ctl, uint8 *data);
+
+/***************************************************************
+ * Apply a Control characteristic record. Nothing changes unless
+ * the whole record is valid. Enabling starts bumpless from the
+ * given damper position. Returns VENT_CONTROL_OK or an error.
+ **************************************************************/
+uint8 VentControl_Unpack(VENT_CONTROL_T *ctl, const uint8 *data, uint16 length, uint16 position);
+
+/***************************************************************
+ * Run one step with a new temperature sample (1/100 degC).
+ * Returns 1 and the new damper position when it should move.
+ **************************************************************/
+uint8 VentControl_Update(VENT_CONTROL_T *ctl, int16 temperature, uint32 now, uint16 *position);
+
+#endif /* _VENT_CONTROL_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,256 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#include "VentDamper.h"
+#include <string.h>
+
+/* Compare values the Servo characteristic steps 0-5 have always driven */
+#define VENT_DAMPER_LEGACY(step) \
+    (((step) == 0u) ? VENT_DAMPER_DEFAULT_CLOSED : ((step) == 1u) ? 4350u : \
+     ((step) == 2u) ? 4375u : ((step) == 3u) ? 4425u : \
+     ((step) == 4u) ? 4450u : VENT_DAMPER_DEFAULT_OPEN)
+
+/* Default servo table. The legacy steps fall on every second point and
+   keep their exact values, the points in between split the difference. */
+#define VENT_DAMPER_DEFAULT(i) \
+    ((uint16)((((i) & 1u) == 0u) ? VENT_DAMPER_LEGACY((i) / 2u) : \
+     ((VENT_DAMPER_LEGACY((i) / 2u) + VENT_DAMPER_LEGACY(((i) / 2u) + 1u)) / 2u)))
+
+/* The calibration row owns a whole flash row so it can be rewritten
+   without touching the code around it. It sits with the BLE bonding
+   data in .cy_checksum_exclude, after the code, where VentDiff ends the
+   old image a patch is checked against. */
+typedef union
+{
+    VENT_DAMPER_CAL_T cal;
+    uint8 row[CY_FLASH_SIZEOF_ROW];
+} VENT_DAMPER_CAL_ROW_T;
+
+#if defined(__ARMCC_VERSION)
+    static CY_ALIGN(CY_FLASH_SIZEOF_ROW) const VENT_DAMPER_CAL_ROW_T ventDamperCalRow CY_SECTION(".cy_checksum_exclude") =
+#elif defined (__GNUC__)
+    static const VENT_DAMPER_CAL_ROW_T ventDamperCalRow CY_SECTION(".cy_checksum_exclude")
+        CY_ALIGN(CY_FLASH_SIZEOF_ROW) =
+#elif defined (__ICCARM__)
+    #pragma data_alignment=CY_FLASH_SIZEOF_ROW
+    #pragma location=".cy_checksum_exclude"
+    static const VENT_DAMPER_CAL_ROW_T ventDamperCalRow =
+#endif  /* (__ARMCC_VERSION) */
+{
+    {
+        VENT_DAMPER_CAL_MAGIC,
+        {
+            VENT_DAMPER_DEFAULT(0),  VENT_DAMPER_DEFAULT(1),  VENT_DAMPER_DEFAULT(2),
+            VENT_DAMPER_DEFAULT(3),  VENT_DAMPER_DEFAULT(4),  VENT_DAMPER_DEFAULT(5),
+            VENT_DAMPER_DEFAULT(6),  VENT_DAMPER_DEFAULT(7),  VENT_DAMPER_DEFAULT(8),
+            VENT_DAMPER_DEFAULT(9),  VENT_DAMPER_DEFAULT(10),
+        }
+    }
+};
+
+static uint16 damperPosition = VENT_DAMPER_POSITION_NONE;
+
+/* Move-then-release state, times in ms from VentTimer */
+static uint8  damperEnergised;
+static uint32 damperMoveTime;
+static uint32 damperEnergiseTime;
+static uint32 damperReleaseTime;
+static uint32 damperSettle = VENT_DAMPER_SETTLE_MS;
+static uint32 damperRefresh = VENT_DAMPER_REFRESH_MS;
+static VENT_DAMPER_STATS_T damperStats;
+
+/***************************************************************
+ * Calibration table in use. Read through a volatile pointer so
+ * the compiler does not fold the flash contents at build time.
+ **************************************************************/
+static const volatile VENT_DAMPER_CAL_T *VentDamper_GetCal(void)
+{
+    const volatile VENT_DAMPER_CAL_T *cal = &ventDamperCalRow.cal;
+
+    return (cal->magic == VENT_DAMPER_CAL_MAGIC) ? cal : 0;
+}
+
+/***************************************************************
+ * PWM_Servo compare value for a position in permille
+ **************************************************************/
+uint16 VentDamper_ToCompare(uint16 position)
+{
+    const volatile VENT_DAMPER_CAL_T *cal = VentDamper_GetCal();
+    uint8 seg;
+    int32 lo, hi, frac;
+
+    if (position > VENT_DAMPER_POSITION_MAX)
+        position = VENT_DAMPER_POSITION_MAX;
+
+    seg = (uint8)(position / VENT_DAMPER_CAL_STEP);
+    frac = (int32)(position % VENT_DAMPER_CAL_STEP);
+
+    if (seg >= (VENT_DAMPER_CAL_POINTS - 1u))
+    {
+        seg = VENT_DAMPER_CAL_POINTS - 2u;
+        frac = VENT_DAMPER_CAL_STEP;
+    }
+
+    if (cal != 0)
+    {
+        lo = cal->compare[seg];
+        hi = cal->compare[seg + 1u];
+    }
+    else
+    {
+        /* Erased or damaged row, fall back to the default servo */
+        lo = VENT_DAMPER_DEFAULT(seg);
+        hi = VENT_DAMPER_DEFAULT(seg + 1u);
+    }
+
+    /* Table may run either way, keep the interpolation signed */
+    return (uint16)(lo + (((hi - lo) * frac) / (int32)VENT_DAMPER_CAL_STEP));
+}
+
+/***************************************************************
+ * Start driving the servo pin, the compare value must already
+ * be set
+ **************************************************************/
+static void VentDamper_Energise(uint32 now)
+{
+    if (!damperEnergised)
+    {
+        PWM_Servo_Enable();
+        Servo_SetDriveMode(Servo_DM_STRONG);
+        damperEnergised = 1;
+        damperEnergiseTime = now;
+    }
+    damperMoveTime = now;
+}
+
+/***************************************************************
+ * Stop the PWM and leave the servo pin floating
+ **************************************************************/
+static void VentDamper_Release(uint32 now)
+{
+    Servo_SetDriveMode(Servo_DM_ALG_HIZ);
+    PWM_Servo_Stop();
+
+    if (damperEnergised)
+    {
+        damperStats.driveTime += now - damperEnergiseTime;
+    }
+    damperEnergised = 0;
+    damperReleaseTime = now;
+}
+
+/***************************************************************
+ * Initialise the PWM with the servo released
+ **************************************************************/
+void VentDamper_Start(void)
+{
+    PWM_Servo_Init();
+    VentDamper_Release(VentTimer_GetTimeStamp());
+}
+
+/***************************************************************
+ * Change the settle and refresh times
+ **************************************************************/
+void VentDamper_SetTiming(uint32 settleTime, uint32 refreshTime)
+{
+    damperSettle = settleTime;
+    damperRefresh = refreshTime;
+}
+
+/***************************************************************
+ * Release the servo once it settled, handle the refresh
+ **************************************************************/
+void VentDamper_Process(uint32 now)
+{
+    uint8 intState;
+
+    /* The motion ISR may drive the servo at any time */
+    intState = CyEnterCriticalSection();
+    if (damperEnergised)
+    {
+        if ((uint32)(now - damperMoveTime) >= damperSettle)
+        {
+            VentDamper_Release(now);
+        }
+    }
+    else if ((damperRefresh != 0u) && (damperPosition != VENT_DAMPER_POSITION_NONE) &&
+             ((uint32)(now - damperReleaseTime) >= damperRefresh))
+    {
+        damperStats.refreshes++;
+        VentDamper_Energise(now);
+    }
+    CyExitCriticalSection(intState);
+}
+
+/***************************************************************
+ * Returns non-zero while the PWM drives the servo
+ **************************************************************/
+uint8 VentDamper_IsEnergised(void)
+{
+    return damperEnergised;
+}
+
+/***************************************************************
+ * Drive statistics since reset
+ **************************************************************/
+const VENT_DAMPER_STATS_T *VentDamper_GetStats(void)
+{
+    return &damperStats;
+}
+
+/***************************************************************
+ * Drive the servo to a position without counting a new move
+ **************************************************************/
+void VentDamper_Drive(uint16 position)
+{
+    if (position > VENT_DAMPER_POSITION_MAX)
+        position = VENT_DAMPER_POSITION_MAX;
+
+    PWM_Servo_WriteCompare(VentDamper_ToCompare(position));
+    damperPosition = position;
+    VentDamper_Energise(VentTimer_GetTimeStamp());
+}
+
+/***************************************************************
+ * Drive the servo to a position in permille, it is released
+ * again by VentDamper_Process() after the settle time
+ **************************************************************/
+void VentDamper_SetPosition(uint16 position)
+{
+    damperStats.moves++;
+    VentDamper_Drive(position);
+}
+
+/***************************************************************
+ * Last commanded position
+ **************************************************************/
+uint16 VentDamper_GetPosition(void)
+{
+    return damperPosition;
+}
+
+/***************************************************************
+ * Write a per-unit table to flash
+ **************************************************************/
+uint32 VentDamper_SaveCalibration(const uint16 compare[VENT_DAMPER_CAL_POINTS])
+{
+    VENT_DAMPER_CAL_ROW_T rowData;
+    uint32 rowNum;
+
+    memset(rowData.row, 0, sizeof(rowData.row));
+    rowData.cal.magic = VENT_DAMPER_CAL_MAGIC;
+    memcpy(rowData.cal.compare, compare, sizeof(rowData.cal.compare));
+
+    rowNum = (uint32)((const uint8 *)&ventDamperCalRow - (const uint8 *)CY_FLASH_BASE) / CY_FLASH_SIZEOF_ROW;
+    return CySysFlashWriteRow(rowNum, rowData.row);
+}
+
+/* [] END OF FILE */
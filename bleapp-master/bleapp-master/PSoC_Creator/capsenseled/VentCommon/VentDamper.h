@@ -0,0 +1,118 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#ifndef _VENT_DAMPER_H_
+#define _VENT_DAMPER_H_
+
+#include <project.h>
+#include "VentTimer.h"
+
+/* Damper position range, 0 = closed, 1000 = fully open */
+#define VENT_DAMPER_POSITION_MAX    (1000u)
+#define VENT_DAMPER_POSITION_NONE   (0xFFFFu)
+
+/* The servo is driven this long after a move, then the PWM is stopped
+   and the pin released so it stops drawing holding current (ms) */
+#define VENT_DAMPER_SETTLE_MS       (600u)
+
+/* Re-drive the last position this often to correct drift, 0 = never (ms) */
+#define VENT_DAMPER_REFRESH_MS      (0u)
+
+/* Calibration points, one every 100 permille */
+#define VENT_DAMPER_CAL_POINTS      (11u)
+#define VENT_DAMPER_CAL_STEP        (VENT_DAMPER_POSITION_MAX / (VENT_DAMPER_CAL_POINTS - 1u))
+#define VENT_DAMPER_CAL_MAGIC       (0xDA3Eu)
+
+/* PWM_Servo compare values of the default servo at both ends of travel */
+#define VENT_DAMPER_DEFAULT_CLOSED  (4315u)
+#define VENT_DAMPER_DEFAULT_OPEN    (4475u)
+
+/* The Servo characteristic still carries the old 0-5 steps */
+#define VENT_DAMPER_LEGACY_STEPS    (5u)
+#define VENT_DAMPER_FROM_STEP(step) ((uint16)((step) * (VENT_DAMPER_POSITION_MAX / VENT_DAMPER_LEGACY_STEPS)))
+
+/* Calibration record, stored at the start of its own flash row */
+typedef struct
+{
+    uint16 magic;
+    uint16 compare[VENT_DAMPER_CAL_POINTS];
+} VENT_DAMPER_CAL_T;
+
+/* Drive statistics, multiply driveTime by the servo current to
+   estimate the energy spent per move */
+typedef struct
+{
+    uint32 moves;
+    uint32 refreshes;
+    uint32 driveTime;
+} VENT_DAMPER_STATS_T;
+
+/***************************************************************
+ * Initialise the PWM with the servo released. Replaces
+ * PWM_Servo_Start(), VentTimer_Start() must run first.
+ **************************************************************/
+void VentDamper_Start(void);
+
+/***************************************************************
+ * Change the settle and refresh times (ms), refresh 0 = never
+ **************************************************************/
+void VentDamper_SetTiming(uint32 settleTime, uint32 refreshTime);
+
+/***************************************************************
+ * Release the servo once it settled and handle the periodic
+ * refresh, call from the main loop
+ **************************************************************/
+void VentDamper_Process(uint32 now);
+
+/***************************************************************
+ * Returns non-zero while the PWM drives the servo. HFCLK must
+ * stay on until it returns zero.
+ **************************************************************/
+uint8 VentDamper_IsEnergised(void);
+
+/***************************************************************
+ * Drive statistics since reset
+ **************************************************************/
+const VENT_DAMPER_STATS_T *VentDamper_GetStats(void);
+
+/***************************************************************
+ * Drive the servo to a position in permille, values above
+ * VENT_DAMPER_POSITION_MAX are clamped
+ **************************************************************/
+void VentDamper_SetPosition(uint16 position);
+
+/***************************************************************
+ * Same as VentDamper_SetPosition() for the intermediate steps
+ * of a move, does not count as a new move
+ **************************************************************/
+void VentDamper_Drive(uint16 position);
+
+/***************************************************************
+ * Last commanded position, VENT_DAMPER_POSITION_NONE if the
+ * servo has not been moved since reset
+ **************************************************************/
+uint16 VentDamper_GetPosition(void);
+
+/***************************************************************
+ * PWM_Servo compare value for a position in permille
+ **************************************************************/
+uint16 VentDamper_ToCompare(uint16 position);
+
+/***************************************************************
+ * Write a per-unit table to flash. Stalls the CPU for the
+ * duration of the row write, call while the link is idle.
+ * Returns CY_SYS_FLASH_SUCCESS or the CySysFlashWriteRow error.
+ **************************************************************/
+uint32 VentDamper_SaveCalibration(const uint16 compare[VENT_DAMPER_CAL_POINTS]);
+
+#endif /* _VENT_DAMPER_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,292 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#include "VentLog.h"
+#include <string.h>
+
+/* Largest encoded record, four varints of at most 5 bytes */
+#define VENT_LOG_MAX_RECORD         (20u)
+
+#define VENT_LOG_PAYLOAD            (CY_FLASH_SIZEOF_ROW - sizeof(VENT_LOG_ROW_HEADER_T))
+
+typedef union
+{
+    VENT_LOG_ROW_HEADER_T header;
+    uint8 bytes[CY_FLASH_SIZEOF_ROW];
+} VENT_LOG_ROW_T;
+
+/* Log area in flash. The non-zero initialiser keeps it out of .bss,
+   row 0 still reads as invalid because its magic does not match. */
+static const VENT_LOG_ROW_T CY_ALIGN(CY_FLASH_SIZEOF_ROW) logFlash[VENT_LOG_ROWS] =
+{
+    { { 0xFFFFu, 0u, 0u, 0u, 0u, { 0u, 0, 0u, 0 } } }
+};
+
+/* Row being filled in RAM */
+static VENT_LOG_ROW_T logRow;
+static VENT_LOG_RECORD_T logLast;
+static uint8 logWriteRow;
+static uint32 logSequence;
+
+static VENT_LOG_STATS_T logStats;
+
+/* Download in progress. Slot 0 is row snapRow, the slots from
+   snapNext to snapCount are still to be read and stay untouched. */
+static uint8 downloadActive;
+static uint8 snapRow;
+static uint8 snapCount;
+static uint8 snapNext;
+static uint32 downloadStart;
+static uint32 downloadSeen;
+static uint32 downloadBytes;
+
+/***************************************************************
+ * Row in flash, read through a volatile pointer so the compiler
+ * does not fold the build-time contents
+ **************************************************************/
+static const volatile VENT_LOG_ROW_T *VentLog_FlashRow(uint8 row)
+{
+    return &logFlash[row];
+}
+
+/***************************************************************
+ * Bytes a row occupies in the log stream, 0 if it is unused
+ **************************************************************/
+static uint32 VentLog_RowSize(uint8 row)
+{
+    const volatile VENT_LOG_ROW_T *r = VentLog_FlashRow(row);
+
+    if ((r->header.magic != VENT_LOG_ROW_MAGIC) || (r->header.length > VENT_LOG_PAYLOAD))
+        return 0;
+    return sizeof(VENT_LOG_ROW_HEADER_T) + r->header.length;
+}
+
+/***************************************************************
+ * Non-zero if the row belongs to the running download and has
+ * not been read yet
+ **************************************************************/
+static uint8 VentLog_Frozen(uint8 row)
+{
+    uint8 slot = (uint8)((row + VENT_LOG_ROWS - snapRow) % VENT_LOG_ROWS);
+
+    return (uint8)(downloadActive && (slot >= snapNext) && (slot < snapCount));
+}
+
+/***************************************************************
+ * Append an unsigned varint, returns the bytes used
+ **************************************************************/
+static uint8 VentLog_PutVarint(uint8 *p, uint32 value)
+{
+    uint8 n = 0;
+
+    while (value >= 0x80u)
+    {
+        p[n++] = (uint8)(value | 0x80u);
+        value >>= 7;
+    }
+    p[n++] = (uint8)value;
+    return n;
+}
+
+/***************************************************************
+ * Append a signed delta as a zigzag varint
+ **************************************************************/
+static uint8 VentLog_PutDelta(uint8 *p, int32 delta)
+{
+    return VentLog_PutVarint(p, ((uint32)delta << 1) ^ (uint32)(delta >> 31));
+}
+
+/***************************************************************
+ * Find the newest row in flash and continue after it
+ **************************************************************/
+void VentLog_Start(void)
+{
+    const volatile VENT_LOG_ROW_T *r;
+    uint32 newest = 0;
+    uint8 i;
+
+    logWriteRow = 0;
+    for (i = 0; i < VENT_LOG_ROWS; i++)
+    {
+        r = VentLog_FlashRow(i);
+        if ((VentLog_RowSize(i) != 0u) && (r->header.sequence > newest))
+        {
+            newest = r->header.sequence;
+            logWriteRow = (uint8)((i + 1u) % VENT_LOG_ROWS);
+        }
+    }
+    logSequence = newest + 1u;
+    logRow.header.count = 0;
+}
+
+/***************************************************************
+ * Write the partly filled row now
+ **************************************************************/
+void VentLog_Flush(void)
+{
+    uint32 rowNum;
+
+    if ((logRow.header.count == 0u) || VentLog_Frozen(logWriteRow))
+        return;
+
+    logRow.header.magic = VENT_LOG_ROW_MAGIC;
+    logRow.header.sequence = logSequence;
+    memset(&logRow.bytes[sizeof(VENT_LOG_ROW_HEADER_T) + logRow.header.length], 0,
+           VENT_LOG_PAYLOAD - logRow.header.length);
+
+    rowNum = (uint32)((const uint8 *)&logFlash[logWriteRow] - (const uint8 *)CY_FLASH_BASE) / CY_FLASH_SIZEOF_ROW;
+    if (CySysFlashWriteRow(rowNum, logRow.bytes) == CY_SYS_FLASH_SUCCESS)
+    {
+        logStats.rowsWritten++;
+        logWriteRow = (uint8)((logWriteRow + 1u) % VENT_LOG_ROWS);
+        logSequence++;
+    }
+    logRow.header.count = 0;
+}
+
+/***************************************************************
+ * Add a record
+ **************************************************************/
+void VentLog_Append(const VENT_LOG_RECORD_T *record)
+{
+    uint8 encoded[VENT_LOG_MAX_RECORD];
+    uint8 n = 0;
+
+    if (logRow.header.count != 0u)
+    {
+        n += VentLog_PutVarint(&encoded[n], record->time - logLast.time);
+        n += VentLog_PutDelta(&encoded[n], (int32)record->temperature - logLast.temperature);
+        n += VentLog_PutDelta(&encoded[n], (int32)record->position - logLast.position);
+        n += VentLog_PutDelta(&encoded[n], (int32)record->pressure - logLast.pressure);
+
+        if ((logRow.header.length + n) > VENT_LOG_PAYLOAD)
+        {
+            /* The row it would overwrite is still to be downloaded */
+            if (VentLog_Frozen(logWriteRow))
+            {
+                logStats.recordsDropped++;
+                return;
+            }
+            VentLog_Flush();
+        }
+    }
+
+    if (logRow.header.count == 0u)
+    {
+        logRow.header.first = *record;
+        logRow.header.length = 0;
+        logRow.header.reserved = 0;
+    }
+    else
+    {
+        memcpy(&logRow.bytes[sizeof(VENT_LOG_ROW_HEADER_T) + logRow.header.length], encoded, n);
+        logRow.header.length += n;
+    }
+    logRow.header.count++;
+    logLast = *record;
+    logStats.recordsWritten++;
+}
+
+/***************************************************************
+ * Start a download, the log is frozen as it is
+ **************************************************************/
+void VentLog_DownloadStart(uint32 now)
+{
+    /* The row in RAM goes to flash first, so the download only
+       serves rows that do not change */
+    downloadActive = 0;
+    VentLog_Flush();
+
+    /* Rows never written lead the ring from the write position,
+       the used ones follow oldest first */
+    snapRow = logWriteRow;
+    snapCount = VENT_LOG_ROWS;
+    while ((snapCount != 0u) && (VentLog_RowSize(snapRow) == 0u))
+    {
+        snapRow = (uint8)((snapRow + 1u) % VENT_LOG_ROWS);
+        snapCount--;
+    }
+    snapNext = 0;
+    downloadStart = now;
+    downloadSeen = now;
+    downloadBytes = 0;
+    downloadActive = 1;
+}
+
+/***************************************************************
+ * Copy the row of a download slot
+ **************************************************************/
+uint16 VentLog_DownloadRow(uint16 slot, uint8 *buffer, uint32 now)
+{
+    const volatile VENT_LOG_ROW_T *r;
+    uint16 size, i;
+
+    if (!downloadActive)
+        return 0;
+
+    downloadSeen = now;
+    if (slot >= snapCount)
+    {
+        snapNext = snapCount;
+        return 0;
+    }
+    if (slot > snapNext)
+        snapNext = (uint8)slot;
+
+    /* A row lost to a failed write keeps its slot, the reader skips
+       it on the magic */
+    r = VentLog_FlashRow((uint8)((snapRow + slot) % VENT_LOG_ROWS));
+    size = (uint16)VentLog_RowSize((uint8)((snapRow + slot) % VENT_LOG_ROWS));
+    if (size == 0u)
+        size = sizeof(VENT_LOG_ROW_HEADER_T);
+
+    for (i = 0; i < size; i++)
+    {
+        buffer[i] = r->bytes[i];
+    }
+    downloadBytes += size;
+    return size;
+}
+
+/***************************************************************
+ * End the download
+ **************************************************************/
+void VentLog_DownloadEnd(uint32 now)
+{
+    if (!downloadActive)
+        return;
+
+    logStats.downloadBytes = downloadBytes;
+    logStats.downloadTime = now - downloadStart;
+    downloadActive = 0;
+}
+
+/***************************************************************
+ * End a download left idle
+ **************************************************************/
+uint8 VentLog_DownloadProcess(uint32 now)
+{
+    if (downloadActive && ((uint32)(now - downloadSeen) > VENT_LOG_DOWNLOAD_TIMEOUT))
+    {
+        VentLog_DownloadEnd(now);
+    }
+    return downloadActive;
+}
+
+/***************************************************************
+ * Write and download statistics
+ **************************************************************/
+const VENT_LOG_STATS_T *VentLog_GetStats(void)
+{
+    return &logStats;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,115 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#ifndef _VENT_LOG_H_
+#define _VENT_LOG_H_
+
+#include <project.h>
+
+/* Flash rows reserved for the history, used round robin so every row
+   sees the same number of erase cycles */
+#define VENT_LOG_ROWS               (32u)
+#define VENT_LOG_ROW_MAGIC          (0x4C47u)
+
+/* Log characteristic: the hub writes a slot number (uint16 LE) and
+   reads the row it selects with Read / Read Blob, header and payload as
+   stored. Slot 0 starts a download and freezes the log as it is, the
+   following slots run oldest row first, an empty value is the end. A
+   row without VENT_LOG_ROW_MAGIC was lost and is skipped by the reader.
+   VENT_LOG_SLOT_END closes the download. */
+#define VENT_LOG_SLOT_END           (0xFFFFu)
+#define VENT_LOG_SLOT_LEN           (2u)
+
+/* A download nobody reads from is closed after this (ms) */
+#define VENT_LOG_DOWNLOAD_TIMEOUT   (30000u)
+
+typedef struct
+{
+    uint32 time;            /* seconds */
+    int16  temperature;     /* 1/100 degC */
+    uint16 position;        /* permille */
+    int16  pressure;        /* Pa */
+} VENT_LOG_RECORD_T;
+
+/* Row header, the first record is stored here in full and the rest
+   follow as zigzag varint deltas from the previous record */
+typedef struct
+{
+    uint16 magic;
+    uint16 length;          /* bytes after the header */
+    uint32 sequence;
+    uint16 count;
+    uint16 reserved;
+    VENT_LOG_RECORD_T first;
+} VENT_LOG_ROW_HEADER_T;
+
+typedef struct
+{
+    uint32 rowsWritten;
+    uint32 recordsWritten;
+    uint32 recordsDropped;  /* the next row was still to be downloaded */
+    uint32 downloadBytes;
+    uint32 downloadTime;    /* ms, last download */
+} VENT_LOG_STATS_T;
+
+/***************************************************************
+ * Find the newest row in flash and continue after it
+ **************************************************************/
+void VentLog_Start(void);
+
+/***************************************************************
+ * Add a record, writes a flash row whenever one fills up.
+ * The row write stalls the CPU for a few ms.
+ **************************************************************/
+void VentLog_Append(const VENT_LOG_RECORD_T *record);
+
+/***************************************************************
+ * Write the partly filled row now, e.g. before a planned
+ * power down
+ **************************************************************/
+void VentLog_Flush(void);
+
+/***************************************************************
+ * Start a download: the row being filled is written out and
+ * the rows in flash are frozen. Until the download ends a row
+ * still to be read is never overwritten, records that would
+ * need it are dropped and counted.
+ **************************************************************/
+void VentLog_DownloadStart(uint32 now);
+
+/***************************************************************
+ * Copy the row of a download slot, oldest first, into buffer
+ * (CY_FLASH_SIZEOF_ROW bytes). Returns the bytes copied, 0 past
+ * the last row or without a download. Reading a slot releases
+ * the rows before it.
+ **************************************************************/
+uint16 VentLog_DownloadRow(uint16 slot, uint8 *buffer, uint32 now);
+
+/***************************************************************
+ * End the download, e.g. on VENT_LOG_SLOT_END or a disconnect
+ **************************************************************/
+void VentLog_DownloadEnd(uint32 now);
+
+/***************************************************************
+ * Call from the main loop, ends a download left idle for
+ * VENT_LOG_DOWNLOAD_TIMEOUT. Returns non-zero while one runs.
+ **************************************************************/
+uint8 VentLog_DownloadProcess(uint32 now);
+
+/***************************************************************
+ * Write and download statistics. Records per row are
+ * recordsWritten / rowsWritten.
+ **************************************************************/
+const VENT_LOG_STATS_T *VentLog_GetStats(void);
+
+#endif /* _VENT_LOG_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,408 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#include "VentMotion.h"
+
+/* Smoothstep curve resolution */
+#define VENT_MOTION_CURVE_SHIFT     (12u)
+#define VENT_MOTION_CURVE_ONE       (1L << VENT_MOTION_CURVE_SHIFT)
+
+typedef struct
+{
+    uint16 position;
+    VENT_MOTION_PROFILE_T profile;
+    uint16 frames;
+} VENT_MOTION_MOVE_T;
+
+/* Move queue, filled from the main loop and drained by the ISR */
+static VENT_MOTION_MOVE_T motionQueue[VENT_MOTION_QUEUE_LEN];
+static volatile uint8 queueHead;
+static volatile uint8 queueCount;
+
+/* Move in flight, positions and speeds in 1/256 permille */
+static volatile uint8 motionActive;
+static VENT_MOTION_PROFILE_T motionProfile;
+static int32 motionPos;
+static int32 motionSpeed;
+static int32 motionTarget;
+static int32 motionStart;
+static uint16 motionFrame;
+static uint16 motionFrames;
+static uint16 motionElapsed;
+static uint16 motionPeak;
+
+static int32 maxSpeed = (int32)VENT_MOTION_MAX_SPEED << VENT_MOTION_SHIFT;
+static int32 maxAccel = (int32)VENT_MOTION_MAX_ACCEL << VENT_MOTION_SHIFT;
+
+static VENT_MOTION_STATS_T motionStats;
+
+/***************************************************************
+ * Smallest n with n * n >= value, one bit of the root per pass
+ **************************************************************/
+static uint32 VentMotion_Sqrt(uint32 value)
+{
+    uint32 root = 0;
+    uint32 rem = value;
+    uint32 bit = 1uL << 30;
+
+    while (bit > rem)
+    {
+        bit >>= 2;
+    }
+    while (bit != 0u)
+    {
+        if (rem >= (root + bit))
+        {
+            rem -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    /* root is rounded down, a remainder means value is not a square */
+    return (rem != 0u) ? (root + 1u) : root;
+}
+
+/***************************************************************
+ * Frames of an S-curve move between two positions in
+ * 1/256 permille
+ **************************************************************/
+static uint16 VentMotion_SCurveFrames(int32 from, int32 to)
+{
+    int32 distance = to - from;
+    uint32 bySpeed, byAccel;
+
+    if (distance < 0)
+        distance = -distance;
+
+    /* Smoothstep peaks at 1.5 * distance / n speed and 6 * distance / n^2
+       acceleration, pick the shortest n that respects both limits */
+    bySpeed = (uint32)((3 * distance) / (2 * maxSpeed)) + 1u;
+    byAccel = VentMotion_Sqrt((uint32)((6 * distance) / maxAccel)) + 1u;
+
+    return (uint16)((bySpeed > byAccel) ? bySpeed : byAccel);
+}
+
+/***************************************************************
+ * Where the queued moves end, called with interrupts disabled
+ **************************************************************/
+static int32 VentMotion_QueueEnd(void)
+{
+    if (queueCount != 0u)
+        return (int32)motionQueue[(queueHead + queueCount - 1u) % VENT_MOTION_QUEUE_LEN].position << VENT_MOTION_SHIFT;
+    if (motionActive)
+        return motionTarget;
+    return (int32)VentDamper_GetPosition() << VENT_MOTION_SHIFT;
+}
+
+/***************************************************************
+ * Start or stop the frame interrupt
+ **************************************************************/
+static void VentMotion_RunTimer(uint8 run)
+{
+    CySysWdtUnlock();
+    if (run)
+    {
+        CySysWdtEnable(VENT_MOTION_COUNTER_MASK);
+    }
+    else
+    {
+        CySysWdtDisable(VENT_MOTION_COUNTER_MASK);
+    }
+    CySysWdtLock();
+}
+
+/***************************************************************
+ * Begin a move from the current position, called with
+ * interrupts disabled. frames is the S-curve length.
+ **************************************************************/
+static void VentMotion_Begin(uint16 position, VENT_MOTION_PROFILE_T profile, uint16 frames)
+{
+    if (!motionActive)
+    {
+        motionPos = (int32)VentDamper_GetPosition() << VENT_MOTION_SHIFT;
+        motionSpeed = 0;
+        motionPeak = 0;
+        motionElapsed = 0;
+        VentMotion_RunTimer(1);
+    }
+
+    motionTarget = (int32)position << VENT_MOTION_SHIFT;
+    motionProfile = profile;
+    motionActive = 1;
+
+    if (profile == VENT_MOTION_SCURVE)
+    {
+        motionStart = motionPos;
+        motionSpeed = 0;
+        motionFrame = 0;
+        motionFrames = frames;
+    }
+}
+
+/***************************************************************
+ * Distance covered while braking from speed to standstill
+ **************************************************************/
+static int32 VentMotion_StopDistance(int32 speed)
+{
+    return (speed > 0) ? ((speed * (speed + maxAccel)) / (2 * maxAccel)) : 0;
+}
+
+/***************************************************************
+ * One trapezoid frame, returns non-zero when the target is hit
+ **************************************************************/
+static uint8 VentMotion_StepTrapezoid(void)
+{
+    int32 distance = motionTarget - motionPos;
+    int32 dir = (distance < 0) ? -1 : 1;
+    int32 toward = motionSpeed * dir;
+    int32 remain = distance * dir;
+    int32 speed;
+
+    if ((remain <= maxAccel) && (toward <= maxAccel) && (toward >= -maxAccel))
+    {
+        motionPos = motionTarget;
+        motionSpeed = 0;
+        return 1;
+    }
+
+    /* Fastest of accelerate, cruise or brake that can still stop at the
+       target. If none can (a preemption reversed the target) keep braking,
+       the damper overshoots and comes back. */
+    speed = toward + maxAccel;
+    if (speed > maxSpeed)
+        speed = maxSpeed;
+    if ((speed + VentMotion_StopDistance(speed - maxAccel)) > remain)
+    {
+        speed = (toward < maxSpeed) ? toward : maxSpeed;
+        if ((speed + VentMotion_StopDistance(speed - maxAccel)) > remain)
+        {
+            speed = toward - maxAccel;
+        }
+    }
+
+    motionSpeed = speed * dir;
+    motionPos += motionSpeed;
+    return 0;
+}
+
+/***************************************************************
+ * One S-curve frame, returns non-zero when the target is hit
+ **************************************************************/
+static uint8 VentMotion_StepSCurve(void)
+{
+    int32 u, s, last = motionPos;
+
+    motionFrame++;
+    if (motionFrame >= motionFrames)
+    {
+        motionPos = motionTarget;
+        motionSpeed = 0;
+        return 1;
+    }
+
+    /* s = 3u^2 - 2u^3 */
+    u = ((int32)motionFrame << VENT_MOTION_CURVE_SHIFT) / motionFrames;
+    s = ((u * u) >> VENT_MOTION_CURVE_SHIFT) * ((3 * VENT_MOTION_CURVE_ONE) - (2 * u)) >> VENT_MOTION_CURVE_SHIFT;
+
+    motionPos = motionStart + (((motionTarget - motionStart) * s) >> VENT_MOTION_CURVE_SHIFT);
+    motionSpeed = motionPos - last;
+    return 0;
+}
+
+/***************************************************************
+ * Frame interrupt, steps the profile and starts the next move
+ **************************************************************/
+static void VentMotion_Isr(void)
+{
+    int32 last = motionPos;
+    int32 step;
+    uint8 done;
+
+    if (!motionActive)
+    {
+        VentMotion_RunTimer(0);
+        return;
+    }
+
+    done = (motionProfile == VENT_MOTION_SCURVE) ? VentMotion_StepSCurve() : VentMotion_StepTrapezoid();
+
+    step = motionPos - last;
+    if (step < 0)
+        step = -step;
+    step >>= VENT_MOTION_SHIFT;
+    if (step > motionPeak)
+        motionPeak = (uint16)step;
+    motionElapsed++;
+
+    if (motionPos < 0)
+        motionPos = 0;
+    if (motionPos > ((int32)VENT_DAMPER_POSITION_MAX << VENT_MOTION_SHIFT))
+        motionPos = (int32)VENT_DAMPER_POSITION_MAX << VENT_MOTION_SHIFT;
+
+    VentDamper_Drive((uint16)((motionPos + (1L << (VENT_MOTION_SHIFT - 1u))) >> VENT_MOTION_SHIFT));
+
+    if (done)
+    {
+        motionStats.frames = motionElapsed;
+        motionStats.peakStep = motionPeak;
+        motionActive = 0;
+
+        if (queueCount != 0u)
+        {
+            VENT_MOTION_MOVE_T *next = &motionQueue[queueHead];
+
+            queueHead = (uint8)((queueHead + 1u) % VENT_MOTION_QUEUE_LEN);
+            queueCount--;
+            VentMotion_Begin(next->position, next->profile, next->frames);
+        }
+        else
+        {
+            VentMotion_RunTimer(0);
+        }
+    }
+}
+
+/***************************************************************
+ * Hook the WDT counter
+ **************************************************************/
+void VentMotion_Start(void)
+{
+    CySysWdtUnlock();
+    CySysWdtSetMode(VENT_MOTION_COUNTER, CY_SYS_WDT_MODE_INT);
+    CySysWdtSetMatch(VENT_MOTION_COUNTER, VENT_MOTION_FRAME_TICKS);
+    CySysWdtSetClearOnMatch(VENT_MOTION_COUNTER, 1u);
+    CySysWdtLock();
+    CySysWdtSetInterruptCallback(VENT_MOTION_COUNTER, VentMotion_Isr);
+}
+
+/***************************************************************
+ * Speed and acceleration limits
+ **************************************************************/
+void VentMotion_SetLimits(uint32 speed, uint32 accel)
+{
+    uint8 intState;
+
+    intState = CyEnterCriticalSection();
+    maxSpeed = (speed != 0u) ? (int32)speed : 1;
+    maxAccel = (accel != 0u) ? (int32)accel : 1;
+    CyExitCriticalSection(intState);
+}
+
+/***************************************************************
+ * Drop any queued moves and retarget the move in flight
+ **************************************************************/
+void VentMotion_MoveTo(uint16 position, VENT_MOTION_PROFILE_T profile)
+{
+    uint8 intState;
+    uint16 frames = 0;
+    int32 from;
+
+    if (position > VENT_DAMPER_POSITION_MAX)
+        position = VENT_DAMPER_POSITION_MAX;
+
+    /* Only the position is sampled under the lock, the S-curve length is
+       worked out with interrupts on. The ISR may step once in between,
+       which moves the start by less than one frame of travel. */
+    if (profile == VENT_MOTION_SCURVE)
+    {
+        intState = CyEnterCriticalSection();
+        from = motionActive ? motionPos : ((int32)VentDamper_GetPosition() << VENT_MOTION_SHIFT);
+        CyExitCriticalSection(intState);
+        frames = VentMotion_SCurveFrames(from, (int32)position << VENT_MOTION_SHIFT);
+    }
+
+    intState = CyEnterCriticalSection();
+    queueCount = 0;
+
+    if (VentDamper_GetPosition() == VENT_DAMPER_POSITION_NONE)
+    {
+        /* Nothing to ramp from after reset, jump there */
+        VentDamper_SetPosition(position);
+    }
+    else
+    {
+        /* Count the move and hold the current position until the first frame */
+        VentDamper_SetPosition(VentDamper_GetPosition());
+        VentMotion_Begin(position, profile, frames);
+    }
+    CyExitCriticalSection(intState);
+}
+
+/***************************************************************
+ * Run a move after the ones already queued
+ **************************************************************/
+uint8 VentMotion_Queue(uint16 position, VENT_MOTION_PROFILE_T profile)
+{
+    uint8 intState;
+    uint8 queued = 1;
+    uint16 frames = 0;
+    int32 from;
+
+    if (position > VENT_DAMPER_POSITION_MAX)
+        position = VENT_DAMPER_POSITION_MAX;
+
+    /* An S-curve move starts where the queue ends. The ISR only takes
+       moves off the front, so that end holds until the move is added. */
+    if (profile == VENT_MOTION_SCURVE)
+    {
+        intState = CyEnterCriticalSection();
+        from = VentMotion_QueueEnd();
+        CyExitCriticalSection(intState);
+        frames = VentMotion_SCurveFrames(from, (int32)position << VENT_MOTION_SHIFT);
+    }
+
+    intState = CyEnterCriticalSection();
+    if (!motionActive && (queueCount == 0u))
+    {
+        CyExitCriticalSection(intState);
+        VentMotion_MoveTo(position, profile);
+        return 1;
+    }
+
+    if (queueCount < VENT_MOTION_QUEUE_LEN)
+    {
+        VENT_MOTION_MOVE_T *move = &motionQueue[(queueHead + queueCount) % VENT_MOTION_QUEUE_LEN];
+
+        move->position = position;
+        move->profile = profile;
+        move->frames = frames;
+        queueCount++;
+    }
+    else
+    {
+        queued = 0;
+    }
+    CyExitCriticalSection(intState);
+    return queued;
+}
+
+/***************************************************************
+ * Returns non-zero while a move is in flight or queued
+ **************************************************************/
+uint8 VentMotion_IsBusy(void)
+{
+    return (uint8)(motionActive || (queueCount != 0u));
+}
+
+/***************************************************************
+ * Statistics of the last completed move
+ **************************************************************/
+const VENT_MOTION_STATS_T *VentMotion_GetStats(void)
+{
+    return &motionStats;
+}
+
+/* [] END OF FILE */
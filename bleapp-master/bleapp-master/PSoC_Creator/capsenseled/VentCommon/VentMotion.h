@@ -0,0 +1,88 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#ifndef _VENT_MOTION_H_
+#define _VENT_MOTION_H_
+
+#include <project.h>
+#include "VentDamper.h"
+
+/* WDT counter stepping the profile once per servo frame. Runs from LFCLK
+   and is only enabled while a move is in flight. */
+#define VENT_MOTION_COUNTER         CY_SYS_WDT_COUNTER0
+#define VENT_MOTION_COUNTER_MASK    CY_SYS_WDT_COUNTER0_MASK
+
+/* One step per 20 ms servo frame */
+#define VENT_MOTION_FRAME_TICKS     (VENT_TIMER_LFCLK_HZ / 50u)
+
+/* Positions are stepped in 1/256 permille */
+#define VENT_MOTION_SHIFT           (8u)
+
+/* Default limits, full travel in about 2.2 s */
+#define VENT_MOTION_MAX_SPEED       (10u)   /* permille per frame */
+#define VENT_MOTION_MAX_ACCEL       (1u)    /* permille per frame per frame */
+
+/* Moves waiting behind the one in flight */
+#define VENT_MOTION_QUEUE_LEN       (4u)
+
+typedef enum
+{
+    /* Constant acceleration, cruise, constant deceleration */
+    VENT_MOTION_TRAPEZOID,
+
+    /* Smoothstep position curve, no acceleration steps at either end */
+    VENT_MOTION_SCURVE
+} VENT_MOTION_PROFILE_T;
+
+/* Statistics of the last completed move */
+typedef struct
+{
+    uint16 frames;
+    uint16 peakStep;
+} VENT_MOTION_STATS_T;
+
+/***************************************************************
+ * Hook the WDT counter, VentDamper_Start() must run first
+ **************************************************************/
+void VentMotion_Start(void);
+
+/***************************************************************
+ * Speed and acceleration limits in 1/256 permille per frame
+ * and per frame squared
+ **************************************************************/
+void VentMotion_SetLimits(uint32 maxSpeed, uint32 maxAccel);
+
+/***************************************************************
+ * Drop any queued moves and retarget the move in flight.
+ * A trapezoid move keeps its current speed, an S-curve move
+ * restarts from the current position.
+ **************************************************************/
+void VentMotion_MoveTo(uint16 position, VENT_MOTION_PROFILE_T profile);
+
+/***************************************************************
+ * Run a move after the ones already queued. Returns 0 if the
+ * queue is full.
+ **************************************************************/
+uint8 VentMotion_Queue(uint16 position, VENT_MOTION_PROFILE_T profile);
+
+/***************************************************************
+ * Returns non-zero while a move is in flight or queued
+ **************************************************************/
+uint8 VentMotion_IsBusy(void);
+
+/***************************************************************
+ * Statistics of the last completed move
+ **************************************************************/
+const VENT_MOTION_STATS_T *VentMotion_GetStats(void);
+
+#endif /* _VENT_MOTION_H_ */
+
+/* [] END OF FILE */
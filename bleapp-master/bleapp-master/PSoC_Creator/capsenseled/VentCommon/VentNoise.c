@@ -0,0 +1,377 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#include "VentNoise.h"
+#include "VentTimer.h"
+
+/* Goertzel coefficients 2cos(w) in Q13 */
+#define VENT_NOISE_COEFF_SHIFT      (13u)
+#define VENT_NOISE_COEFF_MASK       ((1uL << VENT_NOISE_COEFF_SHIFT) - 1u)
+
+#define VENT_NOISE_BUFFER_BYTES     (VENT_NOISE_FRAME * VENT_NOISE_BYTES_PER_SAMPLE)
+
+#ifdef VENT_NOISE_DMA
+#ifndef NoiseDma_CHANNEL
+#error "VENT_NOISE_DMA needs the NoiseDma component in TopDesign"
+#endif
+
+#define dmaChannel                  (NoiseDma_CHANNEL)
+#endif /* VENT_NOISE_DMA */
+
+/* Quarter sine wave in Q14, 64 steps */
+static const int16 sineTable[65] =
+{
+        0,   402,   804,  1205,  1606,  2006,  2404,  2801,
+     3196,  3590,  3981,  4370,  4756,  5139,  5520,  5897,
+     6270,  6639,  7005,  7366,  7723,  8076,  8423,  8765,
+     9102,  9434,  9760, 10080, 10394, 10702, 11003, 11297,
+    11585, 11866, 12140, 12406, 12665, 12916, 13160, 13395,
+    13623, 13842, 14053, 14256, 14449, 14635, 14811, 14978,
+    15137, 15286, 15426, 15557, 15679, 15791, 15893, 15986,
+    16069, 16143, 16207, 16261, 16305, 16340, 16364, 16379,
+    16384,
+};
+
+/* I2S bytes arrive MSB first, left then right channel */
+static uint8 sampleBuffer[2][VENT_NOISE_BUFFER_BYTES];
+static volatile uint8 readyMask;
+static uint8 nextBuffer;
+static uint8 started;
+
+/* Burst capture, frames left in the burst under way including the
+   one kept */
+static uint32 burstInterval;
+static uint32 burstTime;
+static volatile uint8 burstFrames;
+static volatile uint8 capturing;
+static uint32 frameTime;
+
+static int32 coeff[VENT_NOISE_BANDS];
+static uint8 level[VENT_NOISE_BANDS];
+static int32 dcMean;
+
+static VENT_NOISE_STATS_T stats;
+
+/***************************************************************
+ * sin of phase (full turn = 65536) in Q14, table with linear
+ * interpolation
+ **************************************************************/
+static int32 VentNoise_Sin(uint16 phase)
+{
+    uint16 quarter = (uint16)(phase & 0x3FFFu);
+    uint16 index, frac;
+    int32 value;
+
+    if (phase & 0x4000u)
+    {
+        quarter = (uint16)(0x4000u - quarter);
+    }
+    index = (uint16)(quarter >> 8);
+    frac = (uint16)(quarter & 0xFFu);
+    value = sineTable[index];
+    if (index < 64u)
+    {
+        value += ((sineTable[index + 1u] - value) * (int32)frac) >> 8;
+    }
+    return (phase & 0x8000u) ? -value : value;
+}
+
+#ifdef VENT_NOISE_DMA
+/***************************************************************
+ * Both buffers chain into each other, each raises the interrupt
+ **************************************************************/
+static void VentNoise_DmaDone(void)
+{
+    if (burstInterval != 0u)
+    {
+        /* Frames before the last one of a burst are dropped */
+        if (burstFrames > 1u)
+        {
+            burstFrames--;
+            nextBuffer ^= 1u;
+            return;
+        }
+        burstFrames = 0;
+        I2S_1_Stop();
+        capturing = 0;
+    }
+
+    if (readyMask & (1u << nextBuffer))
+    {
+        stats.overruns++;
+    }
+    readyMask |= (uint8)(1u << nextBuffer);
+    nextBuffer ^= 1u;
+}
+#endif /* VENT_NOISE_DMA */
+
+/***************************************************************
+ * Integer log2 in 1/4 steps
+ **************************************************************/
+static uint8 VentNoise_Log2(uint32 value, uint8 scale)
+{
+    uint8 msb = 0;
+
+    if (value == 0u)
+        return 0;
+    while ((value >> msb) > 1u)
+    {
+        msb++;
+    }
+    /* Next two bits below the leading one give the quarter steps */
+    return (uint8)(((msb + scale) << 2) |
+                   ((msb >= 2u) ? ((value >> (msb - 2u)) & 3u) : ((value << (2u - msb)) & 3u)));
+}
+
+/***************************************************************
+ * Goertzel over one band, returns its level
+ **************************************************************/
+static uint8 VentNoise_Band(const int16 *samples, int32 c)
+{
+    int32 s0, s1 = 0, s2 = 0;
+    int32 a, b, peak;
+    uint32 power;
+    uint8 shift = 0;
+    uint16 i;
+
+    for (i = 0; i < VENT_NOISE_FRAME; i++)
+    {
+        /* c * s1 in two halves, the full product overflows 32 bits */
+        s0 = samples[i] + c * (s1 >> VENT_NOISE_COEFF_SHIFT) +
+             ((c * (int32)((uint32)s1 & VENT_NOISE_COEFF_MASK)) >> VENT_NOISE_COEFF_SHIFT) - s2;
+        s2 = s1;
+        s1 = s0;
+    }
+
+    /* Scale the states to 15 bits, the shift comes back in the log */
+    peak = ((s1 < 0) ? -s1 : s1) | ((s2 < 0) ? -s2 : s2);
+    while ((peak >> shift) >= 0x4000)
+    {
+        shift++;
+    }
+    a = s1 >> shift;
+    b = s2 >> shift;
+    power = (uint32)(a * a) + (uint32)(b * b);
+    a = (c * a) >> VENT_NOISE_COEFF_SHIFT;
+    power -= (uint32)(a * b);
+    if ((int32)power < 0)
+    {
+        power = 0;
+    }
+    return VentNoise_Log2(power, (uint8)(2u * shift));
+}
+
+/***************************************************************
+ * Restart the capture into the buffer after the last one, frames
+ * is the length of the burst or 0 to run on
+ **************************************************************/
+static void VentNoise_Capture(uint8 frames)
+{
+#ifdef VENT_NOISE_DMA
+    CyDmaChDisable(dmaChannel);
+    CyDmaValidateDescriptor(dmaChannel, 0);
+    CyDmaValidateDescriptor(dmaChannel, 1);
+    CyDmaSetNextDescriptor(dmaChannel, nextBuffer);
+    CyDmaChEnable(dmaChannel);
+#endif /* VENT_NOISE_DMA */
+
+    burstFrames = frames;
+    capturing = 1;
+    frameTime = VentTimer_GetTimeStamp();
+    I2S_1_Start();
+    I2S_1_ClearRxFIFO();
+    I2S_1_EnableRx();
+}
+
+/***************************************************************
+ * Start I2S_1 and the double buffered DMA capture
+ **************************************************************/
+void VentNoise_Start(void)
+{
+#ifdef VENT_NOISE_DMA
+    cydma_init_struct config;
+    uint8 i;
+#endif /* VENT_NOISE_DMA */
+
+    VentNoise_SetBand(0, VENT_NOISE_BAND0_HZ);
+    VentNoise_SetBand(1, VENT_NOISE_BAND1_HZ);
+    VentNoise_SetBand(2, VENT_NOISE_BAND2_HZ);
+    VentNoise_SetBand(3, VENT_NOISE_BAND3_HZ);
+
+#ifdef VENT_NOISE_DMA
+    /* One byte per request from the 8 bit rx FIFO register into
+       alternating buffers */
+    config.numDataElements = VENT_NOISE_BUFFER_BYTES;
+    config.dataElementSize = CYDMA_BYTE;
+    config.srcDstTransferWidth = CYDMA_ELEMENT_ELEMENT;
+    config.addressIncrement = CYDMA_INC_DST_ADDR;
+    config.triggerType = CYDMA_PULSE;
+    config.transferMode = CYDMA_SINGLE_DATA_ELEMENT;
+    config.preemptable = CYDMA_PREEMPTABLE;
+    config.actions = CYDMA_CHAIN | CYDMA_GENERATE_IRQ;
+
+    /* The channel and its trigger route come from the fitter */
+    CyDmaEnable();
+    for (i = 0; i < 2; i++)
+    {
+        CyDmaSetConfiguration(dmaChannel, i, &config);
+        CyDmaSetSrcAddress(dmaChannel, i, (void *)I2S_1_RX_CH0_F0_PTR);
+        CyDmaSetDstAddress(dmaChannel, i, (void *)sampleBuffer[i]);
+        CyDmaValidateDescriptor(dmaChannel, i);
+    }
+    CyDmaSetNextDescriptor(dmaChannel, 0);
+    readyMask = 0;
+    nextBuffer = 0;
+
+    CyDmaSetInterruptCallback(dmaChannel, VentNoise_DmaDone);
+    CyDmaSetInterruptSourceMask(CyDmaGetInterruptSourceMask() | (1uL << dmaChannel));
+    CyIntEnable(CYDMA_INTR_NUMBER);
+    CyDmaChEnable(dmaChannel);
+
+    started = 1;
+    capturing = 1;
+    frameTime = VentTimer_GetTimeStamp();
+    I2S_1_Start();
+    I2S_1_ClearRxFIFO();
+    I2S_1_EnableRx();
+#endif /* VENT_NOISE_DMA */
+}
+
+/***************************************************************
+ * Continuous or burst capture
+ **************************************************************/
+void VentNoise_SetInterval(uint32 interval)
+{
+    uint8 intState;
+
+    if (!started)
+        return;
+
+    intState = CyEnterCriticalSection();
+    burstInterval = interval;
+    burstTime = VentTimer_GetTimeStamp();
+    if (interval == 0u)
+    {
+        if (!capturing)
+        {
+            VentNoise_Capture(0u);
+        }
+    }
+    CyExitCriticalSection(intState);
+}
+
+/***************************************************************
+ * Centre frequency of one band
+ **************************************************************/
+void VentNoise_SetBand(uint8 band, uint16 frequency)
+{
+    uint16 phase;
+
+    if (band >= VENT_NOISE_BANDS)
+        return;
+
+    /* 2cos(w) in Q13 is cos(w) in Q14, cos is sin a quarter turn on */
+    phase = (uint16)(((uint32)frequency << 16) / VENT_NOISE_SAMPLE_HZ);
+    coeff[band] = VentNoise_Sin((uint16)(phase + 0x4000u));
+}
+
+/***************************************************************
+ * Run the filter bank over a finished buffer
+ **************************************************************/
+uint8 VentNoise_Process(void)
+{
+    int16 samples[VENT_NOISE_FRAME];
+    const uint8 *raw;
+    uint8 buffer;
+    uint8 intState;
+    uint16 i;
+    uint8 b;
+
+    if ((burstInterval != 0u) && !capturing && (readyMask == 0u) &&
+        VentTimer_Elapsed(burstTime, burstInterval))
+    {
+        burstTime = VentTimer_GetTimeStamp();
+        VentNoise_Capture(VENT_NOISE_BURST_FRAMES);
+    }
+
+    if (readyMask == 0u)
+    {
+        /* The DMA trigger does not reach the channel, a burst is given up
+           so it does not keep the part out of Deep Sleep */
+        if (capturing && VentTimer_Elapsed(frameTime, VENT_NOISE_STALL_MS))
+        {
+            stats.stalls++;
+            frameTime = VentTimer_GetTimeStamp();
+            if (burstInterval != 0u)
+            {
+                intState = CyEnterCriticalSection();
+                I2S_1_Stop();
+                burstFrames = 0;
+                capturing = 0;
+                CyExitCriticalSection(intState);
+            }
+        }
+        return 0;
+    }
+    frameTime = VentTimer_GetTimeStamp();
+
+    /* The buffer finished last, the DMA is filling the other one */
+    buffer = (readyMask & (1u << (nextBuffer ^ 1u))) ? (uint8)(nextBuffer ^ 1u) : nextBuffer;
+    raw = sampleBuffer[buffer];
+
+    /* Left channel only, DC removed and scaled for the filters */
+    for (i = 0; i < VENT_NOISE_FRAME; i++)
+    {
+        int32 x = (int16)(((uint16)raw[i * VENT_NOISE_BYTES_PER_SAMPLE] << 8) |
+                          raw[i * VENT_NOISE_BYTES_PER_SAMPLE + 1u]);
+
+        dcMean += (x - (dcMean >> VENT_NOISE_DC_SHIFT));
+        samples[i] = (int16)((x - (dcMean >> VENT_NOISE_DC_SHIFT)) >> VENT_NOISE_INPUT_SHIFT);
+    }
+
+    /* The DMA may refill this buffer now */
+    intState = CyEnterCriticalSection();
+    readyMask &= (uint8)~(1u << buffer);
+    CyExitCriticalSection(intState);
+
+    for (b = 0; b < VENT_NOISE_BANDS; b++)
+    {
+        level[b] = VentNoise_Band(samples, coeff[b]);
+    }
+    stats.frames++;
+    return 1;
+}
+
+/***************************************************************
+ * Band energy of the last frame
+ **************************************************************/
+uint8 VentNoise_GetLevel(uint8 band)
+{
+    return (band < VENT_NOISE_BANDS) ? level[band] : 0u;
+}
+
+/***************************************************************
+ * Statistics since start
+ **************************************************************/
+const VENT_NOISE_STATS_T *VentNoise_GetStats(void)
+{
+    return &stats;
+}
+
+/***************************************************************
+ * I2S_1 capturing for the DMA
+ **************************************************************/
+uint8 VentNoise_IsBusy(void)
+{
+    return capturing;
+}
+
+/* [] END OF FILE */
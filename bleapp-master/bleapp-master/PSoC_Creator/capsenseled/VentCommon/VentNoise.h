@@ -0,0 +1,99 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#ifndef _VENT_NOISE_H_
+#define _VENT_NOISE_H_
+
+#include <project.h>
+
+/* I2S_1 receives 16 bit stereo, 64 bit frames, from a clock of
+   HFCLK / 94, that is about 3990 samples per second per channel */
+#define VENT_NOISE_SAMPLE_HZ        (CYDEV_BCLK__HFCLK__HZ / 94u / 2u / 64u)
+
+/* Samples per analysis frame, one DMA buffer (about 32 ms) */
+#define VENT_NOISE_FRAME            (128u)
+#define VENT_NOISE_BYTES_PER_SAMPLE (4u)
+
+/* In burst acquisition the microphone settles during the first frames
+   after its clock starts, only the last frame of a burst is analysed */
+#define VENT_NOISE_BURST_FRAMES     (2u)
+
+/* Capture with the DMA. Needs a DMA Channel component named NoiseDma in
+   TopDesign with tr_in wired to the I2S_1 rx_dma0 terminal, the fitter
+   then picks the channel and routes the trigger. The rx FIFO holds one
+   sample and I2S_1 has no interrupt wired, so without it the microphone
+   stays off and every band reads 0. Off until that is checked on a board.
+   A capture that delivers no frame counts as a stall. */
+/* #define VENT_NOISE_DMA */
+
+/* No frame for this long while capturing is a stall (ms, 8 frames) */
+#define VENT_NOISE_STALL_MS         (8u * VENT_NOISE_FRAME * 1000u / VENT_NOISE_SAMPLE_HZ)
+
+/* Input is scaled down before the filters so the states stay in 32 bits */
+#define VENT_NOISE_INPUT_SHIFT      (4u)
+
+/* DC removal, the mean follows the input by 1/2^shift per sample */
+#define VENT_NOISE_DC_SHIFT         (6u)
+
+/* Default bands: blade pass of the air handler and its harmonics, then
+   broadband airflow noise (Hz) */
+#define VENT_NOISE_BANDS            (4u)
+#define VENT_NOISE_BAND0_HZ         (120u)
+#define VENT_NOISE_BAND1_HZ         (250u)
+#define VENT_NOISE_BAND2_HZ         (500u)
+#define VENT_NOISE_BAND3_HZ         (1000u)
+
+typedef struct
+{
+    uint32 frames;
+    uint32 overruns;        /* frames dropped because Process was late */
+    uint32 stalls;          /* captures that delivered no frame */
+} VENT_NOISE_STATS_T;
+
+/***************************************************************
+ * Start I2S_1 and the double buffered DMA capture, only sets
+ * the bands without VENT_NOISE_DMA
+ **************************************************************/
+void VentNoise_Start(void);
+
+/***************************************************************
+ * Centre frequency of one band (Hz), takes effect next frame
+ **************************************************************/
+void VentNoise_SetBand(uint8 band, uint16 frequency);
+
+/***************************************************************
+ * Capture a burst every interval ms and stop I2S_1 in between,
+ * 0 for continuous capture. Bursts start from VentNoise_Process().
+ **************************************************************/
+void VentNoise_SetInterval(uint32 interval);
+
+/***************************************************************
+ * Run the filter bank over a finished buffer, returns 1 when
+ * new band levels are ready
+ **************************************************************/
+uint8 VentNoise_Process(void);
+
+/***************************************************************
+ * Band energy of the last frame in 1/4 log2 steps (~0.75 dB)
+ **************************************************************/
+uint8 VentNoise_GetLevel(uint8 band);
+
+const VENT_NOISE_STATS_T *VentNoise_GetStats(void);
+
+/***************************************************************
+ * Returns non-zero while I2S_1 and its DMA capture, the part
+ * must not enter Deep Sleep then
+ **************************************************************/
+uint8 VentNoise_IsBusy(void);
+
+#endif /* _VENT_NOISE_H_ */
+
+/* [] END OF FILE */
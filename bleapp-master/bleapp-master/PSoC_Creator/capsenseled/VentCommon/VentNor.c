@@ -0,0 +1,294 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#include "VentNor.h"
+
+#define VENT_NOR_HEADER_LEN         (4u)
+
+#ifdef VENT_NOR_DMA
+#if !defined(NorTxDma_CHANNEL) || !defined(NorRxDma_CHANNEL)
+#error "VENT_NOR_DMA needs the NorTxDma and NorRxDma components in TopDesign"
+#endif
+
+#define txChannel                   (NorTxDma_CHANNEL)
+#define rxChannel                   (NorRxDma_CHANNEL)
+#endif /* VENT_NOR_DMA */
+
+static volatile uint8 xferActive;
+
+/* Command and address, then the data phase from a second descriptor */
+static uint8 norHeader[VENT_NOR_HEADER_LEN];
+static const uint8 norFill = 0xFFu;
+#ifdef VENT_NOR_DMA
+static uint8 norSink;
+#endif /* VENT_NOR_DMA */
+
+#ifdef VENT_NOR_DMA
+/***************************************************************
+ * RX DMA finished, every byte has been clocked
+ **************************************************************/
+static void VentNor_DmaDone(void)
+{
+    CyDmaChDisable(txChannel);
+    CyDmaChDisable(rxChannel);
+    xferActive = 0;
+}
+#endif /* VENT_NOR_DMA */
+
+/***************************************************************
+ * Short command through the FIFO without DMA, fits in 8 bytes
+ **************************************************************/
+static void VentNor_Command(const uint8 *tx, uint8 *rx, uint8 len)
+{
+    uint8 i;
+
+    SCB_1_SpiUartClearRxBuffer();
+    SCB_1_SpiUartPutArray(tx, len);
+    while (SCB_1_SpiUartGetRxBufferSize() < len)
+    {
+    }
+    for (i = 0; i < len; i++)
+    {
+        uint8 b = (uint8)SCB_1_SpiUartReadRxData();
+
+        if (rx != 0)
+        {
+            rx[i] = b;
+        }
+    }
+}
+
+/***************************************************************
+ * Read the status register
+ **************************************************************/
+static uint8 VentNor_Status(void)
+{
+    uint8 tx[2] = { VENT_NOR_CMD_READ_STATUS, 0xFFu };
+    uint8 rx[2];
+
+    VentNor_Command(tx, rx, 2);
+    return rx[1];
+}
+
+/***************************************************************
+ * Set the write enable latch before program or erase
+ **************************************************************/
+static void VentNor_WriteEnable(void)
+{
+    uint8 cmd = VENT_NOR_CMD_WRITE_ENABLE;
+
+    VentNor_Command(&cmd, 0, 1);
+}
+
+#ifdef VENT_NOR_DMA
+/***************************************************************
+ * Start a command + address + data transfer on both channels.
+ * tx or rx may be 0 to send 0xFF or drop the incoming bytes.
+ **************************************************************/
+static void VentNor_Transfer(uint8 command, uint32 address, const uint8 *tx, uint8 *rx, uint16 len)
+{
+    cydma_init_struct config;
+
+    norHeader[0] = command;
+    norHeader[1] = (uint8)(address >> 16);
+    norHeader[2] = (uint8)(address >> 8);
+    norHeader[3] = (uint8)address;
+
+    config.dataElementSize = CYDMA_BYTE;
+    config.triggerType = CYDMA_PULSE;
+    config.transferMode = CYDMA_SINGLE_DATA_ELEMENT;
+    config.preemptable = CYDMA_PREEMPTABLE;
+
+    /* RX: header bytes are dropped, the data phase goes to rx. The FIFO
+       register is read as a word, only its low byte is stored. */
+    config.srcDstTransferWidth = CYDMA_WORD_ELEMENT;
+    config.numDataElements = VENT_NOR_HEADER_LEN;
+    config.addressIncrement = CYDMA_INC_NONE;
+    config.actions = CYDMA_CHAIN;
+    CyDmaSetConfiguration(rxChannel, 0, &config);
+    CyDmaSetSrcAddress(rxChannel, 0, (void *)SCB_1_RX_FIFO_RD_PTR);
+    CyDmaSetDstAddress(rxChannel, 0, (void *)&norSink);
+
+    config.numDataElements = len;
+    config.addressIncrement = (rx != 0) ? CYDMA_INC_DST_ADDR : CYDMA_INC_NONE;
+    config.actions = CYDMA_GENERATE_IRQ;
+    CyDmaSetConfiguration(rxChannel, 1, &config);
+    CyDmaSetSrcAddress(rxChannel, 1, (void *)SCB_1_RX_FIFO_RD_PTR);
+    CyDmaSetDstAddress(rxChannel, 1, (rx != 0) ? (void *)rx : (void *)&norSink);
+
+    /* TX: header, then the data or filler bytes to clock the reply out.
+       Bytes from memory, whole words into the FIFO register. */
+    config.srcDstTransferWidth = CYDMA_ELEMENT_WORD;
+    config.numDataElements = VENT_NOR_HEADER_LEN;
+    config.addressIncrement = CYDMA_INC_SRC_ADDR;
+    config.actions = CYDMA_CHAIN;
+    CyDmaSetConfiguration(txChannel, 0, &config);
+    CyDmaSetSrcAddress(txChannel, 0, (void *)norHeader);
+    CyDmaSetDstAddress(txChannel, 0, (void *)SCB_1_TX_FIFO_WR_PTR);
+
+    config.numDataElements = len;
+    config.addressIncrement = (tx != 0) ? CYDMA_INC_SRC_ADDR : CYDMA_INC_NONE;
+    config.actions = CYDMA_NONE;
+    CyDmaSetConfiguration(txChannel, 1, &config);
+    CyDmaSetSrcAddress(txChannel, 1, (tx != 0) ? (void *)tx : (void *)&norFill);
+    CyDmaSetDstAddress(txChannel, 1, (void *)SCB_1_TX_FIFO_WR_PTR);
+
+    CyDmaValidateDescriptor(rxChannel, 0);
+    CyDmaValidateDescriptor(rxChannel, 1);
+    CyDmaValidateDescriptor(txChannel, 0);
+    CyDmaValidateDescriptor(txChannel, 1);
+    CyDmaSetNextDescriptor(rxChannel, 0);
+    CyDmaSetNextDescriptor(txChannel, 0);
+
+    SCB_1_SpiUartClearRxBuffer();
+    xferActive = 1;
+
+    /* RX first so no byte is missed, TX then starts clocking */
+    CyDmaChEnable(rxChannel);
+    CyDmaChEnable(txChannel);
+}
+#else
+/***************************************************************
+ * Command + address + data with the CPU. SS drops as soon as
+ * the TX FIFO runs dry, so interrupts stay off until the last
+ * byte is clocked. tx or rx may be 0 as on the DMA path.
+ **************************************************************/
+static void VentNor_Transfer(uint8 command, uint32 address, const uint8 *tx, uint8 *rx, uint16 len)
+{
+    uint32 total = VENT_NOR_HEADER_LEN + (uint32)len;
+    uint32 sent = 0;
+    uint32 received = 0;
+    uint8 intState;
+    uint8 b;
+
+    norHeader[0] = command;
+    norHeader[1] = (uint8)(address >> 16);
+    norHeader[2] = (uint8)(address >> 8);
+    norHeader[3] = (uint8)address;
+
+    SCB_1_SpiUartClearRxBuffer();
+
+    intState = CyEnterCriticalSection();
+    while (received < total)
+    {
+        if ((sent < total) && ((sent - received) < VENT_NOR_CPU_AHEAD))
+        {
+            if (sent < VENT_NOR_HEADER_LEN)
+            {
+                b = norHeader[sent];
+            }
+            else
+            {
+                b = (tx != 0) ? tx[sent - VENT_NOR_HEADER_LEN] : norFill;
+            }
+            SCB_1_SpiUartWriteTxData(b);
+            sent++;
+        }
+        if (SCB_1_SpiUartGetRxBufferSize() != 0u)
+        {
+            b = (uint8)SCB_1_SpiUartReadRxData();
+            if ((received >= VENT_NOR_HEADER_LEN) && (rx != 0))
+            {
+                rx[received - VENT_NOR_HEADER_LEN] = b;
+            }
+            received++;
+        }
+    }
+    CyExitCriticalSection(intState);
+}
+#endif /* VENT_NOR_DMA */
+
+/***************************************************************
+ * Start SCB_1, and the two DMA channels with VENT_NOR_DMA
+ **************************************************************/
+void VentNor_Start(void)
+{
+    SCB_1_Start();
+
+#ifdef VENT_NOR_DMA
+    /* Keep the TX FIFO topped up and raise RX on every byte so SS stays
+       asserted for the whole command */
+    SCB_1_TX_FIFO_CTRL_REG = SCB_1_GET_TX_FIFO_CTRL_TRIGGER_LEVEL(SCB_1_FIFO_SIZE - 1u);
+    SCB_1_RX_FIFO_CTRL_REG = SCB_1_GET_RX_FIFO_CTRL_TRIGGER_LEVEL(0u);
+
+    /* The channels and their trigger routes come from the fitter */
+    CyDmaEnable();
+
+    /* A stalled TX descriptor would drop SS in the middle of a command */
+    CyDmaSetPriority(txChannel, 0);
+    CyDmaSetPriority(rxChannel, 0);
+
+    CyDmaSetInterruptCallback(rxChannel, VentNor_DmaDone);
+    CyDmaSetInterruptSourceMask(CyDmaGetInterruptSourceMask() | (1uL << rxChannel));
+    CyIntEnable(CYDMA_INTR_NUMBER);
+#endif /* VENT_NOR_DMA */
+}
+
+/***************************************************************
+ * Returns non-zero while a transfer, program or erase runs
+ **************************************************************/
+uint8 VentNor_IsBusy(void)
+{
+    if (xferActive)
+        return 1;
+    return (uint8)((VentNor_Status() & VENT_NOR_STATUS_BUSY) != 0u);
+}
+
+/***************************************************************
+ * Returns non-zero while the DMA transfer runs
+ **************************************************************/
+uint8 VentNor_IsTransferring(void)
+{
+    return xferActive;
+}
+
+/***************************************************************
+ * Read len bytes, waits in Sleep for the DMA to finish
+ **************************************************************/
+void VentNor_Read(uint32 address, uint8 *buffer, uint16 len)
+{
+    while (VentNor_IsBusy())
+    {
+    }
+
+    VentNor_Transfer(VENT_NOR_CMD_READ, address, 0, buffer, len);
+    while (xferActive)
+    {
+        CySysPmSleep();
+    }
+}
+
+/***************************************************************
+ * Start programming up to one page
+ **************************************************************/
+void VentNor_ProgramPage(uint32 address, const uint8 *data, uint16 len)
+{
+    VentNor_WriteEnable();
+    VentNor_Transfer(VENT_NOR_CMD_PROGRAM, address, data, 0, len);
+}
+
+/***************************************************************
+ * Start erasing the sector holding address
+ **************************************************************/
+void VentNor_EraseSector(uint32 address)
+{
+    uint8 cmd[VENT_NOR_HEADER_LEN];
+
+    cmd[0] = VENT_NOR_CMD_ERASE_SECTOR;
+    cmd[1] = (uint8)(address >> 16);
+    cmd[2] = (uint8)(address >> 8);
+    cmd[3] = (uint8)address;
+
+    VentNor_WriteEnable();
+    VentNor_Command(cmd, 0, VENT_NOR_HEADER_LEN);
+}
+
+/* [] END OF FILE */
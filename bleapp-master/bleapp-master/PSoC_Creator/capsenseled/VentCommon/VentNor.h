@@ -0,0 +1,82 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#ifndef _VENT_NOR_H_
+#define _VENT_NOR_H_
+
+#include <project.h>
+
+/* SPI NOR on SCB_1, 25-series command set with 3 byte addresses */
+#define VENT_NOR_PAGE_SIZE          (256u)
+#define VENT_NOR_SECTOR_SIZE        (4096u)
+#define VENT_NOR_SIZE               (16uL * 1024uL * 1024uL)
+#define VENT_NOR_SECTORS            (VENT_NOR_SIZE / VENT_NOR_SECTOR_SIZE)
+
+/* Flash map: the history log from sector 0, the firmware update staging
+   area (one header sector and a full internal flash image) at the top */
+#define VENT_NOR_STAGING_SIZE       (VENT_NOR_SECTOR_SIZE + (256uL * 1024uL))
+#define VENT_NOR_STAGING_ADDR       (VENT_NOR_SIZE - VENT_NOR_STAGING_SIZE)
+#define VENT_NOR_LOG_SECTORS        (VENT_NOR_STAGING_ADDR / VENT_NOR_SECTOR_SIZE)
+
+#define VENT_NOR_CMD_READ           (0x03u)
+#define VENT_NOR_CMD_PROGRAM        (0x02u)
+#define VENT_NOR_CMD_ERASE_SECTOR   (0x20u)
+#define VENT_NOR_CMD_WRITE_ENABLE   (0x06u)
+#define VENT_NOR_CMD_READ_STATUS    (0x05u)
+#define VENT_NOR_STATUS_BUSY        (0x01u)
+
+/* Move long transfers with the DMA instead of the CPU. Needs DMA Channel
+   components named NorTxDma and NorRxDma in TopDesign, tr_in wired to the
+   SCB_1 tx_tr_out and rx_tr_out terminals, so the fitter picks the
+   channels and routes the triggers. Off until that is checked on a board. */
+/* #define VENT_NOR_DMA */
+
+/* Bytes in flight on the CPU path, the RX FIFO must never overflow */
+#define VENT_NOR_CPU_AHEAD          (SCB_1_FIFO_SIZE)
+
+/***************************************************************
+ * Start SCB_1, and the two DMA channels with VENT_NOR_DMA
+ **************************************************************/
+void VentNor_Start(void);
+
+/***************************************************************
+ * Returns non-zero while a transfer, program or erase is
+ * still running
+ **************************************************************/
+uint8 VentNor_IsBusy(void);
+
+/***************************************************************
+ * Returns non-zero while the DMA moves a transfer through SCB_1,
+ * the part must not enter Deep Sleep then. A program or erase
+ * runs on in the flash by itself. The CPU path finishes every
+ * transfer before returning.
+ **************************************************************/
+uint8 VentNor_IsTransferring(void);
+
+/***************************************************************
+ * Read len bytes, returns once they are in buffer
+ **************************************************************/
+void VentNor_Read(uint32 address, uint8 *buffer, uint16 len);
+
+/***************************************************************
+ * Start programming up to one page. data must stay untouched
+ * until VentNor_IsBusy() returns zero.
+ **************************************************************/
+void VentNor_ProgramPage(uint32 address, const uint8 *data, uint16 len);
+
+/***************************************************************
+ * Start erasing the 4 KB sector holding address
+ **************************************************************/
+void VentNor_EraseSector(uint32 address);
+
+#endif /* _VENT_NOR_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,263 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#include "VentPressure.h"
+#include "VentTimer.h"
+
+/* Extra fraction bits kept through the filter */
+#define VENT_PRESSURE_FRAC          (4u)
+
+#ifdef VENT_PRESSURE_DMA
+#ifndef PressureDma_CHANNEL
+#error "VENT_PRESSURE_DMA needs the PressureDma component in TopDesign"
+#endif
+#endif /* VENT_PRESSURE_DMA */
+
+/* Ping-pong buffers, one fills while the main loop filters the other.
+   With the DMA descriptor 0 fills buffer 0 and chains to 1. */
+static int16 sampleBuffer[2][VENT_PRESSURE_BLOCK];
+static volatile uint8 bufferReady;
+static volatile uint8 bufferFilling;
+static volatile uint32 overruns;
+
+#ifndef VENT_PRESSURE_DMA
+static volatile uint8 sampleCount;
+#endif /* VENT_PRESSURE_DMA */
+
+static uint8 started;
+
+/* Burst acquisition, the SAR runs while converting is set */
+static uint32 burstInterval;
+static uint32 burstTime;
+static volatile uint8 converting;
+
+static int32 filtered;
+static uint8 filterPrimed;
+
+/***************************************************************
+ * One buffer is full and the other one filling
+ **************************************************************/
+static void VentPressure_BlockDone(void)
+{
+    uint8 mask = (uint8)(1u << bufferFilling);
+
+    if (bufferReady & mask)
+    {
+        overruns++;
+    }
+    bufferReady |= mask;
+    bufferFilling ^= 1u;
+
+    /* The scan under way still completes, the DMA overwrites its
+       result when the next burst rearms the descriptors and the
+       interrupt path drops it */
+    if (burstInterval != 0u)
+    {
+        ADC_SAR_Seq_1_StopConvert();
+        converting = 0;
+    }
+}
+
+/***************************************************************
+ * SAR end of scan, called from ADC_SAR_Seq_1_ISR through
+ * cyapicallbacks.h. The component ISR clears the interrupt.
+ * The IRQ is off when the DMA moves the results.
+ **************************************************************/
+void ADC_SAR_Seq_1_ISR_InterruptCallback(void)
+{
+#ifndef VENT_PRESSURE_DMA
+    if ((ADC_SAR_Seq_1_SAR_INTR_REG & ADC_SAR_Seq_1_EOS_MASK) == 0u)
+        return;
+
+    /* A scan finishing after a burst stopped has no buffer to go to */
+    if (!converting)
+        return;
+
+    sampleBuffer[bufferFilling][sampleCount] = (int16)ADC_SAR_Seq_1_SAR_CHAN_RESULT_REG;
+    if (++sampleCount >= VENT_PRESSURE_BLOCK)
+    {
+        sampleCount = 0;
+        VentPressure_BlockDone();
+    }
+#endif /* VENT_PRESSURE_DMA */
+}
+
+/***************************************************************
+ * Fill the buffer after the last one from its start
+ **************************************************************/
+static void VentPressure_Burst(void)
+{
+#ifdef VENT_PRESSURE_DMA
+    CyDmaChDisable(PressureDma_CHANNEL);
+    CyDmaValidateDescriptor(PressureDma_CHANNEL, 0);
+    CyDmaValidateDescriptor(PressureDma_CHANNEL, 1);
+    CyDmaSetNextDescriptor(PressureDma_CHANNEL, bufferFilling);
+    CyDmaChEnable(PressureDma_CHANNEL);
+#else
+    sampleCount = 0;
+#endif /* VENT_PRESSURE_DMA */
+
+    converting = 1;
+    ADC_SAR_Seq_1_StartConvert();
+}
+
+/***************************************************************
+ * Start the ADC and the double buffer
+ **************************************************************/
+void VentPressure_Start(void)
+{
+#ifdef VENT_PRESSURE_DMA
+    cydma_init_struct config;
+    uint8 i;
+#endif /* VENT_PRESSURE_DMA */
+
+    ADC_SAR_Seq_1_Start();
+
+    ADC_SAR_Seq_1_SAR_SAMPLE_CTRL_REG = (ADC_SAR_Seq_1_SAR_SAMPLE_CTRL_REG & ~ADC_SAR_Seq_1_AVG_CNT_MASK) |
+                                        (VENT_PRESSURE_AVG_CNT << ADC_SAR_Seq_1_AVG_CNT_OFFSET) |
+                                        ADC_SAR_Seq_1_AVG_SHIFT;
+    ADC_SAR_Seq_1_SAR_CHAN_CONFIG_REG |= ADC_SAR_Seq_1_AVERAGING_EN;
+
+    bufferReady = 0;
+    bufferFilling = 0;
+
+#ifdef VENT_PRESSURE_DMA
+    /* Results go through the DMA, keep the per-scan ISR from waking the CPU */
+    ADC_SAR_Seq_1_IRQ_Disable();
+
+    config.dataElementSize = CYDMA_HALFWORD;
+    config.numDataElements = VENT_PRESSURE_BLOCK;
+    config.srcDstTransferWidth = CYDMA_WORD_ELEMENT;
+    config.addressIncrement = CYDMA_INC_DST_ADDR;
+    config.triggerType = CYDMA_PULSE;
+    config.transferMode = CYDMA_SINGLE_DATA_ELEMENT;
+    config.preemptable = CYDMA_PREEMPTABLE;
+    config.actions = CYDMA_CHAIN | CYDMA_GENERATE_IRQ;
+
+    /* The channel and its trigger route come from the fitter */
+    CyDmaEnable();
+    for (i = 0; i < 2u; i++)
+    {
+        CyDmaSetConfiguration(PressureDma_CHANNEL, i, &config);
+        CyDmaSetSrcAddress(PressureDma_CHANNEL, i, (void *)ADC_SAR_Seq_1_SAR_CHAN_RESULT_PTR);
+        CyDmaSetDstAddress(PressureDma_CHANNEL, i, (void *)sampleBuffer[i]);
+        CyDmaValidateDescriptor(PressureDma_CHANNEL, i);
+    }
+    CyDmaSetNextDescriptor(PressureDma_CHANNEL, 0);
+
+    CyDmaSetInterruptCallback(PressureDma_CHANNEL, VentPressure_BlockDone);
+    CyDmaSetInterruptSourceMask(CyDmaGetInterruptSourceMask() | (1uL << PressureDma_CHANNEL));
+    CyIntEnable(CYDMA_INTR_NUMBER);
+    CyDmaChEnable(PressureDma_CHANNEL);
+#else
+    sampleCount = 0;
+#endif /* VENT_PRESSURE_DMA */
+
+    started = 1;
+    converting = 1;
+    ADC_SAR_Seq_1_StartConvert();
+}
+
+/***************************************************************
+ * Continuous or burst acquisition
+ **************************************************************/
+void VentPressure_SetInterval(uint32 interval)
+{
+    uint8 intState;
+
+    if (!started)
+        return;
+
+    intState = CyEnterCriticalSection();
+    burstInterval = interval;
+    burstTime = VentTimer_GetTimeStamp();
+    if ((interval == 0u) && !converting)
+    {
+        VentPressure_Burst();
+    }
+    CyExitCriticalSection(intState);
+}
+
+/***************************************************************
+ * Filter any completed buffers
+ **************************************************************/
+uint8 VentPressure_Process(void)
+{
+    uint8 updated = 0;
+    uint8 i, b;
+    uint8 intState;
+    int32 sum;
+
+    for (b = 0; b < 2u; b++)
+    {
+        if (!(bufferReady & (1u << b)))
+            continue;
+
+        /* Decimate: the block mean is one output sample */
+        sum = 0;
+        for (i = 0; i < VENT_PRESSURE_BLOCK; i++)
+        {
+            sum += sampleBuffer[b][i];
+        }
+        sum = (sum << VENT_PRESSURE_FRAC) / (int32)VENT_PRESSURE_BLOCK;
+
+        intState = CyEnterCriticalSection();
+        bufferReady &= (uint8)~(1u << b);
+        CyExitCriticalSection(intState);
+
+        if (!filterPrimed)
+        {
+            filtered = sum;
+            filterPrimed = 1;
+        }
+        else
+        {
+            filtered += (sum - filtered) >> VENT_PRESSURE_IIR_SHIFT;
+        }
+        updated = 1;
+    }
+
+    if ((burstInterval != 0u) && !converting && (bufferReady == 0u) &&
+        VentTimer_Elapsed(burstTime, burstInterval))
+    {
+        burstTime = VentTimer_GetTimeStamp();
+        VentPressure_Burst();
+    }
+    return updated;
+}
+
+/***************************************************************
+ * Latest filtered differential pressure in Pa
+ **************************************************************/
+int16 VentPressure_GetPa(void)
+{
+    int32 mv = ADC_SAR_Seq_1_CountsTo_mVolts(0, (int16)(filtered >> VENT_PRESSURE_FRAC));
+
+    return (int16)(((mv - VENT_PRESSURE_ZERO_MV) * VENT_PRESSURE_PA_PER_V) / 1000);
+}
+
+/***************************************************************
+ * Buffers dropped because the main loop fell behind
+ **************************************************************/
+uint32 VentPressure_GetOverruns(void)
+{
+    return overruns;
+}
+
+/***************************************************************
+ * SAR converting into the buffers, or finishing its last scan
+ **************************************************************/
+uint8 VentPressure_IsBusy(void)
+{
+    return (uint8)(converting || ((ADC_SAR_Seq_1_SAR_STATUS_REG & ADC_SAR_Seq_1_STATUS_BUSY) != 0u));
+}
+
+/* [] END OF FILE */
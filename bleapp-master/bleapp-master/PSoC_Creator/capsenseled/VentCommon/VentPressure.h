@@ -0,0 +1,78 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#ifndef _VENT_PRESSURE_H_
+#define _VENT_PRESSURE_H_
+
+#include <project.h>
+
+/* ADC_SAR_Seq_1 free-runs at about 20 ksps; hardware averaging of
+   2^(n+1) samples brings the result rate down to about 315 Hz */
+#define VENT_PRESSURE_AVG_CNT       (5u)
+#define VENT_PRESSURE_SAMPLE_HZ     (315u)
+
+/* Results per buffer, each completed buffer is decimated to one value */
+#define VENT_PRESSURE_BLOCK         (32u)
+
+/* Low-pass after decimation, y += (x - y) >> shift */
+#define VENT_PRESSURE_IIR_SHIFT     (3u)
+
+/* Move the results with the DMA instead of the SAR end of scan interrupt.
+   Needs a DMA Channel component named PressureDma in TopDesign with tr_in
+   wired to the ADC_SAR_Seq_1 eos terminal, the fitter then picks the
+   channel and routes the trigger. Off until that is checked on a board. */
+/* #define VENT_PRESSURE_DMA */
+
+/* Differential pressure sensor transfer function */
+#define VENT_PRESSURE_ZERO_MV       (1650)
+#define VENT_PRESSURE_PA_PER_V      (1000)
+
+/* The Pressure characteristic is one signed byte in 2 Pa units */
+#define VENT_PRESSURE_CHAR_UNIT_PA  (2)
+
+/***************************************************************
+ * Start the ADC, hook up the double buffer and begin
+ * continuous acquisition
+ **************************************************************/
+void VentPressure_Start(void);
+
+/***************************************************************
+ * Acquire one buffer every interval ms and stop the SAR in
+ * between, 0 for continuous acquisition. Bursts start from
+ * VentPressure_Process().
+ **************************************************************/
+void VentPressure_SetInterval(uint32 interval);
+
+/***************************************************************
+ * Filter any completed buffers. Returns 1 when a new filtered
+ * value is available.
+ **************************************************************/
+uint8 VentPressure_Process(void);
+
+/***************************************************************
+ * Latest filtered differential pressure in Pa
+ **************************************************************/
+int16 VentPressure_GetPa(void);
+
+/***************************************************************
+ * Buffers dropped because the main loop fell behind
+ **************************************************************/
+uint32 VentPressure_GetOverruns(void);
+
+/***************************************************************
+ * Returns non-zero while the SAR fills the buffers, the part
+ * must not enter Deep Sleep then
+ **************************************************************/
+uint8 VentPressure_IsBusy(void);
+
+#endif /* _VENT_PRESSURE_H_ */
+
+/* [] END OF FILE */
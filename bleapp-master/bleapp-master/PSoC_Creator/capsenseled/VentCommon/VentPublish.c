@@ -0,0 +1,187 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#include "VentPublish.h"
+#include <string.h>
+
+/***************************************************************
+ * Reset the group state and statistics
+ **************************************************************/
+void VentPublish_Init(VENT_PUBLISH_GROUP_T *group)
+{
+    uint8 i;
+
+    for (i = 0; i < group->fieldCount; i++)
+    {
+        group->fields[i].value = 0;
+        group->fields[i].published = 0;
+    }
+    group->notifyEnabled = 0;
+    group->lastNotify = 0;
+    group->primed = 0;
+    group->recordLen = 0;
+    group->sent = 0;
+    group->suppressed = 0;
+    group->failed = 0;
+}
+
+/***************************************************************
+ * Enable or disable notifications for the group
+ **************************************************************/
+void VentPublish_Enable(VENT_PUBLISH_GROUP_T *group, uint8 enable)
+{
+    group->notifyEnabled = enable;
+    group->primed = 0;
+}
+
+/***************************************************************
+ * Store a new sample for one field of the group
+ **************************************************************/
+void VentPublish_SetField(VENT_PUBLISH_GROUP_T *group, uint8 index, int32 value)
+{
+    if (index < group->fieldCount)
+    {
+        group->fields[index].value = value;
+    }
+}
+
+/***************************************************************
+ * Pack all fields little endian, returns the record length
+ **************************************************************/
+static uint8 VentPublish_Pack(const VENT_PUBLISH_GROUP_T *group, uint8 *record)
+{
+    uint8 len = 0;
+    uint8 i, b;
+
+    for (i = 0; i < group->fieldCount; i++)
+    {
+        for (b = 0; (b < group->fields[i].size) && (len < VENT_PUBLISH_MAX_RECORD); b++)
+        {
+            record[len++] = (uint8)((uint32)group->fields[i].value >> (8u * b));
+        }
+    }
+    return len;
+}
+
+/***************************************************************
+ * Returns non-zero if the field moved past its delta threshold
+ **************************************************************/
+static uint8 VentPublish_Significant(const VENT_PUBLISH_FIELD_T *field)
+{
+    int32 diff = field->value - field->published;
+    uint32 absDiff = (uint32)((diff < 0) ? -diff : diff);
+    uint32 absPublished = (uint32)((field->published < 0) ? -field->published : field->published);
+
+    if ((field->absDelta == 0u) && (field->relDelta == 0u))
+    {
+        return (uint8)(absDiff != 0u);
+    }
+    if ((field->absDelta != 0u) && (absDiff >= field->absDelta))
+    {
+        return 1u;
+    }
+    /* 64 bit so a large value cannot wrap the 1/1024 scaling */
+    if ((field->relDelta != 0u) && (((uint64)absDiff << 10) >= ((uint64)absPublished * field->relDelta)))
+    {
+        return 1u;
+    }
+    return 0u;
+}
+
+/***************************************************************
+ * Update the GATT DB if the record changed and send a
+ * notification when the policy allows it
+ **************************************************************/
+uint8 VentPublish_Process(VENT_PUBLISH_GROUP_T *group, uint32 now)
+{
+    CYBLE_GATTS_HANDLE_VALUE_NTF_T handle;
+    uint8 record[VENT_PUBLISH_MAX_RECORD];
+    uint8 len;
+    uint8 changed = 0;
+    uint8 fresh = 0;
+    uint8 significant = 0;
+    uint8 due;
+    uint32 silence = now - group->lastNotify;
+    uint8 i;
+
+    if (CyBle_GetState() != CYBLE_STATE_CONNECTED)
+        return 0;
+
+    if (group->pack != 0)
+    {
+        len = group->pack(group->fields, group->fieldCount, (uint8)group->sent, record);
+    }
+    else
+    {
+        len = VentPublish_Pack(group, record);
+    }
+    handle.attrHandle = group->attrHandle;
+    handle.value.val = record;
+    handle.value.len = len;
+
+    /* Only touch the GATT DB when the packed record actually changed */
+    if ((len != group->recordLen) || (memcmp(record, group->record, len) != 0))
+    {
+        CyBle_GattsWriteAttributeValue(&handle, 0, &cyBle_connHandle, CYBLE_GATT_DB_LOCALLY_INITIATED);
+        memcpy(group->record, record, len);
+        group->recordLen = len;
+        fresh = 1;
+    }
+
+    if (!group->notifyEnabled)
+        return 0;
+
+    for (i = 0; i < group->fieldCount; i++)
+    {
+        if (group->fields[i].value != group->fields[i].published)
+        {
+            changed = 1;
+        }
+        if (VentPublish_Significant(&group->fields[i]))
+        {
+            significant = 1;
+        }
+    }
+
+    /* First notification after subscribing always goes out, then
+       deltas are rate limited and the heartbeat bounds the silence */
+    due = (!group->primed) ||
+          (significant && (silence >= group->minInterval)) ||
+          ((group->maxSilence != 0u) && (silence >= group->maxSilence));
+
+    if (due)
+    {
+        if (CyBle_GattsNotification(cyBle_connHandle, &handle) != CYBLE_ERROR_OK)
+        {
+            /* Stack busy or out of buffers, retried on the next pass */
+            group->failed++;
+            return 0;
+        }
+        for (i = 0; i < group->fieldCount; i++)
+        {
+            group->fields[i].published = group->fields[i].value;
+        }
+        group->lastNotify = now;
+        group->primed = 1;
+        group->sent++;
+        return 1;
+    }
+
+    /* A held back change is counted when it first reaches the record,
+       not on every pass it stays unpublished */
+    if (changed && fresh)
+    {
+        group->suppressed++;
+    }
+    return 0;
+}
+
+/* [] END OF FILE */
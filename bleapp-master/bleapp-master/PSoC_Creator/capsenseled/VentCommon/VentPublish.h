@@ -0,0 +1,101 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#ifndef _VENT_PUBLISH_H_
+#define _VENT_PUBLISH_H_
+
+#include <project.h>
+
+/* Largest packed record, fits the default 23 byte ATT MTU */
+#define VENT_PUBLISH_MAX_RECORD     (20u)
+
+/* One value packed into a characteristic */
+typedef struct
+{
+    /* Bytes the value takes in the packed record (1, 2 or 4), little endian */
+    uint8  size;
+
+    /* Change from the last published value that is worth a notification */
+    uint16 absDelta;
+
+    /* Same, relative to the last published value in 1/1024 units (0 = off) */
+    uint16 relDelta;
+
+    /* Latest sample and the value carried by the last notification */
+    int32  value;
+    int32  published;
+} VENT_PUBLISH_FIELD_T;
+
+/* Packs the fields for layouts that are not whole little endian bytes,
+   sequence counts the notifications sent. Returns the record length. */
+typedef uint8 (*VENT_PUBLISH_PACK_T)(const VENT_PUBLISH_FIELD_T *fields, uint8 fieldCount,
+                                     uint8 sequence, uint8 *record);
+
+/* A characteristic whose fields are packed into one notification */
+typedef struct
+{
+    CYBLE_GATT_DB_ATTR_HANDLE_T attrHandle;
+    VENT_PUBLISH_FIELD_T *fields;
+    uint8  fieldCount;
+
+    /* Never notify more often than this (ms) */
+    uint32 minInterval;
+
+    /* Notify at least this often even without changes, 0 = no heartbeat (ms) */
+    uint32 maxSilence;
+
+    /* Optional packer, 0 = fields one after the other little endian */
+    VENT_PUBLISH_PACK_T pack;
+
+    /* Set by the CCCD write handler */
+    uint8  notifyEnabled;
+
+    /* Time of the last notification, 0 until the first one went out */
+    uint32 lastNotify;
+    uint8  primed;
+
+    /* GATT DB copy of the record, only rewritten when it changes */
+    uint8  record[VENT_PUBLISH_MAX_RECORD];
+    uint8  recordLen;
+
+    /* Statistics: notifications sent, value changes the policy held
+       back (each counted once) and notifications the stack refused */
+    uint32 sent;
+    uint32 suppressed;
+    uint32 failed;
+} VENT_PUBLISH_GROUP_T;
+
+/***************************************************************
+ * Reset the group state and statistics
+ **************************************************************/
+void VentPublish_Init(VENT_PUBLISH_GROUP_T *group);
+
+/***************************************************************
+ * Called from the CCCD write handler and on disconnect. The
+ * first notification after enabling is sent unconditionally.
+ **************************************************************/
+void VentPublish_Enable(VENT_PUBLISH_GROUP_T *group, uint8 enable);
+
+/***************************************************************
+ * Store a new sample for one field of the group
+ **************************************************************/
+void VentPublish_SetField(VENT_PUBLISH_GROUP_T *group, uint8 index, int32 value);
+
+/***************************************************************
+ * Update the GATT DB if the record changed and send a
+ * notification when the policy allows it.
+ * Returns 1 if a notification was sent.
+ **************************************************************/
+uint8 VentPublish_Process(VENT_PUBLISH_GROUP_T *group, uint32 now);
+
+#endif /* _VENT_PUBLISH_H_ */
+
+/* [] END OF FILE */
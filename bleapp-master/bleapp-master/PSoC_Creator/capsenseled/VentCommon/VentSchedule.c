@@ -0,0 +1,243 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#include "VentSchedule.h"
+#include "VentControl.h"
+#include "VentDamper.h"
+#include <string.h>
+
+#define VENT_SCHEDULE_NO_TIME       (0xFFFFFFFFu)
+
+/* The table owns a whole flash row so it can be rewritten
+   without touching the code around it, erased row = no table */
+typedef union
+{
+    VENT_SCHEDULE_T table;
+    uint8 row[CY_FLASH_SIZEOF_ROW];
+} VENT_SCHEDULE_ROW_T;
+
+static const VENT_SCHEDULE_ROW_T CY_ALIGN(CY_FLASH_SIZEOF_ROW) scheduleRow =
+{
+    { 0xFFFFu, 0u, 0u, { 0u }, { 0u } }
+};
+
+/* RAM copy of the table in use */
+static VENT_SCHEDULE_T schedule;
+
+/* Time of week at the last fold, and the VentTimer stamp it belongs to */
+static uint32 scheduleSeconds = VENT_SCHEDULE_NO_TIME;
+static uint32 scheduleStamp;
+
+/* Entry in force, VENT_SCHEDULE_NONE until it has been applied once */
+static uint8 scheduleActive = VENT_SCHEDULE_NONE;
+
+/***************************************************************
+ * CRC-16/CCITT, 0x1021 polynomial, 0xFFFF start
+ **************************************************************/
+static uint16 VentSchedule_Crc(const uint8 *data, uint16 length)
+{
+    uint16 crc = 0xFFFFu;
+    uint8 b;
+
+    while (length-- != 0u)
+    {
+        crc ^= (uint16)((uint16)*data++ << 8);
+        for (b = 0; b < 8u; b++)
+        {
+            crc = (crc & 0x8000u) ? (uint16)((crc << 1) ^ 0x1021u) : (uint16)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/***************************************************************
+ * Returns non-zero if the byte is a Servo command a schedule
+ * may carry: a setpoint or one of the legacy steps
+ **************************************************************/
+static uint8 VentSchedule_ValidCommand(uint8 command)
+{
+    return (uint8)(((command & VENT_CONTROL_SETPOINT_FLAG) != 0u) || (command <= VENT_DAMPER_LEGACY_STEPS));
+}
+
+/***************************************************************
+ * Index of the last transition at or before the minute, the
+ * last one of the week covers the time before the first one
+ **************************************************************/
+static uint8 VentSchedule_Find(uint16 minute)
+{
+    uint8 i;
+
+    for (i = schedule.count; i > 0u; i--)
+    {
+        if (schedule.minute[i - 1u] <= minute)
+        {
+            return (uint8)(i - 1u);
+        }
+    }
+    return (uint8)(schedule.count - 1u);
+}
+
+/***************************************************************
+ * Load the table from flash
+ **************************************************************/
+void VentSchedule_Start(void)
+{
+    const volatile VENT_SCHEDULE_T *stored = &scheduleRow.table;
+    uint8 i;
+
+    memset(&schedule, 0, sizeof(schedule));
+    if ((stored->magic == VENT_SCHEDULE_MAGIC) && (stored->count <= VENT_SCHEDULE_MAX_ENTRIES))
+    {
+        schedule.magic = VENT_SCHEDULE_MAGIC;
+        schedule.count = stored->count;
+        for (i = 0; i < schedule.count; i++)
+        {
+            schedule.minute[i] = stored->minute[i];
+            schedule.command[i] = stored->command[i];
+        }
+    }
+    scheduleSeconds = VENT_SCHEDULE_NO_TIME;
+    scheduleActive = VENT_SCHEDULE_NONE;
+}
+
+/***************************************************************
+ * Validate a TABLE message and make it the schedule in use
+ **************************************************************/
+static uint8 VentSchedule_Load(const uint8 *data, uint16 length)
+{
+    VENT_SCHEDULE_ROW_T rowData;
+    uint8 count;
+    uint16 crc;
+    uint16 minute;
+    uint8 i;
+    uint32 rowNum;
+
+    if (length < 4u)
+        return VENT_SCHEDULE_BAD_LENGTH;
+    count = data[1];
+    if ((count > VENT_SCHEDULE_MAX_ENTRIES) ||
+        (length != (2u + (count * VENT_SCHEDULE_ENTRY_SIZE) + 2u)))
+        return VENT_SCHEDULE_BAD_LENGTH;
+
+    crc = (uint16)(data[length - 2u] | ((uint16)data[length - 1u] << 8));
+    if (VentSchedule_Crc(&data[1], (uint16)(length - 3u)) != crc)
+        return VENT_SCHEDULE_BAD_CRC;
+
+    memset(rowData.row, 0, sizeof(rowData.row));
+    rowData.table.magic = VENT_SCHEDULE_MAGIC;
+    rowData.table.count = count;
+    data += 2;
+    for (i = 0; i < count; i++, data += VENT_SCHEDULE_ENTRY_SIZE)
+    {
+        minute = (uint16)(data[0] | ((uint16)data[1] << 8));
+        if ((minute >= VENT_SCHEDULE_MINUTES_WEEK) ||
+            ((i > 0u) && (minute <= rowData.table.minute[i - 1u])) ||
+            !VentSchedule_ValidCommand(data[2]))
+            return VENT_SCHEDULE_BAD_ENTRY;
+        rowData.table.minute[i] = minute;
+        rowData.table.command[i] = data[2];
+    }
+
+    /* Only switch over once the table survives a reset */
+    rowNum = (uint32)((const uint8 *)&scheduleRow - (const uint8 *)CY_FLASH_BASE) / CY_FLASH_SIZEOF_ROW;
+    if (CySysFlashWriteRow(rowNum, rowData.row) != CY_SYS_FLASH_SUCCESS)
+        return VENT_SCHEDULE_FLASH_ERROR;
+
+    memcpy(&schedule, &rowData.table, sizeof(schedule));
+    scheduleActive = VENT_SCHEDULE_NONE;
+    return VENT_SCHEDULE_OK;
+}
+
+/***************************************************************
+ * Handle a message written by the hub
+ **************************************************************/
+uint8 VentSchedule_Write(const uint8 *data, uint16 length, uint32 now)
+{
+    uint32 seconds;
+
+    if (length == 0u)
+        return VENT_SCHEDULE_BAD_LENGTH;
+
+    switch (data[0])
+    {
+        case VENT_SCHEDULE_MSG_TIME:
+            if (length != 5u)
+                return VENT_SCHEDULE_BAD_LENGTH;
+            seconds = (uint32)data[1] | ((uint32)data[2] << 8) | ((uint32)data[3] << 16) | ((uint32)data[4] << 24);
+            if (seconds >= VENT_SCHEDULE_SECONDS_WEEK)
+                return VENT_SCHEDULE_BAD_ENTRY;
+            VentSchedule_SetTime(seconds, now);
+            return VENT_SCHEDULE_OK;
+
+        case VENT_SCHEDULE_MSG_TABLE:
+            return VentSchedule_Load(data, length);
+
+        default:
+            return VENT_SCHEDULE_BAD_ENTRY;
+    }
+}
+
+/***************************************************************
+ * Set the time of week. A resync keeps the entry in force, so
+ * it does not undo a hub override.
+ **************************************************************/
+void VentSchedule_SetTime(uint32 weekSeconds, uint32 now)
+{
+    scheduleSeconds = weekSeconds % VENT_SCHEDULE_SECONDS_WEEK;
+    scheduleStamp = now;
+}
+
+/***************************************************************
+ * Seconds since Monday 00:00. Whole elapsed seconds are folded
+ * into the reference so the ms time stamp never wraps on it.
+ **************************************************************/
+uint32 VentSchedule_GetTime(uint32 now)
+{
+    uint32 elapsed;
+
+    if (scheduleSeconds == VENT_SCHEDULE_NO_TIME)
+        return VENT_SCHEDULE_NO_TIME;
+
+    elapsed = (uint32)(now - scheduleStamp) / 1000u;
+    scheduleStamp += elapsed * 1000u;
+    scheduleSeconds = (scheduleSeconds + (elapsed % VENT_SCHEDULE_SECONDS_WEEK)) % VENT_SCHEDULE_SECONDS_WEEK;
+    return scheduleSeconds;
+}
+
+/***************************************************************
+ * Returns the Servo command of a transition that just became
+ * active, or VENT_SCHEDULE_NONE
+ **************************************************************/
+uint8 VentSchedule_Process(uint32 now)
+{
+    uint32 seconds = VentSchedule_GetTime(now);
+    uint8 entry;
+
+    if ((seconds == VENT_SCHEDULE_NO_TIME) || (schedule.count == 0u))
+        return VENT_SCHEDULE_NONE;
+
+    entry = VentSchedule_Find((uint16)(seconds / 60u));
+    if (entry == scheduleActive)
+        return VENT_SCHEDULE_NONE;
+
+    scheduleActive = entry;
+    return schedule.command[entry];
+}
+
+/***************************************************************
+ * Number of transitions in the table
+ **************************************************************/
+uint8 VentSchedule_GetCount(void)
+{
+    return schedule.count;
+}
+
+/* [] END OF FILE */
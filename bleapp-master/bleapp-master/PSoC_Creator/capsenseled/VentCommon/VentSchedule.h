@@ -0,0 +1,93 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#ifndef _VENT_SCHEDULE_H_
+#define _VENT_SCHEDULE_H_
+
+#include <project.h>
+
+/* Weekly table of transitions, each one switches the vent to a new
+   Servo command (a VentControl setpoint or a legacy 0-5 step) */
+#define VENT_SCHEDULE_MAX_ENTRIES   (32u)
+#define VENT_SCHEDULE_MINUTES_WEEK  (7u * 24u * 60u)
+#define VENT_SCHEDULE_SECONDS_WEEK  (VENT_SCHEDULE_MINUTES_WEEK * 60u)
+#define VENT_SCHEDULE_MAGIC         (0x5343u)
+
+/* Messages written by the hub to the schedule characteristic, first byte:
+     TIME   seconds since Monday 00:00 (uint32 LE)
+     TABLE  count, count x (minute of week uint16 LE, Servo command byte),
+            CRC-16/CCITT over count and entries (uint16 LE).
+   A full table is 100 bytes and goes over a long (prepared) write. */
+#define VENT_SCHEDULE_MSG_TIME      (0x01u)
+#define VENT_SCHEDULE_MSG_TABLE     (0x02u)
+#define VENT_SCHEDULE_ENTRY_SIZE    (3u)
+#define VENT_SCHEDULE_TABLE_MAX_LEN (2u + (VENT_SCHEDULE_MAX_ENTRIES * VENT_SCHEDULE_ENTRY_SIZE) + 2u)
+
+/* No transition is due */
+#define VENT_SCHEDULE_NONE          (0xFFu)
+
+/* VentSchedule_Write results */
+#define VENT_SCHEDULE_OK            (0u)
+#define VENT_SCHEDULE_BAD_LENGTH    (1u)
+#define VENT_SCHEDULE_BAD_CRC       (2u)
+#define VENT_SCHEDULE_BAD_ENTRY     (3u)
+#define VENT_SCHEDULE_FLASH_ERROR   (4u)
+
+/* Table as stored in its flash row, minutes strictly increasing */
+typedef struct
+{
+    uint16 magic;
+    uint8  count;
+    uint8  reserved;
+    uint16 minute[VENT_SCHEDULE_MAX_ENTRIES];
+    uint8  command[VENT_SCHEDULE_MAX_ENTRIES];
+} VENT_SCHEDULE_T;
+
+/***************************************************************
+ * Load the table from flash. The schedule stays idle until the
+ * hub provides the time of week.
+ **************************************************************/
+void VentSchedule_Start(void);
+
+/***************************************************************
+ * Handle a message written by the hub (TIME or TABLE). A new
+ * table is validated and saved to flash before it is used.
+ * Returns VENT_SCHEDULE_OK or one of the error codes.
+ **************************************************************/
+uint8 VentSchedule_Write(const uint8 *data, uint16 length, uint32 now);
+
+/***************************************************************
+ * Set the time of week, seconds since Monday 00:00
+ **************************************************************/
+void VentSchedule_SetTime(uint32 weekSeconds, uint32 now);
+
+/***************************************************************
+ * Seconds since Monday 00:00, or 0xFFFFFFFF if never set
+ **************************************************************/
+uint32 VentSchedule_GetTime(uint32 now);
+
+/***************************************************************
+ * Call from the main loop with the VentTimer time stamp.
+ * Returns the Servo command of a transition that just became
+ * active, or VENT_SCHEDULE_NONE. The entry in force is also
+ * returned once after the table or the time was (re)loaded.
+ * A hub override simply stands until the next transition.
+ **************************************************************/
+uint8 VentSchedule_Process(uint32 now);
+
+/***************************************************************
+ * Number of transitions in the table
+ **************************************************************/
+uint8 VentSchedule_GetCount(void);
+
+#endif /* _VENT_SCHEDULE_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,34 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#include "VentStatus.h"
+
+/***************************************************************
+ * VentPublish packer for a group laid out as VENT_STATUS_FIELD_
+ **************************************************************/
+uint8 VentStatus_Pack(const VENT_PUBLISH_FIELD_T *fields, uint8 fieldCount, uint8 sequence, uint8 *record)
+{
+    VENT_STATUS_T status;
+
+    VentStatus_Clear(&status);
+    if (fieldCount >= VENT_STATUS_FIELDS)
+    {
+        status.temperature = (int16)fields[VENT_STATUS_FIELD_TEMPERATURE].value;
+        status.position = (uint16)fields[VENT_STATUS_FIELD_POSITION].value;
+        status.pressure = (int16)fields[VENT_STATUS_FIELD_PRESSURE].value;
+        status.battery = (uint8)fields[VENT_STATUS_FIELD_BATTERY].value;
+        status.faults = (uint8)fields[VENT_STATUS_FIELD_FAULTS].value;
+    }
+    status.sequence = sequence;
+    return VentStatus_Encode(&status, record);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,34 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#ifndef _VENT_STATUS_H_
+#define _VENT_STATUS_H_
+
+#include <project.h>
+#include "VentPublish.h"
+#include "VentStatusCodec.h"
+
+/* Field order when the status is published through VentPublish */
+#define VENT_STATUS_FIELD_TEMPERATURE   (0u)
+#define VENT_STATUS_FIELD_POSITION      (1u)
+#define VENT_STATUS_FIELD_PRESSURE      (2u)
+#define VENT_STATUS_FIELD_BATTERY       (3u)
+#define VENT_STATUS_FIELD_FAULTS        (4u)
+#define VENT_STATUS_FIELDS              (5u)
+
+/***************************************************************
+ * VentPublish packer for a group laid out as VENT_STATUS_FIELD_
+ **************************************************************/
+uint8 VentStatus_Pack(const VENT_PUBLISH_FIELD_T *fields, uint8 fieldCount, uint8 sequence, uint8 *record);
+
+#endif /* _VENT_STATUS_H_ */
+
+/* [] END OF FILE */
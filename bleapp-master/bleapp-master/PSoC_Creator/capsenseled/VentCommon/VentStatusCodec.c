@@ -0,0 +1,161 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#include "VentStatusCodec.h"
+#include <string.h>
+
+/* Bit stream cursor */
+typedef struct
+{
+    uint8_t *bytes;
+    const uint8_t *source;
+    uint16_t bit;
+} VENT_STATUS_BITS_T;
+
+/***************************************************************
+ * Append the low width bits of value
+ **************************************************************/
+static void VentStatus_Put(VENT_STATUS_BITS_T *bits, uint32_t value, uint8_t width)
+{
+    uint8_t i;
+
+    for (i = 0; i < width; i++, bits->bit++)
+    {
+        if (value & (1uL << i))
+        {
+            bits->bytes[bits->bit >> 3] |= (uint8_t)(1u << (bits->bit & 7u));
+        }
+    }
+}
+
+/***************************************************************
+ * Read width bits as an unsigned value
+ **************************************************************/
+static uint32_t VentStatus_Get(VENT_STATUS_BITS_T *bits, uint8_t width)
+{
+    uint32_t value = 0;
+    uint8_t i;
+
+    for (i = 0; i < width; i++, bits->bit++)
+    {
+        if (bits->source[bits->bit >> 3] & (1u << (bits->bit & 7u)))
+        {
+            value |= (1uL << i);
+        }
+    }
+    return value;
+}
+
+/***************************************************************
+ * Read width bits as a two's complement value
+ **************************************************************/
+static int32_t VentStatus_GetSigned(VENT_STATUS_BITS_T *bits, uint8_t width)
+{
+    uint32_t value = VentStatus_Get(bits, width);
+
+    if (value & (1uL << (width - 1u)))
+    {
+        value |= ~((1uL << width) - 1u);
+    }
+    return (int32_t)value;
+}
+
+/***************************************************************
+ * Clamp a signed field to its width, the most negative value
+ * stays reserved for "not fitted"
+ **************************************************************/
+static uint32_t VentStatus_Signed(int32_t value, int32_t none, uint8_t width)
+{
+    int32_t max = (int32_t)((1uL << (width - 1u)) - 1u);
+
+    if (value != none)
+    {
+        if (value > max)
+            value = max;
+        if (value < -max)
+            value = -max;
+    }
+    return (uint32_t)value & ((1uL << width) - 1u);
+}
+
+/***************************************************************
+ * Set every field to "not fitted"
+ **************************************************************/
+void VentStatus_Clear(VENT_STATUS_T *status)
+{
+    status->version = VENT_STATUS_VERSION;
+    status->sequence = 0;
+    status->temperature = VENT_STATUS_NO_TEMPERATURE;
+    status->position = VENT_STATUS_NO_POSITION;
+    status->pressure = VENT_STATUS_NO_PRESSURE;
+    status->battery = VENT_STATUS_NO_BATTERY;
+    status->faults = 0;
+}
+
+/***************************************************************
+ * Pack the status with the current layout version
+ **************************************************************/
+uint8_t VentStatus_Encode(const VENT_STATUS_T *status, uint8_t *record)
+{
+    VENT_STATUS_BITS_T bits;
+
+    memset(record, 0, VENT_STATUS_V1_LEN);
+    bits.bytes = record;
+    bits.bit = 0;
+
+    VentStatus_Put(&bits, VENT_STATUS_VERSION, 4u);
+    VentStatus_Put(&bits, status->sequence, 8u);
+    VentStatus_Put(&bits, VentStatus_Signed(status->temperature, VENT_STATUS_NO_TEMPERATURE, 12u), 12u);
+    VentStatus_Put(&bits, (status->position < VENT_STATUS_NO_POSITION) ? status->position : VENT_STATUS_NO_POSITION, 10u);
+    VentStatus_Put(&bits, VentStatus_Signed(status->pressure, VENT_STATUS_NO_PRESSURE, 12u), 12u);
+    VentStatus_Put(&bits, (status->battery < VENT_STATUS_NO_BATTERY) ? status->battery : VENT_STATUS_NO_BATTERY, 7u);
+    VentStatus_Put(&bits, status->faults, 8u);
+
+    return VENT_STATUS_V1_LEN;
+}
+
+/***************************************************************
+ * Unpack a record of this or any later version
+ **************************************************************/
+uint8_t VentStatus_Decode(const uint8_t *record, uint8_t length, VENT_STATUS_T *status)
+{
+    VENT_STATUS_BITS_T bits;
+
+    if ((length < VENT_STATUS_V1_LEN) || ((record[0] & 0x0Fu) == 0u))
+        return 0;
+
+    bits.source = record;
+    bits.bit = 0;
+
+    status->version = (uint8_t)VentStatus_Get(&bits, 4u);
+    status->sequence = (uint8_t)VentStatus_Get(&bits, 8u);
+    status->temperature = (int16_t)VentStatus_GetSigned(&bits, 12u);
+    status->position = (uint16_t)VentStatus_Get(&bits, 10u);
+    status->pressure = (int16_t)VentStatus_GetSigned(&bits, 12u);
+    status->battery = (uint8_t)VentStatus_Get(&bits, 7u);
+    status->faults = (uint8_t)VentStatus_Get(&bits, 8u);
+
+    return 1;
+}
+
+/***************************************************************
+ * Status characteristic of any vent model
+ **************************************************************/
+uint8_t VentStatus_IsUuid(const uint8_t *uuid)
+{
+    static const uint8_t status[VENT_STATUS_UUID_LEN] = VENT_STATUS_UUID;
+
+    return (uint8_t)((memcmp(uuid, status, VENT_STATUS_UUID_ALIAS) == 0) &&
+                     (memcmp(&uuid[VENT_STATUS_UUID_ALIAS + 2u], &status[VENT_STATUS_UUID_ALIAS + 2u],
+                             VENT_STATUS_UUID_LEN - VENT_STATUS_UUID_ALIAS - 2u) == 0));
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,105 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#ifndef _VENT_STATUS_CODEC_H_
+#define _VENT_STATUS_CODEC_H_
+
+#include <stdint.h>
+
+/* Status characteristic, one bit-packed record with the whole vent state.
+   Fields are written LSB first into a little endian bit stream:
+
+     version      4  layout version, fields are only ever appended
+     sequence     8  bumped for every notification, gaps show drops
+     temperature 12  signed, 1/16 degC
+     position    10  damper permille
+     pressure    12  signed, Pa
+     battery      7  percent
+     faults       8  VENT_STATUS_FAULT_ and VENT_STATUS_FLAG_ bits
+
+   Each field has an all-ones (or most negative) value for "not fitted".
+   A decoder accepts any later version and ignores the fields it does not
+   know, so vents and hubs can be updated independently.
+
+   The codec needs nothing but the C library, so hubs and host tools
+   build it as it is. VentStatus.h adds the VentPublish packer. */
+#define VENT_STATUS_VERSION         (1u)
+#define VENT_STATUS_V1_BITS         (4u + 8u + 12u + 10u + 12u + 7u + 8u)
+#define VENT_STATUS_V1_LEN          ((VENT_STATUS_V1_BITS + 7u) / 8u)
+
+/* Never grows past the default 23 byte ATT MTU */
+#define VENT_STATUS_MAX_LEN         (20u)
+
+/* Status characteristic UUID, LSB first as in the GATT DB. Each vent
+   model puts its own 16 bit alias in bytes 12 and 13 of the shared base,
+   a hub matches the rest. */
+#define VENT_STATUS_UUID_LEN        (16u)
+#define VENT_STATUS_UUID_ALIAS      (12u)
+#define VENT_STATUS_UUID            { 0xF8u, 0x34u, 0x9Bu, 0x5Fu, 0x80u, 0x00u, 0x00u, 0x80u, \
+                                      0x00u, 0x10u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u }
+
+#define VENT_STATUS_NO_TEMPERATURE  (-2048)
+#define VENT_STATUS_NO_POSITION     (0x3FFu)
+#define VENT_STATUS_NO_PRESSURE     (-2048)
+#define VENT_STATUS_NO_BATTERY      (0x7Fu)
+
+/* 1/100 degC, as the vents measure it, to the 1/16 degC of the record */
+#define VENT_STATUS_TEMP_FROM_C100(t)   ((int16_t)(((int32_t)(t) * 4) / 25))
+#define VENT_STATUS_TEMP_TO_C100(t)     ((int16_t)(((int32_t)(t) * 25) / 4))
+
+/* Something is wrong */
+#define VENT_STATUS_FAULT_SENSOR    (0x01u)     /* no reading from a fitted sensor */
+#define VENT_STATUS_FAULT_OVERRUN   (0x02u)     /* sample buffers were dropped */
+#define VENT_STATUS_FAULT_STORAGE   (0x04u)     /* history writes are stalling */
+#define VENT_STATUS_FAULT_BATTERY   (0x08u)     /* battery in the low tier or below */
+
+/* State worth knowing */
+#define VENT_STATUS_FLAG_OVERRIDE   (0x10u)     /* local buttons own the damper */
+#define VENT_STATUS_FLAG_CONTROL    (0x20u)     /* on-vent controller is running */
+#define VENT_STATUS_FLAG_MOVING     (0x40u)     /* servo is energised */
+
+typedef struct
+{
+    uint8_t  version;
+    uint8_t  sequence;
+    int16_t  temperature;
+    uint16_t position;
+    int16_t  pressure;
+    uint8_t  battery;
+    uint8_t  faults;
+} VENT_STATUS_T;
+
+/***************************************************************
+ * Set every field to "not fitted"
+ **************************************************************/
+void VentStatus_Clear(VENT_STATUS_T *status);
+
+/***************************************************************
+ * Pack the status with the current layout version, values out
+ * of range are clamped. Returns the record length.
+ **************************************************************/
+uint8_t VentStatus_Encode(const VENT_STATUS_T *status, uint8_t *record);
+
+/***************************************************************
+ * Unpack a record of this or any later version. Returns 0 if
+ * the record is too short or has no valid version.
+ **************************************************************/
+uint8_t VentStatus_Decode(const uint8_t *record, uint8_t length, VENT_STATUS_T *status);
+
+/***************************************************************
+ * Returns non-zero if a 128 bit UUID, LSB first, is the status
+ * characteristic of any vent model
+ **************************************************************/
+uint8_t VentStatus_IsUuid(const uint8_t *uuid);
+
+#endif /* _VENT_STATUS_CODEC_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,674 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#include "VentStore.h"
+#include "VentTimer.h"
+#include <string.h>
+
+#define VENT_STORE_NONE             (0xFFFFu)
+#define VENT_STORE_NO_BUFFER        (0xFFu)
+#define VENT_STORE_NO_PAGE          (0xFFFFFFFFuL)
+#define VENT_STORE_ERASED16         (0xFFFFu)
+
+#define VENT_STORE_SECTOR_ADDR(s)   ((uint32)(s) * VENT_NOR_SECTOR_SIZE)
+#define VENT_STORE_SLOT_ADDR(s, i)  (VENT_STORE_SECTOR_ADDR(s) + VENT_STORE_HEADER_SIZE + \
+                                     (uint32)(i) * VENT_STORE_RECORD_SIZE)
+#define VENT_STORE_PAGE_OF(a)       ((a) & ~(uint32)(VENT_NOR_PAGE_SIZE - 1u))
+#define VENT_STORE_NEXT_SECTOR(s)   ((uint16)(((uint32)(s) + 1u) % VENT_NOR_LOG_SECTORS))
+
+enum
+{
+    VENT_STORE_OP_NONE,
+    VENT_STORE_OP_PROGRAM,
+    VENT_STORE_OP_ERASE
+};
+
+/* Sector ring, oldest at tail, appends go to head */
+static uint16 tailSector;
+static uint16 headSector;
+static uint16 sectorCount;
+static uint32 headSequence;
+static uint32 headTime;
+static uint16 headSlot;
+static uint32 lastTime;
+
+/* Two page buffers so records keep coming while the other one programs */
+static uint8  pageBuffer[2][VENT_NOR_PAGE_SIZE];
+static uint32 pageAddr[2];
+static uint16 pageUsed[2];
+static uint8  pageDirty[2];
+static uint8  fillPage;
+static uint8  programPage = VENT_STORE_NO_BUFFER;
+
+static uint8  norOp;
+static uint16 erasedSector;
+static uint16 eraseTarget;
+
+/* Header time of the sector the query cursor is in */
+static uint16 cursorSector = VENT_STORE_NONE;
+static uint32 cursorTime;
+
+static VENT_STORE_STATS_T stats;
+
+/***************************************************************
+ * Little endian helpers, records are packed byte by byte
+ **************************************************************/
+static void VentStore_Put16(uint8 *p, uint16 v)
+{
+    p[0] = (uint8)v;
+    p[1] = (uint8)(v >> 8);
+}
+
+static void VentStore_Put32(uint8 *p, uint32 v)
+{
+    VentStore_Put16(p, (uint16)v);
+    VentStore_Put16(p + 2, (uint16)(v >> 16));
+}
+
+static uint16 VentStore_Get16(const uint8 *p)
+{
+    return (uint16)(p[0] | ((uint16)p[1] << 8));
+}
+
+static uint32 VentStore_Get32(const uint8 *p)
+{
+    return VentStore_Get16(p) | ((uint32)VentStore_Get16(p + 2) << 16);
+}
+
+/***************************************************************
+ * Zero bits in the low bits of v
+ **************************************************************/
+static uint8 VentStore_Zeros(uint32 v, uint8 bits)
+{
+    uint8 n = bits;
+
+    while (v != 0u)
+    {
+        v &= v - 1u;
+        n--;
+    }
+    return n;
+}
+
+/***************************************************************
+ * Check of a header, zero bits of sequence and time
+ **************************************************************/
+static uint32 VentStore_HeaderCheck(const uint8 *header)
+{
+    return (uint32)VentStore_Zeros(VentStore_Get32(header + 4), 32u) +
+           VentStore_Zeros(VentStore_Get32(header + 8), 32u);
+}
+
+/***************************************************************
+ * Check of a record, zero bits of everything but the check
+ **************************************************************/
+static uint16 VentStore_RecordCheck(const uint8 *raw)
+{
+    return (uint16)(VentStore_Zeros(VentStore_Get32(raw), 32u) +
+                    VentStore_Zeros(VentStore_Get16(raw + 4) & VENT_STORE_POSITION_MASK, 10u) +
+                    VentStore_Zeros(VentStore_Get16(raw + 6), 16u));
+}
+
+/***************************************************************
+ * Returns non-zero for a record written in full
+ **************************************************************/
+static uint8 VentStore_RecordValid(const uint8 *raw)
+{
+    return (VentStore_Get16(raw) != VENT_STORE_ERASED16) &&
+           ((VentStore_Get16(raw + 4) >> VENT_STORE_CHECK_SHIFT) == VentStore_RecordCheck(raw));
+}
+
+/***************************************************************
+ * Read through the page buffers, records not programmed yet
+ * are served from RAM. Never crosses a page.
+ **************************************************************/
+static void VentStore_ReadBytes(uint32 address, uint8 *buffer, uint16 len)
+{
+    uint8 i;
+
+    for (i = 0; i < 2; i++)
+    {
+        if ((pageAddr[i] == VENT_STORE_PAGE_OF(address)) &&
+            ((i == fillPage) || pageDirty[i] || (programPage == i)))
+        {
+            memcpy(buffer, &pageBuffer[i][address - pageAddr[i]], len);
+            return;
+        }
+    }
+    VentNor_Read(address, buffer, len);
+}
+
+/***************************************************************
+ * Read a sector header, returns 0 if the sector holds no log
+ **************************************************************/
+static uint8 VentStore_ReadHeader(uint16 sector, uint32 *sequence, uint32 *time)
+{
+    uint8 header[VENT_STORE_HEADER_SIZE];
+
+    VentStore_ReadBytes(VENT_STORE_SECTOR_ADDR(sector), header, VENT_STORE_HEADER_SIZE);
+    if ((VentStore_Get32(header) != VENT_STORE_MAGIC) ||
+        (VentStore_Get32(header + 12) != VentStore_HeaderCheck(header)))
+        return 0;
+    *sequence = VentStore_Get32(header + 4);
+    *time = VentStore_Get32(header + 8);
+    return 1;
+}
+
+/***************************************************************
+ * Time offset stored in a slot, VENT_STORE_ERASED16 if empty
+ **************************************************************/
+static uint16 VentStore_ReadOffset(uint16 sector, uint16 slot)
+{
+    uint8 raw[2];
+
+    VentStore_ReadBytes(VENT_STORE_SLOT_ADDR(sector, slot), raw, sizeof(raw));
+    return VentStore_Get16(raw);
+}
+
+/***************************************************************
+ * First slot with an offset of at least offset, or the first
+ * empty or bad one. Offsets only grow so a binary search finds
+ * it.
+ **************************************************************/
+static uint16 VentStore_FindSlot(uint16 sector, uint16 offset)
+{
+    uint8 raw[VENT_STORE_RECORD_SIZE];
+    uint16 lo = 0;
+    uint16 hi = VENT_STORE_RECORDS_PER_SECTOR;
+
+    while (lo < hi)
+    {
+        uint16 mid = (uint16)((lo + hi) / 2u);
+
+        VentStore_ReadBytes(VENT_STORE_SLOT_ADDR(sector, mid), raw, sizeof(raw));
+        if (!VentStore_RecordValid(raw) || (VentStore_Get16(raw) >= offset))
+        {
+            hi = mid;
+        }
+        else
+        {
+            lo = (uint16)(mid + 1u);
+        }
+    }
+    return lo;
+}
+
+/***************************************************************
+ * Make the fill buffer the empty page at address
+ **************************************************************/
+static void VentStore_OpenPage(uint32 address)
+{
+    pageAddr[fillPage] = VENT_STORE_PAGE_OF(address);
+    pageUsed[fillPage] = 0;
+    memset(pageBuffer[fillPage], 0xFF, VENT_NOR_PAGE_SIZE);
+}
+
+/***************************************************************
+ * Queue the fill buffer for programming and switch to the other
+ **************************************************************/
+static void VentStore_ClosePage(void)
+{
+    pageDirty[fillPage] = 1;
+    fillPage ^= 1u;
+
+    if (pageDirty[fillPage] || (programPage == fillPage))
+    {
+        stats.stalls++;
+        while (pageDirty[fillPage] || (programPage == fillPage))
+        {
+            VentStore_Process();
+        }
+    }
+    pageAddr[fillPage] = VENT_STORE_NO_PAGE;
+    pageUsed[fillPage] = 0;
+}
+
+/***************************************************************
+ * Move the head to the pre-erased next sector
+ **************************************************************/
+static void VentStore_OpenSector(uint32 time)
+{
+    uint16 next = VENT_STORE_NEXT_SECTOR(headSector);
+
+    if (pageUsed[fillPage] != 0u)
+    {
+        VentStore_ClosePage();
+    }
+    if (erasedSector != next)
+    {
+        stats.stalls++;
+        while (erasedSector != next)
+        {
+            VentStore_Process();
+        }
+    }
+
+    headSector = next;
+    headSequence++;
+    headTime = time;
+    headSlot = 0;
+    erasedSector = VENT_STORE_NONE;
+    sectorCount++;
+
+    VentStore_OpenPage(VENT_STORE_SECTOR_ADDR(headSector));
+    VentStore_Put32(&pageBuffer[fillPage][0], VENT_STORE_MAGIC);
+    VentStore_Put32(&pageBuffer[fillPage][4], headSequence);
+    VentStore_Put32(&pageBuffer[fillPage][8], headTime);
+    VentStore_Put32(&pageBuffer[fillPage][12], VentStore_HeaderCheck(pageBuffer[fillPage]));
+    pageUsed[fillPage] = VENT_STORE_HEADER_SIZE;
+}
+
+/***************************************************************
+ * Check the pages of the last record and of the first empty
+ * slot of the head sector, the last program went to one of
+ * them. A power loss while it ran can leave records half
+ * written, or written after a slot that still reads empty.
+ * Keeps the records before the first bad slot and clears the
+ * rest of the pages, and the header if no record is left.
+ * Returns non-zero if it had to.
+ **************************************************************/
+static uint8 VentStore_RecoverHead(void)
+{
+    uint8 *scratch = pageBuffer[0];
+    uint32 first = VENT_STORE_PAGE_OF(VENT_STORE_SLOT_ADDR(headSector, (headSlot != 0u) ? (headSlot - 1u) : 0u));
+    uint32 last = VENT_STORE_SECTOR_ADDR(headSector) + VENT_NOR_SECTOR_SIZE;
+    uint32 page, address;
+    uint16 slot = 0;
+    uint16 good = headSlot;
+    uint8 torn = 0;
+    uint8 i, erased;
+
+    if (headSlot < VENT_STORE_RECORDS_PER_SECTOR)
+    {
+        last = VENT_STORE_PAGE_OF(VENT_STORE_SLOT_ADDR(headSector, headSlot)) + VENT_NOR_PAGE_SIZE;
+    }
+
+    for (page = first; page < last; page += VENT_NOR_PAGE_SIZE)
+    {
+        VentNor_Read(page, scratch, VENT_NOR_PAGE_SIZE);
+        address = (page == VENT_STORE_SECTOR_ADDR(headSector)) ? VENT_STORE_SLOT_ADDR(headSector, 0) : page;
+        slot = (uint16)((address - VENT_STORE_SLOT_ADDR(headSector, 0)) / VENT_STORE_RECORD_SIZE);
+        for (; address < (page + VENT_NOR_PAGE_SIZE); address += VENT_STORE_RECORD_SIZE, slot++)
+        {
+            const uint8 *raw = &scratch[address - page];
+
+            erased = 1;
+            for (i = 0; i < VENT_STORE_RECORD_SIZE; i++)
+            {
+                if (raw[i] != 0xFFu)
+                    erased = 0;
+            }
+            if (!torn && ((slot < headSlot) ? !VentStore_RecordValid(raw) : !erased))
+            {
+                torn = 1;
+                good = (slot < headSlot) ? slot : headSlot;
+            }
+            if (torn && !erased)
+            {
+                stats.discarded++;
+            }
+        }
+    }
+
+    if (torn)
+    {
+        /* All zero never passes either check. Without a record left
+           the header goes as well. */
+        memset(scratch, 0, VENT_NOR_PAGE_SIZE);
+        address = (good != 0u) ? VENT_STORE_SLOT_ADDR(headSector, good) : VENT_STORE_SECTOR_ADDR(headSector);
+        for (; address < last; address = VENT_STORE_PAGE_OF(address) + VENT_NOR_PAGE_SIZE)
+        {
+            VentNor_ProgramPage(address, scratch,
+                                (uint16)(VENT_STORE_PAGE_OF(address) + VENT_NOR_PAGE_SIZE - address));
+            while (VentNor_IsBusy())
+            {
+            }
+        }
+        headSlot = good;
+    }
+    return torn;
+}
+
+/***************************************************************
+ * Start the flash and continue after the newest record
+ **************************************************************/
+void VentStore_Start(void)
+{
+    uint32 start = VentTimer_GetTimeStamp();
+    uint32 minSequence = 0xFFFFFFFFuL;
+    uint32 sequence, time;
+    uint16 s;
+    uint8 torn;
+
+    VentNor_Start();
+
+    fillPage = 0;
+    programPage = VENT_STORE_NO_BUFFER;
+    pageAddr[0] = pageAddr[1] = VENT_STORE_NO_PAGE;
+    pageUsed[0] = pageUsed[1] = 0;
+    pageDirty[0] = pageDirty[1] = 0;
+    norOp = VENT_STORE_OP_NONE;
+
+    /* The sector after the head may have been cut short by a power
+       loss during its erase, erase it again rather than trust it */
+    erasedSector = VENT_STORE_NONE;
+
+    headSector = VENT_NOR_LOG_SECTORS - 1u;
+    headSequence = 0;
+    headSlot = VENT_STORE_RECORDS_PER_SECTOR;
+    tailSector = 0;
+    sectorCount = 0;
+    lastTime = 0;
+    cursorSector = VENT_STORE_NONE;
+    stats.discarded = 0;
+
+    for (s = 0; s < VENT_NOR_LOG_SECTORS; s++)
+    {
+        if (!VentStore_ReadHeader(s, &sequence, &time))
+            continue;
+        sectorCount++;
+        if (sequence >= headSequence)
+        {
+            headSequence = sequence;
+            headSector = s;
+            headTime = time;
+        }
+        if (sequence < minSequence)
+        {
+            minSequence = sequence;
+            tailSector = s;
+        }
+    }
+
+    if (sectorCount != 0u)
+    {
+        /* A full ring erases its tail next, that erase may be the one
+           the power loss cut short */
+        if ((VENT_STORE_NEXT_SECTOR(headSector) == tailSector) && (tailSector != headSector))
+        {
+            tailSector = VENT_STORE_NEXT_SECTOR(tailSector);
+            sectorCount--;
+        }
+
+        /* Continue in the partly written page of the head sector, or
+           in a new sector if that page was cut short */
+        headSlot = VentStore_FindSlot(headSector, VENT_STORE_ERASED16);
+        torn = VentStore_RecoverHead();
+        if (torn && (headSlot == 0u))
+        {
+            /* Not one record of the new head sector was kept and its
+               header is cleared, the sector before is the head again */
+            sectorCount--;
+            headSector = (uint16)((headSector + VENT_NOR_LOG_SECTORS - 1u) % VENT_NOR_LOG_SECTORS);
+            if ((sectorCount != 0u) && VentStore_ReadHeader(headSector, &headSequence, &headTime))
+            {
+                headSlot = VentStore_FindSlot(headSector, VENT_STORE_ERASED16);
+                torn = 0;
+            }
+        }
+        if (sectorCount != 0u)
+        {
+            lastTime = headTime;
+        }
+        if (headSlot != 0u)
+        {
+            lastTime += VentStore_ReadOffset(headSector, (uint16)(headSlot - 1u));
+        }
+        if (torn)
+        {
+            headSlot = VENT_STORE_RECORDS_PER_SECTOR;
+        }
+        if (headSlot < VENT_STORE_RECORDS_PER_SECTOR)
+        {
+            uint32 address = VENT_STORE_SLOT_ADDR(headSector, headSlot);
+
+            VentStore_OpenPage(address);
+            pageUsed[fillPage] = (uint16)(address - pageAddr[fillPage]);
+            if (pageUsed[fillPage] != 0u)
+            {
+                VentNor_Read(pageAddr[fillPage], pageBuffer[fillPage], pageUsed[fillPage]);
+            }
+        }
+    }
+
+    stats.recoveryTime = VentTimer_GetTimeStamp() - start;
+}
+
+/***************************************************************
+ * Add a record
+ **************************************************************/
+void VentStore_Append(const VENT_LOG_RECORD_T *record)
+{
+    uint32 address;
+    uint8 *p;
+
+    if ((headSlot >= VENT_STORE_RECORDS_PER_SECTOR) ||
+        (record->time < headTime) ||
+        ((record->time - headTime) > VENT_STORE_MAX_OFFSET))
+    {
+        VentStore_OpenSector(record->time);
+    }
+
+    address = VENT_STORE_SLOT_ADDR(headSector, headSlot);
+    p = &pageBuffer[fillPage][address - pageAddr[fillPage]];
+    VentStore_Put16(p, (uint16)(record->time - headTime));
+    VentStore_Put16(p + 2, (uint16)record->temperature);
+    VentStore_Put16(p + 4, record->position & VENT_STORE_POSITION_MASK);
+    VentStore_Put16(p + 6, (uint16)record->pressure);
+    p[5] |= (uint8)(VentStore_RecordCheck(p) << (VENT_STORE_CHECK_SHIFT - 8u));
+    pageUsed[fillPage] = (uint16)(address - pageAddr[fillPage] + VENT_STORE_RECORD_SIZE);
+
+    headSlot++;
+    lastTime = record->time;
+    stats.appends++;
+
+    if (pageUsed[fillPage] == VENT_NOR_PAGE_SIZE)
+    {
+        VentStore_ClosePage();
+        if (headSlot < VENT_STORE_RECORDS_PER_SECTOR)
+        {
+            VentStore_OpenPage(address + VENT_STORE_RECORD_SIZE);
+        }
+    }
+}
+
+/***************************************************************
+ * Program pages, then keep the next sector erased
+ **************************************************************/
+void VentStore_Process(void)
+{
+    uint16 next = VENT_STORE_NEXT_SECTOR(headSector);
+    uint8 i;
+
+    if (VentNor_IsBusy())
+        return;
+
+    if (norOp == VENT_STORE_OP_PROGRAM)
+    {
+        programPage = VENT_STORE_NO_BUFFER;
+        stats.pagesWritten++;
+    }
+    else if (norOp == VENT_STORE_OP_ERASE)
+    {
+        erasedSector = eraseTarget;
+        stats.sectorsErased++;
+    }
+    norOp = VENT_STORE_OP_NONE;
+
+    /* Older page first, its records were appended earlier */
+    for (i = 0; i < 2; i++)
+    {
+        uint8 page = (uint8)(fillPage ^ 1u ^ i);
+
+        if (pageDirty[page])
+        {
+            pageDirty[page] = 0;
+            programPage = page;
+            norOp = VENT_STORE_OP_PROGRAM;
+            VentNor_ProgramPage(pageAddr[page], pageBuffer[page], pageUsed[page]);
+            return;
+        }
+    }
+
+    if (erasedSector != next)
+    {
+        if ((sectorCount != 0u) && (next == tailSector) && (next != headSector))
+        {
+            /* Ring is full, the oldest sector goes */
+            tailSector = VENT_STORE_NEXT_SECTOR(tailSector);
+            sectorCount--;
+        }
+        eraseTarget = next;
+        norOp = VENT_STORE_OP_ERASE;
+        VentNor_EraseSector(VENT_STORE_SECTOR_ADDR(next));
+    }
+}
+
+/***************************************************************
+ * Program the partly filled page and wait for it
+ **************************************************************/
+void VentStore_Flush(void)
+{
+    if (pageUsed[fillPage] != 0u)
+    {
+        pageDirty[fillPage] = 1;
+    }
+    while (pageDirty[0] || pageDirty[1] || (norOp == VENT_STORE_OP_PROGRAM))
+    {
+        VentStore_Process();
+    }
+}
+
+/***************************************************************
+ * Time of the newest record
+ **************************************************************/
+uint32 VentStore_LastTime(void)
+{
+    return lastTime;
+}
+
+/***************************************************************
+ * Position cursor on the first record at or after time
+ **************************************************************/
+uint8 VentStore_Find(uint32 time, uint32 *cursor)
+{
+    uint16 lo = 0;
+    uint16 hi;
+    uint16 sector;
+    uint32 sequence, first;
+
+    if (sectorCount == 0u)
+        return 0;
+
+    /* Last sector starting at or before time, ring order from tail */
+    hi = sectorCount;
+    while ((uint16)(hi - lo) > 1u)
+    {
+        uint16 mid = (uint16)((lo + hi) / 2u);
+
+        sector = (uint16)((tailSector + (uint32)mid) % VENT_NOR_LOG_SECTORS);
+        if (VentStore_ReadHeader(sector, &sequence, &first) && (first <= time))
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    sector = (uint16)((tailSector + (uint32)lo) % VENT_NOR_LOG_SECTORS);
+
+    if (!VentStore_ReadHeader(sector, &sequence, &first))
+        return 0;
+    if (time <= first)
+    {
+        *cursor = VENT_STORE_SLOT_ADDR(sector, 0);
+    }
+    else if ((time - first) > VENT_STORE_MAX_OFFSET)
+    {
+        *cursor = VENT_STORE_SLOT_ADDR(sector, VENT_STORE_RECORDS_PER_SECTOR);
+    }
+    else
+    {
+        *cursor = VENT_STORE_SLOT_ADDR(sector, VentStore_FindSlot(sector, (uint16)(time - first)));
+    }
+    return 1;
+}
+
+/***************************************************************
+ * Read the record at cursor and advance it
+ **************************************************************/
+uint8 VentStore_Next(uint32 *cursor, VENT_LOG_RECORD_T *record)
+{
+    uint8 raw[VENT_STORE_RECORD_SIZE];
+    uint16 sector = (uint16)(*cursor / VENT_NOR_SECTOR_SIZE);
+    uint16 offset = (uint16)(*cursor % VENT_NOR_SECTOR_SIZE);
+    uint16 slot;
+    uint32 sequence;
+
+    /* A cursor past the last slot points at the next sector base */
+    if (offset < VENT_STORE_HEADER_SIZE)
+    {
+        sector = (uint16)((sector + VENT_NOR_LOG_SECTORS - 1u) % VENT_NOR_LOG_SECTORS);
+        slot = VENT_STORE_RECORDS_PER_SECTOR;
+    }
+    else
+    {
+        slot = (uint16)((offset - VENT_STORE_HEADER_SIZE) / VENT_STORE_RECORD_SIZE);
+    }
+
+    for (;;)
+    {
+        if ((sector == headSector) && (slot >= headSlot))
+            return 0;
+
+        if (slot < VENT_STORE_RECORDS_PER_SECTOR)
+        {
+            VentStore_ReadBytes(VENT_STORE_SLOT_ADDR(sector, slot), raw, sizeof(raw));
+            if (VentStore_RecordValid(raw))
+                break;
+        }
+
+        /* End of a sector, possibly closed early or cut short */
+        if (sector == headSector)
+            return 0;
+        sector = VENT_STORE_NEXT_SECTOR(sector);
+        slot = 0;
+        if (!VentStore_ReadHeader(sector, &sequence, &cursorTime))
+            return 0;
+        cursorSector = sector;
+    }
+
+    if (sector != cursorSector)
+    {
+        if (!VentStore_ReadHeader(sector, &sequence, &cursorTime))
+            return 0;
+        cursorSector = sector;
+    }
+
+    record->time = cursorTime + VentStore_Get16(raw);
+    record->temperature = (int16)VentStore_Get16(raw + 2);
+    record->position = VentStore_Get16(raw + 4) & VENT_STORE_POSITION_MASK;
+    record->pressure = (int16)VentStore_Get16(raw + 6);
+
+    *cursor = VENT_STORE_SLOT_ADDR(sector, slot + 1u);
+    return 1;
+}
+
+/***************************************************************
+ * Statistics since VentStore_Start
+ **************************************************************/
+const VENT_STORE_STATS_T *VentStore_GetStats(void)
+{
+    return &stats;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,95 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#ifndef _VENT_STORE_H_
+#define _VENT_STORE_H_
+
+#include <project.h>
+#include "VentNor.h"
+#include "VentLog.h"
+
+/* Every sector starts with a header, records follow back to back. A
+   sector is closed early when the time offset no longer fits.
+
+   Header: magic, sequence, first time, number of zero bits in sequence
+   and time. Record: time offset, temperature, position in the low 10
+   bits with the number of zero bits of the other 58 above it, pressure.
+   A program or erase cut short by a power loss only moves bits one way,
+   which always changes the count, so a half written header or record
+   never passes for a good one. */
+#define VENT_STORE_MAGIC            (0x56534C48uL)
+#define VENT_STORE_HEADER_SIZE      (16u)
+#define VENT_STORE_RECORD_SIZE      (8u)
+#define VENT_STORE_RECORDS_PER_SECTOR \
+    ((VENT_NOR_SECTOR_SIZE - VENT_STORE_HEADER_SIZE) / VENT_STORE_RECORD_SIZE)
+#define VENT_STORE_MAX_OFFSET       (0xFFFEu)
+#define VENT_STORE_POSITION_MASK    (0x03FFu)
+#define VENT_STORE_CHECK_SHIFT      (10u)
+
+/* Record field value for a sensor this node does not have */
+#define VENT_STORE_NO_VALUE         ((int16)0x8000)
+
+typedef struct
+{
+    uint32 appends;
+    uint32 pagesWritten;
+    uint32 sectorsErased;
+    uint32 stalls;          /* appends that had to wait for the flash */
+    uint32 recoveryTime;    /* ms spent in VentStore_Start */
+    uint32 discarded;       /* slots of a cut short page VentStore_Start cleared */
+} VENT_STORE_STATS_T;
+
+/***************************************************************
+ * Start the flash and continue after the newest record. A page
+ * cut short by a power loss is cleared after its last good
+ * record and the next record opens a new sector.
+ **************************************************************/
+void VentStore_Start(void);
+
+/***************************************************************
+ * Add a record. Times must not go backwards. Only waits when
+ * both page buffers or the next sector are still busy.
+ **************************************************************/
+void VentStore_Append(const VENT_LOG_RECORD_T *record);
+
+/***************************************************************
+ * Program pages and erase the next sector ahead of the write
+ * position, call from the main loop
+ **************************************************************/
+void VentStore_Process(void);
+
+/***************************************************************
+ * Program the partly filled page and wait for it
+ **************************************************************/
+void VentStore_Flush(void);
+
+/***************************************************************
+ * Time of the newest record, 0 if the log is empty
+ **************************************************************/
+uint32 VentStore_LastTime(void);
+
+/***************************************************************
+ * Position cursor on the first record at or after time.
+ * Returns 0 if the log is empty.
+ **************************************************************/
+uint8 VentStore_Find(uint32 time, uint32 *cursor);
+
+/***************************************************************
+ * Read the record at cursor and advance it. Returns 0 at the
+ * end of the log.
+ **************************************************************/
+uint8 VentStore_Next(uint32 *cursor, VENT_LOG_RECORD_T *record);
+
+const VENT_STORE_STATS_T *VentStore_GetStats(void);
+
+#endif /* _VENT_STORE_H_ */
+
+/* [] END OF FILE */
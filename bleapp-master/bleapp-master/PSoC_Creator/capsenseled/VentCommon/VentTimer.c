@@ -0,0 +1,59 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#include "VentTimer.h"
+
+/* Last raw counter value and total LFCLK ticks seen since start */
+static uint32 lastCount;
+static uint64 totalTicks;
+
+/***************************************************************
+ * Start the free-running WDT counter used as the time base
+ **************************************************************/
+void VentTimer_Start(void)
+{
+    CySysWdtUnlock();
+    CySysWdtSetMode(VENT_TIMER_COUNTER, CY_SYS_WDT_MODE_NONE);
+    CySysWdtEnable(VENT_TIMER_COUNTER_MASK);
+    CySysWdtLock();
+
+    lastCount = CySysWdtGetCount(VENT_TIMER_COUNTER);
+    totalTicks = 0;
+}
+
+/***************************************************************
+ * Milliseconds since VentTimer_Start()
+ **************************************************************/
+uint32 VentTimer_GetTimeStamp(void)
+{
+    uint32 count;
+    uint8 intState;
+
+    intState = CyEnterCriticalSection();
+    count = CySysWdtGetCount(VENT_TIMER_COUNTER);
+    /* Counter 2 is 32 bits wide, unsigned subtraction handles its wrap */
+    totalTicks += (uint32)(count - lastCount);
+    lastCount = count;
+    CyExitCriticalSection(intState);
+
+    /* 1000 / 32768 == 125 / 4096 */
+    return (uint32)((totalTicks * 125u) >> 12);
+}
+
+/***************************************************************
+ * Returns non-zero if interval ms have passed since timeStamp
+ **************************************************************/
+uint8 VentTimer_Elapsed(uint32 timeStamp, uint32 interval)
+{
+    return (uint8)((uint32)(VentTimer_GetTimeStamp() - timeStamp) >= interval);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,44 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#ifndef _VENT_TIMER_H_
+#define _VENT_TIMER_H_
+
+#include <project.h>
+
+/* Free-running WDT counter used as the vent time base. It runs from LFCLK,
+   so it keeps counting while the device is in deep sleep. */
+#define VENT_TIMER_COUNTER          CY_SYS_WDT_COUNTER2
+#define VENT_TIMER_COUNTER_MASK     CY_SYS_WDT_COUNTER2_MASK
+
+/* LFCLK ticks per second */
+#define VENT_TIMER_LFCLK_HZ         (32768u)
+
+/***************************************************************
+ * Start the free-running WDT counter used as the time base
+ **************************************************************/
+void VentTimer_Start(void);
+
+/***************************************************************
+ * Milliseconds since VentTimer_Start(). Wraps after ~49 days,
+ * compare time stamps with VentTimer_Elapsed() only.
+ * Must be called at least once every 36 hours.
+ **************************************************************/
+uint32 VentTimer_GetTimeStamp(void);
+
+/***************************************************************
+ * Returns non-zero if interval ms have passed since timeStamp
+ **************************************************************/
+uint8 VentTimer_Elapsed(uint32 timeStamp, uint32 interval);
+
+#endif /* _VENT_TIMER_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,485 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#include "VentUpdate.h"
+#include "VentTimer.h"
+#include <string.h>
+
+/* The running image, COPY reads from it in place */
+#define VENT_UPDATE_OLD_IMAGE       ((const uint8 *)CY_FLASH_BASE)
+
+/* Staging header, little endian words */
+#define VENT_UPDATE_STAGED_LEN      (16u)
+
+typedef enum
+{
+    VENT_UPDATE_DEC_HEADER,
+    VENT_UPDATE_DEC_CHECK,
+    VENT_UPDATE_DEC_TAG,
+    VENT_UPDATE_DEC_LEN,
+    VENT_UPDATE_DEC_SRC,
+    VENT_UPDATE_DEC_COPY,
+    VENT_UPDATE_DEC_INSERT,
+    VENT_UPDATE_DEC_FILL_BYTE,
+    VENT_UPDATE_DEC_FILL,
+    VENT_UPDATE_DEC_END
+} VENT_UPDATE_DEC_T;
+
+static VENT_UPDATE_STATE_T updateState;
+static VENT_UPDATE_STATS_T stats;
+
+/* One chunk from the hub, consumed before the next is accepted */
+static uint8  input[VENT_UPDATE_CHUNK_MAX];
+static uint16 inputLen;
+static uint16 inputPos;
+
+/* Patch header and the decoder */
+static uint8  header[VENT_UPDATE_HEADER_LEN];
+static uint32 oldSize;
+static uint32 oldCrc;
+static uint32 newSize;
+static uint32 newCrc;
+static VENT_UPDATE_DEC_T decState;
+static uint8  opTag;
+static uint32 opLen;
+static uint32 varValue;
+static uint8  varShift;
+static uint32 oldPos;
+static uint8  fillValue;
+
+/* Old image CRC, run a slice at a time before the first operation */
+static uint32 checkPos;
+static uint32 checkCrc;
+
+/* New image output, one NOR page at a time */
+static uint8  page[VENT_NOR_PAGE_SIZE];
+static uint16 pageUsed;
+static uint8  pageBusy;
+static uint32 outPos;
+static uint32 outCrc;
+static uint32 erasedEnd;
+static uint8  headerErased;
+static uint8  stagedWritten;
+static uint32 startTime;
+
+/* CRC-32 (IEEE, reflected) four bits at a time */
+static const uint32 crcTable[16] =
+{
+    0x00000000uL, 0x1DB71064uL, 0x3B6E20C8uL, 0x26D930ACuL,
+    0x76DC4190uL, 0x6B6B51F4uL, 0x4DB26158uL, 0x5005713CuL,
+    0xEDB88320uL, 0xF00F9344uL, 0xD6D6A3E8uL, 0xCB61B38CuL,
+    0x9B64C2B0uL, 0x86D3D2D4uL, 0xA00AE278uL, 0xBDBDF21CuL,
+};
+
+/***************************************************************
+ * Continue a CRC-32, start and finish with ~0
+ **************************************************************/
+static uint32 VentUpdate_Crc(uint32 crc, const uint8 *data, uint32 length)
+{
+    while (length-- != 0u)
+    {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ crcTable[crc & 0x0Fu];
+        crc = (crc >> 4) ^ crcTable[crc & 0x0Fu];
+    }
+    return crc;
+}
+
+static uint32 VentUpdate_Get32(const uint8 *p)
+{
+    return (uint32)p[0] | ((uint32)p[1] << 8) | ((uint32)p[2] << 16) | ((uint32)p[3] << 24);
+}
+
+static void VentUpdate_Put32(uint8 *p, uint32 value)
+{
+    p[0] = (uint8)value;
+    p[1] = (uint8)(value >> 8);
+    p[2] = (uint8)(value >> 16);
+    p[3] = (uint8)(value >> 24);
+}
+
+/***************************************************************
+ * Stop applying, the staging header stays erased
+ **************************************************************/
+static void VentUpdate_Fail(uint8 error)
+{
+    stats.error = error;
+    updateState = VENT_UPDATE_FAILED;
+    inputLen = 0;
+    inputPos = 0;
+}
+
+/***************************************************************
+ * Check the patch header against the running image
+ **************************************************************/
+static void VentUpdate_Header(void)
+{
+    if (VentUpdate_Get32(&header[0]) != VENT_UPDATE_MAGIC)
+    {
+        VentUpdate_Fail(VENT_UPDATE_BAD_HEADER);
+        return;
+    }
+    oldSize = VentUpdate_Get32(&header[4]);
+    oldCrc = VentUpdate_Get32(&header[8]);
+    newSize = VentUpdate_Get32(&header[12]);
+    newCrc = VentUpdate_Get32(&header[16]);
+
+    if ((oldSize > CY_FLASH_SIZE) || (newSize == 0u) ||
+        (newSize > CY_FLASH_SIZE) || (newSize > VENT_UPDATE_IMAGE_MAX))
+    {
+        VentUpdate_Fail(VENT_UPDATE_BAD_HEADER);
+        return;
+    }
+
+    checkPos = 0;
+    checkCrc = 0xFFFFFFFFuL;
+    decState = VENT_UPDATE_DEC_CHECK;
+}
+
+/***************************************************************
+ * CRC the next slice of the old image, then compare
+ **************************************************************/
+static void VentUpdate_Check(void)
+{
+    uint32 n = oldSize - checkPos;
+
+    if (n > VENT_UPDATE_CHECK_SLICE)
+        n = VENT_UPDATE_CHECK_SLICE;
+    checkCrc = VentUpdate_Crc(checkCrc, &VENT_UPDATE_OLD_IMAGE[checkPos], n);
+    checkPos += n;
+    if (checkPos < oldSize)
+        return;
+
+    /* COPY trusts the old image, so the patch must be for this build */
+    if ((uint32)~checkCrc != oldCrc)
+    {
+        VentUpdate_Fail(VENT_UPDATE_WRONG_IMAGE);
+        return;
+    }
+    decState = VENT_UPDATE_DEC_TAG;
+}
+
+/***************************************************************
+ * Add one LEB128 byte, returns 1 when the value is complete
+ **************************************************************/
+static uint8 VentUpdate_Varint(uint8 b)
+{
+    if (varShift > 28u)
+    {
+        VentUpdate_Fail(VENT_UPDATE_BAD_PATCH);
+        return 0;
+    }
+    varValue |= (uint32)(b & 0x7Fu) << varShift;
+    varShift += 7u;
+    return (uint8)((b & 0x80u) == 0u);
+}
+
+static void VentUpdate_VarintReset(void)
+{
+    varValue = 0;
+    varShift = 0;
+}
+
+/***************************************************************
+ * Append new image bytes to the page buffer
+ **************************************************************/
+static void VentUpdate_Emit(const uint8 *data, uint16 length)
+{
+    memcpy(&page[pageUsed], data, length);
+    outCrc = VentUpdate_Crc(outCrc, data, length);
+    pageUsed += length;
+    outPos += length;
+}
+
+/***************************************************************
+ * Run the decoder until the page is full or the chunk is used
+ **************************************************************/
+static void VentUpdate_Decode(void)
+{
+    uint16 room;
+    uint16 n;
+    uint8 b;
+
+    while ((updateState == VENT_UPDATE_RECEIVING) && (pageUsed < VENT_NOR_PAGE_SIZE))
+    {
+        room = (uint16)(VENT_NOR_PAGE_SIZE - pageUsed);
+
+        /* Output only states, no patch bytes needed */
+        if (decState == VENT_UPDATE_DEC_COPY)
+        {
+            n = (opLen < room) ? (uint16)opLen : room;
+            VentUpdate_Emit(&VENT_UPDATE_OLD_IMAGE[oldPos], n);
+            stats.copyBytes += n;
+            oldPos += n;
+            opLen -= n;
+            if (opLen == 0u)
+                decState = VENT_UPDATE_DEC_TAG;
+            continue;
+        }
+        if (decState == VENT_UPDATE_DEC_FILL)
+        {
+            n = (opLen < room) ? (uint16)opLen : room;
+            memset(&page[pageUsed], fillValue, n);
+            outCrc = VentUpdate_Crc(outCrc, &page[pageUsed], n);
+            pageUsed += n;
+            outPos += n;
+            stats.fillBytes += n;
+            opLen -= n;
+            if (opLen == 0u)
+                decState = VENT_UPDATE_DEC_TAG;
+            continue;
+        }
+        if ((decState == VENT_UPDATE_DEC_END) || (decState == VENT_UPDATE_DEC_CHECK))
+            return;
+
+        if (inputPos >= inputLen)
+            return;
+
+        if (decState == VENT_UPDATE_DEC_INSERT)
+        {
+            n = (uint16)(inputLen - inputPos);
+            if (n > room)
+                n = room;
+            if (n > opLen)
+                n = (uint16)opLen;
+            VentUpdate_Emit(&input[inputPos], n);
+            stats.insertBytes += n;
+            inputPos += n;
+            opLen -= n;
+            if (opLen == 0u)
+                decState = VENT_UPDATE_DEC_TAG;
+            continue;
+        }
+
+        b = input[inputPos++];
+        switch (decState)
+        {
+            case VENT_UPDATE_DEC_HEADER:
+                header[opLen++] = b;
+                if (opLen == VENT_UPDATE_HEADER_LEN)
+                {
+                    VentUpdate_Header();
+                }
+                break;
+
+            case VENT_UPDATE_DEC_TAG:
+                opTag = b;
+                VentUpdate_VarintReset();
+                if (opTag == VENT_UPDATE_OP_END)
+                {
+                    decState = VENT_UPDATE_DEC_END;
+                    if ((outPos != newSize) || ((uint32)~outCrc != newCrc))
+                    {
+                        VentUpdate_Fail(VENT_UPDATE_BAD_CRC);
+                    }
+                }
+                else if (opTag <= VENT_UPDATE_OP_FILL)
+                {
+                    decState = VENT_UPDATE_DEC_LEN;
+                }
+                else
+                {
+                    VentUpdate_Fail(VENT_UPDATE_BAD_PATCH);
+                }
+                break;
+
+            case VENT_UPDATE_DEC_LEN:
+                if (!VentUpdate_Varint(b))
+                    break;
+                opLen = varValue;
+                if ((opLen == 0u) || (opLen > (newSize - outPos)))
+                {
+                    VentUpdate_Fail(VENT_UPDATE_BAD_PATCH);
+                    break;
+                }
+                VentUpdate_VarintReset();
+                decState = (opTag == VENT_UPDATE_OP_COPY) ? VENT_UPDATE_DEC_SRC :
+                           (opTag == VENT_UPDATE_OP_INSERT) ? VENT_UPDATE_DEC_INSERT : VENT_UPDATE_DEC_FILL_BYTE;
+                break;
+
+            case VENT_UPDATE_DEC_SRC:
+                if (!VentUpdate_Varint(b))
+                    break;
+                /* zigzag: 0, -1, 1, -2 ... */
+                oldPos += (varValue & 1u) ? ~(varValue >> 1) : (varValue >> 1);
+                if ((oldPos > oldSize) || (opLen > (oldSize - oldPos)))
+                {
+                    VentUpdate_Fail(VENT_UPDATE_BAD_PATCH);
+                    break;
+                }
+                decState = VENT_UPDATE_DEC_COPY;
+                break;
+
+            case VENT_UPDATE_DEC_FILL_BYTE:
+                fillValue = b;
+                decState = VENT_UPDATE_DEC_FILL;
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+/***************************************************************
+ * Reset the engine
+ **************************************************************/
+void VentUpdate_Start(void)
+{
+    memset(&stats, 0, sizeof(stats));
+    updateState = VENT_UPDATE_IDLE;
+    inputLen = 0;
+    inputPos = 0;
+    pageBusy = 0;
+}
+
+/***************************************************************
+ * Feed the next patch chunk
+ **************************************************************/
+uint8 VentUpdate_Write(const uint8 *data, uint16 length)
+{
+    if ((length == 0u) || (length > VENT_UPDATE_CHUNK_MAX))
+        return VENT_UPDATE_BAD_PATCH;
+
+    if ((updateState == VENT_UPDATE_RECEIVING) || (updateState == VENT_UPDATE_FINISHING))
+    {
+        if ((inputPos < inputLen) || (decState == VENT_UPDATE_DEC_CHECK) ||
+            (updateState == VENT_UPDATE_FINISHING))
+            return VENT_UPDATE_BUSY;
+    }
+    else
+    {
+        /* Only a header starts a new patch, what follows a failed one
+           is refused until the hub starts over */
+        if ((length < 4u) || (VentUpdate_Get32(data) != VENT_UPDATE_MAGIC))
+            return VENT_UPDATE_BAD_HEADER;
+
+        /* The page buffer may still be on its way out */
+        if (pageBusy)
+            return VENT_UPDATE_BUSY;
+        memset(&stats, 0, sizeof(stats));
+        updateState = VENT_UPDATE_RECEIVING;
+        decState = VENT_UPDATE_DEC_HEADER;
+        opLen = 0;
+        oldPos = 0;
+        outPos = 0;
+        outCrc = 0xFFFFFFFFuL;
+        pageUsed = 0;
+        erasedEnd = VENT_UPDATE_IMAGE_ADDR;
+        headerErased = 0;
+        stagedWritten = 0;
+        startTime = VentTimer_GetTimeStamp();
+    }
+
+    memcpy(input, data, length);
+    inputLen = length;
+    inputPos = 0;
+    stats.patchBytes += length;
+    return VENT_UPDATE_OK;
+}
+
+/***************************************************************
+ * Apply buffered patch bytes, one NOR operation per call
+ **************************************************************/
+void VentUpdate_Process(void)
+{
+    uint8 staged[VENT_UPDATE_STAGED_LEN];
+    uint32 address;
+
+    if (pageBusy)
+    {
+        if (VentNor_IsBusy())
+            return;
+        pageBusy = 0;
+        pageUsed = 0;
+        stats.pagesWritten++;
+    }
+
+    if ((updateState != VENT_UPDATE_RECEIVING) && (updateState != VENT_UPDATE_FINISHING))
+        return;
+
+    /* An old staged image must not survive a patch that is underway */
+    if (!headerErased)
+    {
+        if (VentNor_IsBusy())
+            return;
+        VentNor_EraseSector(VENT_UPDATE_HEADER_ADDR);
+        headerErased = 1;
+        return;
+    }
+
+    if ((updateState == VENT_UPDATE_RECEIVING) && (decState == VENT_UPDATE_DEC_CHECK))
+    {
+        VentUpdate_Check();
+        return;
+    }
+
+    if (updateState == VENT_UPDATE_RECEIVING)
+    {
+        VentUpdate_Decode();
+        if ((updateState == VENT_UPDATE_RECEIVING) && (decState == VENT_UPDATE_DEC_END))
+        {
+            updateState = VENT_UPDATE_FINISHING;
+        }
+    }
+
+    if ((pageUsed == VENT_NOR_PAGE_SIZE) || ((updateState == VENT_UPDATE_FINISHING) && (pageUsed != 0u)))
+    {
+        if (VentNor_IsBusy())
+            return;
+        address = VENT_UPDATE_IMAGE_ADDR + outPos - pageUsed;
+        if (address >= erasedEnd)
+        {
+            VentNor_EraseSector(erasedEnd);
+            erasedEnd += VENT_NOR_SECTOR_SIZE;
+            return;
+        }
+        VentNor_ProgramPage(address, page, pageUsed);
+        pageBusy = 1;
+        return;
+    }
+
+    if ((updateState == VENT_UPDATE_FINISHING) && !stagedWritten)
+    {
+        if (VentNor_IsBusy())
+            return;
+        VentUpdate_Put32(&staged[0], VENT_UPDATE_STAGED_MAGIC);
+        VentUpdate_Put32(&staged[4], newSize);
+        VentUpdate_Put32(&staged[8], newCrc);
+        VentUpdate_Put32(&staged[12], oldCrc);
+        memcpy(page, staged, sizeof(staged));
+        VentNor_ProgramPage(VENT_UPDATE_HEADER_ADDR, page, sizeof(staged));
+        stagedWritten = 1;
+        return;
+    }
+
+    if ((updateState == VENT_UPDATE_FINISHING) && stagedWritten && !VentNor_IsBusy())
+    {
+        stats.imageBytes = outPos;
+        stats.applyTime = VentTimer_GetTimeStamp() - startTime;
+        updateState = VENT_UPDATE_STAGED;
+    }
+}
+
+/***************************************************************
+ * Engine state and statistics
+ **************************************************************/
+VENT_UPDATE_STATE_T VentUpdate_GetState(void)
+{
+    return updateState;
+}
+
+const VENT_UPDATE_STATS_T *VentUpdate_GetStats(void)
+{
+    return &stats;
+}
+
+/* [] END OF FILE */
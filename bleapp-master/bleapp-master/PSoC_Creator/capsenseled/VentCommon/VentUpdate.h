@@ -0,0 +1,124 @@
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#ifndef _VENT_UPDATE_H_
+#define _VENT_UPDATE_H_
+
+#include <project.h>
+#include "VentNor.h"
+
+/* Firmware delta patch, built by Tools/VentDiff from two .hex images.
+
+   Header, little endian:
+     magic    uint32  VENT_UPDATE_MAGIC
+     oldSize  uint32  bytes of the running image the patch reads from
+     oldCrc   uint32  CRC-32 of those bytes, the patch only fits that build
+     newSize  uint32  bytes of the new image
+     newCrc   uint32  CRC-32 of the new image
+
+   Then operations until END, each a tag byte and LEB128 varints:
+     COPY   len, src   len bytes of the old image, src is the zigzag
+                       distance from where the previous COPY ended
+     INSERT len, bytes literal bytes
+     FILL   len, byte  a run of one value
+
+   The new image is rebuilt into the NOR staging area with one page
+   buffer, the old image is read straight from the internal flash.
+
+   The old image ends where .cy_checksum_exclude starts: the rows the
+   vent rewrites (bonding data, damper calibration) differ from vent to
+   vent and must not take part in the CRC or be copied from. */
+#define VENT_UPDATE_MAGIC           (0x31504456uL)      /* "VDP1" */
+#define VENT_UPDATE_HEADER_LEN      (20u)
+
+#define VENT_UPDATE_OP_END          (0x00u)
+#define VENT_UPDATE_OP_COPY         (0x01u)
+#define VENT_UPDATE_OP_INSERT       (0x02u)
+#define VENT_UPDATE_OP_FILL         (0x03u)
+
+/* Staging area: header sector, then the image. The header is written
+   last, so a staged image is complete and checked once it is there. */
+#define VENT_UPDATE_STAGED_MAGIC    (0x47545356uL)      /* "VSTG" */
+#define VENT_UPDATE_HEADER_ADDR     (VENT_NOR_STAGING_ADDR)
+#define VENT_UPDATE_IMAGE_ADDR      (VENT_NOR_STAGING_ADDR + VENT_NOR_SECTOR_SIZE)
+#define VENT_UPDATE_IMAGE_MAX       (VENT_NOR_STAGING_SIZE - VENT_NOR_SECTOR_SIZE)
+
+/* Largest patch chunk per write, the default 23 byte ATT MTU */
+#define VENT_UPDATE_CHUNK_MAX       (20u)
+
+/* Old image bytes CRCed per VentUpdate_Process() call, keeps the main
+   loop turning while a 256 KB image is checked */
+#define VENT_UPDATE_CHECK_SLICE     (1024u)
+
+/* ATT application error for a chunk that arrived before the last one
+   was consumed, the hub waits and writes it again */
+#define VENT_UPDATE_ATT_BUSY        (0x80u)
+
+/* ATT application error for a chunk that was refused, the hub gives up
+   the patch and starts over with the header */
+#define VENT_UPDATE_ATT_REFUSED     (0x81u)
+
+typedef enum
+{
+    VENT_UPDATE_IDLE,
+    VENT_UPDATE_RECEIVING,
+    VENT_UPDATE_FINISHING,
+    VENT_UPDATE_STAGED,
+    VENT_UPDATE_FAILED
+} VENT_UPDATE_STATE_T;
+
+/* VentUpdate_Write results and failure reasons */
+#define VENT_UPDATE_OK              (0u)
+#define VENT_UPDATE_BUSY            (1u)
+#define VENT_UPDATE_BAD_HEADER      (2u)
+#define VENT_UPDATE_WRONG_IMAGE     (3u)
+#define VENT_UPDATE_BAD_PATCH       (4u)
+#define VENT_UPDATE_BAD_CRC         (5u)
+
+typedef struct
+{
+    uint32 patchBytes;
+    uint32 imageBytes;
+    uint32 copyBytes;
+    uint32 insertBytes;
+    uint32 fillBytes;
+    uint32 pagesWritten;
+    uint32 applyTime;       /* ms from the header to the staged image */
+    uint8  error;
+} VENT_UPDATE_STATS_T;
+
+/***************************************************************
+ * Reset the engine, call after VentStore_Start() started the NOR
+ **************************************************************/
+void VentUpdate_Start(void);
+
+/***************************************************************
+ * Feed the next patch chunk. Once a patch finished or failed,
+ * only a chunk that begins with VENT_UPDATE_MAGIC starts a new
+ * one, the rest of a failed patch gets VENT_UPDATE_BAD_HEADER.
+ * Returns VENT_UPDATE_BUSY while the previous chunk or the check
+ * of the old image is still going on.
+ **************************************************************/
+uint8 VentUpdate_Write(const uint8 *data, uint16 length);
+
+/***************************************************************
+ * Apply buffered patch bytes, call from the main loop. Returns
+ * without waiting whenever the NOR is busy, and CRCs at most
+ * VENT_UPDATE_CHECK_SLICE bytes of the old image per call.
+ **************************************************************/
+void VentUpdate_Process(void);
+
+VENT_UPDATE_STATE_T VentUpdate_GetState(void);
+const VENT_UPDATE_STATS_T *VentUpdate_GetStats(void);
+
+#endif /* _VENT_UPDATE_H_ */
+
+/* [] END OF FILE */
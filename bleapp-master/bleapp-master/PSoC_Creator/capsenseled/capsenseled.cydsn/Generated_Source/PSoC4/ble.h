@@ -213,7 +213,7 @@
 #define CYBLE_GATT_MTU_PLUS_L2CAP_MEM_EXT   (CYBLE_ALIGN_TO_4(CYBLE_GATT_MTU + CYBLE_MEM_EXT_SZ + CYBLE_L2CAP_HDR_SZ))
 
 /* GATT Maximum attribute length */
-#define CYBLE_GATT_MAX_ATTR_LEN             ((0x000Bu == 0u) ? (1u) : (0x000Bu))
+#define CYBLE_GATT_MAX_ATTR_LEN             ((0x0100u == 0u) ? (1u) : (0x0100u))
 #define CYBLE_GATT_MAX_ATTR_LEN_PLUS_L2CAP_MEM_EXT \
                                     (CYBLE_ALIGN_TO_4(CYBLE_GATT_MAX_ATTR_LEN + CYBLE_MEM_EXT_SZ + CYBLE_L2CAP_HDR_SZ))
 
@@ -223,9 +223,9 @@
 #define CYBLE_GATT_WRITE_HEADER_LEN         (3u)
 
 /* Number of characteristics supporting reliable write property */
-#define CYBLE_GATT_RELIABLE_CHAR_COUNT      (0x0000u)
+#define CYBLE_GATT_RELIABLE_CHAR_COUNT      (0x0001u)
 /* The total length of characteristics with reliable write property */
-#define CYBLE_GATT_RELIABLE_CHAR_LENGTH      (0x0000u)
+#define CYBLE_GATT_RELIABLE_CHAR_LENGTH      (0x0064u)
 
 #define CYBLE_GATT_PREPARE_LENGTH           ((CYBLE_GATT_RELIABLE_CHAR_LENGTH > CYBLE_GATT_MAX_ATTR_LEN) ? \
                                              CYBLE_GATT_RELIABLE_CHAR_LENGTH : CYBLE_GATT_MAX_ATTR_LEN)
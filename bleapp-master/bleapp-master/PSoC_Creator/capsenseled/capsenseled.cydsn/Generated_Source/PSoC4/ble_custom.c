@@ -62,6 +62,50 @@ const CYBLE_CUSTOMS_T cyBle_customs[0x01u] = {
                     CYBLE_GATT_INVALID_ATTR_HANDLE_VALUE, 
                 }, 
             },
+
+            /* Control characteristic */
+            {
+                0x0018u, /* Handle of the Control characteristic */ 
+                
+                /* Array of Descriptors handles */
+                {
+                    0x0019u, /* Handle of the Characteristic User Description descriptor */ 
+                    CYBLE_GATT_INVALID_ATTR_HANDLE_VALUE, 
+                }, 
+            },
+
+            /* Log characteristic */
+            {
+                0x001Bu, /* Handle of the Log characteristic */ 
+                
+                /* Array of Descriptors handles */
+                {
+                    0x001Cu, /* Handle of the Characteristic User Description descriptor */ 
+                    CYBLE_GATT_INVALID_ATTR_HANDLE_VALUE, 
+                }, 
+            },
+
+            /* Schedule characteristic */
+            {
+                0x001Eu, /* Handle of the Schedule characteristic */ 
+                
+                /* Array of Descriptors handles */
+                {
+                    0x001Fu, /* Handle of the Characteristic Extended Properties descriptor */ 
+                    0x0020u, /* Handle of the Characteristic User Description descriptor */ 
+                }, 
+            },
+
+            /* Status characteristic */
+            {
+                0x0022u, /* Handle of the Status characteristic */ 
+                
+                /* Array of Descriptors handles */
+                {
+                    0x0023u, /* Handle of the StatusCCCD descriptor */ 
+                    0x0024u, /* Handle of the Characteristic User Description descriptor */ 
+                }, 
+            },
         }, 
     },
 };
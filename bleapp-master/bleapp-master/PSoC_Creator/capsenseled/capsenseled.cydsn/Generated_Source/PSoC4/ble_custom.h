@@ -26,7 +26,7 @@
 /* Maximum supported Custom Services */
 #define CYBLE_CUSTOMS_SERVICE_COUNT                  (0x01u)
 #define CYBLE_CUSTOMC_SERVICE_COUNT                  (0x00u)
-#define CYBLE_CUSTOM_SERVICE_CHAR_COUNT              (0x03u)
+#define CYBLE_CUSTOM_SERVICE_CHAR_COUNT              (0x07u)
 #define CYBLE_CUSTOM_SERVICE_CHAR_DESCRIPTORS_COUNT  (0x02u)
 
 /* Below are the indexes and handles of the defined Custom Services and their characteristics */
@@ -38,6 +38,16 @@
 #define CYBLE_LEDCAPSENSE_TEMP_CHARACTERISTIC_USER_DESCRIPTION_DESC_INDEX   (0x01u) /* Index of Characteristic User Description descriptor */
 #define CYBLE_LEDCAPSENSE_SERVO_CHAR_INDEX   (0x02u) /* Index of Servo characteristic */
 #define CYBLE_LEDCAPSENSE_SERVO_CHARACTERISTIC_USER_DESCRIPTION_DESC_INDEX   (0x00u) /* Index of Characteristic User Description descriptor */
+#define CYBLE_LEDCAPSENSE_CONTROL_CHAR_INDEX   (0x03u) /* Index of Control characteristic */
+#define CYBLE_LEDCAPSENSE_CONTROL_CHARACTERISTIC_USER_DESCRIPTION_DESC_INDEX   (0x00u) /* Index of Characteristic User Description descriptor */
+#define CYBLE_LEDCAPSENSE_LOG_CHAR_INDEX   (0x04u) /* Index of Log characteristic */
+#define CYBLE_LEDCAPSENSE_LOG_CHARACTERISTIC_USER_DESCRIPTION_DESC_INDEX   (0x00u) /* Index of Characteristic User Description descriptor */
+#define CYBLE_LEDCAPSENSE_SCHEDULE_CHAR_INDEX   (0x05u) /* Index of Schedule characteristic */
+#define CYBLE_LEDCAPSENSE_SCHEDULE_CHARACTERISTIC_EXTENDED_PROPERTIES_DESC_INDEX   (0x00u) /* Index of Characteristic Extended Properties descriptor */
+#define CYBLE_LEDCAPSENSE_SCHEDULE_CHARACTERISTIC_USER_DESCRIPTION_DESC_INDEX   (0x01u) /* Index of Characteristic User Description descriptor */
+#define CYBLE_LEDCAPSENSE_STATUS_CHAR_INDEX   (0x06u) /* Index of Status characteristic */
+#define CYBLE_LEDCAPSENSE_STATUS_STATUSCCCD_DESC_INDEX   (0x00u) /* Index of StatusCCCD descriptor */
+#define CYBLE_LEDCAPSENSE_STATUS_CHARACTERISTIC_USER_DESCRIPTION_DESC_INDEX   (0x01u) /* Index of Characteristic User Description descriptor */
 
 
 #define CYBLE_LEDCAPSENSE_SERVICE_HANDLE   (0x000Cu) /* Handle of ledcapsense service */
@@ -51,6 +61,20 @@
 #define CYBLE_LEDCAPSENSE_SERVO_DECL_HANDLE   (0x0014u) /* Handle of Servo characteristic declaration */
 #define CYBLE_LEDCAPSENSE_SERVO_CHAR_HANDLE   (0x0015u) /* Handle of Servo characteristic */
 #define CYBLE_LEDCAPSENSE_SERVO_CHARACTERISTIC_USER_DESCRIPTION_DESC_HANDLE   (0x0016u) /* Handle of Characteristic User Description descriptor */
+#define CYBLE_LEDCAPSENSE_CONTROL_DECL_HANDLE   (0x0017u) /* Handle of Control characteristic declaration */
+#define CYBLE_LEDCAPSENSE_CONTROL_CHAR_HANDLE   (0x0018u) /* Handle of Control characteristic */
+#define CYBLE_LEDCAPSENSE_CONTROL_CHARACTERISTIC_USER_DESCRIPTION_DESC_HANDLE   (0x0019u) /* Handle of Characteristic User Description descriptor */
+#define CYBLE_LEDCAPSENSE_LOG_DECL_HANDLE   (0x001Au) /* Handle of Log characteristic declaration */
+#define CYBLE_LEDCAPSENSE_LOG_CHAR_HANDLE   (0x001Bu) /* Handle of Log characteristic */
+#define CYBLE_LEDCAPSENSE_LOG_CHARACTERISTIC_USER_DESCRIPTION_DESC_HANDLE   (0x001Cu) /* Handle of Characteristic User Description descriptor */
+#define CYBLE_LEDCAPSENSE_SCHEDULE_DECL_HANDLE   (0x001Du) /* Handle of Schedule characteristic declaration */
+#define CYBLE_LEDCAPSENSE_SCHEDULE_CHAR_HANDLE   (0x001Eu) /* Handle of Schedule characteristic */
+#define CYBLE_LEDCAPSENSE_SCHEDULE_CHARACTERISTIC_EXTENDED_PROPERTIES_DESC_HANDLE   (0x001Fu) /* Handle of Characteristic Extended Properties descriptor */
+#define CYBLE_LEDCAPSENSE_SCHEDULE_CHARACTERISTIC_USER_DESCRIPTION_DESC_HANDLE   (0x0020u) /* Handle of Characteristic User Description descriptor */
+#define CYBLE_LEDCAPSENSE_STATUS_DECL_HANDLE   (0x0021u) /* Handle of Status characteristic declaration */
+#define CYBLE_LEDCAPSENSE_STATUS_CHAR_HANDLE   (0x0022u) /* Handle of Status characteristic */
+#define CYBLE_LEDCAPSENSE_STATUS_STATUSCCCD_DESC_HANDLE   (0x0023u) /* Handle of StatusCCCD descriptor */
+#define CYBLE_LEDCAPSENSE_STATUS_CHARACTERISTIC_USER_DESCRIPTION_DESC_HANDLE   (0x0024u) /* Handle of Characteristic User Description descriptor */
 
 
 
@@ -80,24 +80,29 @@ CYBLE_STATE_T cyBle_state;
         {{
             0x00u, 0x00u,
             0x00u, 0x00u,
+            0x00u, 0x00u,
         },
         {
             0x00u, 0x00u,
             0x00u, 0x00u,
+            0x00u, 0x00u,
         },
         {
             0x00u, 0x00u,
             0x00u, 0x00u,
+            0x00u, 0x00u,
         },
         {
             0x00u, 0x00u,
             0x00u, 0x00u,
+            0x00u, 0x00u,
         },
         {
             0x00u, 0x00u,
             0x00u, 0x00u,
+            0x00u, 0x00u,
         }}, 
-        0x04u, /* CYBLE_GATT_DB_CCCD_COUNT */ 
+        0x06u, /* CYBLE_GATT_DB_CCCD_COUNT */ 
         0x05u, /* CYBLE_GAP_MAX_BONDED_DEVICE */ 
     };
 #endif /* (CYBLE_MODE_PROFILE) */
@@ -113,7 +118,7 @@ CYBLE_STATE_T cyBle_state;
     0x000Bu,    /* Handle of the Client Characteristic Configuration descriptor */
 };
     
-    static uint8 cyBle_attValues[0x37u] = {
+    static uint8 cyBle_attValues[0x1DFu] = {
     /* Device Name */
     (uint8)'c', (uint8)'a', (uint8)'p', (uint8)'l', (uint8)'e', (uint8)'d',
 
@@ -146,6 +151,59 @@ CYBLE_STATE_T cyBle_state;
     (uint8)'u', (uint8)'i', (uint8)'n', (uint8)'t', (uint8)'8', (uint8)' ', (uint8)'s', (uint8)'e', (uint8)'r',
     (uint8)'v', (uint8)'o',
 
+    /* Control */
+    0x34u, 0x08u, 0x00u, 0x00u, 0xE8u, 0x03u, 0xC8u, 0x00u, 0x64u, 0x00u, 0x2Cu, 0x01u, 0x01u, 0x00u,
+
+    /* Characteristic User Description */
+    (uint8)'v', (uint8)'e', (uint8)'n', (uint8)'t', (uint8)' ', (uint8)'c', (uint8)'o', (uint8)'n', (uint8)'t',
+    (uint8)'r', (uint8)'o', (uint8)'l',
+
+    /* Log */
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+    0x00u,
+
+    /* Characteristic User Description */
+    (uint8)'v', (uint8)'e', (uint8)'n', (uint8)'t', (uint8)' ', (uint8)'l', (uint8)'o', (uint8)'g',
+
+    /* Schedule */
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+
+    /* Characteristic Extended Properties */
+    0x01u, 0x00u,
+
+    /* Characteristic User Description */
+    (uint8)'v', (uint8)'e', (uint8)'n', (uint8)'t', (uint8)' ', (uint8)'s', (uint8)'c', (uint8)'h', (uint8)'e',
+    (uint8)'d', (uint8)'u', (uint8)'l', (uint8)'e',
+
+    /* Status */
+    0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+
+    /* Characteristic User Description */
+    (uint8)'v', (uint8)'e', (uint8)'n', (uint8)'t', (uint8)' ', (uint8)'s', (uint8)'t', (uint8)'a', (uint8)'t',
+    (uint8)'u', (uint8)'s',
+
 };
 #if(CYBLE_GATT_DB_CCCD_COUNT != 0u)
 uint8 cyBle_attValuesCCCD[CYBLE_GATT_DB_CCCD_COUNT];
@@ -160,6 +218,14 @@ const uint8 cyBle_attUuid128[][16u] = {
     { 0xF4u, 0x34u, 0x9Bu, 0x5Fu, 0x80u, 0x00u, 0x00u, 0x80u, 0x00u, 0x10u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u },
     /* Servo */
     { 0xF3u, 0x34u, 0x9Bu, 0x5Fu, 0x80u, 0x00u, 0x00u, 0x80u, 0x00u, 0x10u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u },
+    /* Control */
+    { 0xF5u, 0x34u, 0x9Bu, 0x5Fu, 0x80u, 0x00u, 0x00u, 0x80u, 0x00u, 0x10u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u },
+    /* Log */
+    { 0xF6u, 0x34u, 0x9Bu, 0x5Fu, 0x80u, 0x00u, 0x00u, 0x80u, 0x00u, 0x10u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u },
+    /* Schedule */
+    { 0xF7u, 0x34u, 0x9Bu, 0x5Fu, 0x80u, 0x00u, 0x00u, 0x80u, 0x00u, 0x10u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u },
+    /* Status */
+    { 0xF8u, 0x34u, 0x9Bu, 0x5Fu, 0x80u, 0x00u, 0x00u, 0x80u, 0x00u, 0x10u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u },
 };
 
 CYBLE_GATTS_ATT_GEN_VAL_LEN_T cyBle_attValuesLen[CYBLE_GATT_DB_ATT_VAL_COUNT] = {
@@ -179,9 +245,23 @@ CYBLE_GATTS_ATT_GEN_VAL_LEN_T cyBle_attValuesLen[CYBLE_GATT_DB_ATT_VAL_COUNT] =
     { 0x0010u, (void *)&cyBle_attUuid128[3] }, /* Servo UUID */
     { 0x0001u, (void *)&cyBle_attValues[43] }, /* Servo */
     { 0x000Bu, (void *)&cyBle_attValues[44] }, /* Characteristic User Description */
+    { 0x0010u, (void *)&cyBle_attUuid128[4] }, /* Control UUID */
+    { 0x000Eu, (void *)&cyBle_attValues[55] }, /* Control */
+    { 0x000Cu, (void *)&cyBle_attValues[69] }, /* Characteristic User Description */
+    { 0x0010u, (void *)&cyBle_attUuid128[5] }, /* Log UUID */
+    { 0x0100u, (void *)&cyBle_attValues[81] }, /* Log */
+    { 0x0008u, (void *)&cyBle_attValues[337] }, /* Characteristic User Description */
+    { 0x0010u, (void *)&cyBle_attUuid128[6] }, /* Schedule UUID */
+    { 0x0064u, (void *)&cyBle_attValues[345] }, /* Schedule */
+    { 0x0002u, (void *)&cyBle_attValues[445] }, /* Characteristic Extended Properties */
+    { 0x000Du, (void *)&cyBle_attValues[447] }, /* Characteristic User Description */
+    { 0x0010u, (void *)&cyBle_attUuid128[7] }, /* Status UUID */
+    { 0x0008u, (void *)&cyBle_attValues[460] }, /* Status */
+    { 0x0002u, (void *)&cyBle_attValuesCCCD[4] }, /* StatusCCCD */
+    { 0x000Bu, (void *)&cyBle_attValues[468] }, /* Characteristic User Description */
 };
 
-const CYBLE_GATTS_DB_T cyBle_gattDB[0x16u] = {
+const CYBLE_GATTS_DB_T cyBle_gattDB[0x24u] = {
     { 0x0001u, 0x2800u /* Primary service                     */, 0x00000001u /*        */, 0x0007u, {{0x1800u, NULL}}                           },
     { 0x0002u, 0x2803u /* Characteristic                      */, 0x00020001u /* rd     */, 0x0003u, {{0x2A00u, NULL}}                           },
     { 0x0003u, 0x2A00u /* Device Name                         */, 0x01020001u /* rd     */, 0x0003u, {{0x0006u, (void *)&cyBle_attValuesLen[0]}} },
@@ -193,7 +273,7 @@ const CYBLE_GATTS_DB_T cyBle_gattDB[0x16u] = {
     { 0x0009u, 0x2803u /* Characteristic                      */, 0x00220001u /* rd,ind */, 0x000Bu, {{0x2A05u, NULL}}                           },
     { 0x000Au, 0x2A05u /* Service Changed                     */, 0x01220001u /* rd,ind */, 0x000Bu, {{0x0004u, (void *)&cyBle_attValuesLen[3]}} },
     { 0x000Bu, 0x2902u /* Client Characteristic Configuration */, 0x010A0101u /* rd,wr  */, 0x000Bu, {{0x0002u, (void *)&cyBle_attValuesLen[4]}} },
-    { 0x000Cu, 0x2800u /* Primary service                     */, 0x08000001u /*        */, 0x0016u, {{0x0010u, (void *)&cyBle_attValuesLen[5]}} },
+    { 0x000Cu, 0x2800u /* Primary service                     */, 0x08000001u /*        */, 0x0024u, {{0x0010u, (void *)&cyBle_attValuesLen[5]}} },
     { 0x000Du, 0x2803u /* Characteristic                      */, 0x000A0001u /* rd,wr  */, 0x000Fu, {{0x0010u, (void *)&cyBle_attValuesLen[6]}} },
     { 0x000Eu, 0x0000u /* led                                 */, 0x090A0101u /* rd,wr  */, 0x000Fu, {{0x0001u, (void *)&cyBle_attValuesLen[7]}} },
     { 0x000Fu, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd     */, 0x000Fu, {{0x0009u, (void *)&cyBle_attValuesLen[8]}} },
@@ -204,6 +284,20 @@ const CYBLE_GATTS_DB_T cyBle_gattDB[0x16u] = {
     { 0x0014u, 0x2803u /* Characteristic                      */, 0x000A0001u /* rd,wr  */, 0x0016u, {{0x0010u, (void *)&cyBle_attValuesLen[13]}} },
     { 0x0015u, 0x0000u /* Servo                               */, 0x090A0101u /* rd,wr  */, 0x0016u, {{0x0001u, (void *)&cyBle_attValuesLen[14]}} },
     { 0x0016u, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd     */, 0x0016u, {{0x000Bu, (void *)&cyBle_attValuesLen[15]}} },
+    { 0x0017u, 0x2803u /* Characteristic                      */, 0x000A0001u /* rd,wr  */, 0x0019u, {{0x0010u, (void *)&cyBle_attValuesLen[16]}} },
+    { 0x0018u, 0x0000u /* Control                             */, 0x090A0101u /* rd,wr  */, 0x0019u, {{0x000Eu, (void *)&cyBle_attValuesLen[17]}} },
+    { 0x0019u, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd     */, 0x0019u, {{0x000Cu, (void *)&cyBle_attValuesLen[18]}} },
+    { 0x001Au, 0x2803u /* Characteristic                      */, 0x000A0001u /* rd,wr  */, 0x001Cu, {{0x0010u, (void *)&cyBle_attValuesLen[19]}} },
+    { 0x001Bu, 0x0000u /* Log                                 */, 0x090A0101u /* rd,wr  */, 0x001Cu, {{0x0100u, (void *)&cyBle_attValuesLen[20]}} },
+    { 0x001Cu, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd     */, 0x001Cu, {{0x0008u, (void *)&cyBle_attValuesLen[21]}} },
+    { 0x001Du, 0x2803u /* Characteristic                      */, 0x00880001u /* wr     */, 0x0020u, {{0x0010u, (void *)&cyBle_attValuesLen[22]}} },
+    { 0x001Eu, 0x0000u /* Schedule                            */, 0x09880101u /* wr     */, 0x0020u, {{0x0064u, (void *)&cyBle_attValuesLen[23]}} },
+    { 0x001Fu, 0x2900u /* Characteristic Extended Properties  */, 0x01020001u /* rd     */, 0x001Fu, {{0x0002u, (void *)&cyBle_attValuesLen[24]}} },
+    { 0x0020u, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd     */, 0x0020u, {{0x000Du, (void *)&cyBle_attValuesLen[25]}} },
+    { 0x0021u, 0x2803u /* Characteristic                      */, 0x00120001u /* rd,ntf */, 0x0024u, {{0x0010u, (void *)&cyBle_attValuesLen[26]}} },
+    { 0x0022u, 0x0000u /* Status                              */, 0x09120001u /* rd,ntf */, 0x0024u, {{0x0008u, (void *)&cyBle_attValuesLen[27]}} },
+    { 0x0023u, 0x2902u /* StatusCCCD                          */, 0x010A0101u /* rd,wr  */, 0x0023u, {{0x0002u, (void *)&cyBle_attValuesLen[28]}} },
+    { 0x0024u, 0x2901u /* Characteristic User Description     */, 0x01020001u /* rd     */, 0x0024u, {{0x000Bu, (void *)&cyBle_attValuesLen[29]}} },
 };
 
 
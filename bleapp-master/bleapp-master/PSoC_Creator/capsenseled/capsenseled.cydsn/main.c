@@ -1,15 +1,89 @@
 #include <project.h>
 #include <stdio.h>
+#include <string.h>
+#include "VentTimer.h"
+#include "VentPublish.h"
+#include "VentMotion.h"
+#include "VentControl.h"
+#include "VentLog.h"
+#include "VentSchedule.h"
+#include "VentStatus.h"
+
+/* Temperature publish policy, Temp is in 1/100 degC */
+#define TEMP_MIN_INTERVAL_MS    (2000u)
+#define TEMP_MAX_SILENCE_MS     (60000u)
+#define TEMP_ABS_DELTA          (10u)
+
+/* Status publish policy, the whole vent state in one bit-packed record
+   (ms, 1/16 degC, permille) */
+#define STATUS_MIN_INTERVAL_MS  (2000u)
+#define STATUS_MAX_SILENCE_MS   (60000u)
+#define STATUS_TEMP_DELTA       (2u)
+#define STATUS_POSITION_DELTA   (10u)
+
+/* History record every minute */
+#define LOG_INTERVAL_MS         (60000u)
 
 uint16 fingerPos    = 0xFFFF;
 uint16 fingerPosOld = 0xFFFF;
 
-int capsenseNotify, tempNotify;
+int capsenseNotify;
+
+volatile uint16 Temp;
+
+/* Fields packed into the Temp characteristic notification */
+VENT_PUBLISH_FIELD_T tempFields[] =
+{
+    /* size, absDelta, relDelta */
+    { sizeof(uint16), TEMP_ABS_DELTA, 0u, 0, 0 },
+};
 
-volatile uint16 Temp, TempOld;
+VENT_PUBLISH_GROUP_T tempGroup =
+{
+    CYBLE_LEDCAPSENSE_TEMP_CHAR_HANDLE,
+    tempFields,
+    sizeof(tempFields) / sizeof(tempFields[0]),
+    TEMP_MIN_INTERVAL_MS,
+    TEMP_MAX_SILENCE_MS,
+    0,                      /* pack, fields one after the other */
+    0u, 0u, 0u, { 0u }, 0u, 0u, 0u, 0u
+};
+
+VENT_PUBLISH_FIELD_T statusFields[VENT_STATUS_FIELDS] =
+{
+    /* size, absDelta, relDelta, order as VENT_STATUS_FIELD_ */
+    { 0u, STATUS_TEMP_DELTA,     0u, 0, 0 },
+    { 0u, STATUS_POSITION_DELTA, 0u, 0, 0 },
+    { 0u, 0u,                    0u, 0, 0 },
+    { 0u, 0u,                    0u, 0, 0 },
+    { 0u, 0u,                    0u, 0, 0 },
+};
+
+VENT_PUBLISH_GROUP_T statusGroup =
+{
+    CYBLE_LEDCAPSENSE_STATUS_CHAR_HANDLE,
+    statusFields,
+    sizeof(statusFields) / sizeof(statusFields[0]),
+    STATUS_MIN_INTERVAL_MS,
+    STATUS_MAX_SILENCE_MS,
+    VentStatus_Pack,
+    0u, 0u, 0u, { 0u }, 0u, 0u, 0u, 0u
+};
 
 int flag;
 
+/* On-vent temperature controller, set up by the hub through the
+   Control characteristic and switched by the schedule */
+VENT_CONTROL_T ventControl;
+
+uint32 logTime;
+
+/* Row of a history download, served to the hub with Read Blob */
+uint8 logBuffer[CY_FLASH_SIZEOF_ROW];
+
+/* Long write of the schedule table in progress */
+uint8 scheduleBuffer[VENT_SCHEDULE_TABLE_MAX_LEN];
+
 /***************************************************************
  * Function to update the Servo state in the GATT database
  **************************************************************/
@@ -26,6 +100,24 @@ void updateServo()
     CyBle_GattsWriteAttributeValue(&tempHandle,0,&cyBle_connHandle,CYBLE_GATT_DB_LOCALLY_INITIATED);  
 }
 
+/***************************************************************
+ * Function to update the controller settings in the GATT database
+ **************************************************************/
+void updateControl()
+{
+    CYBLE_GATTS_HANDLE_VALUE_NTF_T 	tempHandle;
+    uint8 record[VENT_CONTROL_CHAR_LEN];
+
+    if(CyBle_GetState() != CYBLE_STATE_CONNECTED)
+        return;
+
+    VentControl_Pack(&ventControl, record);
+    tempHandle.attrHandle = CYBLE_LEDCAPSENSE_CONTROL_CHAR_HANDLE;
+    tempHandle.value.val = record;
+    tempHandle.value.len = VENT_CONTROL_CHAR_LEN;
+    CyBle_GattsWriteAttributeValue(&tempHandle,0,&cyBle_connHandle,CYBLE_GATT_DB_LOCALLY_INITIATED);
+}
+
 /***************************************************************
  * Function to update the LED state in the GATT database
  **************************************************************/
@@ -66,25 +158,180 @@ void updateLed()
 //}
 
 /***************************************************************
- * Function to update the CapSesnse state in the GATT database
+ * Function to update the Temp state in the GATT database
  **************************************************************/
 void updateTemp()
 {
-    if(CyBle_GetState() != CYBLE_STATE_CONNECTED)
+    /* the publish policy decides if the reading is worth a notification */
+    VentPublish_SetField(&tempGroup, 0, Temp);
+    VentPublish_Process(&tempGroup, VentTimer_GetTimeStamp());
+}
+
+/***************************************************************
+ * Function to collect the vent state for the status characteristic
+ **************************************************************/
+void updateStatus()
+{
+    uint8 faults = 0;
+
+    if (ventControl.enabled)
+        faults |= VENT_STATUS_FLAG_CONTROL;
+    if (VentDamper_IsEnergised())
+        faults |= VENT_STATUS_FLAG_MOVING;
+
+    VentPublish_SetField(&statusGroup, VENT_STATUS_FIELD_TEMPERATURE, VENT_STATUS_TEMP_FROM_C100((int16)Temp));
+    VentPublish_SetField(&statusGroup, VENT_STATUS_FIELD_POSITION, VentDamper_GetPosition());
+    VentPublish_SetField(&statusGroup, VENT_STATUS_FIELD_FAULTS, faults);
+    VentPublish_Process(&statusGroup, VentTimer_GetTimeStamp());
+}
+
+/***************************************************************
+ * Function to add a history record once per log interval
+ **************************************************************/
+void updateLog()
+{
+    VENT_LOG_RECORD_T record;
+    uint32 now = VentTimer_GetTimeStamp();
+
+    if ((uint32)(now - logTime) < LOG_INTERVAL_MS)
         return;
-    
-	CYBLE_GATTS_HANDLE_VALUE_NTF_T 	tempHandle;
-    
-    tempHandle.attrHandle = CYBLE_LEDCAPSENSE_TEMP_CHAR_HANDLE;
-  	//tempHandle.value.val = (uint8 *)&fingerPos;
-    tempHandle.value.val = (uint8 *)&Temp;
-    tempHandle.value.len = 2; 
-    CyBle_GattsWriteAttributeValue(&tempHandle,0,&cyBle_connHandle,CYBLE_GATT_DB_LOCALLY_INITIATED );  
-    
-    /* send notification to client if notifications are enabled and temperature has changed */
-    if (tempNotify && (Temp != TempOld) )
-        CyBle_GattsNotification(cyBle_connHandle,&tempHandle);
-        TempOld = Temp;
+    logTime = now;
+
+    record.time = now / 1000u;
+    record.temperature = (int16)Temp;
+    record.position = VentDamper_GetPosition();
+    record.pressure = 0;
+    VentLog_Append(&record);
+}
+
+/***************************************************************
+ * Function to serve a history download: slot 0 freezes the log,
+ * each slot puts one row in the GATT database for the hub to
+ * read, an empty value ends it
+ **************************************************************/
+void selectLogRow(uint16 slot)
+{
+    CYBLE_GATTS_HANDLE_VALUE_NTF_T 	tempHandle;
+    uint32 now = VentTimer_GetTimeStamp();
+
+    tempHandle.attrHandle = CYBLE_LEDCAPSENSE_LOG_CHAR_HANDLE;
+    tempHandle.value.val = logBuffer;
+    if (slot == VENT_LOG_SLOT_END)
+    {
+        VentLog_DownloadEnd(now);
+        tempHandle.value.len = 0;
+    }
+    else
+    {
+        if (slot == 0u)
+        {
+            VentLog_DownloadStart(now);
+        }
+        tempHandle.value.len = VentLog_DownloadRow(slot, logBuffer, now);
+    }
+    CyBle_GattsWriteAttributeValue(&tempHandle,0,&cyBle_connHandle,CYBLE_GATT_DB_LOCALLY_INITIATED);
+}
+
+/***************************************************************
+ * Function to act on a Servo command byte from the hub or the
+ * schedule: a legacy 0-5 step, or from the schedule only, a
+ * setpoint for the controller
+ **************************************************************/
+void applyServoCommand(uint8 command)
+{
+    if (command & VENT_CONTROL_SETPOINT_FLAG)
+    {
+        VentControl_SetSetpoint(&ventControl, VENT_CONTROL_DECODE_SETPOINT(command));
+        VentControl_Enable(&ventControl, 1, VentDamper_GetPosition());
+    }
+    else if (command <= VENT_DAMPER_LEGACY_STEPS)
+    {
+        VentControl_Enable(&ventControl, 0, 0);
+        VentMotion_MoveTo(VENT_DAMPER_FROM_STEP(command), VENT_MOTION_SCURVE);
+    }
+    updateControl();
+}
+
+/***************************************************************
+ * Function to run the weekly schedule from the WDT time base
+ **************************************************************/
+void updateSchedule()
+{
+    uint8 command = VentSchedule_Process(VentTimer_GetTimeStamp());
+
+    if (command != VENT_SCHEDULE_NONE)
+    {
+        applyServoCommand(command);
+    }
+}
+
+/***************************************************************
+ * Function to reject a write with an ATT error
+ **************************************************************/
+void sendWriteError(uint8 opCode, CYBLE_GATT_DB_ATTR_HANDLE_T attrHandle, CYBLE_GATT_ERR_CODE_T errorCode)
+{
+    CYBLE_GATTS_ERR_PARAM_T err;
+
+    err.opcode = opCode;
+    err.attrHandle = attrHandle;
+    err.errorCode = errorCode;
+    CyBle_GattsErrorRsp(cyBle_connHandle, &err);
+}
+
+/***************************************************************
+ * Function to give the hub the ATT error a schedule message
+ * was turned down with
+ **************************************************************/
+CYBLE_GATT_ERR_CODE_T scheduleError(uint8 result)
+{
+    switch (result)
+    {
+        case VENT_SCHEDULE_OK:
+            return CYBLE_GATT_ERR_NONE;
+        case VENT_SCHEDULE_BAD_CRC:
+            return CYBLE_GATT_ERR_INVALID_CRC;
+        case VENT_SCHEDULE_BAD_ENTRY:
+            return CYBLE_GATT_ERR_OUT_OF_RANGE;
+        case VENT_SCHEDULE_FLASH_ERROR:
+            return CYBLE_GATT_ERR_UNLIKELY_ERROR;
+        default:
+            return CYBLE_GATT_ERR_INVALID_ATTRIBUTE_LEN;
+    }
+}
+
+/***************************************************************
+ * Function to load the schedule table from a long write
+ **************************************************************/
+void execWriteSchedule(CYBLE_GATTS_EXEC_WRITE_REQ_T *req)
+{
+    CYBLE_GATT_ERR_CODE_T error;
+    uint16 length = 0;
+    uint8 i;
+
+    if ((req->execWriteFlag != CYBLE_GATT_EXECUTE_WRITE_EXEC_FLAG) || (req->prepWriteReqCount == 0u) ||
+        (req->baseAddr[0].handleValuePair.attrHandle != CYBLE_LEDCAPSENSE_SCHEDULE_CHAR_HANDLE))
+        return;
+
+    for (i = 0; i < req->prepWriteReqCount; i++)
+    {
+        length += req->baseAddr[i].handleValuePair.value.len;
+    }
+
+    /* the stack keeps the parts back to back from baseAddr[0] */
+    if ((length > sizeof(scheduleBuffer)) || (req->baseAddr[0].offset != 0u))
+    {
+        req->attrHandle = CYBLE_LEDCAPSENSE_SCHEDULE_CHAR_HANDLE;
+        req->gattErrorCode = CYBLE_GATT_ERR_INVALID_ATTRIBUTE_LEN;
+        return;
+    }
+    memcpy(scheduleBuffer, req->baseAddr[0].handleValuePair.value.val, length);
+
+    error = scheduleError(VentSchedule_Write(scheduleBuffer, length, VentTimer_GetTimeStamp()));
+    if (error != CYBLE_GATT_ERR_NONE)
+    {
+        req->attrHandle = CYBLE_LEDCAPSENSE_SCHEDULE_CHAR_HANDLE;
+        req->gattErrorCode = error;
+    }
 }
 
 /***************************************************************
@@ -99,7 +346,9 @@ void BleCallBack(uint32 event, void* eventParam)
         /* if there is a disconnect or the stack just turned on from a reset then start the advertising and turn on the LED blinking */
         case CYBLE_EVT_STACK_ON:
         case CYBLE_EVT_GAP_DEVICE_DISCONNECTED:
-            tempNotify = 0;
+            VentPublish_Enable(&tempGroup, 0);
+            VentLog_DownloadEnd(VentTimer_GetTimeStamp());
+            VentPublish_Enable(&statusGroup, 0);
             capsenseNotify = 0;
             CyBle_GappStartAdvertisement(CYBLE_ADVERTISING_FAST);
             blue_Write(0);
@@ -110,6 +359,7 @@ void BleCallBack(uint32 event, void* eventParam)
         case CYBLE_EVT_GATT_CONNECT_IND:
             updateServo();
             updateLed();
+            updateControl();
             updateTemp();
             blue_Write(1);
             //updateCapsense();  
@@ -120,43 +370,63 @@ void BleCallBack(uint32 event, void* eventParam)
         case CYBLE_EVT_GATTS_WRITE_REQ:
             wrReqParam = (CYBLE_GATTS_WRITE_REQ_PARAM_T *) eventParam;
 			
-            /* request write the Servo value */
+            /* request write the Servo value, the legacy steps only, the
+               controller is set up through the Control characteristic */
             if(wrReqParam->handleValPair.attrHandle == CYBLE_LEDCAPSENSE_SERVO_CHAR_HANDLE)
             {
+                if(wrReqParam->handleValPair.value.val[0] > VENT_DAMPER_LEGACY_STEPS)
+                {
+                    sendWriteError(CYBLE_GATT_WRITE_REQ, wrReqParam->handleValPair.attrHandle,
+                                   CYBLE_GATT_ERR_OUT_OF_RANGE);
+                }
                 /* only update the value and write the response if the requested write is allowed */
-                if(CYBLE_GATT_ERR_NONE == CyBle_GattsWriteAttributeValue(&wrReqParam->handleValPair, 0, &cyBle_connHandle, CYBLE_GATT_DB_PEER_INITIATED))
+                else if(CYBLE_GATT_ERR_NONE == CyBle_GattsWriteAttributeValue(&wrReqParam->handleValPair, 0, &cyBle_connHandle, CYBLE_GATT_DB_PEER_INITIATED))
                 {
-                    switch (wrReqParam->handleValPair.value.val[0]) {
-                        case (0):
-                            PWM_Servo_WriteCompare(4315);
-                            //Timer_WritePeriod(1205);
-                            //Timer_Start();
-                        break;
-                        case (1):
-                            PWM_Servo_WriteCompare(4350);
-                            //Timer_WritePeriod(540);
-                            //Timer_Start();
-                        break;
-                        case (2):
-                            PWM_Servo_WriteCompare(4375);
-                            //Timer_WritePeriod(225);
-                            //Timer_Start();
-                        case (3):
-                            PWM_Servo_WriteCompare(4425);
-                        break;
-                        case (4):
-                            PWM_Servo_WriteCompare(4450);
+                    /* a hub write is an override, it stands until the
+                       next scheduled transition */
+                    applyServoCommand(wrReqParam->handleValPair.value.val[0]);
+                    CyBle_GattsWriteRsp(cyBle_connHandle);
+                }
+            }
+            
+            /* request write the controller settings, the stack only keeps
+               them once the whole record is taken */
+            if(wrReqParam->handleValPair.attrHandle == CYBLE_LEDCAPSENSE_CONTROL_CHAR_HANDLE)
+            {
+                switch (VentControl_Unpack(&ventControl, wrReqParam->handleValPair.value.val,
+                                           wrReqParam->handleValPair.value.len, VentDamper_GetPosition()))
+                {
+                    case VENT_CONTROL_OK:
+                        updateControl();
+                        CyBle_GattsWriteRsp(cyBle_connHandle);
                         break;
-                        case (5):
-                            PWM_Servo_WriteCompare(4475);
+                    case VENT_CONTROL_BAD_LENGTH:
+                        sendWriteError(CYBLE_GATT_WRITE_REQ, wrReqParam->handleValPair.attrHandle,
+                                       CYBLE_GATT_ERR_INVALID_ATTRIBUTE_LEN);
                         break;
                     default:
+                        sendWriteError(CYBLE_GATT_WRITE_REQ, wrReqParam->handleValPair.attrHandle,
+                                       CYBLE_GATT_ERR_OUT_OF_RANGE);
                         break;
-                    }
+                }
+            }
+
+            /* request a row of the history */
+            if(wrReqParam->handleValPair.attrHandle == CYBLE_LEDCAPSENSE_LOG_CHAR_HANDLE)
+            {
+                if(wrReqParam->handleValPair.value.len != VENT_LOG_SLOT_LEN)
+                {
+                    sendWriteError(CYBLE_GATT_WRITE_REQ, wrReqParam->handleValPair.attrHandle,
+                                   CYBLE_GATT_ERR_INVALID_ATTRIBUTE_LEN);
+                }
+                else
+                {
+                    selectLogRow((uint16)(wrReqParam->handleValPair.value.val[0] |
+                                          ((uint16)wrReqParam->handleValPair.value.val[1] << 8)));
                     CyBle_GattsWriteRsp(cyBle_connHandle);
                 }
             }
-            
+
             /* request write the LED value */
             if(wrReqParam->handleValPair.attrHandle == CYBLE_LEDCAPSENSE_LED_CHAR_HANDLE)
             {
@@ -176,15 +446,45 @@ void BleCallBack(uint32 event, void* eventParam)
                 //CyBle_GattsWriteRsp(cyBle_connHandle);
             //}
             
+            /* short schedule writes carry the hub time reference */
+            if(wrReqParam->handleValPair.attrHandle == CYBLE_LEDCAPSENSE_SCHEDULE_CHAR_HANDLE)
+            {
+                CYBLE_GATT_ERR_CODE_T error = scheduleError(VentSchedule_Write(wrReqParam->handleValPair.value.val,
+                    wrReqParam->handleValPair.value.len, VentTimer_GetTimeStamp()));
+
+                if (error == CYBLE_GATT_ERR_NONE)
+                {
+                    CyBle_GattsWriteRsp(cyBle_connHandle);
+                }
+                else
+                {
+                    sendWriteError(CYBLE_GATT_WRITE_REQ, wrReqParam->handleValPair.attrHandle, error);
+                }
+            }
+
+            /* request to update the status notification */
+            if(wrReqParam->handleValPair.attrHandle == CYBLE_LEDCAPSENSE_STATUS_STATUSCCCD_DESC_HANDLE)
+            {
+                CyBle_GattsWriteAttributeValue(&wrReqParam->handleValPair, 0, &cyBle_connHandle, CYBLE_GATT_DB_PEER_INITIATED);
+                VentPublish_Enable(&statusGroup, wrReqParam->handleValPair.value.val[0] & 0x01);
+                CyBle_GattsWriteRsp(cyBle_connHandle);
+            }
+
             // request to update temp notification
             if(wrReqParam->handleValPair.attrHandle == CYBLE_LEDCAPSENSE_TEMP_TEMPCCCD_DESC_HANDLE)
             {
                 CyBle_GattsWriteAttributeValue(&wrReqParam->handleValPair, 0, &cyBle_connHandle, CYBLE_GATT_DB_PEER_INITIATED);
-                tempNotify = wrReqParam->handleValPair.value.val[0] & 0x01;
+                VentPublish_Enable(&tempGroup, wrReqParam->handleValPair.value.val[0] & 0x01);
                 CyBle_GattsWriteRsp(cyBle_connHandle);
             }
             
 			break;  
+
+        /* the table is written once with a long write, the stack queues
+           the parts and hands them over on execute */
+        case CYBLE_EVT_GATTS_EXEC_WRITE_REQ:
+            execWriteSchedule((CYBLE_GATTS_EXEC_WRITE_REQ_T *) eventParam);
+            break;
         
         default:
             break;
@@ -203,13 +503,24 @@ CY_ISR(Timer_Int_Handler) {
  **************************************************************/
 int main()
 {
+    uint16 position;
+
     CyGlobalIntEnable; 
     
     //capsense_Start();
     //capsense_InitializeEnabledBaselines();
     
+    VentTimer_Start();
+    VentPublish_Init(&tempGroup);
+    VentPublish_Init(&statusGroup);
+    VentPublish_SetField(&statusGroup, VENT_STATUS_FIELD_PRESSURE, VENT_STATUS_NO_PRESSURE);
+    VentPublish_SetField(&statusGroup, VENT_STATUS_FIELD_BATTERY, VENT_STATUS_NO_BATTERY);
+    VentControl_Init(&ventControl);
+    VentLog_Start();
+    VentSchedule_Start();
     timer_int_StartEx(Timer_Int_Handler);
-    PWM_Servo_Start();
+    VentDamper_Start();
+    VentMotion_Start();
     UART_Start();
     OneWire_Start();
     flag = 1;
@@ -217,9 +528,6 @@ int main()
     /* Start BLE stack and register the callback function */
     CyBle_Start(BleCallBack);
     
-    // Turn off PWM
-    PWM_Servo_WriteCompare(0);
-    
     for(;;)
     {        
         /* if Capsense scan is done, read the value and start another scan */
@@ -247,6 +555,11 @@ int main()
             sprintf(buf, "%d\r\n", Temp);
             UART_UartPutString(buf);
             updateTemp();
+            updateLog();
+            if (VentControl_Update(&ventControl, (int16)Temp, VentTimer_GetTimeStamp(), &position))
+            {
+                VentMotion_MoveTo(position, VENT_MOTION_SCURVE);
+            }
             flag = 1;
             //Timer_WritePeriod(10000);
             //Timer_Start();
@@ -256,6 +569,10 @@ int main()
            
         }
         
+        updateSchedule();
+        updateStatus();
+        VentDamper_Process(VentTimer_GetTimeStamp());
+        VentLog_DownloadProcess(VentTimer_GetTimeStamp());
         CyBle_ProcessEvents();
         CyBle_EnterLPM(CYBLE_BLESS_DEEPSLEEP);    
     }
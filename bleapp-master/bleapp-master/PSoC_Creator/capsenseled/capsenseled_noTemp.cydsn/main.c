@@ -83,8 +83,10 @@ void updateTemp()
     
     /* send notification to client if notifications are enabled and temperature has changed */
     if (tempNotify && (Temp != TempOld) )
+    {
         CyBle_GattsNotification(cyBle_connHandle,&tempHandle);
         TempOld = Temp;
+    }
 }
 
 /***************************************************************